@@ -0,0 +1,304 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+tiling_func 调用的内存分配探针（可选注入）：
+- 替换全局 operator new/delete（含数组、nothrow、sized 版本；aligned 版本仅在支持 __cpp_aligned_new 时）
+  与 malloc/calloc/realloc/free/posix_memalign/aligned_alloc/memalign，统一转发到 glibc 的 __libc_* 实现，
+  只在探针激活的线程上计数（对齐分配也经过钩子，否则其释放走 free 钩子会让净增字节为负）
+- 生成文件中的 tiling_func(tiling_context) 改写为 utgen_alloc::ProbedCall(...)，
+  每次调用记录分配次数、释放次数、分配字节数、峰值与净增字节，以及返回状态与 tiling key
+- 进程退出时写 JSON 旁路文件（默认 <stem>_alloc.json，可用环境变量 UTGEN_ALLOC_REPORT 覆盖）
+
+替换全局分配函数对整个可执行文件生效，同一测试二进制中只应链接一个注入了探针的文件。
+"""
+
+from __future__ import annotations
+
+from typing import List
+
+from tiling_layouts import TilingProbe
+
+
+PROBE_MARKER = "namespace utgen_alloc"
+
+
+def render_alloc_probe(report_stem: str) -> str:
+    out: List[str] = []
+    out.append("#include <malloc.h>")
+    out.append("#include <cerrno>")
+    out.append("#include <cstdint>")
+    out.append("#include <cstdlib>")
+    out.append("#include <fstream>")
+    out.append("#include <mutex>")
+    out.append("#include <new>")
+    out.append("#include <string>")
+    out.append("#include <vector>")
+    out.append("#include <gtest/gtest.h>")
+    out.append("")
+    out.append("extern \"C\" void* __libc_malloc(size_t size);")
+    out.append("extern \"C\" void* __libc_calloc(size_t num, size_t size);")
+    out.append("extern \"C\" void* __libc_realloc(void* ptr, size_t size);")
+    out.append("extern \"C\" void* __libc_memalign(size_t alignment, size_t size);")
+    out.append("extern \"C\" void __libc_free(void* ptr);")
+    out.append("")
+    out.append("namespace utgen_alloc {")
+    out.append("// 仅含平凡类型，thread_local 零初始化，不会在分配函数内触发 TLS 构造")
+    out.append("struct Counters {")
+    out.append("    bool active;")
+    out.append("    uint64_t alloc_count;")
+    out.append("    uint64_t free_count;")
+    out.append("    uint64_t alloc_bytes;")
+    out.append("    int64_t live_bytes;")
+    out.append("    int64_t peak_bytes;")
+    out.append("};")
+    out.append("")
+    out.append("thread_local Counters counters;")
+    out.append("")
+    out.append("inline void OnAlloc(void* ptr)")
+    out.append("{")
+    out.append("    if (ptr == nullptr || !counters.active) {")
+    out.append("        return;")
+    out.append("    }")
+    out.append("    size_t size = malloc_usable_size(ptr);")
+    out.append("    counters.alloc_count++;")
+    out.append("    counters.alloc_bytes += size;")
+    out.append("    counters.live_bytes += static_cast<int64_t>(size);")
+    out.append("    if (counters.live_bytes > counters.peak_bytes) {")
+    out.append("        counters.peak_bytes = counters.live_bytes;")
+    out.append("    }")
+    out.append("}")
+    out.append("")
+    out.append("inline void OnFree(void* ptr)")
+    out.append("{")
+    out.append("    if (ptr == nullptr || !counters.active) {")
+    out.append("        return;")
+    out.append("    }")
+    out.append("    counters.free_count++;")
+    out.append("    counters.live_bytes -= static_cast<int64_t>(malloc_usable_size(ptr));")
+    out.append("}")
+    out.append("")
+    out.append("struct CallRecord {")
+    out.append("    std::string test_name;")
+    out.append("    uint64_t tiling_key;")
+    out.append("    int64_t status;")
+    out.append("    Counters stats;")
+    out.append("};")
+    out.append("")
+    out.append("class Report {")
+    out.append("public:")
+    out.append("    static Report& Get()")
+    out.append("    {")
+    out.append("        static Report instance;")
+    out.append("        return instance;")
+    out.append("    }")
+    out.append("")
+    out.append("    void Add(CallRecord record)")
+    out.append("    {")
+    out.append("        std::lock_guard<std::mutex> lock(mutex_);")
+    out.append("        records_.push_back(std::move(record));")
+    out.append("    }")
+    out.append("")
+    out.append("    ~Report()")
+    out.append("    {")
+    out.append("        const char* env_path = std::getenv(\"UTGEN_ALLOC_REPORT\");")
+    out.append(f"        std::string path = (env_path != nullptr && *env_path != '\\0') ? env_path : \"{report_stem}_alloc.json\";")
+    out.append("        std::ofstream os(path);")
+    out.append("        os << \"{\\n  \\\"calls\\\": [\";")
+    out.append("        for (size_t i = 0; i < records_.size(); ++i) {")
+    out.append("            const auto& r = records_[i];")
+    out.append("            os << (i ? \",\\n\" : \"\\n\") << \"    {\\\"test\\\": \\\"\" << r.test_name << \"\\\", \\\"tiling_key\\\": \\\"\" << r.tiling_key")
+    out.append("               << \"\\\", \\\"status\\\": \" << r.status << \", \\\"allocs\\\": \" << r.stats.alloc_count")
+    out.append("               << \", \\\"frees\\\": \" << r.stats.free_count << \", \\\"bytes\\\": \" << r.stats.alloc_bytes")
+    out.append("               << \", \\\"peak_bytes\\\": \" << r.stats.peak_bytes << \", \\\"net_bytes\\\": \" << r.stats.live_bytes << \"}\";")
+    out.append("        }")
+    out.append("        os << \"\\n  ]\\n}\\n\";")
+    out.append("    }")
+    out.append("")
+    out.append("private:")
+    out.append("    Report() = default;")
+    out.append("    std::mutex mutex_;")
+    out.append("    std::vector<CallRecord> records_;")
+    out.append("};")
+    out.append("")
+    out.append("// 只统计 func(ctx) 调用期间当前线程上的分配；记录本身在探针关闭后写入")
+    out.append("template <typename Func, typename Context>")
+    out.append("auto ProbedCall(Func&& func, Context* context) -> decltype(func(context))")
+    out.append("{")
+    out.append("    Report::Get();")
+    out.append("    counters = Counters{};")
+    out.append("    counters.active = true;")
+    out.append("    auto ret = func(context);")
+    out.append("    counters.active = false;")
+    out.append("    Counters stats = counters;")
+    out.append("    const auto* test_info = testing::UnitTest::GetInstance()->current_test_info();")
+    out.append("    std::string test_name;")
+    out.append("    if (test_info != nullptr) {")
+    out.append("        test_name = std::string(test_info->test_suite_name()) + \".\" + test_info->name();")
+    out.append("    }")
+    out.append("    Report::Get().Add({test_name, context->GetTilingKey(), static_cast<int64_t>(ret), stats});")
+    out.append("    return ret;")
+    out.append("}")
+    out.append("} // namespace utgen_alloc")
+    out.append("")
+    out.append("extern \"C\" void* malloc(size_t size)")
+    out.append("{")
+    out.append("    void* ptr = __libc_malloc(size);")
+    out.append("    utgen_alloc::OnAlloc(ptr);")
+    out.append("    return ptr;")
+    out.append("}")
+    out.append("")
+    out.append("extern \"C\" void* calloc(size_t num, size_t size)")
+    out.append("{")
+    out.append("    void* ptr = __libc_calloc(num, size);")
+    out.append("    utgen_alloc::OnAlloc(ptr);")
+    out.append("    return ptr;")
+    out.append("}")
+    out.append("")
+    out.append("extern \"C\" void* realloc(void* ptr, size_t size)")
+    out.append("{")
+    out.append("    utgen_alloc::OnFree(ptr);")
+    out.append("    void* new_ptr = __libc_realloc(ptr, size);")
+    out.append("    utgen_alloc::OnAlloc(new_ptr);")
+    out.append("    return new_ptr;")
+    out.append("}")
+    out.append("")
+    out.append("extern \"C\" int posix_memalign(void** memptr, size_t alignment, size_t size)")
+    out.append("{")
+    out.append("    if (alignment == 0 || alignment % sizeof(void*) != 0 || (alignment & (alignment - 1)) != 0) {")
+    out.append("        return EINVAL;")
+    out.append("    }")
+    out.append("    void* ptr = __libc_memalign(alignment, size);")
+    out.append("    if (ptr == nullptr) {")
+    out.append("        return ENOMEM;")
+    out.append("    }")
+    out.append("    utgen_alloc::OnAlloc(ptr);")
+    out.append("    *memptr = ptr;")
+    out.append("    return 0;")
+    out.append("}")
+    out.append("")
+    out.append("extern \"C\" void* aligned_alloc(size_t alignment, size_t size)")
+    out.append("{")
+    out.append("    void* ptr = __libc_memalign(alignment, size);")
+    out.append("    utgen_alloc::OnAlloc(ptr);")
+    out.append("    return ptr;")
+    out.append("}")
+    out.append("")
+    out.append("extern \"C\" void* memalign(size_t alignment, size_t size)")
+    out.append("{")
+    out.append("    void* ptr = __libc_memalign(alignment, size);")
+    out.append("    utgen_alloc::OnAlloc(ptr);")
+    out.append("    return ptr;")
+    out.append("}")
+    out.append("")
+    out.append("extern \"C\" void free(void* ptr)")
+    out.append("{")
+    out.append("    utgen_alloc::OnFree(ptr);")
+    out.append("    __libc_free(ptr);")
+    out.append("}")
+    out.append("")
+    out.append("void* operator new(size_t size)")
+    out.append("{")
+    out.append("    void* ptr = __libc_malloc(size == 0 ? 1 : size);")
+    out.append("    if (ptr == nullptr) {")
+    out.append("        throw std::bad_alloc();")
+    out.append("    }")
+    out.append("    utgen_alloc::OnAlloc(ptr);")
+    out.append("    return ptr;")
+    out.append("}")
+    out.append("")
+    out.append("void* operator new[](size_t size)")
+    out.append("{")
+    out.append("    return operator new(size);")
+    out.append("}")
+    out.append("")
+    out.append("void* operator new(size_t size, const std::nothrow_t&) noexcept")
+    out.append("{")
+    out.append("    void* ptr = __libc_malloc(size == 0 ? 1 : size);")
+    out.append("    utgen_alloc::OnAlloc(ptr);")
+    out.append("    return ptr;")
+    out.append("}")
+    out.append("")
+    out.append("void* operator new[](size_t size, const std::nothrow_t& tag) noexcept")
+    out.append("{")
+    out.append("    return operator new(size, tag);")
+    out.append("}")
+    out.append("")
+    out.append("void operator delete(void* ptr) noexcept")
+    out.append("{")
+    out.append("    utgen_alloc::OnFree(ptr);")
+    out.append("    __libc_free(ptr);")
+    out.append("}")
+    out.append("")
+    out.append("void operator delete[](void* ptr) noexcept")
+    out.append("{")
+    out.append("    operator delete(ptr);")
+    out.append("}")
+    out.append("")
+    out.append("void operator delete(void* ptr, size_t) noexcept")
+    out.append("{")
+    out.append("    operator delete(ptr);")
+    out.append("}")
+    out.append("")
+    out.append("void operator delete[](void* ptr, size_t) noexcept")
+    out.append("{")
+    out.append("    operator delete(ptr);")
+    out.append("}")
+    out.append("")
+    out.append("void operator delete(void* ptr, const std::nothrow_t&) noexcept")
+    out.append("{")
+    out.append("    operator delete(ptr);")
+    out.append("}")
+    out.append("")
+    out.append("void operator delete[](void* ptr, const std::nothrow_t&) noexcept")
+    out.append("{")
+    out.append("    operator delete(ptr);")
+    out.append("}")
+    out.append("")
+    out.append("// aligned new/delete 为 C++17 起的接口，更低标准下不声明 std::align_val_t")
+    out.append("#if defined(__cpp_aligned_new)")
+    out.append("void* operator new(size_t size, std::align_val_t alignment)")
+    out.append("{")
+    out.append("    void* ptr = __libc_memalign(static_cast<size_t>(alignment), size == 0 ? 1 : size);")
+    out.append("    if (ptr == nullptr) {")
+    out.append("        throw std::bad_alloc();")
+    out.append("    }")
+    out.append("    utgen_alloc::OnAlloc(ptr);")
+    out.append("    return ptr;")
+    out.append("}")
+    out.append("")
+    out.append("void* operator new[](size_t size, std::align_val_t alignment)")
+    out.append("{")
+    out.append("    return operator new(size, alignment);")
+    out.append("}")
+    out.append("")
+    out.append("void operator delete(void* ptr, std::align_val_t) noexcept")
+    out.append("{")
+    out.append("    operator delete(ptr);")
+    out.append("}")
+    out.append("")
+    out.append("void operator delete[](void* ptr, std::align_val_t) noexcept")
+    out.append("{")
+    out.append("    operator delete(ptr);")
+    out.append("}")
+    out.append("")
+    out.append("void operator delete(void* ptr, size_t, std::align_val_t) noexcept")
+    out.append("{")
+    out.append("    operator delete(ptr);")
+    out.append("}")
+    out.append("")
+    out.append("void operator delete[](void* ptr, size_t, std::align_val_t) noexcept")
+    out.append("{")
+    out.append("    operator delete(ptr);")
+    out.append("}")
+    out.append("#endif")
+    return "\n".join(out) + "\n"
+
+
+def alloc_probe(report_stem: str) -> TilingProbe:
+    """分配探针：tiling_func(tiling_context) 改写为 ProbedCall(...)，位于其它探针之内（见 tiling_layouts.inject_probes）。"""
+    return TilingProbe(
+        kind="alloc",
+        marker=PROBE_MARKER,
+        wrap=lambda _call: "utgen_alloc::ProbedCall(tiling_func, tiling_context)",
+        blocks=[("alloc", render_alloc_probe(report_stem))],
+    )
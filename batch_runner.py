@@ -0,0 +1,323 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+多算子批量生成调度器（替代逐个串行调用 entrypoint.sh 的 run_batch.sh）：
+- 读取算子清单，每个算子依次执行 workflow.sh stage-1 与 stage-2
+- stage-1（阻塞在 LLM 流式调用上）与 stage-2（本地转换）各用一个线程池：某个算子的 stage-1 完成后立即把它的 stage-2
+  投入 stage-2 池，与其它算子的 stage-1 重叠执行
+- 每个作业失败后按指数退避重试；stage-1 最终失败时仍执行 stage-2（与 workflow.sh stage-all 一致，沿用最近一次的参数文件）
+- 结束时打印每个算子各阶段耗时与重试次数的汇总表，并写出 <batch_dir>/summary.json
+- 本批的模型调用指标写入 <batch_dir>/llm_calls.jsonl（llm_metrics.py），汇总中给出服务端前缀缓存命中与首 token 时延
+
+清单格式（文本，# 开头为注释，相对路径相对清单所在目录）：
+    AllGatherMatmul  /path/to/op_tiling/runtime/all_gather_matmul
+    MatmulAllReduce  /path/to/src1 /path/to/src2
+也可为 JSON：[{"op": "AllGatherMatmul", "paths": ["/path/to/src"]}, ...]
+
+用法：
+    python3 batch_runner.py operators.txt --workers 8 --retries 2
+    python3 batch_runner.py operators.txt --stage 2 --only AllGatherMatmul,MatmulAllReduce
+
+stage-1 输入（源码、few-shot、特殊要求）未变化的算子直接复用上次的参数文件（见 stage1_manifest.py），
+--force 强制全部重新生成。
+"""
+
+from __future__ import annotations
+
+import argparse
+import datetime
+import json
+import os
+import subprocess
+import sys
+import threading
+import time
+from concurrent.futures import Future, ThreadPoolExecutor
+from dataclasses import dataclass, field
+from pathlib import Path
+from typing import Dict, List, Optional, Set
+
+import llm_metrics
+
+SCRIPT_DIR = Path(__file__).resolve().parent
+WORKFLOW = SCRIPT_DIR / "workflow.sh"
+STAGES = {"1": "stage-1", "2": "stage-2"}
+
+
+@dataclass
+class OperatorJob:
+    name: str
+    paths: List[str]
+
+
+@dataclass
+class StageResult:
+    ok: bool = False
+    seconds: float = 0.0
+    attempts: int = 0
+    log_file: str = ""
+    skipped: bool = False
+
+
+@dataclass
+class OperatorResult:
+    job: OperatorJob
+    stages: Dict[str, StageResult] = field(default_factory=dict)
+
+
+def load_manifest(manifest: Path) -> List[OperatorJob]:
+    """读取算子清单（文本或 JSON），相对路径按清单所在目录解析。"""
+    base = manifest.resolve().parent
+
+    def resolve(path: str) -> str:
+        p = Path(os.path.expanduser(path))
+        return str(p if p.is_absolute() else (base / p).resolve())
+
+    text = manifest.read_text(encoding="utf-8")
+    jobs: List[OperatorJob] = []
+    if manifest.suffix == ".json":
+        for entry in json.loads(text):
+            jobs.append(OperatorJob(entry["op"], [resolve(p) for p in entry["paths"]]))
+    else:
+        for lineno, line in enumerate(text.splitlines(), 1):
+            line = line.split("#", 1)[0].strip()
+            if not line:
+                continue
+            parts = line.split()
+            if len(parts) < 2:
+                raise ValueError(f"{manifest}:{lineno}: 需要 '<算子名称> <源码路径...>'")
+            jobs.append(OperatorJob(parts[0], [resolve(p) for p in parts[1:]]))
+
+    seen: Set[str] = set()
+    for job in jobs:
+        if job.name in seen:
+            raise ValueError(f"{manifest}: 算子 {job.name} 重复出现")
+        seen.add(job.name)
+    return jobs
+
+
+class BatchRunner:
+    def __init__(self, jobs: List[OperatorJob], batch_dir: Path, stages: List[str],
+                 workers: int, stage2_workers: int, retries: int, retry_delay: float,
+                 force: bool = False):
+        self.jobs = jobs
+        self.batch_dir = batch_dir
+        self.stages = stages
+        self.retries = retries
+        self.retry_delay = retry_delay
+        self.env = dict(os.environ, STAGE1_FORCE="1") if force else dict(os.environ)
+        # 常驻进程（utgen_daemon.py）串行执行请求，并发作业各自直接运行
+        self.env.setdefault("UTGEN_DAEMON", "0")
+        self.metrics_file = Path(self.env.setdefault("LLM_METRICS_FILE", str(batch_dir / "llm_calls.jsonl")))
+        self.results = {job.name: OperatorResult(job) for job in jobs}
+        self.pools = {
+            "1": ThreadPoolExecutor(max_workers=workers, thread_name_prefix="stage1"),
+            "2": ThreadPoolExecutor(max_workers=stage2_workers, thread_name_prefix="stage2"),
+        }
+        self._lock = threading.Lock()
+        self._procs: Set[subprocess.Popen] = set()
+        self._pending: List[Future] = []
+        self._stopping = threading.Event()
+
+    def _print(self, message: str):
+        with self._lock:
+            print(message, flush=True)
+
+    def _run_once(self, job: OperatorJob, stage: str, log_file: Path, attempt: int) -> bool:
+        cmd = [str(WORKFLOW), STAGES[stage], job.name] + job.paths
+        with open(log_file, "a", encoding="utf-8") as log:
+            log.write(f"===== 第 {attempt} 次尝试 {datetime.datetime.now():%Y-%m-%d %H:%M:%S}: {' '.join(cmd)}\n")
+            log.flush()
+            proc = subprocess.Popen(cmd, cwd=SCRIPT_DIR, stdout=log, stderr=subprocess.STDOUT,
+                                    stdin=subprocess.DEVNULL, env=self.env)
+            with self._lock:
+                self._procs.add(proc)
+            try:
+                return proc.wait() == 0
+            finally:
+                with self._lock:
+                    self._procs.discard(proc)
+
+    def _run_stage(self, job: OperatorJob, stage: str) -> StageResult:
+        result = StageResult(log_file=str(self.batch_dir / f"{job.name}_stage{stage}.log"))
+        start = time.monotonic()
+        while result.attempts <= self.retries and not self._stopping.is_set():
+            result.attempts += 1
+            if self._run_once(job, stage, Path(result.log_file), result.attempts):
+                result.ok = True
+                break
+            if result.attempts <= self.retries and not self._stopping.is_set():
+                delay = self.retry_delay * (2 ** (result.attempts - 1))
+                self._print(f"⚠️  {job.name} stage-{stage} 第 {result.attempts} 次失败，{delay:.0f}s 后重试")
+                self._stopping.wait(delay)
+        result.seconds = time.monotonic() - start
+        mark = "✅" if result.ok else "❌"
+        self._print(f"{mark} {job.name} stage-{stage} {result.seconds:.1f}s（{result.attempts} 次）  日志: {result.log_file}")
+        return result
+
+    def _submit(self, job: OperatorJob, stage: str):
+        future = self.pools[stage].submit(self._stage_task, job, stage)
+        with self._lock:
+            self._pending.append(future)
+
+    def _stage_task(self, job: OperatorJob, stage: str):
+        if self._stopping.is_set():
+            self.results[job.name].stages[stage] = StageResult(skipped=True)
+            return
+        result = self._run_stage(job, stage)
+        self.results[job.name].stages[stage] = result
+        if stage == "1" and "2" in self.stages:
+            if not result.ok:
+                self._print(f"⚠️  {job.name} 测试参数生成失败，但继续执行单测生成")
+            self._submit(job, "2")
+
+    def run(self) -> bool:
+        first = self.stages[0]
+        for job in self.jobs:
+            self._submit(job, first)
+        try:
+            # stage-1 任务完成时会追加 stage-2 任务，直到没有新任务为止
+            index = 0
+            while True:
+                with self._lock:
+                    if index >= len(self._pending):
+                        break
+                    future = self._pending[index]
+                future.result()
+                index += 1
+        except KeyboardInterrupt:
+            self._print("🛑 收到中断，终止运行中的作业...")
+            self._stopping.set()
+            with self._lock:
+                for proc in self._procs:
+                    proc.terminate()
+            raise
+        finally:
+            for pool in self.pools.values():
+                pool.shutdown(wait=True, cancel_futures=True)
+        return all(r.ok for res in self.results.values() for r in res.stages.values())
+
+    def summary(self, wall_seconds: float) -> str:
+        header = ["算子"]
+        for stage in self.stages:
+            header += [f"stage-{stage}(s)", "次数"]
+        header.append("结果")
+        rows = [header]
+        serial = 0.0
+        for job in self.jobs:
+            res = self.results[job.name]
+            row = [job.name]
+            ok = True
+            for stage in self.stages:
+                r = res.stages.get(stage, StageResult(skipped=True))
+                ok = ok and r.ok
+                serial += r.seconds
+                row += ["-", "-"] if r.skipped else [f"{r.seconds:.1f}", str(r.attempts)]
+            row.append("成功" if ok else "失败")
+            rows.append(row)
+
+        widths = [max(_display_width(row[i]) for row in rows) for i in range(len(header))]
+        lines = []
+        for n, row in enumerate(rows):
+            lines.append("  ".join(_pad(cell, widths[i]) for i, cell in enumerate(row)))
+            if n == 0:
+                lines.append("  ".join("-" * w for w in widths))
+        speedup = serial / wall_seconds if wall_seconds > 0 else 0.0
+        lines.append("")
+        lines.append(f"总耗时 {wall_seconds:.1f}s，各阶段耗时之和 {serial:.1f}s（并行加速 {speedup:.1f}x）")
+        lines.extend(llm_metrics.format_summary(self.llm_summary()))
+        return "\n".join(lines)
+
+    def llm_summary(self) -> Dict:
+        return llm_metrics.summarize(llm_metrics.load(self.metrics_file))
+
+    def write_summary_json(self, wall_seconds: float):
+        data = {
+            "wall_seconds": round(wall_seconds, 3),
+            "llm": self.llm_summary(),
+            "operators": [
+                {
+                    "op": job.name,
+                    "paths": job.paths,
+                    "stages": {
+                        f"stage-{stage}": {
+                            "ok": r.ok, "seconds": round(r.seconds, 3), "attempts": r.attempts,
+                            "skipped": r.skipped, "log": r.log_file,
+                        }
+                        for stage, r in self.results[job.name].stages.items()
+                    },
+                }
+                for job in self.jobs
+            ],
+        }
+        with open(self.batch_dir / "summary.json", "w", encoding="utf-8") as f:
+            json.dump(data, f, ensure_ascii=False, indent=2)
+
+
+def _display_width(text: str) -> int:
+    # 中文字符在终端占两列
+    return sum(2 if ord(ch) > 0x7F else 1 for ch in text)
+
+
+def _pad(text: str, width: int) -> str:
+    return text + " " * (width - _display_width(text))
+
+
+def main(argv: Optional[List[str]] = None) -> int:
+    parser = argparse.ArgumentParser(description="多算子并行执行 stage-1/stage-2")
+    parser.add_argument("manifest", help="算子清单（文本或 .json）")
+    parser.add_argument("--workers", type=int, default=4, help="stage-1 并发数（LLM 调用，默认 4）")
+    parser.add_argument("--stage2-workers", type=int, default=max(1, min(4, os.cpu_count() or 1)),
+                        help="stage-2 并发数（本地转换，默认 min(4, CPU 数)）")
+    parser.add_argument("--stage", choices=["all", "1", "2"], default="all", help="执行的阶段（默认 all）")
+    parser.add_argument("--retries", type=int, default=1, help="每个作业失败后的重试次数（默认 1）")
+    parser.add_argument("--retry-delay", type=float, default=10.0, help="首次重试前等待秒数，之后翻倍（默认 10）")
+    parser.add_argument("--only", default="", help="只执行清单中的这些算子（逗号分隔）")
+    parser.add_argument("--force", action="store_true", help="忽略 stage-1 增量判定，全部重新生成")
+    parser.add_argument("--dry-run", action="store_true", help="只打印执行计划")
+    args = parser.parse_args(argv)
+
+    try:
+        jobs = load_manifest(Path(args.manifest))
+    except (OSError, ValueError, KeyError, json.JSONDecodeError) as e:
+        print(f"❌ 无法读取算子清单: {e}")
+        return 1
+    if args.only:
+        wanted = [name.strip() for name in args.only.split(",") if name.strip()]
+        unknown = sorted(set(wanted) - {job.name for job in jobs})
+        if unknown:
+            print(f"❌ 清单中没有这些算子: {', '.join(unknown)}")
+            return 1
+        jobs = [job for job in jobs if job.name in wanted]
+    if not jobs:
+        print("❌ 算子清单为空")
+        return 1
+
+    stages = ["1", "2"] if args.stage == "all" else [args.stage]
+    print(f"📋 {len(jobs)} 个算子，阶段 {'+'.join('stage-' + s for s in stages)}，"
+          f"stage-1 并发 {args.workers}，stage-2 并发 {args.stage2_workers}，重试 {args.retries} 次")
+    if args.dry_run:
+        for job in jobs:
+            print(f"  {job.name}: {' '.join(job.paths)}")
+        return 0
+
+    batch_dir = SCRIPT_DIR / "runs" / f"batch_{datetime.datetime.now():%Y%m%d_%H%M%S}"
+    batch_dir.mkdir(parents=True, exist_ok=True)
+    runner = BatchRunner(jobs, batch_dir, stages, max(1, args.workers), max(1, args.stage2_workers),
+                         max(0, args.retries), args.retry_delay, args.force)
+    start = time.monotonic()
+    try:
+        ok = runner.run()
+    except KeyboardInterrupt:
+        ok = False
+    wall = time.monotonic() - start
+
+    print("")
+    print(runner.summary(wall))
+    runner.write_summary_json(wall)
+    print(f"📁 汇总: {batch_dir / 'summary.json'}")
+    return 0 if ok else 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,159 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+tiling 函数时延基准（Google Benchmark）渲染：
+- 复用 param_harness 的 TilingParams / Harness 与 test_params[] 数据表，与单测共享同一份 xlsx 行
+- 每行注册一个 benchmark，TilingContextFaker 的构造与平台信息写入都在计时循环之外，
+  循环内只对 tiling_func(tiling_context) 手动计时
+- 每个用例上报 p50/p99（纳秒）与 tiling key；默认输出 JSON 到 bench_<op>_tiling.json
+- 状态或 tiling key 与期望不符时照常保留计时，以 mismatch 计数器与 label 标出，全部跑完后进程返回非零
+"""
+
+from __future__ import annotations
+
+from typing import List
+
+from param_harness import (
+    ParamSuite,
+    TestParamRow,
+    render_harness,
+    render_param_row,
+    snake_from_camel,
+    unique_test_names,
+)
+
+
+def bench_file_stem(op_name: str) -> str:
+    return f"bench_{snake_from_camel(op_name)}_tiling"
+
+
+def render_bench_body(suite: ParamSuite) -> str:
+    """生成单个用例的计时函数。"""
+    H = suite.harness
+    cap = suite.tiling_data_cap
+    out: List[str] = []
+    out.append("inline double Percentile(std::vector<double>& samples, double ratio)")
+    out.append("{")
+    out.append("    if (samples.empty()) {")
+    out.append("        return 0.0;")
+    out.append("    }")
+    out.append("    size_t index = static_cast<size_t>(ratio * static_cast<double>(samples.size() - 1));")
+    out.append("    std::nth_element(samples.begin(), samples.begin() + index, samples.end());")
+    out.append("    return samples[index];")
+    out.append("}")
+    out.append("")
+    out.append("// 状态或 tiling key 与期望不符的用例数；用例顺序执行，无需同步")
+    out.append("int g_mismatch_count = 0;")
+    out.append("")
+    out.append("void BenchTilingCase(benchmark::State& state, const TestParam& test_param)")
+    out.append("{")
+    out.append(f"    std::string op_type(\"{suite.op_name}\");")
+    out.append("    auto* op_impl = gert::OpImplRegistry::GetInstance().GetOpImpl(op_type.c_str());")
+    out.append("    if (op_impl == nullptr || op_impl->tiling == nullptr) {")
+    out.append("        state.SkipWithError(\"tiling func not registered\");")
+    out.append("        ++g_mismatch_count;")
+    out.append("        return;")
+    out.append("    }")
+    out.append("    auto tiling_func = op_impl->tiling;")
+    out.append("    const auto& platform_cache = TilingPlatformCache::Get();")
+    out.append("")
+    out.append(f"    auto tilingData = gert::TilingData::CreateCap({cap});")
+    out.append(f"    auto workspace_holer = gert::ContinuousVector::Create<size_t>({cap});")
+    out.append("    auto workspace = reinterpret_cast<gert::ContinuousVector*>(workspace_holer.get());")
+    out.append(f"    {H} harness;")
+    out.append("    harness.InitHolder(tilingData.get(), workspace, test_param.tiling_params_str_pair);")
+    out.append("    gert::TilingContext* tiling_context = harness.GetTilingContext();")
+    out.append("    harness.SetPlatformRes(platform_cache);")
+    out.append("    TopoInfoGuard topo_guard(harness);")
+    out.append("")
+    out.append("    std::vector<double> samples;")
+    out.append("    samples.reserve(state.max_iterations < 1000000 ? static_cast<size_t>(state.max_iterations) : 1000000);")
+    out.append("    ge::graphStatus ret = ge::GRAPH_SUCCESS;")
+    out.append("    for (auto _ : state) {")
+    out.append("        auto start = std::chrono::steady_clock::now();")
+    out.append("        ret = tiling_func(tiling_context);")
+    out.append("        auto end = std::chrono::steady_clock::now();")
+    out.append("        double elapsed_ns = std::chrono::duration<double, std::nano>(end - start).count();")
+    out.append("        state.SetIterationTime(elapsed_ns * 1e-9);")
+    out.append("        samples.push_back(elapsed_ns);")
+    out.append("    }")
+    out.append("")
+    out.append("    uint64_t tiling_key = tiling_context->GetTilingKey();")
+    out.append("    state.counters[\"p50_ns\"] = Percentile(samples, 0.50);")
+    out.append("    state.counters[\"p99_ns\"] = Percentile(samples, 0.99);")
+    out.append("    state.counters[\"tiling_key\"] = static_cast<double>(tiling_key);")
+    out.append("    state.counters[\"status\"] = static_cast<double>(ret);")
+    out.append("    // counters 为 double，超过 2^53 的 tiling key 以 label 中的十进制为准")
+    out.append("    std::string label = \"tiling_key=\" + std::to_string(tiling_key);")
+    out.append("    // 不符时不调用 SkipWithError，以免丢弃该用例的计时与计数器")
+    out.append("    bool mismatch = false;")
+    out.append("    if (ret != test_param.status) {")
+    out.append("        label += \" unexpected status (expect \" + std::to_string(test_param.status) + \")\";")
+    out.append("        mismatch = true;")
+    out.append("    } else if (test_param.check_tiling_key && tiling_key != test_param.tiling_key) {")
+    out.append("        label += \" unexpected tiling key (expect \" + std::to_string(test_param.tiling_key) + \")\";")
+    out.append("        mismatch = true;")
+    out.append("    }")
+    out.append("    state.counters[\"mismatch\"] = mismatch ? 1.0 : 0.0;")
+    out.append("    state.SetLabel(label);")
+    out.append("    if (mismatch) {")
+    out.append("        ++g_mismatch_count;")
+    out.append("    }")
+    out.append("}")
+    return "\n".join(out) + "\n"
+
+
+def render_bench_main(suite: ParamSuite, rows: List[TestParamRow]) -> str:
+    stem = bench_file_stem(suite.op_name)
+    out: List[str] = []
+    out.append("static TestParam test_params[] = {")
+    out.append(",\n".join(render_param_row(r) for r in rows))
+    out.append("};")
+    out.append(f"}} // namespace {suite.namespace}")
+    out.append("")
+    out.append("int main(int argc, char** argv)")
+    out.append("{")
+    out.append(f"    using namespace {suite.namespace};")
+    out.append("    // 未指定 --benchmark_out 时默认写 JSON，便于按用例比对 p50/p99 与 tiling key")
+    out.append("    std::vector<char*> args(argv, argv + argc);")
+    out.append("    bool has_out = false;")
+    out.append("    for (int i = 1; i < argc; ++i) {")
+    out.append("        has_out = has_out || std::string(argv[i]).rfind(\"--benchmark_out=\", 0) == 0;")
+    out.append("    }")
+    out.append(f"    std::string out_arg = \"--benchmark_out={stem}.json\";")
+    out.append("    std::string format_arg = \"--benchmark_out_format=json\";")
+    out.append("    if (!has_out) {")
+    out.append("        args.push_back(&out_arg[0]);")
+    out.append("        args.push_back(&format_arg[0]);")
+    out.append("    }")
+    out.append("    int bench_argc = static_cast<int>(args.size());")
+    out.append("    for (const auto& test_param : test_params) {")
+    out.append(f"        std::string name = \"{suite.op_name}Tiling/\" + test_param.test_name;")
+    out.append("        benchmark::RegisterBenchmark(name.c_str(), [test_param](benchmark::State& state) {")
+    out.append("            BenchTilingCase(state, test_param);")
+    out.append("        })->UseManualTime();")
+    out.append("    }")
+    out.append("    benchmark::Initialize(&bench_argc, args.data());")
+    out.append("    benchmark::RunSpecifiedBenchmarks();")
+    out.append("    if (g_mismatch_count > 0) {")
+    out.append("        std::fprintf(stderr, \"%d benchmark case(s) returned an unexpected tiling status or key\\n\", g_mismatch_count);")
+    out.append("        return 1;")
+    out.append("    }")
+    out.append("    return 0;")
+    out.append("}")
+    return "\n".join(out) + "\n"
+
+
+def render_bench_file(common_prefix: str, suite: ParamSuite, rows: List[TestParamRow]) -> str:
+    """生成与单测同源的 Google Benchmark 文件（需链接 benchmark，不需要 gtest_main）。"""
+    unique_test_names(rows)
+    return (
+        common_prefix
+        + "\n\n"
+        + "#include <algorithm>\n#include <chrono>\n#include <cstdio>\n\n#include <benchmark/benchmark.h>\n\n"
+        + render_harness(suite, rows)
+        + "\n"
+        + render_bench_body(suite)
+        + "\n"
+        + render_bench_main(suite, rows)
+    )
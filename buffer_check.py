@@ -0,0 +1,195 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+片上缓冲区与核利用率检查（可选注入）：
+- 复用 tiling_score 的 TilingData 解码（TILING_DATA_FIELDS + TILING_ROLES），按 base 块、depthA1/B1、
+  L0 双缓冲与 bias 估算每个用例的 L0A/L0B/L0C/L1/UB 占用，预算取生成文件中 hardware_info 的
+  L0A_SIZE/L0B_SIZE/L0C_SIZE/L1_SIZE/UB_SIZE（模板 HARDWARE_INFO 可覆盖）
+- 核利用率 = GetBlockDim() / CORE_NUM
+- 任一缓冲区超出预算或 block dim 超过 CORE_NUM 即 ADD_FAILURE；利用率低于 UTGEN_UTIL_WARN（默认 0.5）的用例打印告警，
+  低利用率用例占比超过 UTGEN_UTIL_CHRONIC（默认 0.3）时在退出时给出汇总告警
+- 逐用例占用写入 <stem>_buffer.csv（可用环境变量 UTGEN_BUFFER_REPORT 覆盖）
+
+占用估算（字节）：
+  dtype 为用例首个输入的元素字节数（utgen_perf::DtypeBytes）
+  L0A = baseM * baseK * dtype * dbL0A        L0B = baseK * baseN * dtype * dbL0B
+  L0C = baseM * baseN * 4 * dbL0C（fp32 累加）
+  L1  = (depthA1 * baseM * baseK + depthB1 * baseK * baseN) * dtype + isBias * baseN * 4
+  UB  = ub_bytes 角色对应的字段（未映射时不检查）
+"""
+
+from __future__ import annotations
+
+from typing import List
+
+from tiling_layouts import TilingProbe
+from tiling_score import ScoreSpec, perf_model_block
+
+
+CHECK_MARKER = "utgen_buffer::Check("
+
+# (名称, hardware_info 键)
+BUFFERS = [
+    ("L0A", "L0A_SIZE"),
+    ("L0B", "L0B_SIZE"),
+    ("L0C", "L0C_SIZE"),
+    ("L1", "L1_SIZE"),
+    ("UB", "UB_SIZE"),
+]
+
+
+def render_buffer_check(spec: ScoreSpec, report_stem: str) -> str:
+    hw = spec.hardware
+    out: List[str] = []
+    out.append("namespace utgen_buffer {")
+    names = ", ".join(f"\"{name}\"" for name, _ in BUFFERS)
+    budgets = ", ".join(f"{int(hw[key])}ULL" for _, key in BUFFERS)
+    out.append(f"static const char* const kBufferNames[] = {{{names}}};")
+    out.append(f"static const uint64_t kBufferBudget[] = {{{budgets}}};")
+    out.append(f"static const size_t kBufferNum = {len(BUFFERS)};")
+    out.append(f"static const uint32_t kCoreNum = {int(hw['CORE_NUM'])};")
+    out.append(f"static const bool kCheckUb = {'true' if 'ub_bytes' in spec.roles else 'false'};")
+    out.append("")
+    out.append("struct Usage {")
+    out.append("    uint64_t bytes[kBufferNum];")
+    out.append("    uint32_t block_dim;")
+    out.append("};")
+    out.append("")
+    out.append("inline Usage ComputeUsage(const utgen_perf::Decoded& t, uint32_t block_dim)")
+    out.append("{")
+    out.append("    const double dtype = t.dtype_bytes;")
+    out.append("    // 0 表示算子侧未设置，按单缓冲/单块计")
+    out.append("    auto at_least_one = [](uint64_t v) { return std::max<uint64_t>(1, v); };")
+    out.append("    // 按元素数 * 字节数计，INT4 的半字节向上取整")
+    out.append("    auto bytes = [dtype](uint64_t elements) { return static_cast<uint64_t>(std::ceil(elements * dtype)); };")
+    out.append("    Usage usage{};")
+    out.append("    usage.bytes[0] = bytes(t.base_m * t.base_k) * at_least_one(t.db_l0a);")
+    out.append("    usage.bytes[1] = bytes(t.base_k * t.base_n) * at_least_one(t.db_l0b);")
+    out.append("    usage.bytes[2] = t.base_m * t.base_n * 4 * at_least_one(t.db_l0c);")
+    out.append("    usage.bytes[3] = bytes(at_least_one(t.depth_a1) * t.base_m * t.base_k + at_least_one(t.depth_b1) * t.base_k * t.base_n) +")
+    out.append("                     (t.is_bias != 0 ? t.base_n * 4 : 0);")
+    out.append("    usage.bytes[4] = t.ub_bytes;")
+    out.append("    usage.block_dim = block_dim;")
+    out.append("    return usage;")
+    out.append("}")
+    out.append("")
+    out.append("inline double EnvRatio(const char* name, double fallback)")
+    out.append("{")
+    out.append("    const char* value = std::getenv(name);")
+    out.append("    return (value == nullptr || *value == '\\0') ? fallback : std::stod(value);")
+    out.append("}")
+    out.append("")
+    out.append("struct CaseUsage {")
+    out.append("    std::string test_name;")
+    out.append("    uint64_t m;")
+    out.append("    uint64_t n;")
+    out.append("    Usage usage;")
+    out.append("};")
+    out.append("")
+    out.append("class Summary {")
+    out.append("public:")
+    out.append("    static Summary& Get()")
+    out.append("    {")
+    out.append("        static Summary instance;")
+    out.append("        return instance;")
+    out.append("    }")
+    out.append("")
+    out.append("    void Add(CaseUsage record, bool under_used)")
+    out.append("    {")
+    out.append("        std::lock_guard<std::mutex> lock(mutex_);")
+    out.append("        under_used_ += under_used ? 1 : 0;")
+    out.append("        records_.push_back(std::move(record));")
+    out.append("    }")
+    out.append("")
+    out.append("    const double warn_ratio = EnvRatio(\"UTGEN_UTIL_WARN\", 0.5);")
+    out.append("    const double chronic_ratio = EnvRatio(\"UTGEN_UTIL_CHRONIC\", 0.3);")
+    out.append("")
+    out.append("    ~Summary()")
+    out.append("    {")
+    out.append("        const char* env_path = std::getenv(\"UTGEN_BUFFER_REPORT\");")
+    out.append(f"        std::string path = (env_path != nullptr && *env_path != '\\0') ? env_path : \"{report_stem}_buffer.csv\";")
+    out.append("        std::ofstream os(path);")
+    out.append("        os << \"test,m,n,block_dim,core_util\";")
+    out.append("        for (size_t i = 0; i < kBufferNum; ++i) {")
+    out.append("            os << \",\" << kBufferNames[i] << \"_bytes,\" << kBufferNames[i] << \"_occupancy\";")
+    out.append("        }")
+    out.append("        os << \"\\n\";")
+    out.append("        for (const auto& r : records_) {")
+    out.append("            os << r.test_name << \",\" << r.m << \",\" << r.n << \",\" << r.usage.block_dim << \",\"")
+    out.append("               << static_cast<double>(r.usage.block_dim) / kCoreNum;")
+    out.append("            for (size_t i = 0; i < kBufferNum; ++i) {")
+    out.append("                os << \",\" << r.usage.bytes[i] << \",\" << static_cast<double>(r.usage.bytes[i]) / kBufferBudget[i];")
+    out.append("            }")
+    out.append("            os << \"\\n\";")
+    out.append("        }")
+    out.append("        if (!records_.empty() && static_cast<double>(under_used_) / records_.size() > chronic_ratio) {")
+    out.append("            std::cout << \"[buffer] WARNING: \" << under_used_ << \" of \" << records_.size()")
+    out.append("                      << \" cases use less than \" << warn_ratio * 100 << \"% of \" << kCoreNum << \" cores\" << std::endl;")
+    out.append("        }")
+    out.append("    }")
+    out.append("")
+    out.append("private:")
+    out.append("    Summary() = default;")
+    out.append("    std::mutex mutex_;")
+    out.append("    size_t under_used_{0};")
+    out.append("    std::vector<CaseUsage> records_;")
+    out.append("};")
+    out.append("")
+    out.append("// 在 tiling_func 返回后检查缓冲区占用与核利用率，不改变返回值")
+    out.append("template <typename Ret, typename Context>")
+    out.append("Ret Check(Ret ret, Context* context)")
+    out.append("{")
+    out.append("    std::string test_name;")
+    out.append("    const auto* test_info = testing::UnitTest::GetInstance()->current_test_info();")
+    out.append("    if (test_info != nullptr) {")
+    out.append("        test_name = std::string(test_info->test_suite_name()) + \".\" + test_info->name();")
+    out.append("    }")
+    out.append("    auto* raw_tiling_data = context->GetRawTilingData();")
+    out.append("    if (raw_tiling_data == nullptr || raw_tiling_data->GetData() == nullptr) {")
+    out.append("        return ret;")
+    out.append("    }")
+    out.append("    auto tiling = utgen_perf::Decode(static_cast<const uint8_t*>(raw_tiling_data->GetData()), raw_tiling_data->GetDataSize(),")
+    out.append("                                     utgen_perf::DtypeBytes(context));")
+    out.append("    if (!tiling.valid) {")
+    out.append("        std::cout << \"[buffer] \" << test_name << \": tiling data not decodable\" << std::endl;")
+    out.append("        return ret;")
+    out.append("    }")
+    out.append("    Usage usage = ComputeUsage(tiling, context->GetBlockDim());")
+    out.append("    std::ostringstream line;")
+    out.append("    line << \"[buffer] \" << test_name << \":\";")
+    out.append("    for (size_t i = 0; i < kBufferNum; ++i) {")
+    out.append("        if (i == kBufferNum - 1 && !kCheckUb) {")
+    out.append("            continue;")
+    out.append("        }")
+    out.append("        line << \" \" << kBufferNames[i] << \" \" << usage.bytes[i] << \"/\" << kBufferBudget[i];")
+    out.append("        if (usage.bytes[i] > kBufferBudget[i]) {")
+    out.append("            ADD_FAILURE() << \"[buffer] \" << test_name << \" \" << kBufferNames[i] << \" overflow: \" << usage.bytes[i]")
+    out.append("                          << \" bytes > budget \" << kBufferBudget[i] << \" (baseM=\" << tiling.base_m << \", baseN=\"")
+    out.append("                          << tiling.base_n << \", baseK=\" << tiling.base_k << \")\";")
+    out.append("        }")
+    out.append("    }")
+    out.append("    if (usage.block_dim > kCoreNum) {")
+    out.append("        ADD_FAILURE() << \"[buffer] \" << test_name << \" block dim \" << usage.block_dim << \" exceeds CORE_NUM \" << kCoreNum;")
+    out.append("    }")
+    out.append("    double util = static_cast<double>(usage.block_dim) / kCoreNum;")
+    out.append("    line << \", cores \" << usage.block_dim << \"/\" << kCoreNum;")
+    out.append("    bool under_used = util < Summary::Get().warn_ratio;")
+    out.append("    if (under_used) {")
+    out.append("        line << \" WARNING: low core utilisation \" << util * 100 << \"% (M=\" << tiling.m << \", N=\" << tiling.n << \")\";")
+    out.append("    }")
+    out.append("    std::cout << line.str() << std::endl;")
+    out.append("    Summary::Get().Add({test_name, tiling.m, tiling.n, usage}, under_used);")
+    out.append("    return ret;")
+    out.append("}")
+    out.append("} // namespace utgen_buffer")
+    return "\n".join(out) + "\n"
+
+
+def buffer_probe(spec: ScoreSpec, report_stem: str) -> TilingProbe:
+    """缓冲区检查：复用 utgen_perf 的解码（与 --score 共用一份模型），tiling_func 调用包裹为 Check(...)。"""
+    return TilingProbe(
+        kind="buffer",
+        marker=CHECK_MARKER,
+        wrap=lambda call: f"{CHECK_MARKER}{call}, tiling_context)",
+        blocks=[("perf_model", perf_model_block(spec)), ("buffer", render_buffer_check(spec, report_stem))],
+    )
@@ -2,8 +2,18 @@
 
 # AllGatherMatmulV2 UT 模板
 
+# 与默认硬件参数不同的部分（见 platform_cache.DEFAULT_HARDWARE_INFO）
+HARDWARE_INFO = {
+    "UB_SIZE": 262144,
+    "L2_SIZE": 134217728,
+    "L0C_SIZE": 262144,
+    "CORE_NUM": 32,
+}
+
 def render_test_case(op_name, spec, idx, helpers=None):
     ensure_shapes = helpers["ensure_shapes"] if helpers else None
+    platform_setup_lines = helpers["platform_setup_lines"] if helpers else None
+    platform_apply_lines = helpers["platform_apply_lines"] if helpers else None
     # 注意：V2 场景通常输入与输出 dtype 不一致，因此不沿用单一 dtype_to_ge
 
     # 形状：x1, x2, go, out, bias(可忽略)
@@ -84,31 +94,7 @@ def render_test_case(op_name, spec, idx, helpers=None):
     lines.append("    auto tiling_parse_func = gert::OpImplRegistry::GetInstance().GetOpImpl(op_type.c_str())->tiling_parse;")
     lines.append("    map<string, string> socversions = <LB><RB>;")
     lines.append("")
-    lines.append("    // 2. Setup compile info and platform info")
-    lines.append("    string compile_info_string = R\"(<LB>")
-    lines.append("        \"hardware_info\": <LB>")
-    lines.append("            \"BT_SIZE\": 1024,")
-    lines.append("            \"load3d_constraints\": \"0\",")
-    lines.append("            \"Intrinsic_fix_pipe_l0c2out\": true,")
-    lines.append("            \"Intrinsic_data_move_l12ub\": false,")
-    lines.append("            \"Intrinsic_data_move_l0c2ub\": false,")
-    lines.append("            \"Intrinsic_data_move_out2l1_nd2nz\": true,")
-    lines.append("            \"UB_SIZE\": 262144,")
-    lines.append("            \"L2_SIZE\": 134217728,")
-    lines.append("            \"L1_SIZE\": 524288,")
-    lines.append("            \"L0A_SIZE\": 65536,")
-    lines.append("            \"L0B_SIZE\": 65536,")
-    lines.append("            \"L0C_SIZE\": 262144,")
-    lines.append("            \"CORE_NUM\": 32")
-    lines.append("        <RB>")
-    lines.append("    <RB>)\";")
-    lines.append("    map<string, string> soc_infos;")
-    lines.append("    map<string, string> aicore_spec;")
-    lines.append("    map<string, string> intrinsics;")
-    lines.append("    GetPlatFormInfos(compile_info_string.c_str(), soc_infos, aicore_spec, intrinsics);")
-    lines.append("")
-    lines.append("    fe::PlatFormInfos platform_info;")
-    lines.append("    platform_info.Init();")
+    lines.extend(platform_setup_lines())
     lines.append(f"    struct {compile_info_name} <LB><RB> compile_info;")
     lines.append("")
     lines.append("    // tilingParseFunc simulate")
@@ -167,10 +153,7 @@ def render_test_case(op_name, spec, idx, helpers=None):
     lines.append("    ASSERT_NE(tiling_context->GetPlatformInfo(), nullptr);")
     lines.append("")
     lines.append("    // 7. Set Compile settings")
-    lines.append("    holder.GetContext<gert::TilingContext>()->GetPlatformInfo()->SetPlatformRes(\"SoCInfo\", soc_infos);")
-    lines.append("    holder.GetContext<gert::TilingContext>()->GetPlatformInfo()->SetPlatformRes(\"AICoreSpec\", aicore_spec);")
-    lines.append("    holder.GetContext<gert::TilingContext>()->GetPlatformInfo()->SetCoreNumByCoreType(\"AICore\");")
-    lines.append("    holder.GetContext<gert::TilingContext>()->GetPlatformInfo()->SetPlatformRes(\"AICoreintrinsicDtypeMap\", intrinsics);")
+    lines.extend(platform_apply_lines())
     if version_lines:
         lines.extend(version_lines)
     lines.append("")
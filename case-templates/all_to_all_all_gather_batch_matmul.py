@@ -4,6 +4,8 @@
 
 def render_test_case(op_name, spec, idx, helpers=None):
     dtype_to_ge = helpers["dtype_to_ge"] if helpers else None
+    platform_setup_lines = helpers["platform_setup_lines"] if helpers else None
+    platform_apply_lines = helpers["platform_apply_lines"] if helpers else None
 
     # 数据类型：x/weight 按 spec.dtype；输出同输入；bias 可通过 spec.bias_dtype/bias_dt_ge 覆盖
     if dtype_to_ge and getattr(spec, "dtype", None) is not None:
@@ -112,31 +114,7 @@ def render_test_case(op_name, spec, idx, helpers=None):
     lines.append("    auto tiling_func = gert::OpImplRegistry::GetInstance().GetOpImpl(op_type.c_str())->tiling;")
     lines.append("    auto tiling_parse_func = gert::OpImplRegistry::GetInstance().GetOpImpl(op_type.c_str())->tiling_parse;")
     lines.append("")
-    lines.append("    // 2. Setup compile info and platform info")
-    lines.append("    string compile_info_string = R\"(<LB>")
-    lines.append("        \"hardware_info\": <LB>")
-    lines.append("            \"BT_SIZE\": 1024,")
-    lines.append("            \"load3d_constraints\": \"0\",")
-    lines.append("            \"Intrinsic_fix_pipe_l0c2out\": true,")
-    lines.append("            \"Intrinsic_data_move_l12ub\": false,")
-    lines.append("            \"Intrinsic_data_move_l0c2ub\": false,")
-    lines.append("            \"Intrinsic_data_move_out2l1_nd2nz\": true,")
-    lines.append("            \"UB_SIZE\": 196608,")
-    lines.append("            \"L2_SIZE\": 33554432,")
-    lines.append("            \"L1_SIZE\": 524288,")
-    lines.append("            \"L0A_SIZE\": 65536,")
-    lines.append("            \"L0B_SIZE\": 65536,")
-    lines.append("            \"L0C_SIZE\": 131072,")
-    lines.append("            \"CORE_NUM\": 20")
-    lines.append("        <RB>")
-    lines.append("    <RB>)\";")
-    lines.append("    map<string, string> soc_infos;")
-    lines.append("    map<string, string> aicore_spec;")
-    lines.append("    map<string, string> intrinsics;")
-    lines.append("    GetPlatFormInfos(compile_info_string.c_str(), soc_infos, aicore_spec, intrinsics);")
-    lines.append("")
-    lines.append("    fe::PlatFormInfos platform_info;")
-    lines.append("    platform_info.Init();")
+    lines.extend(platform_setup_lines())
     lines.append(f"    struct {compile_info_name} <LB><RB> compile_info;")
     lines.append("")
     lines.append("    // tilingParseFunc simulate")
@@ -186,16 +164,16 @@ def render_test_case(op_name, spec, idx, helpers=None):
     lines.append("                        .OutputShapes(<LB>&y1_output_shape<RB>)")
     # Node Attrs
     lines.append("                        .NodeAttrs(<LB>" + ", ".join([
-        "<LB>\\\"group_ep\\\", ge::AnyValue::CreateFrom<std::string>(ep_group)<RB>",
-        "<LB>\\\"group_tp\\\", ge::AnyValue::CreateFrom<std::string>(tp_group)<RB>",
-        f"<LB>\\\"ep_world_size\\\", ge::AnyValue::CreateFrom<int64_t>({ep_world_size})<RB>",
-        f"<LB>\\\"tp_world_size\\\", ge::AnyValue::CreateFrom<int64_t>({tp_world_size})<RB>",
-        f"<LB>\\\"x_shard_type\\\", ge::AnyValue::CreateFrom<int64_t>({x_shard_type})<RB>",
-        f"<LB>\\\"act_type\\\", ge::AnyValue::CreateFrom<int64_t>({act_type})<RB>",
-        f"<LB>\\\"transpose_weight\\\", ge::AnyValue::CreateFrom<bool>({'true' if transpose_weight else 'false'})<RB>",
-        f"<LB>\\\"output_y2_flag\\\", ge::AnyValue::CreateFrom<bool>({'true' if output_y2_flag else 'false'})<RB>",
-        f"<LB>\\\"output_y3_flag\\\", ge::AnyValue::CreateFrom<bool>({'true' if output_y3_flag else 'false'})<RB>",
-    ]) + "><RB>)")
+        "<LB>\"group_ep\", ge::AnyValue::CreateFrom<std::string>(ep_group)<RB>",
+        "<LB>\"group_tp\", ge::AnyValue::CreateFrom<std::string>(tp_group)<RB>",
+        f"<LB>\"ep_world_size\", ge::AnyValue::CreateFrom<int64_t>({ep_world_size})<RB>",
+        f"<LB>\"tp_world_size\", ge::AnyValue::CreateFrom<int64_t>({tp_world_size})<RB>",
+        f"<LB>\"x_shard_type\", ge::AnyValue::CreateFrom<int64_t>({x_shard_type})<RB>",
+        f"<LB>\"act_type\", ge::AnyValue::CreateFrom<int64_t>({act_type})<RB>",
+        f"<LB>\"transpose_weight\", ge::AnyValue::CreateFrom<bool>({'true' if transpose_weight else 'false'})<RB>",
+        f"<LB>\"output_y2_flag\", ge::AnyValue::CreateFrom<bool>({'true' if output_y2_flag else 'false'})<RB>",
+        f"<LB>\"output_y3_flag\", ge::AnyValue::CreateFrom<bool>({'true' if output_y3_flag else 'false'})<RB>",
+    ]) + "<RB>)")
     lines.append("                        .CompileInfo(&compile_info)")
     lines.append("                        .PlatformInfo(reinterpret_cast<char*>(&platform_info))")
     # 输入/输出类型
@@ -218,10 +196,7 @@ def render_test_case(op_name, spec, idx, helpers=None):
     lines.append("    // 5. Init TilingContext pointer")
     lines.append("    gert::TilingContext* tiling_context = holder.GetContext<gert::TilingContext>();")
     lines.append("    ASSERT_NE(tiling_context->GetPlatformInfo(), nullptr);")
-    lines.append("    holder.GetContext<gert::TilingContext>()->GetPlatformInfo()->SetPlatformRes(\"SoCInfo\", soc_infos);")
-    lines.append("    holder.GetContext<gert::TilingContext>()->GetPlatformInfo()->SetPlatformRes(\"AICoreSpec\", aicore_spec);")
-    lines.append("    holder.GetContext<gert::TilingContext>()->GetPlatformInfo()->SetCoreNumByCoreType(\"AICore\");")
-    lines.append("    holder.GetContext<gert::TilingContext>()->GetPlatformInfo()->SetPlatformRes(\"AICoreintrinsicDtypeMap\", intrinsics);")
+    lines.extend(platform_apply_lines())
     if version_lines:
         lines.extend(version_lines)
     lines.append("")
@@ -5,6 +5,8 @@
 def render_test_case(op_name, spec, idx, helpers=None):
     # 不依赖 ensure_shapes，AlltoAllvGroupedMatMul 的输入/输出与其它算子不同
     dtype_to_ge = helpers["dtype_to_ge"] if helpers else None
+    platform_setup_lines = helpers["platform_setup_lines"] if helpers else None
+    platform_apply_lines = helpers["platform_apply_lines"] if helpers else None
 
     # 数据类型：gmm/mm 张量默认 FP16；计数为 INT64；输出默认 FP16
     dt_fp16 = "ge::DT_FLOAT16"
@@ -94,31 +96,7 @@ def render_test_case(op_name, spec, idx, helpers=None):
     lines.append("    auto tiling_func = gert::OpImplRegistry::GetInstance().GetOpImpl(op_type.c_str())->tiling;")
     lines.append("    auto tiling_parse_func = gert::OpImplRegistry::GetInstance().GetOpImpl(op_type.c_str())->tiling_parse;")
     lines.append("")
-    lines.append("    // 2. Setup compile info and platform info")
-    lines.append("    string compile_info_string = R\"(<LB>")
-    lines.append("        \"hardware_info\": <LB>")
-    lines.append("            \"BT_SIZE\": 1024,")
-    lines.append("            \"load3d_constraints\": \"0\",")
-    lines.append("            \"Intrinsic_fix_pipe_l0c2out\": true,")
-    lines.append("            \"Intrinsic_data_move_l12ub\": false,")
-    lines.append("            \"Intrinsic_data_move_l0c2ub\": false,")
-    lines.append("            \"Intrinsic_data_move_out2l1_nd2nz\": true,")
-    lines.append("            \"UB_SIZE\": 196608,")
-    lines.append("            \"L2_SIZE\": 33554432,")
-    lines.append("            \"L1_SIZE\": 524288,")
-    lines.append("            \"L0A_SIZE\": 65536,")
-    lines.append("            \"L0B_SIZE\": 65536,")
-    lines.append("            \"L0C_SIZE\": 131072,")
-    lines.append("            \"CORE_NUM\": 20")
-    lines.append("        <RB>")
-    lines.append("    <RB>)\";")
-    lines.append("    map<string, string> soc_infos;")
-    lines.append("    map<string, string> aicore_spec;")
-    lines.append("    map<string, string> intrinsics;")
-    lines.append("    GetPlatFormInfos(compile_info_string.c_str(), soc_infos, aicore_spec, intrinsics);")
-    lines.append("")
-    lines.append("    fe::PlatFormInfos platform_info;")
-    lines.append("    platform_info.Init();")
+    lines.extend(platform_setup_lines())
     lines.append(f"    struct {compile_info_name} <LB><RB> compile_info;")
     lines.append("")
     lines.append("    // tilingParseFunc simulate")
@@ -174,14 +152,14 @@ def render_test_case(op_name, spec, idx, helpers=None):
     lines.append("                      .OutputShapes(<LB>" + ", ".join(output_shapes_parts) + "<RB>)")
     # Node Attrs
     lines.append("                      .NodeAttrs(<LB>" + ", ".join([
-        "<LB>\\\"group\\\", ge::AnyValue::CreateFrom<std::string>(group)<RB>",
-        f"<LB>\\\"ep_world_size\\\", ge::AnyValue::CreateFrom<int64_t>({ep_world_size})<RB>",
-        "<LB>\\\"send_counts\\\", ge::AnyValue::CreateFrom<vector<int64_t>>(send_counts)<RB>",
-        "<LB>\\\"recv_counts\\\", ge::AnyValue::CreateFrom<vector<int64_t>>(recv_counts)<RB>",
-        f"<LB>\\\"trans_gmm_weight\\\", ge::AnyValue::CreateFrom<bool>({'true' if trans_gmm_weight else 'false'})<RB>",
-        f"<LB>\\\"trans_mm_weight\\\", ge::AnyValue::CreateFrom<bool>({'true' if trans_mm_weight else 'false'})<RB>",
-        f"<LB>\\\"permute_out_flag\\\", ge::AnyValue::CreateFrom<bool>({'true' if permute_out_flag else 'false'})<RB>",
-    ]) + "><RB>)")
+        "<LB>\"group\", ge::AnyValue::CreateFrom<std::string>(group)<RB>",
+        f"<LB>\"ep_world_size\", ge::AnyValue::CreateFrom<int64_t>({ep_world_size})<RB>",
+        "<LB>\"send_counts\", ge::AnyValue::CreateFrom<vector<int64_t>>(send_counts)<RB>",
+        "<LB>\"recv_counts\", ge::AnyValue::CreateFrom<vector<int64_t>>(recv_counts)<RB>",
+        f"<LB>\"trans_gmm_weight\", ge::AnyValue::CreateFrom<bool>({'true' if trans_gmm_weight else 'false'})<RB>",
+        f"<LB>\"trans_mm_weight\", ge::AnyValue::CreateFrom<bool>({'true' if trans_mm_weight else 'false'})<RB>",
+        f"<LB>\"permute_out_flag\", ge::AnyValue::CreateFrom<bool>({'true' if permute_out_flag else 'false'})<RB>",
+    ]) + "<RB>)")
     lines.append("                      .CompileInfo(&compile_info)")
     lines.append("                      .PlatformInfo(reinterpret_cast<char*>(&platform_info))")
     # 输入/输出类型映射：0 FP16, 1 FP16, 2 INT64, 3 INT64, 4 FP16, 5 FP16；输出均 FP16
@@ -205,10 +183,7 @@ def render_test_case(op_name, spec, idx, helpers=None):
     lines.append("    // 5. Init TilingContext pointer")
     lines.append("    gert::TilingContext* tiling_context = holder.GetContext<gert::TilingContext>();")
     lines.append("    ASSERT_NE(tiling_context->GetPlatformInfo(), nullptr);")
-    lines.append("    holder.GetContext<gert::TilingContext>()->GetPlatformInfo()->SetPlatformRes(\"SoCInfo\", soc_infos);")
-    lines.append("    holder.GetContext<gert::TilingContext>()->GetPlatformInfo()->SetPlatformRes(\"AICoreSpec\", aicore_spec);")
-    lines.append("    holder.GetContext<gert::TilingContext>()->GetPlatformInfo()->SetCoreNumByCoreType(\"AICore\");")
-    lines.append("    holder.GetContext<gert::TilingContext>()->GetPlatformInfo()->SetPlatformRes(\"AICoreintrinsicDtypeMap\", intrinsics);")
+    lines.extend(platform_apply_lines())
     if version_lines:
         lines.extend(version_lines)
     lines.append("")
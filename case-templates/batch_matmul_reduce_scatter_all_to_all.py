@@ -4,6 +4,8 @@
 
 def render_test_case(op_name, spec, idx, helpers=None):
     dtype_to_ge = helpers["dtype_to_ge"] if helpers else None
+    platform_setup_lines = helpers["platform_setup_lines"] if helpers else None
+    platform_apply_lines = helpers["platform_apply_lines"] if helpers else None
 
     # 输入/输出数据类型：x/weight 使用 spec.dtype，bias 可通过 bias_dt_ge/bias_dtype 指定
     if dtype_to_ge and getattr(spec, "dtype", None) is not None:
@@ -107,32 +109,7 @@ def render_test_case(op_name, spec, idx, helpers=None):
     lines.append("    auto tiling_func = gert::OpImplRegistry::GetInstance().GetOpImpl(op_type.c_str())->tiling;")
     lines.append("    auto tiling_parse_func = gert::OpImplRegistry::GetInstance().GetOpImpl(op_type.c_str())->tiling_parse;")
     lines.append("")
-    lines.append("    // 2. Setup compile info and platform info")
-    lines.append("    string compile_info_string = R\"(<LB>")
-    lines.append("        \"hardware_info\": <LB>")
-    lines.append("            \"BT_SIZE\": 1024,")
-    lines.append("            \"load3d_constraints\": \"0\",")
-    lines.append("            \"Intrinsic_fix_pipe_l0c2out\": true,")
-    lines.append("            \"Intrinsic_data_move_l12ub\": false,")
-    lines.append("            \"Intrinsic_data_move_l0c2ub\": false,")
-    lines.append("            \"Intrinsic_data_move_out2l1_nd2nz\": true,")
-    lines.append("            \"UB_SIZE\": 196608,")
-    lines.append("            \"L2_SIZE\": 33554432,")
-    lines.append("            \"L1_SIZE\": 524288,")
-    lines.append("            \"L0A_SIZE\": 65536,")
-    lines.append("            \"L0B_SIZE\": 65536,")
-    lines.append("            \"L0C_SIZE\": 131072,")
-    lines.append("            \"CORE_NUM\": 20")
-    lines.append("        <RB>")
-    lines.append("    <RB>)\";")
-    lines.append("    map<string, string> soc_infos;")
-    lines.append("    map<string, string> aicore_spec;")
-    lines.append("    map<string, string> intrinsics;")
-    lines.append("    GetPlatFormInfos(compile_info_string.c_str(), soc_infos, aicore_spec, intrinsics);")
-    lines.append("")
-    lines.append("    // platform info")
-    lines.append("    fe::PlatFormInfos platform_info;")
-    lines.append("    platform_info.Init();")
+    lines.extend(platform_setup_lines())
     lines.append(f"    struct {compile_info_name} <LB><RB> compile_info;")
     lines.append("")
     lines.append("    // tilingParseFunc simulate")
@@ -177,13 +154,13 @@ def render_test_case(op_name, spec, idx, helpers=None):
 
     lines.append("                        .OutputShapes(<LB>&y1_output_shape<RB>)")
     lines.append("                        .NodeAttrs(<LB>" + ", ".join([
-        "<LB>\\\"group_ep\\\", ge::AnyValue::CreateFrom<std::string>(ep_group)<RB>",
-        "<LB>\\\"group_tp\\\", ge::AnyValue::CreateFrom<std::string>(tp_group)<RB>",
-        f"<LB>\\\"ep_world_size\\\", ge::AnyValue::CreateFrom<int64_t>({ep_world_size})<RB>",
-        f"<LB>\\\"tp_world_size\\\", ge::AnyValue::CreateFrom<int64_t>({tp_world_size})<RB>",
-        f"<LB>\\\"y_shard_type\\\", ge::AnyValue::CreateFrom<int64_t>({y_shard_type})<RB>",
-        f"<LB>\\\"transpose_weight\\\", ge::AnyValue::CreateFrom<bool>({'true' if transpose_weight else 'false'})<RB>",
-    ]) + "><RB>)")
+        "<LB>\"group_ep\", ge::AnyValue::CreateFrom<std::string>(ep_group)<RB>",
+        "<LB>\"group_tp\", ge::AnyValue::CreateFrom<std::string>(tp_group)<RB>",
+        f"<LB>\"ep_world_size\", ge::AnyValue::CreateFrom<int64_t>({ep_world_size})<RB>",
+        f"<LB>\"tp_world_size\", ge::AnyValue::CreateFrom<int64_t>({tp_world_size})<RB>",
+        f"<LB>\"y_shard_type\", ge::AnyValue::CreateFrom<int64_t>({y_shard_type})<RB>",
+        f"<LB>\"transpose_weight\", ge::AnyValue::CreateFrom<bool>({'true' if transpose_weight else 'false'})<RB>",
+    ]) + "<RB>)")
     lines.append("                        .CompileInfo(&compile_info)")
     lines.append("                        .PlatformInfo(reinterpret_cast<char*>(&platform_info))")
     if has_bias:
@@ -205,10 +182,7 @@ def render_test_case(op_name, spec, idx, helpers=None):
     lines.append("    // 4. Init TilingContext pointer")
     lines.append("    gert::TilingContext* tiling_context = holder.GetContext<gert::TilingContext>();")
     lines.append("    ASSERT_NE(tiling_context->GetPlatformInfo(), nullptr);")
-    lines.append("    holder.GetContext<gert::TilingContext>()->GetPlatformInfo()->SetPlatformRes(\"SoCInfo\", soc_infos);")
-    lines.append("    holder.GetContext<gert::TilingContext>()->GetPlatformInfo()->SetPlatformRes(\"AICoreSpec\", aicore_spec);")
-    lines.append("    holder.GetContext<gert::TilingContext>()->GetPlatformInfo()->SetCoreNumByCoreType(\"AICore\");")
-    lines.append("    holder.GetContext<gert::TilingContext>()->GetPlatformInfo()->SetPlatformRes(\"AICoreintrinsicDtypeMap\", intrinsics);")
+    lines.extend(platform_apply_lines())
     if version_lines:
         lines.extend(version_lines)
     lines.append("")
@@ -4,6 +4,8 @@
 
 def render_test_case(op_name, spec, idx, helpers=None):
     dtype_to_ge = helpers["dtype_to_ge"] if helpers else None
+    platform_setup_lines = helpers["platform_setup_lines"] if helpers else None
+    platform_apply_lines = helpers["platform_apply_lines"] if helpers else None
 
     # 数据类型：输入/输出同 dtype
     if dtype_to_ge and getattr(spec, "dtype", None) is not None:
@@ -71,37 +73,12 @@ def render_test_case(op_name, spec, idx, helpers=None):
     lines = []
     lines.append(f"TEST_F({op_name}Tiling, {test_name}) <LB>")
     lines.append("    // 1. Setup interfaces")
-    lines.append(f"    std::string op_type(\\\"{op_name}\\\");")
+    lines.append(f"    std::string op_type(\"{op_name}\");")
     lines.append("    ASSERT_NE(gert::OpImplRegistry::GetInstance().GetOpImpl(op_type.c_str()), nullptr);")
     lines.append("    auto tiling_func = gert::OpImplRegistry::GetInstance().GetOpImpl(op_type.c_str())->tiling;")
     lines.append("    auto tiling_parse_func = gert::OpImplRegistry::GetInstance().GetOpImpl(op_type.c_str())->tiling_parse;")
     lines.append("")
-    lines.append("    // 2. Setup compile info and platform info")
-    lines.append("    string compile_info_string = R\"(<LB>")
-    lines.append("        \\\"hardware_info\\\": <LB>")
-    lines.append("            \\\"BT_SIZE\\\": 1024,")
-    lines.append("            \\\"load3d_constraints\\\": \\\"0\\\",")
-    lines.append("            \\\"Intrinsic_fix_pipe_l0c2out\\\": true,")
-    lines.append("            \\\"Intrinsic_data_move_l12ub\\\": false,")
-    lines.append("            \\\"Intrinsic_data_move_l0c2ub\\\": false,")
-    lines.append("            \\\"Intrinsic_data_move_out2l1_nd2nz\\\": true,")
-    lines.append("            \\\"UB_SIZE\\\": 196608,")
-    lines.append("            \\\"L2_SIZE\\\": 33554432,")
-    lines.append("            \\\"L1_SIZE\\\": 524288,")
-    lines.append("            \\\"L0A_SIZE\\\": 65536,")
-    lines.append("            \\\"L0B_SIZE\\\": 65536,")
-    lines.append("            \\\"L0C_SIZE\\\": 131072,")
-    lines.append("            \\\"CORE_NUM\\\": 20")
-    lines.append("        <RB>")
-    lines.append("    <RB>)\";")
-    lines.append("    map<string, string> soc_infos;")
-    lines.append("    map<string, string> aicore_spec;")
-    lines.append("    map<string, string> intrinsics;")
-    lines.append("    GetPlatFormInfos(compile_info_string.c_str(), soc_infos, aicore_spec, intrinsics);")
-    lines.append("")
-    lines.append("    // platform info")
-    lines.append("    fe::PlatFormInfos platform_info;")
-    lines.append("    platform_info.Init();")
+    lines.extend(platform_setup_lines())
     lines.append(f"    struct {compile_info_name} <LB><RB> compile_info;")
     lines.append("")
     lines.append("    // tilingParseFunc simulate")
@@ -128,9 +105,9 @@ def render_test_case(op_name, spec, idx, helpers=None):
     lines.append("                        .InputShapes(<LB>&x_ref_shape<RB>)")
     lines.append("                        .OutputShapes(<LB>&x_ref_output_shape<RB>)")
     lines.append("                        .NodeAttrs(<LB>" + ", ".join([
-        "<LB>\\\"group\\\", ge::AnyValue::CreateFrom<std::string>(group)<RB>",
-        "<LB>\\\"world_size\\\", ge::AnyValue::CreateFrom<int64_t>(world_size)<RB>",
-    ]) + "><RB>)")
+        "<LB>\"group\", ge::AnyValue::CreateFrom<std::string>(group)<RB>",
+        "<LB>\"world_size\", ge::AnyValue::CreateFrom<int64_t>(world_size)<RB>",
+    ]) + "<RB>)")
     lines.append("                        .CompileInfo(&compile_info)")
     lines.append("                        .PlatformInfo(reinterpret_cast<char*>(&platform_info))")
     lines.append(f"                        .NodeInputTd(0, {{dt_in}}, ge::FORMAT_ND, ge::FORMAT_ND)")
@@ -148,10 +125,7 @@ def render_test_case(op_name, spec, idx, helpers=None):
     lines.append("    ASSERT_NE(tiling_context->GetPlatformInfo(), nullptr);")
     if version_lines:
         lines.extend(version_lines)
-    lines.append("    holder.GetContext<gert::TilingContext>()->GetPlatformInfo()->SetPlatformRes(\"SoCInfo\", soc_infos);")
-    lines.append("    holder.GetContext<gert::TilingContext>()->GetPlatformInfo()->SetPlatformRes(\"AICoreSpec\", aicore_spec);")
-    lines.append("    holder.GetContext<gert::TilingContext>()->GetPlatformInfo()->SetCoreNumByCoreType(\"AICore\");")
-    lines.append("    holder.GetContext<gert::TilingContext>()->GetPlatformInfo()->SetPlatformRes(\"AICoreintrinsicDtypeMap\", intrinsics);")
+    lines.extend(platform_apply_lines())
     lines.append("")
     lines.append("    // 5. Call op function")
     lines.append(f"    EXPECT_EQ(tiling_func(tiling_context), {expected_ret});")
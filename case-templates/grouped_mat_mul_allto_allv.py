@@ -5,6 +5,8 @@
 def render_test_case(op_name, spec, idx, helpers=None):
     # 数据类型映射
     dtype_to_ge = helpers["dtype_to_ge"] if helpers else None
+    platform_setup_lines = helpers["platform_setup_lines"] if helpers else None
+    platform_apply_lines = helpers["platform_apply_lines"] if helpers else None
     dt_fp16 = "ge::DT_FLOAT16"
     if dtype_to_ge and getattr(spec, "dtype", None) is not None:
         dt_in, _ = dtype_to_ge(spec.dtype)
@@ -91,32 +93,7 @@ def render_test_case(op_name, spec, idx, helpers=None):
     lines.append("    auto tiling_func = gert::OpImplRegistry::GetInstance().GetOpImpl(op_type.c_str())->tiling;")
     lines.append("    auto tiling_parse_func = gert::OpImplRegistry::GetInstance().GetOpImpl(op_type.c_str())->tiling_parse;")
     lines.append("")
-    lines.append("    // 2. Setup compile info and platform info")
-    lines.append("    string compile_info_string = R\"(<LB>")
-    lines.append("        \"hardware_info\": <LB>")
-    lines.append("            \"BT_SIZE\": 1024,")
-    lines.append("            \"load3d_constraints\": \"0\",")
-    lines.append("            \"Intrinsic_fix_pipe_l0c2out\": true,")
-    lines.append("            \"Intrinsic_data_move_l12ub\": false,")
-    lines.append("            \"Intrinsic_data_move_l0c2ub\": false,")
-    lines.append("            \"Intrinsic_data_move_out2l1_nd2nz\": true,")
-    lines.append("            \"UB_SIZE\": 196608,")
-    lines.append("            \"L2_SIZE\": 33554432,")
-    lines.append("            \"L1_SIZE\": 524288,")
-    lines.append("            \"L0A_SIZE\": 65536,")
-    lines.append("            \"L0B_SIZE\": 65536,")
-    lines.append("            \"L0C_SIZE\": 131072,")
-    lines.append("            \"CORE_NUM\": 20")
-    lines.append("        <RB>")
-    lines.append("    <RB>)\";")
-    lines.append("    map<string, string> soc_infos;")
-    lines.append("    map<string, string> aicore_spec;")
-    lines.append("    map<string, string> intrinsics;")
-    lines.append("    GetPlatFormInfos(compile_info_string.c_str(), soc_infos, aicore_spec, intrinsics);")
-    lines.append("")
-    lines.append("    // platform info")
-    lines.append("    fe::PlatFormInfos platform_info;")
-    lines.append("    platform_info.Init();")
+    lines.extend(platform_setup_lines())
     lines.append(f"    struct {compile_info_name} <LB><RB> compile_info;")
     lines.append("")
     lines.append("    // tilingParseFunc simulate")
@@ -165,14 +142,14 @@ def render_test_case(op_name, spec, idx, helpers=None):
     lines.append("                      .OutputShapes(<LB>" + ", ".join(output_shapes_parts) + "<RB>)")
     # Node Attrs
     node_attrs = [
-        f"<LB>\\\"{group_attr_key}\\\", ge::AnyValue::CreateFrom<std::string>(group_name)<RB>",
-        f"<LB>\\\"ep_world_size\\\", ge::AnyValue::CreateFrom<int64_t>({ep_world_size})<RB>",
-        "<LB>\\\"send_counts\\\", ge::AnyValue::CreateFrom<vector<int64_t>>(send_counts)<RB>",
-        "<LB>\\\"recv_counts\\\", ge::AnyValue::CreateFrom<vector<int64_t>>(recv_counts)<RB>",
-        f"<LB>\\\"trans_gmm_weight\\\", ge::AnyValue::CreateFrom<bool>({'true' if trans_gmm_weight else 'false'})<RB>",
-        f"<LB>\\\"trans_mm_weight\\\", ge::AnyValue::CreateFrom<bool>({'true' if trans_mm_weight else 'false'})<RB>",
+        f"<LB>\"{group_attr_key}\", ge::AnyValue::CreateFrom<std::string>(group_name)<RB>",
+        f"<LB>\"ep_world_size\", ge::AnyValue::CreateFrom<int64_t>({ep_world_size})<RB>",
+        "<LB>\"send_counts\", ge::AnyValue::CreateFrom<vector<int64_t>>(send_counts)<RB>",
+        "<LB>\"recv_counts\", ge::AnyValue::CreateFrom<vector<int64_t>>(recv_counts)<RB>",
+        f"<LB>\"trans_gmm_weight\", ge::AnyValue::CreateFrom<bool>({'true' if trans_gmm_weight else 'false'})<RB>",
+        f"<LB>\"trans_mm_weight\", ge::AnyValue::CreateFrom<bool>({'true' if trans_mm_weight else 'false'})<RB>",
     ]
-    lines.append("                      .NodeAttrs(<LB>" + ", ".join(node_attrs) + "><RB>)")
+    lines.append("                      .NodeAttrs(<LB>" + ", ".join(node_attrs) + "<RB>)")
     lines.append("                      .CompileInfo(&compile_info)")
     lines.append("                      .PlatformInfo(reinterpret_cast<char*>(&platform_info))")
     # 输入/输出类型：0 FP16, 1 FP16, 2 INT64, 3 INT64, 4 FP16, 5 FP16；输出均 FP16
@@ -195,10 +172,7 @@ def render_test_case(op_name, spec, idx, helpers=None):
     lines.append("    // 5. Init TilingContext pointer")
     lines.append("    gert::TilingContext* tiling_context = holder.GetContext<gert::TilingContext>();")
     lines.append("    ASSERT_NE(tiling_context->GetPlatformInfo(), nullptr);")
-    lines.append("    holder.GetContext<gert::TilingContext>()->GetPlatformInfo()->SetPlatformRes(\"SoCInfo\", soc_infos);")
-    lines.append("    holder.GetContext<gert::TilingContext>()->GetPlatformInfo()->SetPlatformRes(\"AICoreSpec\", aicore_spec);")
-    lines.append("    holder.GetContext<gert::TilingContext>()->GetPlatformInfo()->SetCoreNumByCoreType(\"AICore\");")
-    lines.append("    holder.GetContext<gert::TilingContext>()->GetPlatformInfo()->SetPlatformRes(\"AICoreintrinsicDtypeMap\", intrinsics);")
+    lines.extend(platform_apply_lines())
     if version_lines:
         lines.extend(version_lines)
     lines.append("")
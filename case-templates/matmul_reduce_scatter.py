@@ -1,10 +1,14 @@
 # -*- coding: utf-8 -*-
 
+from tiling_layouts import mc2_matmul_layout, mc2_matmul_roles
+
 # 可选导出 1：函数形式
 
 def render_test_case(op_name, spec, idx, helpers=None):
     ensure_shapes = helpers["ensure_shapes"] if helpers else None
     dtype_to_ge = helpers["dtype_to_ge"] if helpers else None
+    platform_setup_lines = helpers["platform_setup_lines"] if helpers else None
+    platform_apply_lines = helpers["platform_apply_lines"] if helpers else None
 
     # MatmulReduceScatter 不需要 gather_output，忽略 ensure_shapes 返回的第三项
     x1, x2, _go, out, bias = ensure_shapes(spec)
@@ -42,31 +46,7 @@ def render_test_case(op_name, spec, idx, helpers=None):
     lines.append("    auto tiling_func = gert::OpImplRegistry::GetInstance().GetOpImpl(op_type.c_str())->tiling;")
     lines.append("    auto tiling_parse_func = gert::OpImplRegistry::GetInstance().GetOpImpl(op_type.c_str())->tiling_parse;")
     lines.append("")
-    lines.append("    // 2. Setup compile info and platform info")
-    lines.append("    string compile_info_string = R\"(<LB>")
-    lines.append("        \"hardware_info\": <LB>")
-    lines.append("            \"BT_SIZE\": 1024,")
-    lines.append("            \"load3d_constraints\": \"0\",")
-    lines.append("            \"Intrinsic_fix_pipe_l0c2out\": true,")
-    lines.append("            \"Intrinsic_data_move_l12ub\": false,")
-    lines.append("            \"Intrinsic_data_move_l0c2ub\": false,")
-    lines.append("            \"Intrinsic_data_move_out2l1_nd2nz\": true,")
-    lines.append("            \"UB_SIZE\": 196608,")
-    lines.append("            \"L2_SIZE\": 33554432,")
-    lines.append("            \"L1_SIZE\": 524288,")
-    lines.append("            \"L0A_SIZE\": 65536,")
-    lines.append("            \"L0B_SIZE\": 65536,")
-    lines.append("            \"L0C_SIZE\": 131072,")
-    lines.append("            \"CORE_NUM\": 20")
-    lines.append("        <RB>")
-    lines.append("    <RB>)\";")
-    lines.append("    map<string, string> soc_infos;")
-    lines.append("    map<string, string> aicore_spec;")
-    lines.append("    map<string, string> intrinsics;")
-    lines.append("    GetPlatFormInfos(compile_info_string.c_str(), soc_infos, aicore_spec, intrinsics);")
-    lines.append("")
-    lines.append("    fe::PlatFormInfos platform_info;")
-    lines.append("    platform_info.Init();")
+    lines.extend(platform_setup_lines())
     lines.append(f"    struct {op_name}CompileInfo <LB><RB> compile_info;")
     lines.append("")
     lines.append("    // tilingParseFunc simulate")
@@ -118,10 +98,7 @@ def render_test_case(op_name, spec, idx, helpers=None):
     lines.append("    ASSERT_NE(tiling_context->GetPlatformInfo(), nullptr);")
     lines.append("")
     lines.append("    // 7. Set Compile settings")
-    lines.append("    holder.GetContext<gert::TilingContext>()->GetPlatformInfo()->SetPlatformRes(\"SoCInfo\", soc_infos);")
-    lines.append("    holder.GetContext<gert::TilingContext>()->GetPlatformInfo()->SetPlatformRes(\"AICoreSpec\", aicore_spec);")
-    lines.append("    holder.GetContext<gert::TilingContext>()->GetPlatformInfo()->SetCoreNumByCoreType(\"AICore\");")
-    lines.append("    holder.GetContext<gert::TilingContext>()->GetPlatformInfo()->SetPlatformRes(\"AICoreintrinsicDtypeMap\", intrinsics);")
+    lines.extend(platform_apply_lines())
     lines.append("")
     lines.append("    // 8. Set communication")
     lines.append("    ge::HcomTopoInfo::TopoInfo topoInfo;")
@@ -148,3 +125,78 @@ def render_test_case(op_name, spec, idx, helpers=None):
 
 
 
+
+
+# 可选导出 2：参数化描述（--mode param 使用，结构见 param_harness.py）
+# 注：HCCL_DETERMINISTIC 属于进程级环境变量，不进入参数化数据表
+
+PARAM_SUITE = {
+    "kernel_io": (4, 1),
+    "fields": [
+        ("x1_dim0", "int64_t", 1024),
+        ("x1_dim1", "int64_t", 2048),
+        ("x2_dim0", "int64_t", 2048),
+        ("x2_dim1", "int64_t", 1024),
+        ("out_dim0", "int64_t", 128),
+        ("out_dim1", "int64_t", 1024),
+        ("bias_len", "int64_t", 1024),
+        ("has_bias", "bool", False),
+        ("is_trans_a", "bool", False),
+        ("is_trans_b", "bool", False),
+        ("comm_turn", "int64_t", 0),
+        ("rank_size", "int64_t", 8),
+        ("group", "std::string", "group"),
+        ("reduce_op", "std::string", "sum"),
+        ("dtype_in", "ge::DataType", "DT_FLOAT16"),
+        ("dtype_out", "ge::DataType", "DT_FLOAT16"),
+    ],
+    "inputs": [
+        ("x1_shape", ["x1_dim0", "x1_dim1"]),
+        ("x2_shape", ["x2_dim0", "x2_dim1"]),
+        ("bias_shape", ["bias_len"], "has_bias"),
+        None,
+    ],
+    "outputs": [
+        ("output_shape", ["out_dim0", "out_dim1"]),
+    ],
+    "attrs": [
+        ("group", "std::string", "group"),
+        ("reduce_op", "std::string", "reduce_op"),
+        ("is_trans_a", "bool", "is_trans_a"),
+        ("is_trans_b", "bool", "is_trans_b"),
+        ("comm_turn", "int64_t", "comm_turn"),
+    ],
+    "dtypes": ["dtype_in", "dtype_in", "dtype_in", None, "dtype_out"],
+    "groups": [("group", "rank_size")],
+    "topo_comm_sets": True,
+    "set_op_type": False,
+}
+
+
+def param_values(op_name, spec, idx, helpers=None):
+    x1, x2, _go, out, bias = helpers["ensure_shapes"](spec)
+    dt_in, dt_out = helpers["dtype_to_ge"](spec.dtype)
+    return {
+        "x1_dim0": x1[0],
+        "x1_dim1": x1[1],
+        "x2_dim0": x2[0],
+        "x2_dim1": x2[1],
+        "out_dim0": out[0],
+        "out_dim1": out[1],
+        "bias_len": bias[0] if bias else None,
+        "has_bias": spec.has_bias,
+        "is_trans_a": spec.is_trans_a,
+        "is_trans_b": spec.is_trans_b,
+        "comm_turn": spec.comm_turn,
+        "rank_size": getattr(spec, "world_size", 8),
+        "reduce_op": getattr(spec, "reduce_op", "sum"),
+        "dtype_in": dt_in,
+        "dtype_out": dt_out,
+    }
+
+
+# 可选导出 3：TilingData 布局与打分角色（--golden/--score 使用，见 tiling_layouts.py、tiling_score.py）
+
+TILING_DATA_FIELDS = mc2_matmul_layout()
+TILING_ROLES = mc2_matmul_roles()
+TILING_SCORE = {"comm": "reduce_scatter", "dtype_bytes": 2}
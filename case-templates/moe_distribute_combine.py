@@ -5,6 +5,8 @@
 def render_test_case(op_name, spec, idx, helpers=None):
     ensure_shapes = helpers["ensure_shapes"] if helpers else None
     dtype_to_ge = helpers["dtype_to_ge"] if helpers else None
+    platform_setup_lines = helpers["platform_setup_lines"] if helpers else None
+    platform_apply_lines = helpers["platform_apply_lines"] if helpers else None
 
     # 形状来源：优先从 ensure_shapes 读取 x1/x2/out
     # x1 -> expand_x，x2 -> expert_ids，out -> x_output
@@ -90,31 +92,7 @@ def render_test_case(op_name, spec, idx, helpers=None):
     lines.append("    auto tiling_func = gert::OpImplRegistry::GetInstance().GetOpImpl(op_type.c_str())->tiling;")
     lines.append("    auto tiling_parse_func = gert::OpImplRegistry::GetInstance().GetOpImpl(op_type.c_str())->tiling_parse;")
     lines.append("")
-    lines.append("    // 2. Setup compile info and platform info")
-    lines.append("    string compile_info_string = R\"(<LB>")
-    lines.append("        \"hardware_info\": <LB>")
-    lines.append("            \"BT_SIZE\": 1024,")
-    lines.append("            \"load3d_constraints\": \"0\",")
-    lines.append("            \"Intrinsic_fix_pipe_l0c2out\": true,")
-    lines.append("            \"Intrinsic_data_move_l12ub\": false,")
-    lines.append("            \"Intrinsic_data_move_l0c2ub\": false,")
-    lines.append("            \"Intrinsic_data_move_out2l1_nd2nz\": true,")
-    lines.append("            \"UB_SIZE\": 196608,")
-    lines.append("            \"L2_SIZE\": 33554432,")
-    lines.append("            \"L1_SIZE\": 524288,")
-    lines.append("            \"L0A_SIZE\": 65536,")
-    lines.append("            \"L0B_SIZE\": 65536,")
-    lines.append("            \"L0C_SIZE\": 131072,")
-    lines.append("            \"CORE_NUM\": 20")
-    lines.append("        <RB>")
-    lines.append("    <RB>)\";")
-    lines.append("    map<string, string> soc_infos;")
-    lines.append("    map<string, string> aicore_spec;")
-    lines.append("    map<string, string> intrinsics;")
-    lines.append("    GetPlatFormInfos(compile_info_string.c_str(), soc_infos, aicore_spec, intrinsics);")
-    lines.append("")
-    lines.append("    fe::PlatFormInfos platform_info;")
-    lines.append("    platform_info.Init();")
+    lines.extend(platform_setup_lines())
     lines.append(f"    struct {compile_info_name} <LB><RB> compile_info;")
     lines.append("")
     lines.append("    // tilingParseFunc simulate")
@@ -165,7 +143,7 @@ def render_test_case(op_name, spec, idx, helpers=None):
         f"<LB>\"out_dtype\", ge::AnyValue::CreateFrom<int64_t>({out_dtype})<RB>",
         f"<LB>\"comm_quant_mode\", ge::AnyValue::CreateFrom<int64_t>({comm_quant_mode})<RB>",
         f"<LB>\"group_list_type\", ge::AnyValue::CreateFrom<int64_t>({group_list_type})<RB>",
-    ]) + "><RB>")
+    ]) + "<RB>)")
     lines.append("                        .CompileInfo(&compile_info)")
     lines.append("                        .PlatformInfo(reinterpret_cast<char*>(&platform_info))")
     lines.append(f"                        .NodeInputTd(0, ge::{{dt_in}}, ge::FORMAT_ND, ge::FORMAT_ND)")
@@ -182,15 +160,12 @@ def render_test_case(op_name, spec, idx, helpers=None):
     lines.append("")
     # 环境变量设置
     for k, v in env_vars.items():
-        lines.append(f"    setenv(\\\"{k}\\\", \\\"{v}\\\", 1);")
+        lines.append(f"    setenv(\"{k}\", \"{v}\", 1);")
     lines.append("")
     lines.append("    // 6. Init TilingContext pointer")
     lines.append("    gert::TilingContext* tiling_context = holder.GetContext<gert::TilingContext>();")
     lines.append("    ASSERT_NE(tiling_context->GetPlatformInfo(), nullptr);")
-    lines.append("    holder.GetContext<gert::TilingContext>()->GetPlatformInfo()->SetPlatformRes(\"SoCInfo\", soc_infos);")
-    lines.append("    holder.GetContext<gert::TilingContext>()->GetPlatformInfo()->SetPlatformRes(\"AICoreSpec\", aicore_spec);")
-    lines.append("    holder.GetContext<gert::TilingContext>()->GetPlatformInfo()->SetCoreNumByCoreType(\"AICore\");")
-    lines.append("    holder.GetContext<gert::TilingContext>()->GetPlatformInfo()->SetPlatformRes(\"AICoreintrinsicDtypeMap\", intrinsics);")
+    lines.extend(platform_apply_lines())
     if version_lines:
         lines.extend(version_lines)
     lines.append("")
@@ -198,7 +173,7 @@ def render_test_case(op_name, spec, idx, helpers=None):
     lines.append(f"    EXPECT_EQ(tiling_func(tiling_context), {expected_ret});")
     # 清理环境变量
     for k in env_vars.keys():
-        lines.append(f"    unsetenv(\\\"{k}\\\");")
+        lines.append(f"    unsetenv(\"{k}\");")
     if tiling_key_check:
         lines.append(tiling_key_check)
     lines.append("<RB>")
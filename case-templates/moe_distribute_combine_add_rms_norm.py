@@ -4,6 +4,8 @@
 
 def render_test_case(op_name, spec, idx, helpers=None):
     dtype_to_ge = helpers["dtype_to_ge"] if helpers else None
+    platform_setup_lines = helpers["platform_setup_lines"] if helpers else None
+    platform_apply_lines = helpers["platform_apply_lines"] if helpers else None
 
     # 数据类型：按参考UT固定各输入/输出类型；BF16 位置可由 spec.dtype 覆盖
     dt_bf16 = "ge::DT_BF16"
@@ -122,31 +124,7 @@ def render_test_case(op_name, spec, idx, helpers=None):
     lines.append("    auto tiling_func = gert::OpImplRegistry::GetInstance().GetOpImpl(op_type.c_str())->tiling;")
     lines.append("    auto tiling_parse_func = gert::OpImplRegistry::GetInstance().GetOpImpl(op_type.c_str())->tiling_parse;")
     lines.append("")
-    lines.append("    // 2. Setup compile info and platform info")
-    lines.append("    string compile_info_string = R\"(<LB>")
-    lines.append("        \"hardware_info\": <LB>")
-    lines.append("            \"BT_SIZE\": 1024,")
-    lines.append("            \"load3d_constraints\": \"0\",")
-    lines.append("            \"Intrinsic_fix_pipe_l0c2out\": true,")
-    lines.append("            \"Intrinsic_data_move_l12ub\": false,")
-    lines.append("            \"Intrinsic_data_move_l0c2ub\": false,")
-    lines.append("            \"Intrinsic_data_move_out2l1_nd2nz\": true,")
-    lines.append("            \"UB_SIZE\": 196608,")
-    lines.append("            \"L2_SIZE\": 33554432,")
-    lines.append("            \"L1_SIZE\": 524288,")
-    lines.append("            \"L0A_SIZE\": 65536,")
-    lines.append("            \"L0B_SIZE\": 65536,")
-    lines.append("            \"L0C_SIZE\": 131072,")
-    lines.append("            \"CORE_NUM\": 20")
-    lines.append("        <RB>")
-    lines.append("    <RB>)\";")
-    lines.append("    map<string, string> soc_infos;")
-    lines.append("    map<string, string> aicore_spec;")
-    lines.append("    map<string, string> intrinsics;")
-    lines.append("    GetPlatFormInfos(compile_info_string.c_str(), soc_infos, aicore_spec, intrinsics);")
-    lines.append("")
-    lines.append("    fe::PlatFormInfos platform_info;")
-    lines.append("    platform_info.Init();")
+    lines.extend(platform_setup_lines())
     lines.append(f"    struct {compile_info_name} <LB><RB> compile_info;")
     lines.append("")
     lines.append("    // tilingParseFunc simulate")
@@ -209,24 +187,24 @@ def render_test_case(op_name, spec, idx, helpers=None):
     lines.append("                      .OutputShapes(<LB>&y_shape, &rstd_shape, &x_shape<RB>)")
     # Node Attrs
     node_attrs = [
-        "<LB>\\\"group_ep\\\", ge::AnyValue::CreateFrom<std::string>(std::string(\"" + group_ep + "\"))<RB>",
-        f"<LB>\\\"ep_world_size\\\", ge::AnyValue::CreateFrom<int64_t>({ep_world_size})<RB>",
-        f"<LB>\\\"ep_rank_id\\\", ge::AnyValue::CreateFrom<int64_t>({ep_rank_id})<RB>",
-        f"<LB>\\\"moe_expert_num\\\", ge::AnyValue::CreateFrom<int64_t>({moe_expert_num})<RB>",
-        "<LB>\\\"group_tp\\\", ge::AnyValue::CreateFrom<std::string>(std::string(\"" + group_tp + "\"))<RB>",
-        f"<LB>\\\"tp_world_size\\\", ge::AnyValue::CreateFrom<int64_t>({tp_world_size})<RB>",
-        f"<LB>\\\"tp_rank_id\\\", ge::AnyValue::CreateFrom<int64_t>({tp_rank_id})<RB>",
-        f"<LB>\\\"expert_shard_type\\\", ge::AnyValue::CreateFrom<int64_t>({expert_shard_type})<RB>",
-        f"<LB>\\\"shared_expert_num\\\", ge::AnyValue::CreateFrom<int64_t>({shared_expert_num})<RB>",
-        f"<LB>\\\"shared_expert_rank_num\\\", ge::AnyValue::CreateFrom<int64_t>({shared_expert_rank_num})<RB>",
-        f"<LB>\\\"global_bs\\\", ge::AnyValue::CreateFrom<int64_t>({global_bs})<RB>",
-        f"<LB>\\\"out_dtype\\\", ge::AnyValue::CreateFrom<int64_t>({out_dtype})<RB>",
-        f"<LB>\\\"comm_quant_mode\\\", ge::AnyValue::CreateFrom<int64_t>({comm_quant_mode})<RB>",
-        f"<LB>\\\"group_list_type\\\", ge::AnyValue::CreateFrom<int64_t>({group_list_type})<RB>",
-        "<LB>\\\"comm_alg\\\", ge::AnyValue::CreateFrom<std::string>(std::string(\"" + comm_alg + "\"))<RB>",
-        f"<LB>\\\"norm_eps\\\", ge::AnyValue::CreateFrom<float>({norm_eps})<RB>",
+        "<LB>\"group_ep\", ge::AnyValue::CreateFrom<std::string>(std::string(\"" + group_ep + "\"))<RB>",
+        f"<LB>\"ep_world_size\", ge::AnyValue::CreateFrom<int64_t>({ep_world_size})<RB>",
+        f"<LB>\"ep_rank_id\", ge::AnyValue::CreateFrom<int64_t>({ep_rank_id})<RB>",
+        f"<LB>\"moe_expert_num\", ge::AnyValue::CreateFrom<int64_t>({moe_expert_num})<RB>",
+        "<LB>\"group_tp\", ge::AnyValue::CreateFrom<std::string>(std::string(\"" + group_tp + "\"))<RB>",
+        f"<LB>\"tp_world_size\", ge::AnyValue::CreateFrom<int64_t>({tp_world_size})<RB>",
+        f"<LB>\"tp_rank_id\", ge::AnyValue::CreateFrom<int64_t>({tp_rank_id})<RB>",
+        f"<LB>\"expert_shard_type\", ge::AnyValue::CreateFrom<int64_t>({expert_shard_type})<RB>",
+        f"<LB>\"shared_expert_num\", ge::AnyValue::CreateFrom<int64_t>({shared_expert_num})<RB>",
+        f"<LB>\"shared_expert_rank_num\", ge::AnyValue::CreateFrom<int64_t>({shared_expert_rank_num})<RB>",
+        f"<LB>\"global_bs\", ge::AnyValue::CreateFrom<int64_t>({global_bs})<RB>",
+        f"<LB>\"out_dtype\", ge::AnyValue::CreateFrom<int64_t>({out_dtype})<RB>",
+        f"<LB>\"comm_quant_mode\", ge::AnyValue::CreateFrom<int64_t>({comm_quant_mode})<RB>",
+        f"<LB>\"group_list_type\", ge::AnyValue::CreateFrom<int64_t>({group_list_type})<RB>",
+        "<LB>\"comm_alg\", ge::AnyValue::CreateFrom<std::string>(std::string(\"" + comm_alg + "\"))<RB>",
+        f"<LB>\"norm_eps\", ge::AnyValue::CreateFrom<float>({norm_eps})<RB>",
     ]
-    lines.append("                      .NodeAttrs(<LB>" + ", ".join(node_attrs) + "><RB>)")
+    lines.append("                      .NodeAttrs(<LB>" + ", ".join(node_attrs) + "<RB>)")
     lines.append("                      .CompileInfo(&compile_info)")
     lines.append("                      .PlatformInfo(reinterpret_cast<char*>(&platform_info))")
     # 输入类型（与参考UT一致）
@@ -259,10 +237,7 @@ def render_test_case(op_name, spec, idx, helpers=None):
     lines.append("    // 5. Init TilingContext pointer")
     lines.append("    gert::TilingContext* tiling_context = holder.GetContext<gert::TilingContext>();")
     lines.append("    ASSERT_NE(tiling_context->GetPlatformInfo(), nullptr);")
-    lines.append("    holder.GetContext<gert::TilingContext>()->GetPlatformInfo()->SetPlatformRes(\"SoCInfo\", soc_infos);")
-    lines.append("    holder.GetContext<gert::TilingContext>()->GetPlatformInfo()->SetPlatformRes(\"AICoreSpec\", aicore_spec);")
-    lines.append("    holder.GetContext<gert::TilingContext>()->GetPlatformInfo()->SetCoreNumByCoreType(\"AICore\");")
-    lines.append("    holder.GetContext<gert::TilingContext>()->GetPlatformInfo()->SetPlatformRes(\"AICoreintrinsicDtypeMap\", intrinsics);")
+    lines.extend(platform_apply_lines())
     if version_lines:
         lines.extend(version_lines)
     lines.append("")
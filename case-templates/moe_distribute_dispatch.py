@@ -5,6 +5,8 @@
 def render_test_case(op_name, spec, idx, helpers=None):
     ensure_shapes = helpers["ensure_shapes"] if helpers else None
     dtype_to_ge = helpers["dtype_to_ge"] if helpers else None
+    platform_setup_lines = helpers["platform_setup_lines"] if helpers else None
+    platform_apply_lines = helpers["platform_apply_lines"] if helpers else None
 
     # 形状来源优先级：显式 x1/x2 -> ensure_shapes(spec) -> 兜底
     if getattr(spec, "x1_shape", None) and getattr(spec, "x2_shape", None):
@@ -71,6 +73,8 @@ def render_test_case(op_name, spec, idx, helpers=None):
     dynamic_scales_len = getattr(spec, "dynamic_scales_len", expand_x_out[0])
     # 2: expand_idx_output -> 一维，等于 expert_ids 的元素数（B * topk）
     expand_idx_len = getattr(spec, "expand_idx_len", x2[0] * x2[1])
+    # 可选输入 scales：xlsx 提供 scales_shape 列时作为第 3 个输入传入
+    scales = getattr(spec, "scales_shape", None)
     # 3: expert_token_nums_output -> 一维，默认 1，可由 spec 指定
     expert_token_nums_len = getattr(spec, "expert_token_nums_len", 1)
     # 4: ep_recv_count_output -> 一维，长度等于 ep_world_size
@@ -95,31 +99,7 @@ def render_test_case(op_name, spec, idx, helpers=None):
     lines.append("    auto tiling_func = gert::OpImplRegistry::GetInstance().GetOpImpl(op_type.c_str())->tiling;")
     lines.append("    auto tiling_parse_func = gert::OpImplRegistry::GetInstance().GetOpImpl(op_type.c_str())->tiling_parse;")
     lines.append("")
-    lines.append("    // 2. Setup compile info and platform info")
-    lines.append("    string compile_info_string = R\"(<LB>")
-    lines.append("        \"hardware_info\": <LB>")
-    lines.append("            \"BT_SIZE\": 1024,")
-    lines.append("            \"load3d_constraints\": \"0\",")
-    lines.append("            \"Intrinsic_fix_pipe_l0c2out\": true,")
-    lines.append("            \"Intrinsic_data_move_l12ub\": false,")
-    lines.append("            \"Intrinsic_data_move_l0c2ub\": false,")
-    lines.append("            \"Intrinsic_data_move_out2l1_nd2nz\": true,")
-    lines.append("            \"UB_SIZE\": 196608,")
-    lines.append("            \"L2_SIZE\": 33554432,")
-    lines.append("            \"L1_SIZE\": 524288,")
-    lines.append("            \"L0A_SIZE\": 65536,")
-    lines.append("            \"L0B_SIZE\": 65536,")
-    lines.append("            \"L0C_SIZE\": 131072,")
-    lines.append("            \"CORE_NUM\": 20")
-    lines.append("        <RB>")
-    lines.append("    <RB>)\";")
-    lines.append("    map<string, string> soc_infos;")
-    lines.append("    map<string, string> aicore_spec;")
-    lines.append("    map<string, string> intrinsics;")
-    lines.append("    GetPlatFormInfos(compile_info_string.c_str(), soc_infos, aicore_spec, intrinsics);")
-    lines.append("")
-    lines.append("    fe::PlatFormInfos platform_info;")
-    lines.append("    platform_info.Init();")
+    lines.extend(platform_setup_lines())
     lines.append("    struct MoeDistributeDispatchCompileInfo <LB><RB> compile_info;")
     lines.append("")
     lines.append("    // tilingParseFunc simulate")
@@ -139,6 +119,8 @@ def render_test_case(op_name, spec, idx, helpers=None):
     lines.append("    // 4. Define input/output shapes (dims 与 storage_dims 对齐)")
     lines.append(f"    gert::StorageShape expand_x_shape = <LB><LB>{x1[0]}, {x1[1]}<RB>, <LB>{x1[0]}, {x1[1]}<RB><RB>;")
     lines.append(f"    gert::StorageShape expert_ids_shape = <LB><LB>{x2[0]}, {x2[1]}<RB>, <LB>{x2[0]}, {x2[1]}<RB><RB>;")
+    if scales:
+        lines.append(f"    gert::StorageShape scales_shape = <LB><LB>{scales[0]}, {scales[1]}<RB>, <LB>{scales[0]}, {scales[1]}<RB><RB>;")
     lines.append(f"    gert::StorageShape expand_x_output_shape = <LB><LB>{expand_x_out[0]}, {expand_x_out[1]}<RB>, <LB>{expand_x_out[0]}, {expand_x_out[1]}<RB><RB>;")
     lines.append(f"    gert::StorageShape dynamic_scales_output_shape = <LB><LB>{dynamic_scales_len}<RB>, <LB>{dynamic_scales_len}<RB><RB>;")
     lines.append(f"    gert::StorageShape expand_idx_output_shape = <LB><LB>{expand_idx_len}<RB>, <LB>{expand_idx_len}<RB><RB>;")
@@ -151,9 +133,14 @@ def render_test_case(op_name, spec, idx, helpers=None):
     lines.append("    std::string tp_group(\"" + tp_group + "\");")
     lines.append("")
     lines.append("    auto holder = gert::TilingContextFaker()")
-    lines.append("                        .NodeIoNum(2, 6)")
-    lines.append("                        .IrInstanceNum(<LB>1, 1<RB>)")
-    lines.append("                        .InputShapes(<LB>&expand_x_shape, &expert_ids_shape<RB>)")
+    if scales:
+        lines.append("                        .NodeIoNum(3, 6)")
+        lines.append("                        .IrInstanceNum(<LB>1, 1, 1<RB>)")
+        lines.append("                        .InputShapes(<LB>&expand_x_shape, &expert_ids_shape, &scales_shape<RB>)")
+    else:
+        lines.append("                        .NodeIoNum(2, 6)")
+        lines.append("                        .IrInstanceNum(<LB>1, 1<RB>)")
+        lines.append("                        .InputShapes(<LB>&expand_x_shape, &expert_ids_shape<RB>)")
     lines.append("                        .OutputShapes(<LB>&expand_x_output_shape, &dynamic_scales_output_shape, &expand_idx_output_shape,\n                                       &expert_token_nums_output_shape, &ep_recv_count_output_shape,\n                                       &tp_recv_count_output_shape<RB>)")
     lines.append("                        .NodeAttrs(<LB>" + ", ".join([
         "<LB>\"group_ep\", ge::AnyValue::CreateFrom<std::string>(ep_group)<RB>",
@@ -169,11 +156,13 @@ def render_test_case(op_name, spec, idx, helpers=None):
         f"<LB>\"quant_mode\", ge::AnyValue::CreateFrom<int64_t>({quant_mode})<RB>",
         f"<LB>\"global_bs\", ge::AnyValue::CreateFrom<int64_t>({global_bs})<RB>",
         f"<LB>\"expert_token_nums_type\", ge::AnyValue::CreateFrom<int64_t>({expert_token_nums_type})<RB>",
-    ]) + "><RB>")
+    ]) + "<RB>)")
     lines.append("                        .CompileInfo(&compile_info)")
     lines.append("                        .PlatformInfo(reinterpret_cast<char*>(&platform_info))")
     lines.append(f"                        .NodeInputTd(0, ge::{{dt_in}}, ge::FORMAT_ND, ge::FORMAT_ND)")
     lines.append("                        .NodeInputTd(1, ge::DT_INT32, ge::FORMAT_ND, ge::FORMAT_ND)")
+    if scales:
+        lines.append("                        .NodeInputTd(2, ge::DT_FLOAT, ge::FORMAT_ND, ge::FORMAT_ND)")
     lines.append(f"                        .NodeOutputTd(0, ge::{{dt_in}}, ge::FORMAT_ND, ge::FORMAT_ND)")
     lines.append("                        .NodeOutputTd(1, ge::DT_FLOAT, ge::FORMAT_ND, ge::FORMAT_ND)")
     lines.append("                        .NodeOutputTd(2, ge::DT_INT32, ge::FORMAT_ND, ge::FORMAT_ND)")
@@ -192,10 +181,7 @@ def render_test_case(op_name, spec, idx, helpers=None):
     lines.append("    // 6. Init TilingContext pointer")
     lines.append("    gert::TilingContext* tiling_context = holder.GetContext<gert::TilingContext>();")
     lines.append("    ASSERT_NE(tiling_context->GetPlatformInfo(), nullptr);")
-    lines.append("    holder.GetContext<gert::TilingContext>()->GetPlatformInfo()->SetPlatformRes(\"SoCInfo\", soc_infos);")
-    lines.append("    holder.GetContext<gert::TilingContext>()->GetPlatformInfo()->SetPlatformRes(\"AICoreSpec\", aicore_spec);")
-    lines.append("    holder.GetContext<gert::TilingContext>()->GetPlatformInfo()->SetCoreNumByCoreType(\"AICore\");")
-    lines.append("    holder.GetContext<gert::TilingContext>()->GetPlatformInfo()->SetPlatformRes(\"AICoreintrinsicDtypeMap\", intrinsics);")
+    lines.extend(platform_apply_lines())
     if version_lines:
         lines.extend(version_lines)
     lines.append("")
@@ -213,3 +199,108 @@ def render_test_case(op_name, spec, idx, helpers=None):
     return code.strip() + "\n"
 
 
+
+
+# 可选导出 2：参数化描述（--mode param / --sweep 使用，结构见 param_harness.py）
+# 注：env_vars 属于进程级环境变量，不进入参数化数据表
+
+PARAM_SUITE = {
+    "kernel_io": (3, 6),
+    "fields": [
+        ("bs", "int64_t", 8),
+        ("h", "int64_t", 7168),
+        ("k", "int64_t", 8),
+        ("expand_x_out_dim0", "int64_t", 64),
+        ("expand_x_out_dim1", "int64_t", 7168),
+        ("dynamic_scales_len", "int64_t", 64),
+        ("expert_token_nums_len", "int64_t", 1),
+        ("tp_recv_count_len", "int64_t", 1),
+        ("scales_dim0", "int64_t", 9),  # moe_expert_num + shared_expert_num
+        ("has_scales", "bool", False),
+        ("ep_world_size", "int64_t", 8),
+        ("ep_rank_id", "int64_t", 0),
+        ("moe_expert_num", "int64_t", 8),
+        ("tp_world_size", "int64_t", 1),
+        ("tp_rank_id", "int64_t", 0),
+        ("expert_shard_type", "int64_t", 0),
+        ("shared_expert_num", "int64_t", 1),
+        ("shared_expert_rank_num", "int64_t", 1),
+        ("quant_mode", "int64_t", 0),
+        ("global_bs", "int64_t", 0),
+        ("expert_token_nums_type", "int64_t", 0),
+        ("group_ep", "std::string", "ep_group"),
+        ("group_tp", "std::string", "tp_group"),
+        ("short_soc_version", "std::string", ""),
+        ("dtype_x", "ge::DataType", "DT_BF16"),
+    ],
+    "inputs": [
+        ("expand_x_shape", ["bs", "h"]),
+        ("expert_ids_shape", ["bs", "k"]),
+        ("scales_shape", ["scales_dim0", "h"], "has_scales"),
+    ],
+    "outputs": [
+        ("expand_x_output_shape", ["expand_x_out_dim0", "expand_x_out_dim1"]),
+        ("dynamic_scales_output_shape", ["dynamic_scales_len"]),
+        ("expand_idx_output_shape", ["bs * k"]),
+        ("expert_token_nums_output_shape", ["expert_token_nums_len"]),
+        ("ep_recv_count_output_shape", ["ep_world_size"]),
+        ("tp_recv_count_output_shape", ["tp_recv_count_len"]),
+    ],
+    "attrs": [
+        ("group_ep", "std::string", "group_ep"),
+        ("ep_world_size", "int64_t", "ep_world_size"),
+        ("ep_rank_id", "int64_t", "ep_rank_id"),
+        ("moe_expert_num", "int64_t", "moe_expert_num"),
+        ("group_tp", "std::string", "group_tp"),
+        ("tp_world_size", "int64_t", "tp_world_size"),
+        ("tp_rank_id", "int64_t", "tp_rank_id"),
+        ("expert_shard_type", "int64_t", "expert_shard_type"),
+        ("shared_expert_num", "int64_t", "shared_expert_num"),
+        ("shared_expert_rank_num", "int64_t", "shared_expert_rank_num"),
+        ("quant_mode", "int64_t", "quant_mode"),
+        ("global_bs", "int64_t", "global_bs"),
+        ("expert_token_nums_type", "int64_t", "expert_token_nums_type"),
+    ],
+    "dtypes": ["dtype_x", "DT_INT32", "DT_FLOAT", "dtype_x", "DT_FLOAT", "DT_INT32", "DT_INT64", "DT_INT32", "DT_INT32"],
+    "soc_version": "short_soc_version",
+    "set_op_type": True,
+}
+
+
+def param_values(op_name, spec, idx, helpers=None):
+    if getattr(spec, "x1_shape", None) and getattr(spec, "x2_shape", None):
+        x1, x2 = spec.x1_shape, spec.x2_shape
+        out = getattr(spec, "output_shape", None) or x1
+    else:
+        x1, x2, _go, out, _bias = helpers["ensure_shapes"](spec)
+    dt_in, _dt_out = helpers["dtype_to_ge"](spec.dtype)
+    expand_x_out = getattr(spec, "expand_x_out", (out[0], out[1]))
+    tp_world_size = getattr(spec, "tp_world_size", None)
+    scales = getattr(spec, "scales_shape", None)
+    return {
+        "bs": x1[0],
+        "h": x1[1],
+        "k": x2[1],
+        "expand_x_out_dim0": expand_x_out[0],
+        "expand_x_out_dim1": expand_x_out[1],
+        "dynamic_scales_len": getattr(spec, "dynamic_scales_len", expand_x_out[0]),
+        "expert_token_nums_len": getattr(spec, "expert_token_nums_len", None),
+        "tp_recv_count_len": tp_world_size if tp_world_size and tp_world_size > 0 else None,
+        "scales_dim0": scales[0] if scales else None,
+        "has_scales": True if scales else None,
+        "ep_world_size": getattr(spec, "ep_world_size", None),
+        "ep_rank_id": getattr(spec, "ep_rank_id", None),
+        "moe_expert_num": getattr(spec, "moe_expert_num", None),
+        "tp_world_size": tp_world_size,
+        "tp_rank_id": getattr(spec, "tp_rank_id", None),
+        "expert_shard_type": getattr(spec, "expert_shard_type", None),
+        "shared_expert_num": getattr(spec, "shared_expert_num", None),
+        "shared_expert_rank_num": getattr(spec, "shared_expert_rank_num", None),
+        "quant_mode": getattr(spec, "quant_mode", None),
+        "global_bs": getattr(spec, "global_bs", None),
+        "expert_token_nums_type": getattr(spec, "expert_token_nums_type", None),
+        "group_ep": getattr(spec, "group_ep", None),
+        "group_tp": getattr(spec, "group_tp", None),
+        "short_soc_version": getattr(spec, "short_soc_version", None),
+        "dtype_x": dt_in,
+    }
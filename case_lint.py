@@ -0,0 +1,621 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+Stage 2 渲染结果的毫秒级静态检查：每个 TEST_F 写入文件前先过一遍，拦下必然编译失败或属性错位的用例，
+不必等到 optiling_llt 整体重编、链接（数分钟）后才从编译错误里发现。
+
+检查项（字符串与注释内容不参与）：
+- Python 字面量泄漏：None / True / False（如模板把空单元格渲染成 CreateFrom<int64_t>(None)）
+- 括号配对：() [] {}，以及模板占位符 <LB>/<RB> 残留
+- NodeAttrs 与算子属性表比对：缺失、多余、顺序（tiling 按下标取属性）、CreateFrom<T> 类型与取值是否匹配
+
+属性表来源（按优先级）：模板导出的 ATTR_SCHEMA = [(属性名, C++类型, 默认值), ...]；模板 PARAM_SUITE 的 attrs
+（默认值取对应字段的默认值）；参考UT中第一个 NodeAttrs（字面量取值作为默认值）。
+
+处理方式（--lint / UT_LINT）：
+- repair（默认）：能确定修法的就地修复——True/False 改为 true/false，None 与缺失属性用默认值，类型按属性表改写、
+  0/1 转 bool、数值转字符串，属性按属性表重排；无法修复的用例丢弃并告警
+- reject：有任何问题的用例都丢弃
+- warn：只告警，原样输出
+- off：不检查
+
+用法（单独检查已生成的文件）：
+  python3 case_lint.py test_all_gather_matmul_tiling.cpp [--ref test_all_gather_matmul.cpp] [--op AllGatherMatmul]
+"""
+
+from __future__ import annotations
+
+import argparse
+import re
+import sys
+import time
+from dataclasses import dataclass, field
+from pathlib import Path
+from typing import Any, Dict, List, Optional, Sequence, Tuple
+
+from utils import logger
+
+LINT_MODES = ("repair", "reject", "warn", "off")
+DEFAULT_LINT_MODE = "repair"
+# 每个用例最多输出的问题条数
+MAX_ISSUES_LOGGED = 5
+
+# 字面量/注释的起始记号；字符串与字符字面量的剩余部分（不跨行）；原始字符串的分隔符
+_LITERAL_START_RE = re.compile(r'//|/\*|R"|["\']')
+_QUOTED_TAIL_RE = {
+    '"': re.compile(r'(?:\\.|[^"\\\n])*"'),
+    "'": re.compile(r"(?:\\.|[^'\\\n])+'"),
+}
+_RAW_DELIM_RE = re.compile(r'([^(\s"\\]{0,16})\(')
+_NOT_NEWLINE_RE = re.compile(r'[^\n]')
+_PY_LITERAL_RE = re.compile(r'(?<![\w:.>])(None|True|False)(?![\w(])')
+_PLACEHOLDER_RE = re.compile(r'<LB>|<RB>')
+_NODE_ATTRS_RE = re.compile(r'\.\s*NodeAttrs\s*\(')
+_CREATE_FROM_RE = re.compile(r'\s*ge::AnyValue::CreateFrom\s*<')
+_TEST_F_RE = re.compile(r'^\s*TEST_F\s*\(\s*\w+\s*,\s*(\w+)', re.M)
+_INT_RE = re.compile(r'[+-]?(?:0[xX][0-9a-fA-F]+|\d+)[uUlL]*')
+_FLOAT_RE = re.compile(r'[+-]?(?:\d+\.\d*|\.\d+|\d+)(?:[eE][+-]?\d+)?[fF]?')
+_PAIRS = {")": "(", "]": "[", "}": "{"}
+_BRACKET_RE = re.compile(r'[()\[\]{}]')
+_SPACE_RE = re.compile(r'\s+')
+_INT_TYPE_RE = re.compile(r'(?:std::)?u?int(?:8|16|32|64)_t|int|long|longlong|unsigned|size_t|uint32_t|int64_t')
+_ATTR_NAME_RE = re.compile(r'\{\s*"([^"\\]*)"\s*,')
+
+
+def mask_literals(text: str) -> str:
+    """同长度文本，注释整体与字符串/字符字面量的内容替换为空格（保留换行与引号）。
+
+    从左到右单遍扫描：每个记号只定位一次，注释/字面量的结尾用 find 或锚定匹配向后找，已扫描的部分不回看。
+    """
+    out: List[str] = []
+    last = pos = 0
+    block_unclosed = False  # 某个 /* 之后已找不到 */，后面的 /* 同样找不到
+    while True:
+        m = _LITERAL_START_RE.search(text, pos)
+        if m is None:
+            break
+        start, token = m.start(), m.group(0)
+        if token == "//":
+            end = text.find("\n", start)
+            end = len(text) if end < 0 else end
+            out.append(text[last:start])
+            out.append(" " * (end - start))
+        elif token == "/*":
+            close = -1 if block_unclosed else text.find("*/", start + 2)
+            if close < 0:
+                block_unclosed = True
+                pos = start + 1
+                continue
+            end = close + 2
+            out.append(text[last:start])
+            out.append(_NOT_NEWLINE_RE.sub(" ", text[start:end]))
+        elif token == 'R"':
+            delim = _RAW_DELIM_RE.match(text, start + 2)
+            close = text.find(")" + delim.group(1) + '"', delim.end()) if delim else -1
+            if close < 0:
+                # 不是原始字符串，从引号处按普通字符串继续
+                pos = start + 1
+                continue
+            end = close + len(delim.group(1)) + 2
+            out.append(text[last:start + 2])
+            out.append(_NOT_NEWLINE_RE.sub(" ", text[start + 2:end - 1]) + '"')
+        else:
+            # 数字分隔符 1'000 与标识符后的引号不是字符字面量
+            prev = text[start - 1] if start else ""
+            tail = None
+            if token == '"' or not (prev.isalnum() or prev in "_'"):
+                tail = _QUOTED_TAIL_RE[token].match(text, start + 1)
+            if tail is None:
+                pos = start + 1
+                continue
+            end = tail.end()
+            out.append(text[last:start + 1])
+            out.append(" " * (end - start - 2) + token)
+        last = pos = end
+    out.append(text[last:])
+    return "".join(out)
+
+
+def _matching(masked: str, pos: int) -> int:
+    """masked[pos] 为开括号，返回配对闭括号的下标；不配对返回 -1。"""
+    stack: List[str] = []
+    for m in _BRACKET_RE.finditer(masked, pos):
+        ch = m.group(0)
+        if ch in "([{":
+            stack.append(ch)
+        else:
+            if not stack or stack.pop() != _PAIRS[ch]:
+                return -1
+            if not stack:
+                return m.start()
+    return -1
+
+
+def _line_of(text: str, pos: int) -> int:
+    return text.count("\n", 0, pos) + 1
+
+
+# ---------------------------------------------------------------------------
+# 属性表
+# ---------------------------------------------------------------------------
+
+@dataclass
+class AttrSpec:
+    name: str
+    ctype: str
+    default: Optional[str] = None  # C++ 表达式；None 表示没有可用默认值（缺失/None 时无法修复）
+
+
+def _type_kind(ctype: str) -> str:
+    ctype = _SPACE_RE.sub("", ctype)
+    if ctype == "bool":
+        return "bool"
+    if ctype in ("float", "double"):
+        return "float"
+    if ctype in ("std::string", "string", "constchar*"):
+        return "string"
+    if ctype.startswith("std::vector<") or ctype.startswith("vector<"):
+        return "vector"
+    if _INT_TYPE_RE.fullmatch(ctype):
+        return "int"
+    return "other"
+
+
+def _value_kind(value: str) -> str:
+    value = value.strip()
+    if value == "None":
+        return "none"
+    if value in ("true", "false", "True", "False"):
+        return "bool"
+    if _INT_RE.fullmatch(value):
+        return "int"
+    if _FLOAT_RE.fullmatch(value):
+        return "float"
+    if value.startswith('"'):
+        return "string"
+    if value.startswith("{"):
+        return "init"
+    return "expr"
+
+
+def cpp_literal(value: Any, ctype: str) -> Optional[str]:
+    """Python 默认值 -> 属性类型对应的 C++ 字面量。"""
+    if value is None:
+        return None
+    kind = _type_kind(ctype)
+    if kind == "bool":
+        return "true" if value in (True, 1, "1", "true", "True") else "false"
+    if kind == "string":
+        return '"' + str(value).replace("\\", "\\\\").replace('"', '\\"') + '"'
+    if kind == "vector":
+        if isinstance(value, (list, tuple)):
+            return "{" + ", ".join(str(int(v)) for v in value) + "}"
+        return None
+    if isinstance(value, bool):
+        return "1" if value else "0"
+    if isinstance(value, float) and kind == "int":
+        return str(int(value)) if value.is_integer() else None
+    return str(value)
+
+
+def _parse_attr_entries(text: str, masked: str, start: int, end: int) -> Optional[List[Dict[str, Any]]]:
+    """解析 NodeAttrs 参数 {{"name", ge::AnyValue::CreateFrom<T>(v)}, ...}（start/end 为外层花括号下标）。"""
+    entries: List[Dict[str, Any]] = []
+    pos = start + 1
+    while pos < end:
+        while pos < end and masked[pos] in " \t\r\n,":
+            pos += 1
+        if pos >= end:
+            break
+        if masked[pos] != "{":
+            return None
+        close = _matching(masked, pos)
+        if close < 0 or close > end:
+            return None
+        raw = text[pos:close + 1]
+        entry: Dict[str, Any] = {"raw": raw, "name": None, "ctype": None, "value": None}
+        m = _ATTR_NAME_RE.match(raw)
+        if m:
+            entry["name"] = m.group(1)
+            rest = pos + m.end()
+            cm = _CREATE_FROM_RE.match(text, rest)
+            if cm:
+                # 模板实参可能嵌套尖括号，如 std::vector<int64_t>
+                depth, i = 1, cm.end()
+                while i < close and depth:
+                    depth += {"<": 1, ">": -1}.get(masked[i], 0)
+                    i += 1
+                ctype = text[cm.end():i - 1].strip()
+                j = i
+                while j < close and masked[j] in " \t\r\n":
+                    j += 1
+                if j < close and masked[j] == "(":
+                    vclose = _matching(masked, j)
+                    if 0 < vclose < close and not masked[vclose + 1:close].strip():
+                        entry["ctype"] = ctype
+                        entry["value"] = text[j + 1:vclose].strip()
+        entries.append(entry)
+        pos = close + 1
+    return entries
+
+
+def _node_attr_spans(text: str, masked: str) -> List[Tuple[int, int]]:
+    """每个 .NodeAttrs({...}) 参数外层花括号的 (起, 止) 下标。"""
+    spans = []
+    for m in _NODE_ATTRS_RE.finditer(masked):
+        pos = m.end()
+        while pos < len(masked) and masked[pos] in " \t\r\n":
+            pos += 1
+        if pos < len(masked) and masked[pos] == "{":
+            close = _matching(masked, pos)
+            if close > 0:
+                spans.append((pos, close))
+    return spans
+
+
+def schema_from_reference(ref_content: str) -> Optional[List[AttrSpec]]:
+    """取参考UT中第一个 NodeAttrs 作为属性表，字面量取值作为默认值。"""
+    masked = mask_literals(ref_content)
+    for start, end in _node_attr_spans(ref_content, masked):
+        entries = _parse_attr_entries(ref_content, masked, start, end)
+        if not entries or any(e["ctype"] is None for e in entries):
+            continue
+        schema = []
+        for e in entries:
+            kind = _value_kind(e["value"])
+            literal = kind in ("bool", "int", "float", "string", "init")
+            schema.append(AttrSpec(e["name"], e["ctype"], e["value"] if literal else None))
+        return schema
+    return None
+
+
+def schema_from_template(module: Any) -> Optional[List[AttrSpec]]:
+    """模板导出的 ATTR_SCHEMA，或 PARAM_SUITE 的 attrs；格式不对时抛 ValueError。"""
+    if module is None:
+        return None
+    raw = getattr(module, "ATTR_SCHEMA", None)
+    if raw is not None:
+        schema = []
+        for item in raw:
+            if not isinstance(item, (list, tuple)) or len(item) not in (2, 3):
+                raise ValueError(f"ATTR_SCHEMA 条目应为 (属性名, C++类型[, 默认值]): {item!r}")
+            name, ctype = str(item[0]), str(item[1])
+            schema.append(AttrSpec(name, ctype, cpp_literal(item[2], ctype) if len(item) > 2 else None))
+        return schema
+    suite = getattr(module, "PARAM_SUITE", None)
+    if isinstance(suite, dict) and suite.get("attrs"):
+        defaults = {str(f[0]): f[2] for f in suite.get("fields", []) if len(f) > 2}
+        return [AttrSpec(str(a), str(t), cpp_literal(defaults.get(str(f)), str(t)))
+                for (a, t, f) in suite["attrs"]]
+    return None
+
+
+# ---------------------------------------------------------------------------
+# 检查
+# ---------------------------------------------------------------------------
+
+@dataclass
+class LintIssue:
+    kind: str
+    message: str
+    fixed: bool = False
+
+
+@dataclass
+class LintResult:
+    text: str
+    issues: List[LintIssue] = field(default_factory=list)
+
+    @property
+    def clean(self) -> bool:
+        return not self.issues
+
+    @property
+    def repaired(self) -> bool:
+        return all(issue.fixed for issue in self.issues)
+
+
+def _coerce(value: str, ctype: str, default: Optional[str]) -> Tuple[Optional[str], str]:
+    """把取值改写为 ctype 可接受的形式，返回 (新取值或 None, 说明)。"""
+    kind, vkind = _type_kind(ctype), _value_kind(value)
+    if vkind == "none":
+        return default, "用属性表默认值" if default is not None else "无默认值"
+    if vkind in ("expr",) or kind == "other":
+        return value, ""
+    if kind == "bool":
+        if vkind == "bool":
+            return value.lower(), ""
+        if vkind == "int" and value.strip() in ("0", "1"):
+            return ("true" if value.strip() == "1" else "false"), "0/1 转 bool"
+    elif kind == "int":
+        if vkind == "int":
+            return value, ""
+        if vkind == "bool":
+            return ("1" if value.lower() == "true" else "0"), "bool 转整数"
+        if vkind == "float" and float(value.rstrip("fF")).is_integer():
+            return str(int(float(value.rstrip("fF")))), "整数值的浮点数转整数"
+    elif kind == "float":
+        if vkind in ("int", "float"):
+            return value, ""
+    elif kind == "string":
+        if vkind == "string":
+            return value, ""
+        if vkind in ("int", "float"):
+            return f'"{value}"', "数值转字符串"
+    elif kind == "vector":
+        if vkind == "init":
+            return value, ""
+    return None, f"{vkind} 取值不能用作 {ctype}"
+
+
+def _check_attrs(entries: List[Dict[str, Any]], schema: List[AttrSpec],
+                 issues: List[LintIssue]) -> Optional[List[Dict[str, Any]]]:
+    """按属性表检查并修复 NodeAttrs，返回修复后的条目（无改动时返回 None）。"""
+    by_name = {e["name"]: e for e in entries if e["name"] is not None}
+    changed = False
+    result: List[Dict[str, Any]] = []
+    for spec in schema:
+        entry = by_name.pop(spec.name, None)
+        if entry is None:
+            if spec.default is None:
+                issues.append(LintIssue("attr", f"缺少属性 {spec.name}（属性表无默认值）"))
+                continue
+            issues.append(LintIssue("attr", f"缺少属性 {spec.name}，补为 {spec.default}", True))
+            result.append({"name": spec.name, "ctype": spec.ctype, "value": spec.default, "raw": None})
+            changed = True
+            continue
+        if entry["ctype"] is None:
+            result.append(entry)
+            continue
+        value, note = _coerce(entry["value"], spec.ctype, spec.default)
+        type_differs = _SPACE_RE.sub("", entry["ctype"]) != _SPACE_RE.sub("", spec.ctype)
+        if type_differs or value != entry["value"]:
+            what = []
+            if type_differs:
+                what.append(f"类型 {entry['ctype']} 应为 {spec.ctype}")
+            if value != entry["value"]:
+                what.append(f"取值 {entry['value']}" + (f"（{note}）" if note else ""))
+            if value is None:
+                issues.append(LintIssue("attr", f"属性 {spec.name}: {'，'.join(what)}，无法修复"))
+                result.append(entry)
+                continue
+            issues.append(LintIssue("attr", f"属性 {spec.name}: {'，'.join(what)} → CreateFrom<{spec.ctype}>({value})",
+                                    True))
+            entry = dict(entry, ctype=spec.ctype, value=value, raw=None)
+            changed = True
+        result.append(entry)
+    # 属性表未声明的属性保留在末尾，不影响已声明属性的下标
+    extras = [e for e in entries if e["name"] is None or e["name"] in by_name]
+    for e in extras:
+        issues.append(LintIssue("attr", f"属性表未声明的属性 {e['name'] or e['raw'][:40]}，保留在末尾", True))
+    result.extend(extras)
+    if [e["name"] for e in result] != [e["name"] for e in entries]:
+        if not changed:
+            issues.append(LintIssue("attr", "属性顺序与属性表不一致（tiling 按下标读取属性），已按属性表重排", True))
+        changed = True
+    return result if changed else None
+
+
+# 属性表检查不会改动的取值写法（与 _coerce 保持一致）；标识符按表达式原样保留，但不能是 true/false/None 等字面量
+_IDENT_VALUE = r'(?!(?:None|True|False|true|false)\b)[A-Za-z_][\w:.]*'
+_STRING_VALUE = r'"(?:\\.|[^"\\\n])*"'
+_CLEAN_VALUE = {
+    "bool": r'true|false',
+    "int": _INT_RE.pattern,
+    "float": _INT_RE.pattern + "|" + _FLOAT_RE.pattern,
+    "string": _STRING_VALUE,
+    "vector": r'\{[^{}"/]*\}',
+    "other": _INT_RE.pattern + "|" + _FLOAT_RE.pattern + "|" + _STRING_VALUE,
+}
+_clean_attrs_cache: Dict[Tuple[Tuple[str, str], ...], "re.Pattern[str]"] = {}
+
+
+def _clean_attrs_re(schema: Sequence[AttrSpec]) -> "re.Pattern[str]":
+    """与属性表完全一致（名称、顺序、类型、取值写法）的 NodeAttrs 参数；匹配上的无需逐条解析。"""
+    key = tuple((spec.name, spec.ctype) for spec in schema)
+    pattern = _clean_attrs_cache.get(key)
+    if pattern is None:
+        entries = []
+        for spec in schema:
+            value = _CLEAN_VALUE[_type_kind(spec.ctype)] + "|" + _IDENT_VALUE
+            ctype = r"\s*".join(re.escape(part) for part in spec.ctype.split())
+            entries.append(rf'\{{\s*"{re.escape(spec.name)}"\s*,\s*ge::AnyValue::CreateFrom\s*<\s*{ctype}\s*>'
+                           rf'\s*\(\s*(?:{value})\s*\)\s*\}}')
+        pattern = re.compile(r"\{\s*" + r"\s*,\s*".join(entries) + r"\s*\}")
+        _clean_attrs_cache[key] = pattern
+    return pattern
+
+
+def _render_attrs(entries: List[Dict[str, Any]]) -> str:
+    return "{" + ", ".join(
+        e["raw"] if e["raw"] is not None
+        else f'{{"{e["name"]}", ge::AnyValue::CreateFrom<{e["ctype"]}>({e["value"]})}}'
+        for e in entries
+    ) + "}"
+
+
+def _balanced(masked: str) -> bool:
+    """只看括号字符的快速判断：反复消去相邻的配对括号，轮数等于嵌套深度；不配对时再由 _check_balance 逐个定位。"""
+    brackets = "".join(_BRACKET_RE.findall(masked))
+    while brackets:
+        reduced = brackets.replace("()", "").replace("[]", "").replace("{}", "")
+        if len(reduced) == len(brackets):
+            return False
+        brackets = reduced
+    return True
+
+
+def _check_balance(text: str, masked: str, issues: List[LintIssue]):
+    if _balanced(masked):
+        return
+    stack: List[Tuple[str, int]] = []
+    for m in _BRACKET_RE.finditer(masked):
+        ch, i = m.group(0), m.start()
+        if ch in "([{":
+            stack.append((ch, i))
+        else:
+            if not stack or stack[-1][0] != _PAIRS[ch]:
+                issues.append(LintIssue("brace", f"第{_line_of(text, i)}行多余或不匹配的 '{ch}'"))
+                return
+            stack.pop()
+    if stack:
+        ch, i = stack[-1]
+        issues.append(LintIssue("brace", f"第{_line_of(text, i)}行的 '{ch}' 未闭合"))
+
+
+def lint_case(text: str, schema: Optional[Sequence[AttrSpec]] = None, repair: bool = True) -> LintResult:
+    """检查一个渲染出的 TEST_F；repair 为 True 时返回修复后的文本。"""
+    issues: List[LintIssue] = []
+
+    if _PLACEHOLDER_RE.search(text):
+        issues.append(LintIssue("placeholder", "模板占位符 <LB>/<RB> 未替换", True))
+        if repair:
+            text = text.replace("<LB>", "{").replace("<RB>", "}")
+    masked = mask_literals(text)
+
+    checked: List[Tuple[int, int]] = []
+    if schema:
+        checked = _node_attr_spans(text, masked)
+        attrs_changed = False
+        # 从后往前替换，前面的下标不受影响
+        clean_attrs = _clean_attrs_re(schema)
+        for start, end in reversed(checked):
+            if clean_attrs.fullmatch(text, start, end + 1):
+                continue
+            entries = _parse_attr_entries(text, masked, start, end)
+            if entries is None:
+                issues.append(LintIssue("attr", f"第{_line_of(text, start)}行 NodeAttrs 无法解析，跳过属性检查"))
+                continue
+            fixed = _check_attrs(entries, schema, issues)
+            if fixed is not None and repair:
+                text = text[:start] + _render_attrs(fixed) + text[end + 1:]
+                attrs_changed = True
+        if attrs_changed:
+            masked = mask_literals(text)
+            checked = _node_attr_spans(text, masked)
+
+    # 已按属性表检查过的 NodeAttrs 不再重复报告字面量
+    replacements: List[Tuple[int, str]] = []
+    # 逐位置的环视匹配较慢，先用子串判断跳过绝大多数干净的用例
+    suspects = any(word in masked for word in ("None", "True", "False"))
+    for m in _PY_LITERAL_RE.finditer(masked) if suspects else ():
+        if any(start <= m.start() <= end for start, end in checked):
+            continue
+        word = m.group(1)
+        line = _line_of(text, m.start())
+        if word == "None":
+            issues.append(LintIssue("python", f"第{line}行出现 Python 字面量 None"))
+        else:
+            issues.append(LintIssue("python", f"第{line}行出现 Python 字面量 {word}，改为 {word.lower()}", True))
+            replacements.append((m.start(), word.lower()))
+    if repair and replacements:
+        for pos, word in reversed(replacements):
+            text = text[:pos] + word + text[pos + len(word):]
+        masked = mask_literals(text)
+
+    _check_balance(text, masked, issues)
+    return LintResult(text, issues)
+
+
+class CaseLinter:
+    """按模式检查每个 TEST_F，累计问题数与耗时，最后输出一行汇总。"""
+
+    def __init__(self, schema: Optional[List[AttrSpec]], mode: str = DEFAULT_LINT_MODE, source: str = ""):
+        if mode not in LINT_MODES:
+            raise ValueError(f"未知的检查模式: {mode}（可选 {'/'.join(LINT_MODES)}）")
+        self.schema = schema
+        self.mode = mode
+        self.source = source
+        self.reset()
+
+    def reset(self):
+        self.checked = self.flagged = self.repaired = self.rejected = 0
+        self.seconds = 0.0
+
+    def check(self, idx: int, text: str, label: Optional[str] = None) -> Optional[str]:
+        """返回要写入的用例文本；用例被拒绝时返回 None。"""
+        start = time.perf_counter()
+        result = lint_case(text, self.schema, repair=self.mode == "repair")
+        self.seconds += time.perf_counter() - start
+        self.checked += 1
+        if result.clean:
+            return text
+        self.flagged += 1
+        if label is None:
+            name = _TEST_F_RE.search(text)
+            label = f"第{idx}行" + (f"（{name.group(1)}）" if name else "")
+        keep = self.mode == "warn" or (self.mode == "repair" and result.repaired)
+        for issue in result.issues[:MAX_ISSUES_LOGGED]:
+            mark = "已修复" if issue.fixed and self.mode == "repair" else ("保留" if keep else "丢弃用例")
+            logger.warning(f"⚠️ 静态检查 {label} [{issue.kind}] {issue.message}（{mark}）")
+        if len(result.issues) > MAX_ISSUES_LOGGED:
+            logger.warning(f"⚠️ 静态检查 {label} ... 另有 {len(result.issues) - MAX_ISSUES_LOGGED} 处问题")
+        if not keep:
+            self.rejected += 1
+            return None
+        if self.mode == "repair":
+            self.repaired += 1
+            return result.text
+        return text
+
+    def report(self, op_name: str):
+        if not self.checked:
+            return
+        source = f"，属性表来自{self.source}" if self.source else "，无属性表"
+        logger.info(f"🧹 {op_name} 静态检查: {self.checked} 个用例，修复 {self.repaired}，丢弃 {self.rejected}，"
+                    f"耗时 {self.seconds * 1000:.1f}ms{source}")
+
+
+def load_attr_schema(module: Any, ref_content: Optional[str]) -> Tuple[Optional[List[AttrSpec]], str]:
+    """返回 (属性表, 来源说明)。"""
+    schema = schema_from_template(module)
+    if schema is not None:
+        return schema, "模板 ATTR_SCHEMA" if getattr(module, "ATTR_SCHEMA", None) is not None else "模板 PARAM_SUITE"
+    if ref_content:
+        schema = schema_from_reference(ref_content)
+        if schema is not None:
+            return schema, "参考UT"
+    return None, ""
+
+
+def split_test_cases(content: str) -> List[Tuple[int, int]]:
+    """文件中每个 TEST_F 的 (起, 止) 下标。"""
+    masked = mask_literals(content)
+    spans = []
+    for m in re.finditer(r'^[ \t]*TEST_F\s*\(', masked, re.M):
+        brace = masked.find("{", m.end())
+        if brace < 0:
+            continue
+        close = _matching(masked, brace)
+        spans.append((m.start(), close + 1 if close > 0 else len(content)))
+    return spans
+
+
+def main(argv: Optional[List[str]] = None) -> int:
+    parser = argparse.ArgumentParser(description="检查生成的单测文件中每个 TEST_F（Python 字面量、括号、属性表）")
+    parser.add_argument("file", help="生成的单测 cpp 文件")
+    parser.add_argument("--ref", default=None, help="参考UT（推断属性表）")
+    parser.add_argument("--op", default=None, help="算子名称（读取模板的 ATTR_SCHEMA/PARAM_SUITE）")
+    args = parser.parse_args(argv)
+
+    content = Path(args.file).read_text(encoding="utf-8", errors="ignore")
+    module = None
+    if args.op:
+        from convert_ut_from_xlsx import load_case_template_module
+        module = load_case_template_module(args.op)
+    ref_content = Path(args.ref).read_text(encoding="utf-8", errors="ignore") if args.ref else None
+    try:
+        schema, source = load_attr_schema(module, ref_content)
+    except ValueError as e:
+        print(f"❌ {e}")
+        return 1
+    linter = CaseLinter(schema, "warn", source)
+    for idx, (start, end) in enumerate(split_test_cases(content), start=1):
+        linter.check(idx, content[start:end])
+    linter.report(args.op or Path(args.file).stem)
+    print(f"{'❌' if linter.flagged else '✅'} {linter.checked} 个用例，{linter.flagged} 个有问题")
+    return 1 if linter.flagged else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
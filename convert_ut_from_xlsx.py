@@ -8,10 +8,32 @@
 
 用法：
   python convert_ut_from_xlsx.py --ref /path/to/test_xxx.cpp --xlsx /path/to/params.xlsx \
-    --op AllGatherMatmul [--out /custom/output.cpp] [--name-col test_name]
+    --op AllGatherMatmul [--out /custom/output.cpp] [--name-col test_name] [--mode testf|param|runtime|cases]
 
 说明：
 - 若未指定 --op，会尝试从测试夹具类名或文件名推断（如 test_all_gather_matmul.cpp -> AllGatherMatmul）
+- --mode param：生成单个 TEST_P 与 test_params[] 数据表（所有行共享同一函数体，编译开销与用例数基本无关），
+  需要模板导出 PARAM_SUITE 与 param_values，详见 param_harness.py
+- --mode runtime：生成启动时读取用例表（CSV）并通过 RegisterTest 注册用例的驱动，外加用例表；
+  --mode cases 仅刷新用例表，驱动无需重新编译
+- --bench：额外生成同源的 Google Benchmark 文件，只对 tiling_func 计时，输出每个用例的 p50/p99 与 tiling key
+- --alloc-probe：在输出文件中注入全局分配钩子，记录每次 tiling_func 调用的分配次数/字节/峰值，退出时写 <stem>_alloc.json
+- --golden record|compare：注入 TilingData 黄金快照，记录或比对每次 tiling_func 的 TilingData 字节、workspace 与 block dim
+  （快照默认 <stem>_golden.bin，可用 --golden-file 指定，见 golden_snapshot.py）
+- --score：按模板的 TILING_ROLES 解码 TilingData，用 roofline + 通信掩盖模型估计每个用例的耗时，写 <stem>_perf.csv
+  （见 tiling_score.py；--sweep 在模板提供角色映射时同样汇总预测耗时）
+- --check-buffers：按同一解码估算 L0A/L0B/L0C/L1/UB 占用与核利用率（block dim / CORE_NUM），超出 hardware_info 预算即失败，
+  低利用率告警，写 <stem>_buffer.csv（见 buffer_check.py）
+- --stress：额外生成并发压力测试，多线程交错执行全部用例并与单线程基线比对（见 stress_harness.py）
+- --sweep GRID_JSON：额外生成多线程扫参程序，遍历网格并输出 tiling key 覆盖分布（见 sweep_harness.py）
+- 行级渲染缓存：行内容、模板文件、公共前缀与生成器代码均未变化的行直接复用上次的渲染结果，键不含行号
+  （见 render_cache.py，--no-render-cache 关闭）；输出文件内容与磁盘上一致时不重写，保留时间戳以免触发增量编译
+- --lint：写入前对每个 TEST_F 做毫秒级静态检查（Python 字面量、括号配对、按属性表检查 NodeAttrs），
+  默认修复可修的问题、丢弃无法修复的用例（见 case_lint.py）
+- TestfStream 逐行渲染 TEST_F，stage 1 → stage 2 流水线（stream_pipeline.py）在参数逐行生成时直接喂入
+- --shard N（testf 模式）：输出公共头 <stem>_common.h + 每个至多 N 个 TEST_F 的 <stem>_shard_NNN.cpp + CMake 片段
+  <stem>_shards.cmake，用例按 TEST_F 名哈希分片，改动、插入或删除一行只重编一个分片（见 shard_layout.py）
+- 参数表流式读取（见 param_reader.py）：--xlsx 也接受 csv/parquet/arrow；形状与 dtype 列按列批量解析，空单元格为 None
 - xlsx 推荐列名（不强制，脚本会尽量兼容）：
   - test_name | name
   - m,k,n（或 x1_shape/x2_shape/gather_output_shape/output_shape 形如 "[1024,2048]"）
@@ -27,19 +49,48 @@
 from __future__ import annotations
 
 import argparse
+import errno
+import filecmp
 import re
 from dataclasses import dataclass
 import importlib.util
 import inspect
+import math
 import os
+import tempfile
 from pathlib import Path
-from typing import Dict, List, Optional, Tuple, Any
-
-import pandas as pd
-
+from typing import Dict, Iterable, List, Optional, Tuple, Any
+
+from alloc_probe import alloc_probe
+from bench_harness import bench_file_stem, render_bench_file
+from buffer_check import buffer_probe
+from case_lint import DEFAULT_LINT_MODE, LINT_MODES, CaseLinter, load_attr_schema
+from golden_snapshot import build_tiling_layout, golden_default_path, golden_probe
+from stress_harness import render_stress_file, stress_file_stem
+from sweep_harness import load_sweep_grid, render_sweep_file, sweep_file_stem
+from tiling_layouts import TilingProbe, inject_probes
+from tiling_score import load_score_spec, score_probe
+from param_reader import ParamTable
+from render_cache import RenderCache
+from shard_layout import render_shard_layout, stale_shards
+from param_harness import (
+    ParamSuite,
+    TestParamRow,
+    UnknownDataTypeError,
+    build_param_suite,
+    build_test_param,
+    checked_dtype,
+    render_case_table,
+    render_param_file,
+    render_runtime_file,
+)
+from platform_cache import (
+    inject_platform_cache,
+    platform_apply_lines,
+    platform_setup_lines,
+)
 from utils import (
     create_timestamped_dir,
-    save_file_content,
     logger,
 )
 
@@ -139,11 +190,8 @@ def parse_bool(v: Any) -> bool:
 
 
 def parse_int(v: Any, default: int = 0) -> int:
-    try:
-        if pd.isna(v):
-            return default
-    except Exception:
-        pass
+    if v is None or (isinstance(v, float) and math.isnan(v)):
+        return default
     try:
         return int(v)
     except Exception:
@@ -258,6 +306,14 @@ def dtype_to_ge(dtype: str) -> Tuple[str, str]:
     return ("DT_FLOAT16", "DT_FLOAT16")
 
 
+def strict_dtype_to_ge(dtype: str) -> Tuple[str, str]:
+    """参数化/运行时模式使用：无法识别的 dtype 抛 UnknownDataTypeError，而不是回退为 float16。"""
+    if not (dtype or "").strip():
+        return dtype_to_ge(dtype)
+    dt = checked_dtype("dtype", dtype)
+    return (dt, dt)
+
+
 @dataclass
 class CaseSpec:
     name: str
@@ -300,9 +356,14 @@ class CaseSpec:
     short_soc_version: Optional[str] = None
 
 
+def case_name(row: Dict[str, Any], idx: int) -> str:
+    """用例名：取 test_name/name/case_name 列，均为空时为 case_<行号>。"""
+    return str(row.get("test_name") or row.get("name") or row.get("case_name") or f"case_{idx}")
+
+
 def row_to_case(row: Dict[str, Any], idx: int) -> CaseSpec:
     # 名称
-    name = str(row.get("test_name") or row.get("name") or row.get("case_name") or f"case_{idx}")
+    name = case_name(row, idx)
     # m,k,n
     m = row.get("m") if "m" in row else row.get("M")
     k = row.get("k") if "k" in row else row.get("K")
@@ -318,6 +379,7 @@ def row_to_case(row: Dict[str, Any], idx: int) -> CaseSpec:
     go_shape = parse_shape(row.get("gather_output_shape") or row.get("gather_out_shape")) or None
     out_shape = parse_shape(row.get("output_shape") or row.get("x_output_shape") or row.get("output_x_shape")) or None
     shared_expert_x = parse_shape(row.get("shared_expert_x_shape")) or None
+    scales = parse_shape(row.get("scales_shape")) or None
 
     # 如果提供了 input_tensor_shape（形如 [[M,K],[K,N],[N]]），优先使用
     inputs = parse_shape_list(row.get("input_tensor_shape"))
@@ -424,6 +486,9 @@ def row_to_case(row: Dict[str, Any], idx: int) -> CaseSpec:
             setattr(spec, "shared_expert_x", shared_expert_x)
         except Exception:
             pass
+    # 附加可选字段：scales（模板 MoeDistributeDispatch 的可选输入，提供时 tiling key +10）
+    if scales is not None:
+        setattr(spec, "scales_shape", scales)
     return spec
 
 
@@ -490,31 +555,7 @@ def render_test_case_default(op_name: str, spec: CaseSpec, idx: int) -> str:
     lines.append("    auto tiling_func = gert::OpImplRegistry::GetInstance().GetOpImpl(op_type.c_str())->tiling;")
     lines.append("    auto tiling_parse_func = gert::OpImplRegistry::GetInstance().GetOpImpl(op_type.c_str())->tiling_parse;")
     lines.append("")
-    lines.append("    // 2. Setup compile info and platform info")
-    lines.append("    string compile_info_string = R\"(<LB>")
-    lines.append("        \"hardware_info\": <LB>")
-    lines.append("            \"BT_SIZE\": 1024,")
-    lines.append("            \"load3d_constraints\": \"0\",")
-    lines.append("            \"Intrinsic_fix_pipe_l0c2out\": true,")
-    lines.append("            \"Intrinsic_data_move_l12ub\": false,")
-    lines.append("            \"Intrinsic_data_move_l0c2ub\": false,")
-    lines.append("            \"Intrinsic_data_move_out2l1_nd2nz\": true,")
-    lines.append("            \"UB_SIZE\": 196608,")
-    lines.append("            \"L2_SIZE\": 33554432,")
-    lines.append("            \"L1_SIZE\": 524288,")
-    lines.append("            \"L0A_SIZE\": 65536,")
-    lines.append("            \"L0B_SIZE\": 65536,")
-    lines.append("            \"L0C_SIZE\": 131072,")
-    lines.append("            \"CORE_NUM\": 20")
-    lines.append("        <RB>")
-    lines.append("    <RB>)\";")
-    lines.append("    map<string, string> soc_infos;")
-    lines.append("    map<string, string> aicore_spec;")
-    lines.append("    map<string, string> intrinsics;")
-    lines.append("    GetPlatFormInfos(compile_info_string.c_str(), soc_infos, aicore_spec, intrinsics);")
-    lines.append("")
-    lines.append("    fe::PlatFormInfos platform_info;")
-    lines.append("    platform_info.Init();")
+    lines.extend(platform_setup_lines())
     lines.append(f"    struct {op_name}CompileInfo <LB><RB> compile_info;")
     lines.append("")
     lines.append("    // tilingParseFunc simulate")
@@ -569,10 +610,7 @@ def render_test_case_default(op_name: str, spec: CaseSpec, idx: int) -> str:
     lines.append("    ASSERT_NE(tiling_context->GetPlatformInfo(), nullptr);")
     lines.append("")
     lines.append("    // 7. Set Compile settings")
-    lines.append("    holder.GetContext<gert::TilingContext>()->GetPlatformInfo()->SetPlatformRes(\"SoCInfo\", soc_infos);")
-    lines.append("    holder.GetContext<gert::TilingContext>()->GetPlatformInfo()->SetPlatformRes(\"AICoreSpec\", aicore_spec);")
-    lines.append("    holder.GetContext<gert::TilingContext>()->GetPlatformInfo()->SetCoreNumByCoreType(\"AICore\");")
-    lines.append("    holder.GetContext<gert::TilingContext>()->GetPlatformInfo()->SetPlatformRes(\"AICoreintrinsicDtypeMap\", intrinsics);")
+    lines.extend(platform_apply_lines())
     lines.append("")
     lines.append("    // 8. Set communication")
     lines.append("    ge::HcomTopoInfo::TopoInfo topoInfo;")
@@ -600,21 +638,13 @@ def snake_from_camel(name: str) -> str:
     return s2.lower()
 
 
-def load_case_template_renderer(op_name: str) -> Any:
-    """按算子名加载可插拔模板模块，返回可调用的 render(op_name, spec, idx)。
+def resolve_case_template_path(op_name: str) -> Optional[Path]:
+    """按算子名解析模板文件路径，未找到返回 None。
 
     模板搜索顺序：
     1) $CASE_TEMPLATE_DIR/<CamelCase>.py
     2) $CASE_TEMPLATE_DIR/<snake_case>.py
     3) $CASE_TEMPLATE_DIR/default.py
-    若均不存在，回退内置默认实现。
-    
-    模板模块可导出：
-    - 函数 render_test_case(op_name, spec, idx, helpers)
-      或
-    - 类 Template，包含方法 render_test_case(self, op_name, spec, idx, helpers)
-    
-    helpers 提供常用工具：ensure_shapes, dtype_to_ge, logger。
     """
     # 解析模板目录：优先使用环境变量；若为相对路径，兼容 cwd 与脚本所在目录；最终回退脚本目录下的 case-templates
     env_dir = os.environ.get("CASE_TEMPLATE_DIR")
@@ -641,10 +671,8 @@ def load_case_template_renderer(op_name: str) -> Any:
             continue
 
     if base is None:
-        logger.warning("未找到模板目录，使用内置默认模板")
-        def _fallback(op: str, spec: CaseSpec, idx: int) -> str:
-            return render_test_case_default(op, spec, idx)
-        return _fallback
+        logger.warning("未找到模板目录")
+        return None
 
     candidates: List[Path] = []
     try:
@@ -658,10 +686,7 @@ def load_case_template_renderer(op_name: str) -> Any:
         candidates = []
 
     if not candidates:
-        # 返回内置默认
-        def _fallback(op: str, spec: CaseSpec, idx: int) -> str:
-            return render_test_case_default(op, spec, idx)
-        return _fallback
+        return None
 
     target = candidates[0]
     try:
@@ -670,70 +695,529 @@ def load_case_template_renderer(op_name: str) -> Any:
         logger.info(f"选用模板: {target}")
     except Exception:
         pass
+    return target
+
+
+# 已加载的模板模块：路径 -> ((mtime_ns, size), module)；文件未变化时直接复用（常驻进程内多次生成尤其受益）
+_template_modules: Dict[str, Tuple[Tuple[int, int], Any]] = {}
+
+
+def load_case_template_module(op_name: str) -> Any:
+    """加载算子对应的模板模块，失败返回 None。"""
+    target = resolve_case_template_path(op_name)
+    if target is None:
+        return None
     try:
+        stat = target.stat()
+        stamp = (stat.st_mtime_ns, stat.st_size)
+        cached = _template_modules.get(str(target))
+        if cached is not None and cached[0] == stamp:
+            return cached[1]
         spec_obj = importlib.util.spec_from_file_location(target.stem, str(target))
         if spec_obj and spec_obj.loader:
             module = importlib.util.module_from_spec(spec_obj)
             spec_obj.loader.exec_module(module)
+            _template_modules[str(target)] = (stamp, module)
+            return module
+    except Exception as e:
+        logger.warning(f"加载模板失败: {e}")
+    return None
+
 
-            helpers = {
-                "ensure_shapes": ensure_shapes,
-                "dtype_to_ge": dtype_to_ge,
-                "logger": logger,
-            }
-
-            # 函数导出
-            func = getattr(module, "render_test_case", None)
-            if callable(func):
-                def _call(op: str, s: CaseSpec, i: int) -> str:
-                    # 优先尝试四参
-                    try:
-                        return func(op, s, i, helpers)
-                    except TypeError:
-                        return func(op, s, i)
-                return _call
-
-            # 类导出
-            cls = getattr(module, "Template", None)
-            if cls is not None:
+def template_helpers() -> Dict[str, Any]:
+    """传给模板的常用工具：ensure_shapes, dtype_to_ge, logger, platform_setup_lines, platform_apply_lines。"""
+    return {
+        "ensure_shapes": ensure_shapes,
+        "dtype_to_ge": dtype_to_ge,
+        "logger": logger,
+        "platform_setup_lines": platform_setup_lines,
+        "platform_apply_lines": platform_apply_lines,
+    }
+
+
+def load_case_template_renderer(op_name: str) -> Any:
+    """按算子名加载可插拔模板模块，返回可调用的 render(op_name, spec, idx)。
+
+    模板搜索顺序见 resolve_case_template_path；若均不存在，回退内置默认实现。
+    
+    模板模块可导出：
+    - 函数 render_test_case(op_name, spec, idx, helpers)
+      或
+    - 类 Template，包含方法 render_test_case(self, op_name, spec, idx, helpers)
+    
+    helpers 提供常用工具：ensure_shapes, dtype_to_ge, logger，
+    以及 platform_setup_lines()/platform_apply_lines() 用于接入套件级平台信息缓存。
+    """
+    module = load_case_template_module(op_name)
+    if module is not None:
+        helpers = template_helpers()
+
+        # 函数导出
+        func = getattr(module, "render_test_case", None)
+        if callable(func):
+            def _call(op: str, s: CaseSpec, i: int) -> str:
+                # 优先尝试四参
                 try:
-                    inst = cls()
-                    method = getattr(inst, "render_test_case")
-                    if callable(method):
-                        def _call2(op: str, s: CaseSpec, i: int) -> str:
-                            try:
-                                return method(op, s, i, helpers)
-                            except TypeError:
-                                return method(op, s, i)
-                        return _call2
-                except Exception:
-                    pass
-    except Exception as e:
-        logger.warning(f"加载模板失败，使用默认模板: {e}")
+                    return func(op, s, i, helpers)
+                except TypeError:
+                    return func(op, s, i)
+            return _call
+
+        # 类导出
+        cls = getattr(module, "Template", None)
+        if cls is not None:
+            try:
+                inst = cls()
+                method = getattr(inst, "render_test_case")
+                if callable(method):
+                    def _call2(op: str, s: CaseSpec, i: int) -> str:
+                        try:
+                            return method(op, s, i, helpers)
+                        except TypeError:
+                            return method(op, s, i)
+                    return _call2
+            except Exception:
+                pass
+
+    logger.warning("未找到可用模板，使用内置默认模板")
 
     def _fallback(op: str, spec: CaseSpec, idx: int) -> str:
         return render_test_case_default(op, spec, idx)
     return _fallback
 
 
-def load_params(xlsx_path: Path) -> List[Dict[str, Any]]:
-    df = pd.read_excel(xlsx_path)
-    # 转换为字典列表，并保留原始列名
-    rows: List[Dict[str, Any]] = []
-    for _, r in df.iterrows():
-        row = {str(col): r[col] for col in df.columns}
-        rows.append(row)
-    return rows
+def load_param_suite(op_name: str) -> Optional[Tuple[ParamSuite, Any]]:
+    """加载模板的参数化描述，返回 (ParamSuite, values_fn)；模板未提供 PARAM_SUITE 时返回 None。
+
+    模板需导出：
+    - PARAM_SUITE: dict，结构见 param_harness 模块说明
+    - param_values(op_name, spec, idx, helpers) -> dict，字段名到取值，None 表示使用默认值
+    """
+    module = load_case_template_module(op_name)
+    if module is None:
+        return None
+    raw = getattr(module, "PARAM_SUITE", None)
+    func = getattr(module, "param_values", None)
+    if not isinstance(raw, dict) or not callable(func):
+        return None
+    suite = build_param_suite(op_name, raw)
+    helpers = {**template_helpers(), "dtype_to_ge": strict_dtype_to_ge}
+
+    def _values(op: str, s: CaseSpec, i: int) -> Dict[str, Any]:
+        return func(op, s, i, helpers)
+    return suite, _values
+
+
+# 按列批量解析的列：扫参表中取值高度重复，每批只对不重复的取值解析一次（见 param_reader.py）
+COLUMN_CONVERTERS = {
+    **{col: parse_shape for col in (
+        "x1_shape", "x_shape", "expand_x_shape", "x2_shape", "expert_ids_shape",
+        "gather_output_shape", "gather_out_shape", "output_shape", "x_output_shape", "output_x_shape",
+        "shared_expert_x_shape",
+    )},
+    "bias_shape": parse_shape1d,
+    "input_tensor_shape": parse_shape_list,
+    "input_tensor_dtype": parse_dtype_list,
+    "output_dtype": parse_dtype_list,
+}
+
+
+def load_params(xlsx_path: Path) -> ParamTable:
+    """参数表的惰性行视图（xlsx/csv/parquet），可重复迭代，空单元格为 None。"""
+    return ParamTable(xlsx_path, COLUMN_CONVERTERS)
+
+
+class TestfStream:
+    """
+    逐行渲染 TEST_F（未变化的行复用行级渲染缓存），渲染出的用例随即追加写入 spool 文件，内存中只保留各用例在文件中的偏移。
+    render_testf_mode 一次喂入全部行；stage 1 → stage 2 流水线（stream_pipeline.py）在模型每生成一行参数时喂入一行
+    （spool 为 <out>.partial，可 tail -f 查看）。finish 之后用 commit 把 spool 原子替换为输出文件，
+    需要整体改写（探针注入）或拆分（--shard）时用 read/cases 读回。spool_path 为空时写到临时目录。
+    """
+
+    def __init__(self, op_name: str, common_prefix: str, use_cache: bool = True,
+                 spool_path: Optional[Path] = None, linter: Optional[CaseLinter] = None):
+        self.op_name = op_name
+        self.common_prefix = common_prefix
+        self.linter = linter
+        self.cache = RenderCache(op_name, "testf", resolve_case_template_path(op_name), common_prefix, use_cache)
+        if spool_path is None:
+            fd, name = tempfile.mkstemp(prefix=f"{op_name.lower()}_", suffix=".cpp.tmp")
+            os.close(fd)
+            spool_path = Path(name)
+        self.spool_path = spool_path
+        self._renderer = None
+        self._spool = None
+        self.reset()
+
+    def reset(self):
+        """丢弃已渲染的用例（上游重新生成时调用）。"""
+        self.rows = 0
+        self.case_count = 0
+        self._offsets: List[Tuple[int, int]] = []
+        if self.linter is not None:
+            self.linter.reset()
+        if self._spool is not None:
+            self._spool.close()
+        self.spool_path.parent.mkdir(parents=True, exist_ok=True)
+        self._spool = open(self.spool_path, "wb")
+        self._spool.write(self.common_prefix.encode("utf-8"))
+        self._spool.flush()
+
+    def add(self, row: Dict[str, Any]) -> bool:
+        """渲染一行参数；该行无效时告警跳过并返回 False。"""
+        self.rows += 1
+        idx = self.rows
+        key = self.cache.key(row, case_name(row, idx))
+        case_code = self.cache.get_text(key)
+        if case_code is None:
+            # 选择模板渲染器（全部命中时无需加载模板）
+            if self._renderer is None:
+                self._renderer = load_case_template_renderer(self.op_name)
+            try:
+                spec = row_to_case(row, idx)
+                case_code = self._renderer(self.op_name, spec, idx)
+            except Exception as e:
+                logger.warning(f"跳过第{idx}行: {e}")
+                return False
+            self.cache.set_text(key, case_code)
+        if self.linter is not None:
+            case_code = self.linter.check(idx, case_code)
+            if case_code is None:
+                return False
+        data = case_code.encode("utf-8")
+        self._spool.write(b"\n\n")
+        start = self._spool.tell()
+        self._spool.write(data)
+        self._spool.flush()
+        self._offsets.append((start, len(data)))
+        self.case_count += 1
+        return True
+
+    def finish(self) -> bool:
+        """写完 spool（与 render_testf_mode 的文件内容一致）；没有任何用例时删除 spool 并返回 False。"""
+        self.cache.report(self.op_name)
+        if self.linter is not None:
+            self.linter.report(self.op_name)
+        if self._spool is not None:
+            self._spool.write(b"\n")
+            self._spool.close()
+            self._spool = None
+        if not self.case_count:
+            print("❌ 未能生成任何测试用例")
+            self.discard()
+            return False
+        return True
+
+    def read(self) -> str:
+        return self.spool_path.read_text(encoding="utf-8")
+
+    def cases(self) -> List[str]:
+        """按偏移逐个读回用例文本（分片输出用）。"""
+        out: List[str] = []
+        with open(self.spool_path, "rb") as f:
+            for start, size in self._offsets:
+                f.seek(start)
+                out.append(f.read(size).decode("utf-8"))
+        return out
+
+    def commit(self, out_path: Path) -> bool:
+        """spool 与磁盘上的输出一致时删除 spool、保留原文件时间戳；否则原子替换为输出文件。"""
+        try:
+            if out_path.is_file() and filecmp.cmp(self.spool_path, out_path, shallow=False):
+                logger.info(f"内容未变化，保留原文件: {out_path}")
+                self.discard()
+                return True
+            out_path.parent.mkdir(parents=True, exist_ok=True)
+            os.replace(self.spool_path, out_path)
+        except OSError as e:
+            # 临时目录与输出目录不在同一文件系统时无法 rename，退回到整体写出
+            if e.errno != errno.EXDEV:
+                print(f"❌ 写入失败: {out_path}: {e}")
+                self.discard()
+                return False
+            ok = write_output(self.read(), out_path)
+            self.discard()
+            return ok
+        logger.info(f"文件已保存: {out_path} ({out_path.stat().st_size:,} 字节)")
+        return True
+
+    def discard(self):
+        if self._spool is not None:
+            self._spool.close()
+            self._spool = None
+        try:
+            self.spool_path.unlink()
+        except OSError:
+            pass
+
+
+def spool_path_for(out_path: Path) -> Path:
+    return out_path.with_name(f".{out_path.name}.{os.getpid()}.tmp")
+
+
+def render_testf_stream(op_name: str, common_prefix: str, rows: Iterable[Dict[str, Any]],
+                        linter: Optional[CaseLinter] = None, spool_path: Optional[Path] = None,
+                        use_cache: bool = True) -> TestfStream:
+    """喂入全部行并 finish 后的 TestfStream；用例已写入 spool，由调用方 commit/read/cases/discard。"""
+    stream = TestfStream(op_name, common_prefix, use_cache, spool_path, linter=linter)
+    # 生成测例
+    for row in rows:
+        stream.add(row)
+    stream.finish()
+    return stream
+
+
+def render_testf_mode(op_name: str, common_prefix: str, rows: Iterable[Dict[str, Any]],
+                      linter: Optional[CaseLinter] = None, use_cache: bool = True) -> Optional[str]:
+    """每行参数渲染为一个 TEST_F；未变化的行复用行级渲染缓存，linter 非空时逐个用例做静态检查。"""
+    stream = render_testf_stream(op_name, common_prefix, rows, linter, use_cache=use_cache)
+    if not stream.case_count:
+        return None
+    content = stream.read()
+    stream.discard()
+    return content
+
+
+def _column_of_value(row: Dict[str, Any], value: Any) -> Optional[str]:
+    """出错取值所在的列：先找完全相同的单元格，再找包含该取值的单元格（如 dtype 列表）。"""
+    text = str(value).strip()
+    cells = [(k, str(v).strip()) for k, v in row.items() if v is not None]
+    for k, v in cells:
+        if v == text:
+            return k
+    return next((k for k, v in cells if text and text in v), None)
 
 
-def main():
+def build_param_rows(op_name: str, rows: Iterable[Dict[str, Any]], common_prefix: str = "",
+                     use_cache: bool = True) -> Optional[Tuple[ParamSuite, List[TestParamRow]]]:
+    """按模板的 PARAM_SUITE 将 xlsx 行转换为 TestParam 数据行；未变化的行复用行级渲染缓存。"""
+    try:
+        loaded = load_param_suite(op_name)
+    except ValueError as e:
+        print(f"❌ 模板 PARAM_SUITE 无效: {e}")
+        return None
+    if loaded is None:
+        print(f"❌ 算子 {op_name} 的模板未提供 PARAM_SUITE/param_values，无法使用参数化/运行时模式")
+        return None
+    suite, values_fn = loaded
+    cache = RenderCache(op_name, "param", resolve_case_template_path(op_name), common_prefix, use_cache)
+
+    param_rows: List[TestParamRow] = []
+    for idx, row in enumerate(rows, start=1):
+        key = cache.key(row, case_name(row, idx))
+        param_row = cache.get_param_row(key)
+        if param_row is None:
+            try:
+                spec = row_to_case(row, idx)
+                param_row = build_test_param(suite, spec, values_fn(op_name, spec, idx))
+            except UnknownDataTypeError as e:
+                column = _column_of_value(row, e.value)
+                where = f"第{idx}行" + (f" 列 {column}" if column else "")
+                print(f"❌ {where}: {e}")
+                return None
+            except Exception as e:
+                logger.warning(f"跳过第{idx}行: {e}")
+                continue
+            cache.set_param_row(key, param_row)
+        param_rows.append(param_row)
+    cache.report(op_name)
+
+    if not param_rows:
+        print("❌ 未能生成任何测试用例")
+        return None
+    return suite, param_rows
+
+
+def render_param_mode(op_name: str, common_prefix: str, rows: Iterable[Dict[str, Any]],
+                      linter: Optional[CaseLinter] = None, use_cache: bool = True) -> Optional[str]:
+    """所有行共用一个 TEST_P，每行参数仅作为 test_params[] 中的一条数据；linter 非空时逐条检查 TestParam 初始化项。"""
+    built = build_param_rows(op_name, rows, common_prefix, use_cache)
+    if built is None:
+        return None
+    suite, param_rows = built
+    if linter is None:
+        return render_param_file(common_prefix, suite, param_rows)
+    # TEST_P 函数体与 harness 由固定模板生成，只有每行的初始化项来自 xlsx；
+    # 属性来自 tiling_params 字段（字符串），只检查字面量与括号
+    row_linter = CaseLinter(None, linter.mode)
+    combined = render_param_file(
+        common_prefix, suite, param_rows,
+        lambda idx, row, text: row_linter.check(idx, text, label=f"第{idx}条 TestParam（{row.test_name}）"))
+    row_linter.report(op_name)
+    if combined is None:
+        print("❌ 所有 TestParam 均未通过静态检查")
+    return combined
+
+
+def build_case_linter(op_name: str, ref_content: str, mode: str = DEFAULT_LINT_MODE) -> Optional[CaseLinter]:
+    """按 --lint 构造用例静态检查器（见 case_lint.py）；off 时返回 None，模板 ATTR_SCHEMA 无效时抛 ValueError。"""
+    if mode == "off":
+        return None
+    schema, source = load_attr_schema(load_case_template_module(op_name), ref_content)
+    return CaseLinter(schema, mode, source)
+
+
+def build_common_prefix(ref_content: str, op_name: str) -> str:
+    """参考UT去掉全部 TEST_F 后的公共部分，并注入平台信息缓存。"""
+    # 完整移除 TEST_F，以尽量保留所有公共辅助代码
+    common_full = strip_all_testf_blocks(ref_content)
+    common_prefix = extract_common_prefix(common_full)
+    # compile_info/平台信息在整个文件内只解析一次，模板可通过 HARDWARE_INFO 覆盖硬件参数
+    template_module = load_case_template_module(op_name)
+    return inject_platform_cache(common_prefix, getattr(template_module, "HARDWARE_INFO", None))
+
+
+def write_output(content: str, out_path: Path) -> bool:
+    """内容与磁盘上一致时不重写（保留时间戳，增量编译不会重编该文件）；否则写临时文件后原子替换。"""
+    data = content.encode("utf-8")
+    try:
+        if out_path.is_file() and out_path.stat().st_size == len(data) and out_path.read_bytes() == data:
+            logger.info(f"内容未变化，保留原文件: {out_path}")
+            return True
+    except OSError:
+        pass
+    tmp_path = out_path.with_name(f".{out_path.name}.{os.getpid()}.tmp")
+    try:
+        out_path.parent.mkdir(parents=True, exist_ok=True)
+        tmp_path.write_bytes(data)
+        os.replace(tmp_path, out_path)
+    except OSError as e:
+        print(f"❌ 写入失败: {out_path}: {e}")
+        try:
+            tmp_path.unlink()
+        except OSError:
+            pass
+        return False
+    logger.info(f"文件已保存: {out_path} ({len(content):,} 字符)")
+    return True
+
+
+def write_shard_output(common_prefix: str, cases: List[str], out_path: Path, shard_size: int) -> bool:
+    """按 --shard 写出公共头、各分片与 CMake 片段，删除多余的旧分片；内容未变的文件不重写。"""
+    layout = render_shard_layout(common_prefix, cases, out_path, shard_size)
+    if layout.linkage_fixes:
+        logger.info(f"公共部分 {layout.linkage_fixes} 处定义补 inline/static，可被多个分片 include")
+    for path, content in layout.files.items():
+        if not write_output(content, path):
+            return False
+    for path in stale_shards(out_path, layout.shard_count):
+        try:
+            path.unlink()
+            logger.info(f"🧹 删除多余的旧分片: {path}")
+        except OSError as e:
+            logger.warning(f"无法删除旧分片 {path}: {e}")
+    return True
+
+
+def apply_tiling_probes(content: str, op_name: str, out_path: Path, alloc: bool, golden: Optional[str],
+                        golden_file: Optional[str], score: bool, check_buffers: bool) -> Optional[str]:
+    """按 --alloc-probe/--golden/--score/--check-buffers 收集探针并单遍注入；模板布局/角色无效时返回 None。"""
+    probes: List[TilingProbe] = []
+    if alloc:
+        probes.append(alloc_probe(out_path.stem))
+    if golden or score or check_buffers:
+        module = load_case_template_module(op_name)
+    if golden:
+        # 模板可通过 TILING_DATA_FIELDS 提供字段布局
+        try:
+            layout = build_tiling_layout(getattr(module, "TILING_DATA_FIELDS", None))
+        except ValueError as e:
+            print(f"❌ 模板 TILING_DATA_FIELDS 无效: {e}")
+            return None
+        probes.append(golden_probe(golden_file or golden_default_path(out_path.stem), golden, layout))
+    if score or check_buffers:
+        try:
+            spec = load_score_spec(module)
+        except ValueError as e:
+            print(f"❌ 模板 TILING_ROLES/TILING_SCORE 无效: {e}")
+            return None
+        if spec is None:
+            print(f"⚠️ 模板未提供 TILING_ROLES，跳过耗时估计/缓冲区检查: {op_name}")
+        else:
+            if score:
+                probes.append(score_probe(spec, out_path.stem))
+            if check_buffers:
+                probes.append(buffer_probe(spec, out_path.stem))
+    return inject_probes(content, probes)
+
+
+def run_runtime_mode(op_name: str, common_prefix: str, rows: Iterable[Dict[str, Any]],
+                     out_path: Path, cases_out: Optional[str], cases_only: bool,
+                     alloc_probe: bool = False, golden: Optional[str] = None,
+                     golden_file: Optional[str] = None, score: bool = False,
+                     check_buffers: bool = False, use_cache: bool = True) -> int:
+    """生成运行时驱动（只需编译一次）与用例表；cases_only 时仅刷新用例表，无需重新编译。"""
+    built = build_param_rows(op_name, rows, common_prefix, use_cache)
+    if built is None:
+        return 1
+    suite, param_rows = built
+
+    if cases_only:
+        cases_path = Path(cases_out).resolve() if cases_out else out_path
+    else:
+        cases_path = Path(cases_out).resolve() if cases_out else out_path.with_name(f"{out_path.stem}_cases.csv")
+    if not write_output(render_case_table(suite, param_rows), cases_path):
+        return 1
+    print(f"✅ 用例表写入完成: {cases_path} ({len(param_rows)} 条)")
+    if cases_only:
+        return 0
+
+    driver = render_runtime_file(common_prefix, suite, str(cases_path.resolve()))
+    driver = apply_tiling_probes(driver, op_name, out_path, alloc_probe, golden, golden_file, score, check_buffers)
+    if driver is None:
+        return 1
+    if not write_output(driver, out_path):
+        return 1
+    print(f"✅ 运行时驱动写入完成: {out_path}（运行时可通过 UTGEN_CASE_FILE 指定用例表）")
+    return 0
+
+
+def main(argv: Optional[List[str]] = None):
     parser = argparse.ArgumentParser(description="从参考UT和xlsx参数生成gtest单测（纯工程方案）")
     parser.add_argument("--ref", required=True, help="参考UT cpp文件路径（包含完整公共代码与若干TEST_F）")
-    parser.add_argument("--xlsx", required=True, help="xlsx参数文件路径")
+    parser.add_argument("--xlsx", required=True, help="参数表路径（xlsx，也支持 csv/parquet/arrow）")
     parser.add_argument("--op", default=None, help="算子名称（如 AllGatherMatmul），可选，默认自动推断")
     parser.add_argument("--out", default=None, help="输出单文件路径，默认写入 runs/<ts>_<op>/test_<op>_tiling.cpp")
     parser.add_argument("--name-col", default=None, help="测试名称列名，默认自动在 test_name/name 中选择")
-    args = parser.parse_args()
+    parser.add_argument("--mode", choices=["testf", "param", "runtime", "cases"], default="testf",
+                        help="输出形式：testf 每行一个 TEST_F；param 生成单个 TEST_P + test_params[] 数据表；"
+                             "runtime 生成运行时加载用例表的驱动及用例表；cases 仅生成用例表（后三者需模板提供 PARAM_SUITE）")
+    parser.add_argument("--bench", action="store_true",
+                        help="额外在输出文件旁生成 bench_<op>_tiling.cpp（Google Benchmark，仅计时 tiling_func，需模板提供 PARAM_SUITE）")
+    parser.add_argument("--alloc-probe", action="store_true",
+                        help="注入全局 new/delete 与 malloc 钩子，统计每次 tiling_func 调用的分配次数、字节与峰值，输出 <stem>_alloc.json")
+    parser.add_argument("--golden", choices=["record", "compare"], default=None,
+                        help="注入 TilingData 黄金快照：record 写出快照，compare 与快照逐字段比对（运行时可用 UTGEN_GOLDEN_MODE 覆盖）")
+    parser.add_argument("--golden-file", default=None,
+                        help="快照文件路径（相对运行目录），默认 <stem>_golden.bin，运行时可用 UTGEN_GOLDEN_FILE 覆盖")
+    parser.add_argument("--score", action="store_true",
+                        help="注入 tiling 耗时估计（roofline + 通信掩盖），逐用例输出预测耗时到 <stem>_perf.csv，需模板提供 TILING_ROLES")
+    parser.add_argument("--check-buffers", action="store_true",
+                        help="注入片上缓冲区占用与核利用率检查，超出 hardware_info 预算即失败，输出 <stem>_buffer.csv，需模板提供 TILING_ROLES")
+    parser.add_argument("--stress", action="store_true",
+                        help="额外在输出文件旁生成 stress_<op>_tiling.cpp（多线程并发执行用例并与单线程基线比对，需模板提供 PARAM_SUITE）")
+    parser.add_argument("--sweep", default=None, metavar="GRID_JSON",
+                        help="额外在输出文件旁生成 sweep_<op>_tiling.cpp（多线程遍历参数网格，统计 tiling key 覆盖，需模板提供 PARAM_SUITE）")
+    parser.add_argument("--no-render-cache", action="store_true",
+                        help="不使用行级渲染缓存，所有行重新渲染")
+    parser.add_argument("--lint", choices=LINT_MODES, default=DEFAULT_LINT_MODE,
+                        help="写入前对每个 TEST_F 做静态检查（Python 字面量、括号、属性表）：repair 修复可修的、丢弃其余；"
+                             "reject 有问题即丢弃；warn 只告警；off 不检查（见 case_lint.py）")
+    parser.add_argument("--shard", type=int, default=0, metavar="N",
+                        help="testf 模式按每片至多 N 个 TEST_F 分片输出（按 TEST_F 名哈希分配）：<stem>_common.h + "
+                             "<stem>_shard_NNN.cpp + <stem>_shards.cmake（替代单文件，见 shard_layout.py）")
+    parser.add_argument("--cases-out", default=None,
+                        help="runtime/cases 模式的用例表路径，默认与 --out 同目录的 <stem>_cases.csv")
+    args = parser.parse_args(argv)
+
+    if args.shard < 0:
+        print(f"❌ --shard 必须为正整数: {args.shard}")
+        return 1
+    if args.shard and (args.mode != "testf" or args.alloc_probe or args.golden or args.score or args.check_buffers):
+        # 注入的全局钩子与汇总输出只能出现在一个翻译单元
+        print("❌ --shard 仅支持 testf 模式，且不能与 --alloc-probe/--golden/--score/--check-buffers 同时使用")
+        return 1
 
     ref_path = Path(args.ref).resolve()
     xlsx_path = Path(args.xlsx).resolve()
@@ -746,65 +1230,118 @@ def main():
 
     ref_content = read_text(ref_path)
 
-    # 完整移除 TEST_F，以尽量保留所有公共辅助代码
-    common_full = strip_all_testf_blocks(ref_content)
-    common_prefix = extract_common_prefix(common_full)
-
     op_name = args.op or infer_operator_name(ref_path, ref_content)
     if not op_name:
         print("❌ 无法推断算子名称，请使用 --op 指定")
         return 1
+    common_prefix = build_common_prefix(ref_content, op_name)
+    try:
+        linter = build_case_linter(op_name, ref_content, args.lint)
+    except ValueError as e:
+        print(f"❌ 模板 ATTR_SCHEMA 无效: {e}")
+        return 1
 
     try:
         rows = load_params(xlsx_path)
+        empty = rows.is_empty()
     except Exception as e:
         print(f"❌ 读取xlsx失败: {e}")
         return 1
 
-    if not rows:
+    if empty:
         print("❌ xlsx为空，无测试参数")
         return 1
 
-    # 选择模板渲染器
-    renderer = load_case_template_renderer(op_name)
+    if args.mode in ("runtime", "cases"):
+        if args.out:
+            out_path = Path(args.out).resolve()
+        else:
+            run_dir = create_timestamped_dir(op_name.lower(), str(Path("runs")))
+            suffix = "_cases.csv" if args.mode == "cases" else "_tiling_runtime.cpp"
+            out_path = run_dir / f"test_{op_name.lower()}{suffix}"
+        return run_runtime_mode(op_name, common_prefix, rows, out_path, args.cases_out, args.mode == "cases",
+                                args.alloc_probe, args.golden, args.golden_file, args.score,
+                                args.check_buffers, not args.no_render_cache)
+
+    use_cache = not args.no_render_cache
+    # 输出目标：默认 runs 目录
+    if args.out:
+        out_path = Path(args.out).resolve()
+    else:
+        run_dir = create_timestamped_dir(op_name.lower(), str(Path("runs")))
+        out_path = run_dir / f"test_{op_name.lower()}_tiling.cpp"
+    probed = args.alloc_probe or args.golden or args.score or args.check_buffers
 
-    # 生成测例
-    cases: List[str] = []
-    for idx, row in enumerate(rows, start=1):
+    if args.mode == "param":
+        combined = render_param_mode(op_name, common_prefix, rows, linter, use_cache)
+        if combined is None:
+            return 1
+        combined = apply_tiling_probes(combined, op_name, out_path, args.alloc_probe, args.golden,
+                                       args.golden_file, args.score, args.check_buffers)
+        if combined is None or not write_output(combined, out_path):
+            return 1
+        print(f"✅ 单测生成完成: {out_path}")
+    else:
+        # 用例逐个写入输出目录下的 spool，不在内存中累积
+        stream = render_testf_stream(op_name, common_prefix, rows, linter, spool_path_for(out_path), use_cache)
+        if not stream.case_count:
+            return 1
+        if args.shard:
+            ok = write_shard_output(common_prefix, stream.cases(), out_path, args.shard)
+            stream.discard()
+            if not ok:
+                return 1
+            print(f"✅ 单测分片生成完成: {out_path.parent}/{out_path.stem}_shard_*.cpp"
+                  f"（{stream.case_count} 个用例，每片至多 {args.shard} 个）")
+        elif probed:
+            # 探针注入需要改写整个文件
+            combined = apply_tiling_probes(stream.read(), op_name, out_path, args.alloc_probe, args.golden,
+                                           args.golden_file, args.score, args.check_buffers)
+            stream.discard()
+            if combined is None or not write_output(combined, out_path):
+                return 1
+            print(f"✅ 单测生成完成: {out_path}")
+        else:
+            if not stream.commit(out_path):
+                return 1
+            print(f"✅ 单测生成完成: {out_path}")
+
+    if args.bench or args.stress:
+        built = build_param_rows(op_name, rows, common_prefix, use_cache)
+        if built is None:
+            print("⚠️ 跳过基准/压力测试文件生成")
+            return 0
+        suite, param_rows = built
+        if args.bench:
+            bench_path = out_path.with_name(f"{bench_file_stem(op_name)}.cpp")
+            if not write_output(render_bench_file(common_prefix, suite, param_rows), bench_path):
+                return 1
+            print(f"✅ 基准文件生成完成: {bench_path}")
+        if args.stress:
+            stress_path = out_path.with_name(f"{stress_file_stem(op_name)}.cpp")
+            if not write_output(render_stress_file(common_prefix, suite, param_rows), stress_path):
+                return 1
+            print(f"✅ 压力测试文件生成完成: {stress_path}")
+
+    if args.sweep:
+        loaded = load_param_suite(op_name)
+        if loaded is None:
+            print(f"⚠️ 模板未提供 PARAM_SUITE，跳过扫参文件生成: {op_name}")
+            return 0
         try:
-            spec = row_to_case(row, idx)
-            case_code = renderer(op_name, spec, idx)
-            cases.append(case_code)
+            grid = load_sweep_grid(Path(args.sweep), loaded[0])
         except Exception as e:
-            logger.warning(f"跳过第{idx}行: {e}")
-            continue
-
-    if not cases:
-        print("❌ 未能生成任何测试用例")
-        return 1
-
-    combined = common_prefix + "\n\n" + "\n\n".join(cases) + "\n"
-
-    # 输出目标
-    if args.out:
-        out_path = Path(args.out).resolve()
-        out_path.parent.mkdir(parents=True, exist_ok=True)
-        ok = save_file_content(combined, str(out_path))
-        if not ok:
-            print(f"❌ 写入失败: {out_path}")
+            print(f"❌ 读取扫参网格失败: {e}")
             return 1
-        print(f"✅ 写入完成: {out_path}")
-        return 0
-
-    # 默认 runs 目录
-    runs_dir = Path("runs")
-    run_dir = create_timestamped_dir(op_name.lower(), str(runs_dir))
-    out_path = run_dir / f"test_{op_name.lower()}_tiling.cpp"
-    ok = save_file_content(combined, str(out_path))
-    if not ok:
-        print(f"❌ 写入失败: {out_path}")
-        return 1
-    print(f"✅ 单测生成完成: {out_path}")
+        try:
+            score = load_score_spec(load_case_template_module(op_name))
+        except ValueError as e:
+            print(f"⚠️ 模板 TILING_ROLES 无效，扫参不汇总预测耗时: {e}")
+            score = None
+        sweep_path = out_path.with_name(f"{sweep_file_stem(op_name)}.cpp")
+        if not write_output(render_sweep_file(common_prefix, loaded[0], grid, score), sweep_path):
+            return 1
+        print(f"✅ 扫参文件生成完成: {sweep_path}（{grid.total} 个网格点）")
     return 0
 
 
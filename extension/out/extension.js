@@ -136,6 +136,8 @@ async function runStage1(panel, context, payload) {
     // 配置项：是否使用虚拟环境
     const useVenv = getConfig('useVirtualEnv', true);
     const venvPath = getConfig('venvPath', '.venv');
+    // 配置项：是否通过常驻服务（utgen_daemon.py）执行，避免每次运行重复启动 Python 与导入依赖
+    const useDaemon = getConfig('useDaemon', true) && process.platform !== 'win32';
     // 计算脚本路径：优先使用设置项；若为空则使用扩展父目录的 entrypoint.sh
     const extensionParentDir = path.dirname(context.extensionPath);
     const configuredScriptPath = getConfig('defaultScriptPath', '');
@@ -196,12 +198,14 @@ async function runStage1(panel, context, payload) {
             // macOS/Linux: 使用 bash
             command = '/bin/bash';
             const cdCmd = workspaceFolder ? `cd "${workspaceFolder}" && ` : '';
+            // 常驻服务已在运行时 start 立即返回；启动失败不影响后续流程（workflow.sh 会回退为直接执行）
+            const daemonCmd = useDaemon ? `python3 "${path.join(extensionParentDir, 'utgen_daemon.py')}" start >/dev/null 2>&1; ` : '';
             if (venvExists) {
-                commandArgs = ['-c', `source "${activateScript}" && ${cdCmd}"${scriptPath}" "${payload.operatorName}" ${payload.fewshotFile ? `"${toAbsolute(payload.fewshotFile, workspaceFolder)}"` : ''} ${payload.sourcePaths.map(p => `"${toAbsolute(p, workspaceFolder)}"`).join(' ')}`];
+                commandArgs = ['-c', `source "${activateScript}" && ${daemonCmd}${cdCmd}"${scriptPath}" "${payload.operatorName}" ${payload.fewshotFile ? `"${toAbsolute(payload.fewshotFile, workspaceFolder)}"` : ''} ${payload.sourcePaths.map(p => `"${toAbsolute(p, workspaceFolder)}"`).join(' ')}`];
             }
             else {
                 // 如果虚拟环境不存在，直接执行脚本（脚本内部会尝试激活）
-                commandArgs = ['-c', `${cdCmd}"${scriptPath}" "${payload.operatorName}" ${payload.fewshotFile ? `"${toAbsolute(payload.fewshotFile, workspaceFolder)}"` : ''} ${payload.sourcePaths.map(p => `"${toAbsolute(p, workspaceFolder)}"`).join(' ')}`];
+                commandArgs = ['-c', `${daemonCmd}${cdCmd}"${scriptPath}" "${payload.operatorName}" ${payload.fewshotFile ? `"${toAbsolute(payload.fewshotFile, workspaceFolder)}"` : ''} ${payload.sourcePaths.map(p => `"${toAbsolute(p, workspaceFolder)}"`).join(' ')}`];
             }
         }
         if (!venvExists) {
@@ -226,7 +230,10 @@ async function runStage1(panel, context, payload) {
     const proc = (0, child_process_1.spawn)(command, commandArgs, {
         cwd: extensionParentDir, // utgen-v2 目录
         shell: false,
-        env: { ...process.env }
+        env: {
+            ...process.env,
+            ...(useDaemon ? {} : { UTGEN_DAEMON: '0' })
+        }
     });
     proc.stdout.on('data', (data) => {
         panel.webview.postMessage({ type: 'log', text: data.toString() });
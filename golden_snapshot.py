@@ -0,0 +1,623 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+TilingData 黄金快照（可选注入）：
+- 生成文件中的 tiling_func(tiling_context) 改写为 utgen_golden::Capture(tiling_func(tiling_context), tiling_context)，
+  每次调用后取出 TilingData 原始字节、workspace 大小、block dim、tiling key 与返回状态
+- record：进程退出时写二进制快照文件；compare：mmap 打开快照，按用例名哈希二分查找，
+  先整体 memcmp，不一致时才逐字段生成差异报告（ADD_FAILURE）
+- 模板可导出 TILING_DATA_FIELDS = [(字段名, C++类型[, 元素个数]), ...] 描述 TilingData 布局（按自然对齐排布），
+  差异按字段名与取值报告；未提供时按 4 字节字退化为偏移报告
+- 运行时可通过环境变量 UTGEN_GOLDEN_MODE（record/compare）与 UTGEN_GOLDEN_FILE 覆盖生成时的设置
+
+快照文件格式（小端）：
+  header  : magic "UTGOLD01" | uint32 version | uint32 entry_count | uint64 blob_offset
+  entries : entry_count 条定长记录，按 (name_hash, name) 排序
+            uint64 name_hash | uint64 tiling_key | uint32 name_offset | uint32 name_len
+            uint32 data_offset | uint32 data_size | uint32 ws_offset | uint32 ws_count
+            uint32 block_dim | int32 status
+  blob    : 用例名、TilingData 字节与 workspace 大小（uint64 数组，8 字节对齐）
+
+也可离线比较两份快照：
+  python3 golden_snapshot.py diff old.bin new.bin [--op AllGatherMatmul]
+"""
+
+from __future__ import annotations
+
+import argparse
+import mmap
+import struct
+from dataclasses import dataclass
+from pathlib import Path
+from typing import Any, Dict, List, Optional, Sequence, Tuple
+
+from tiling_layouts import TilingProbe
+
+
+GOLDEN_MARKER = "namespace utgen_golden"
+GOLDEN_MAGIC = b"UTGOLD01"
+GOLDEN_VERSION = 1
+HEADER_FORMAT = "<8sIIQ"
+ENTRY_FORMAT = "<QQIIIIIIIi"
+MAX_DIFFS_PER_CASE = 16
+
+# C++ 类型 -> (字节数, 种类)，种类 u/i/f 决定差异报告中的取值解释方式
+FIELD_CTYPES = {
+    "uint8_t": (1, "u"),
+    "int8_t": (1, "i"),
+    "uint16_t": (2, "u"),
+    "int16_t": (2, "i"),
+    "uint32_t": (4, "u"),
+    "int32_t": (4, "i"),
+    "uint64_t": (8, "u"),
+    "int64_t": (8, "i"),
+    "float": (4, "f"),
+    "double": (8, "f"),
+}
+
+
+@dataclass
+class TilingField:
+    name: str
+    offset: int
+    size: int
+    kind: str
+
+
+@dataclass
+class SnapshotEntry:
+    name: str
+    tiling_key: int
+    block_dim: int
+    status: int
+    data: bytes
+    workspaces: List[int]
+
+
+def golden_default_path(stem: str) -> str:
+    return f"{stem}_golden.bin"
+
+
+def build_tiling_layout(raw: Optional[Sequence[Any]]) -> List[TilingField]:
+    """把模板的 TILING_DATA_FIELDS 展开为带偏移的字段表，数组字段展开为 name[i]。"""
+    if not raw:
+        return []
+    layout: List[TilingField] = []
+    offset = 0
+    for item in raw:
+        if not isinstance(item, (list, tuple)) or len(item) not in (2, 3):
+            raise ValueError(f"TILING_DATA_FIELDS 条目格式错误: {item!r}")
+        name, ctype = str(item[0]), str(item[1])
+        count = int(item[2]) if len(item) == 3 else 1
+        if ctype not in FIELD_CTYPES:
+            raise ValueError(f"TILING_DATA_FIELDS 不支持的类型: {name} {ctype}")
+        size, kind = FIELD_CTYPES[ctype]
+        offset = (offset + size - 1) // size * size
+        for i in range(count):
+            label = f"{name}[{i}]" if count > 1 else name
+            layout.append(TilingField(label, offset, size, kind))
+            offset += size
+    return layout
+
+
+def render_golden_store(default_path: str, default_mode: str, layout: List[TilingField]) -> str:
+    out: List[str] = []
+    out.append("#include <fcntl.h>")
+    out.append("#include <sys/mman.h>")
+    out.append("#include <sys/stat.h>")
+    out.append("#include <unistd.h>")
+    out.append("#include <algorithm>")
+    out.append("#include <cstdint>")
+    out.append("#include <cstdlib>")
+    out.append("#include <cstring>")
+    out.append("#include <fstream>")
+    out.append("#include <iostream>")
+    out.append("#include <map>")
+    out.append("#include <mutex>")
+    out.append("#include <sstream>")
+    out.append("#include <string>")
+    out.append("#include <vector>")
+    out.append("#include <gtest/gtest.h>")
+    out.append("")
+    out.append("namespace utgen_golden {")
+    out.append("#pragma pack(push, 1)")
+    out.append("struct FileHeader {")
+    out.append("    char magic[8];")
+    out.append("    uint32_t version;")
+    out.append("    uint32_t entry_count;")
+    out.append("    uint64_t blob_offset;")
+    out.append("};")
+    out.append("")
+    out.append("struct FileEntry {")
+    out.append("    uint64_t name_hash;")
+    out.append("    uint64_t tiling_key;")
+    out.append("    uint32_t name_offset;")
+    out.append("    uint32_t name_len;")
+    out.append("    uint32_t data_offset;")
+    out.append("    uint32_t data_size;")
+    out.append("    uint32_t ws_offset;")
+    out.append("    uint32_t ws_count;")
+    out.append("    uint32_t block_dim;")
+    out.append("    int32_t status;")
+    out.append("};")
+    out.append("#pragma pack(pop)")
+    out.append("")
+    out.append("struct FieldDesc {")
+    out.append("    const char* name;")
+    out.append("    uint32_t offset;")
+    out.append("    uint32_t size;")
+    out.append("    char kind;")
+    out.append("};")
+    out.append("")
+    if layout:
+        out.append("static const FieldDesc kTilingFields[] = {")
+        out.append(",\n".join(
+            f"    {{\"{f.name}\", {f.offset}, {f.size}, '{f.kind}'}}" for f in layout
+        ))
+        out.append("};")
+        out.append("static const size_t kTilingFieldNum = sizeof(kTilingFields) / sizeof(kTilingFields[0]);")
+    else:
+        out.append("static const FieldDesc* const kTilingFields = nullptr;")
+        out.append("static const size_t kTilingFieldNum = 0;")
+    out.append(f"static const size_t kMaxDiffsPerCase = {MAX_DIFFS_PER_CASE};")
+    out.append("")
+    out.append("inline uint64_t HashName(const std::string& name)")
+    out.append("{")
+    out.append("    uint64_t hash = 1469598103934665603ULL;")
+    out.append("    for (unsigned char c : name) {")
+    out.append("        hash = (hash ^ c) * 1099511628211ULL;")
+    out.append("    }")
+    out.append("    return hash;")
+    out.append("}")
+    out.append("")
+    out.append("struct Record {")
+    out.append("    std::string name;")
+    out.append("    uint64_t tiling_key;")
+    out.append("    uint32_t block_dim;")
+    out.append("    int32_t status;")
+    out.append("    std::vector<uint8_t> data;")
+    out.append("    std::vector<uint64_t> workspaces;")
+    out.append("};")
+    out.append("")
+    out.append("// 按字段（无布局时按 4 字节字）读取 TilingData 中的取值，越界部分视为缺失")
+    out.append("inline std::string FieldValue(const uint8_t* data, size_t size, uint32_t offset, uint32_t width, char kind)")
+    out.append("{")
+    out.append("    if (offset + width > size) {")
+    out.append("        return \"<none>\";")
+    out.append("    }")
+    out.append("    uint64_t bits = 0;")
+    out.append("    std::memcpy(&bits, data + offset, width);")
+    out.append("    std::ostringstream os;")
+    out.append("    if (kind == 'f' && width == 4) {")
+    out.append("        float value;")
+    out.append("        std::memcpy(&value, data + offset, 4);")
+    out.append("        os << value;")
+    out.append("    } else if (kind == 'f' && width == 8) {")
+    out.append("        double value;")
+    out.append("        std::memcpy(&value, data + offset, 8);")
+    out.append("        os << value;")
+    out.append("    } else if (kind == 'i') {")
+    out.append("        int shift = static_cast<int>(64 - width * 8);")
+    out.append("        os << (shift > 0 ? (static_cast<int64_t>(bits << shift) >> shift) : static_cast<int64_t>(bits));")
+    out.append("    } else {")
+    out.append("        os << bits;")
+    out.append("    }")
+    out.append("    return os.str();")
+    out.append("}")
+    out.append("")
+    out.append("inline bool RangeDiffers(const uint8_t* lhs, size_t lhs_size, const uint8_t* rhs, size_t rhs_size,")
+    out.append("                         uint32_t offset, uint32_t width)")
+    out.append("{")
+    out.append("    bool lhs_in = offset + width <= lhs_size;")
+    out.append("    bool rhs_in = offset + width <= rhs_size;")
+    out.append("    if (lhs_in != rhs_in) {")
+    out.append("        return true;")
+    out.append("    }")
+    out.append("    return lhs_in && std::memcmp(lhs + offset, rhs + offset, width) != 0;")
+    out.append("}")
+    out.append("")
+    out.append("// 字段级差异：先按布局表逐字段比较，布局未覆盖的尾部按 4 字节字比较")
+    out.append("inline void DiffTilingData(const uint8_t* golden, size_t golden_size, const uint8_t* actual, size_t actual_size,")
+    out.append("                           std::vector<std::string>& diffs)")
+    out.append("{")
+    out.append("    uint32_t covered = 0;")
+    out.append("    for (size_t i = 0; i < kTilingFieldNum && diffs.size() < kMaxDiffsPerCase; ++i) {")
+    out.append("        const FieldDesc& field = kTilingFields[i];")
+    out.append("        covered = std::max(covered, field.offset + field.size);")
+    out.append("        if (RangeDiffers(golden, golden_size, actual, actual_size, field.offset, field.size)) {")
+    out.append("            diffs.push_back(std::string(field.name) + \": \" +")
+    out.append("                            FieldValue(golden, golden_size, field.offset, field.size, field.kind) + \" -> \" +")
+    out.append("                            FieldValue(actual, actual_size, field.offset, field.size, field.kind));")
+    out.append("        }")
+    out.append("    }")
+    out.append("    size_t end = std::max(golden_size, actual_size);")
+    out.append("    for (uint32_t offset = covered; offset < end && diffs.size() < kMaxDiffsPerCase; offset += 4) {")
+    out.append("        uint32_t width = static_cast<uint32_t>(std::min<size_t>(4, end - offset));")
+    out.append("        if (RangeDiffers(golden, golden_size, actual, actual_size, offset, width)) {")
+    out.append("            std::ostringstream os;")
+    out.append("            os << \"data+0x\" << std::hex << offset << std::dec << \": \"")
+    out.append("               << FieldValue(golden, golden_size, offset, width, 'u') << \" -> \"")
+    out.append("               << FieldValue(actual, actual_size, offset, width, 'u');")
+    out.append("            diffs.push_back(os.str());")
+    out.append("        }")
+    out.append("    }")
+    out.append("}")
+    out.append("")
+    out.append("class Store {")
+    out.append("public:")
+    out.append("    static Store& Get()")
+    out.append("    {")
+    out.append("        static Store instance;")
+    out.append("        return instance;")
+    out.append("    }")
+    out.append("")
+    out.append("    void Handle(Record record)")
+    out.append("    {")
+    out.append("        std::lock_guard<std::mutex> lock(mutex_);")
+    out.append("        // 同一用例内多次调用 tiling_func 时，以 #序号 区分")
+    out.append("        int seq = call_seq_[record.name]++;")
+    out.append("        if (seq > 0) {")
+    out.append("            record.name += \"#\" + std::to_string(seq);")
+    out.append("        }")
+    out.append("        if (recording_) {")
+    out.append("            records_.push_back(std::move(record));")
+    out.append("            return;")
+    out.append("        }")
+    out.append("        Compare(record);")
+    out.append("    }")
+    out.append("")
+    out.append("    ~Store()")
+    out.append("    {")
+    out.append("        if (recording_) {")
+    out.append("            Write();")
+    out.append("        } else if (base_ != nullptr) {")
+    out.append("            std::cout << \"[golden] compared \" << compared_ << \" cases against \" << path_ << \": \" << mismatched_")
+    out.append("                      << \" mismatched, \" << missing_ << \" without golden entry\" << std::endl;")
+    out.append("            munmap(const_cast<uint8_t*>(base_), length_);")
+    out.append("        }")
+    out.append("    }")
+    out.append("")
+    out.append("private:")
+    out.append("    Store()")
+    out.append("    {")
+    out.append("        const char* env_path = std::getenv(\"UTGEN_GOLDEN_FILE\");")
+    out.append(f"        path_ = (env_path != nullptr && *env_path != '\\0') ? env_path : \"{default_path}\";")
+    out.append("        const char* env_mode = std::getenv(\"UTGEN_GOLDEN_MODE\");")
+    out.append(f"        std::string mode = (env_mode != nullptr && *env_mode != '\\0') ? env_mode : \"{default_mode}\";")
+    out.append("        recording_ = mode == \"record\";")
+    out.append("        if (!recording_) {")
+    out.append("            Map();")
+    out.append("        }")
+    out.append("    }")
+    out.append("")
+    out.append("    void Map()")
+    out.append("    {")
+    out.append("        int fd = open(path_.c_str(), O_RDONLY);")
+    out.append("        if (fd < 0) {")
+    out.append("            load_error_ = \"cannot open golden file \" + path_;")
+    out.append("            return;")
+    out.append("        }")
+    out.append("        struct stat st;")
+    out.append("        if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(FileHeader)) {")
+    out.append("            close(fd);")
+    out.append("            load_error_ = \"golden file too small: \" + path_;")
+    out.append("            return;")
+    out.append("        }")
+    out.append("        length_ = static_cast<size_t>(st.st_size);")
+    out.append("        void* addr = mmap(nullptr, length_, PROT_READ, MAP_PRIVATE, fd, 0);")
+    out.append("        close(fd);")
+    out.append("        if (addr == MAP_FAILED) {")
+    out.append("            load_error_ = \"cannot mmap golden file \" + path_;")
+    out.append("            return;")
+    out.append("        }")
+    out.append("        base_ = static_cast<const uint8_t*>(addr);")
+    out.append("        std::memcpy(&header_, base_, sizeof(FileHeader));")
+    out.append(f"        if (std::memcmp(header_.magic, \"{GOLDEN_MAGIC.decode()}\", 8) != 0 || header_.version != {GOLDEN_VERSION} ||")
+    out.append("            sizeof(FileHeader) + static_cast<size_t>(header_.entry_count) * sizeof(FileEntry) > length_ ||")
+    out.append("            header_.blob_offset > length_) {")
+    out.append("            load_error_ = \"invalid golden file \" + path_;")
+    out.append("            munmap(const_cast<uint8_t*>(base_), length_);")
+    out.append("            base_ = nullptr;")
+    out.append("        }")
+    out.append("    }")
+    out.append("")
+    out.append("    FileEntry EntryAt(size_t index) const")
+    out.append("    {")
+    out.append("        FileEntry entry;")
+    out.append("        std::memcpy(&entry, base_ + sizeof(FileHeader) + index * sizeof(FileEntry), sizeof(FileEntry));")
+    out.append("        return entry;")
+    out.append("    }")
+    out.append("")
+    out.append("    const uint8_t* Blob(uint32_t offset) const")
+    out.append("    {")
+    out.append("        return base_ + header_.blob_offset + offset;")
+    out.append("    }")
+    out.append("")
+    out.append("    bool Find(const std::string& name, FileEntry& found) const")
+    out.append("    {")
+    out.append("        uint64_t hash = HashName(name);")
+    out.append("        size_t lo = 0;")
+    out.append("        size_t hi = header_.entry_count;")
+    out.append("        while (lo < hi) {")
+    out.append("            size_t mid = lo + (hi - lo) / 2;")
+    out.append("            if (EntryAt(mid).name_hash < hash) {")
+    out.append("                lo = mid + 1;")
+    out.append("            } else {")
+    out.append("                hi = mid;")
+    out.append("            }")
+    out.append("        }")
+    out.append("        for (; lo < header_.entry_count; ++lo) {")
+    out.append("            FileEntry entry = EntryAt(lo);")
+    out.append("            if (entry.name_hash != hash) {")
+    out.append("                return false;")
+    out.append("            }")
+    out.append("            if (entry.name_len == name.size() &&")
+    out.append("                std::memcmp(Blob(entry.name_offset), name.data(), name.size()) == 0) {")
+    out.append("                found = entry;")
+    out.append("                return true;")
+    out.append("            }")
+    out.append("        }")
+    out.append("        return false;")
+    out.append("    }")
+    out.append("")
+    out.append("    void Compare(const Record& record)")
+    out.append("    {")
+    out.append("        if (base_ == nullptr) {")
+    out.append("            ADD_FAILURE() << \"[golden] \" << load_error_;")
+    out.append("            return;")
+    out.append("        }")
+    out.append("        FileEntry golden;")
+    out.append("        if (!Find(record.name, golden)) {")
+    out.append("            missing_++;")
+    out.append("            std::cout << \"[golden] no golden entry for \" << record.name << std::endl;")
+    out.append("            return;")
+    out.append("        }")
+    out.append("        compared_++;")
+    out.append("        const uint8_t* golden_data = Blob(golden.data_offset);")
+    out.append("        std::vector<uint64_t> golden_ws(golden.ws_count);")
+    out.append("        if (golden.ws_count > 0) {")
+    out.append("            std::memcpy(golden_ws.data(), Blob(golden.ws_offset), golden.ws_count * sizeof(uint64_t));")
+    out.append("        }")
+    out.append("        bool same = golden.tiling_key == record.tiling_key && golden.block_dim == record.block_dim &&")
+    out.append("                    golden.status == record.status && golden_ws == record.workspaces &&")
+    out.append("                    golden.data_size == record.data.size() &&")
+    out.append("                    std::memcmp(golden_data, record.data.data(), record.data.size()) == 0;")
+    out.append("        if (same) {")
+    out.append("            return;")
+    out.append("        }")
+    out.append("        mismatched_++;")
+    out.append("        std::vector<std::string> diffs;")
+    out.append("        if (golden.status != record.status) {")
+    out.append("            diffs.push_back(\"status: \" + std::to_string(golden.status) + \" -> \" + std::to_string(record.status));")
+    out.append("        }")
+    out.append("        if (golden.tiling_key != record.tiling_key) {")
+    out.append("            diffs.push_back(\"tiling_key: \" + std::to_string(golden.tiling_key) + \" -> \" + std::to_string(record.tiling_key));")
+    out.append("        }")
+    out.append("        if (golden.block_dim != record.block_dim) {")
+    out.append("            diffs.push_back(\"block_dim: \" + std::to_string(golden.block_dim) + \" -> \" + std::to_string(record.block_dim));")
+    out.append("        }")
+    out.append("        size_t ws_num = std::max(golden_ws.size(), record.workspaces.size());")
+    out.append("        for (size_t i = 0; i < ws_num; ++i) {")
+    out.append("            std::string lhs = i < golden_ws.size() ? std::to_string(golden_ws[i]) : \"<none>\";")
+    out.append("            std::string rhs = i < record.workspaces.size() ? std::to_string(record.workspaces[i]) : \"<none>\";")
+    out.append("            if (lhs != rhs) {")
+    out.append("                diffs.push_back(\"workspace[\" + std::to_string(i) + \"]: \" + lhs + \" -> \" + rhs);")
+    out.append("            }")
+    out.append("        }")
+    out.append("        if (golden.data_size != record.data.size()) {")
+    out.append("            diffs.push_back(\"data_size: \" + std::to_string(golden.data_size) + \" -> \" + std::to_string(record.data.size()));")
+    out.append("        }")
+    out.append("        DiffTilingData(golden_data, golden.data_size, record.data.data(), record.data.size(), diffs);")
+    out.append("        std::ostringstream os;")
+    out.append("        os << \"[golden] \" << record.name << \" differs from \" << path_ << \" (golden -> actual):\";")
+    out.append("        for (const auto& diff : diffs) {")
+    out.append("            os << \"\\n  \" << diff;")
+    out.append("        }")
+    out.append("        ADD_FAILURE() << os.str();")
+    out.append("    }")
+    out.append("")
+    out.append("    void Write()")
+    out.append("    {")
+    out.append("        std::sort(records_.begin(), records_.end(), [](const Record& lhs, const Record& rhs) {")
+    out.append("            uint64_t lhs_hash = HashName(lhs.name);")
+    out.append("            uint64_t rhs_hash = HashName(rhs.name);")
+    out.append("            return lhs_hash != rhs_hash ? lhs_hash < rhs_hash : lhs.name < rhs.name;")
+    out.append("        });")
+    out.append("        std::vector<FileEntry> entries;")
+    out.append("        std::string blob;")
+    out.append("        for (const auto& record : records_) {")
+    out.append("            FileEntry entry{};")
+    out.append("            entry.name_hash = HashName(record.name);")
+    out.append("            entry.tiling_key = record.tiling_key;")
+    out.append("            entry.block_dim = record.block_dim;")
+    out.append("            entry.status = record.status;")
+    out.append("            entry.name_offset = static_cast<uint32_t>(blob.size());")
+    out.append("            entry.name_len = static_cast<uint32_t>(record.name.size());")
+    out.append("            blob += record.name;")
+    out.append("            entry.data_offset = static_cast<uint32_t>(blob.size());")
+    out.append("            entry.data_size = static_cast<uint32_t>(record.data.size());")
+    out.append("            blob.append(reinterpret_cast<const char*>(record.data.data()), record.data.size());")
+    out.append("            blob.resize((blob.size() + 7) / 8 * 8, '\\0');")
+    out.append("            entry.ws_offset = static_cast<uint32_t>(blob.size());")
+    out.append("            entry.ws_count = static_cast<uint32_t>(record.workspaces.size());")
+    out.append("            blob.append(reinterpret_cast<const char*>(record.workspaces.data()), record.workspaces.size() * sizeof(uint64_t));")
+    out.append("            entries.push_back(entry);")
+    out.append("        }")
+    out.append("        FileHeader header{};")
+    out.append(f"        std::memcpy(header.magic, \"{GOLDEN_MAGIC.decode()}\", 8);")
+    out.append(f"        header.version = {GOLDEN_VERSION};")
+    out.append("        header.entry_count = static_cast<uint32_t>(entries.size());")
+    out.append("        header.blob_offset = (sizeof(FileHeader) + entries.size() * sizeof(FileEntry) + 7) / 8 * 8;")
+    out.append("        std::ofstream os(path_, std::ios::binary | std::ios::trunc);")
+    out.append("        os.write(reinterpret_cast<const char*>(&header), sizeof(header));")
+    out.append("        os.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(FileEntry));")
+    out.append("        std::string padding(header.blob_offset - sizeof(FileHeader) - entries.size() * sizeof(FileEntry), '\\0');")
+    out.append("        os << padding << blob;")
+    out.append("        std::cout << \"[golden] recorded \" << entries.size() << \" cases to \" << path_ << std::endl;")
+    out.append("    }")
+    out.append("")
+    out.append("    std::mutex mutex_;")
+    out.append("    std::string path_;")
+    out.append("    bool recording_{false};")
+    out.append("    std::map<std::string, int> call_seq_;")
+    out.append("    std::vector<Record> records_;")
+    out.append("    const uint8_t* base_{nullptr};")
+    out.append("    size_t length_{0};")
+    out.append("    FileHeader header_{};")
+    out.append("    std::string load_error_;")
+    out.append("    size_t compared_{0};")
+    out.append("    size_t mismatched_{0};")
+    out.append("    size_t missing_{0};")
+    out.append("};")
+    out.append("")
+    out.append("// 在 tiling_func 返回后抓取结果，不改变返回值；用例名取当前 gtest 用例的 suite.name")
+    out.append("template <typename Ret, typename Context>")
+    out.append("Ret Capture(Ret ret, Context* context)")
+    out.append("{")
+    out.append("    Record record;")
+    out.append("    const auto* test_info = testing::UnitTest::GetInstance()->current_test_info();")
+    out.append("    if (test_info != nullptr) {")
+    out.append("        record.name = std::string(test_info->test_suite_name()) + \".\" + test_info->name();")
+    out.append("    }")
+    out.append("    record.tiling_key = context->GetTilingKey();")
+    out.append("    record.block_dim = context->GetBlockDim();")
+    out.append("    record.status = static_cast<int32_t>(ret);")
+    out.append("    auto* raw_tiling_data = context->GetRawTilingData();")
+    out.append("    if (raw_tiling_data != nullptr && raw_tiling_data->GetData() != nullptr) {")
+    out.append("        const auto* begin = static_cast<const uint8_t*>(raw_tiling_data->GetData());")
+    out.append("        record.data.assign(begin, begin + raw_tiling_data->GetDataSize());")
+    out.append("    }")
+    out.append("    size_t ws_num = context->GetWorkspaceNum();")
+    out.append("    const size_t* ws_sizes = ws_num > 0 ? context->GetWorkspaceSizes(ws_num) : nullptr;")
+    out.append("    if (ws_sizes != nullptr) {")
+    out.append("        record.workspaces.assign(ws_sizes, ws_sizes + ws_num);")
+    out.append("    }")
+    out.append("    Store::Get().Handle(std::move(record));")
+    out.append("    return ret;")
+    out.append("}")
+    out.append("} // namespace utgen_golden")
+    return "\n".join(out) + "\n"
+
+
+def golden_probe(default_path: str, default_mode: str,
+                 layout: Optional[List[TilingField]] = None) -> TilingProbe:
+    """快照探针：tiling_func 调用包裹为 Capture(...)；与 --alloc-probe 叠加时 ProbedCall 位于 Capture 之内。"""
+    return TilingProbe(
+        kind="golden",
+        marker=GOLDEN_MARKER,
+        wrap=lambda call: f"utgen_golden::Capture({call}, tiling_context)",
+        blocks=[("golden", render_golden_store(default_path, default_mode, layout or []))],
+    )
+
+
+# =============================================================================
+# 离线读取与比较
+# =============================================================================
+
+def read_snapshot(path: Path) -> Dict[str, SnapshotEntry]:
+    header_size = struct.calcsize(HEADER_FORMAT)
+    entry_size = struct.calcsize(ENTRY_FORMAT)
+    with open(path, "rb") as f, mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ) as mm:
+        magic, version, count, blob = struct.unpack_from(HEADER_FORMAT, mm, 0)
+        if magic != GOLDEN_MAGIC or version != GOLDEN_VERSION:
+            raise ValueError(f"不是有效的快照文件: {path}")
+        entries: Dict[str, SnapshotEntry] = {}
+        for i in range(count):
+            (_, key, name_off, name_len, data_off, data_size,
+             ws_off, ws_count, block_dim, status) = struct.unpack_from(ENTRY_FORMAT, mm, header_size + i * entry_size)
+            name = mm[blob + name_off: blob + name_off + name_len].decode("utf-8", errors="replace")
+            data = mm[blob + data_off: blob + data_off + data_size]
+            workspaces = list(struct.unpack_from(f"<{ws_count}Q", mm, blob + ws_off)) if ws_count else []
+            entries[name] = SnapshotEntry(name, key, block_dim, status, data, workspaces)
+    return entries
+
+
+def _field_value(data: bytes, offset: int, size: int, kind: str) -> str:
+    if offset + size > len(data):
+        return "<none>"
+    fmt = {("u", 1): "<B", ("i", 1): "<b", ("u", 2): "<H", ("i", 2): "<h", ("u", 4): "<I", ("i", 4): "<i",
+           ("u", 8): "<Q", ("i", 8): "<q", ("f", 4): "<f", ("f", 8): "<d"}[(kind, size)]
+    return str(struct.unpack_from(fmt, data, offset)[0])
+
+
+def diff_entries(golden: SnapshotEntry, actual: SnapshotEntry, layout: List[TilingField]) -> List[str]:
+    diffs: List[str] = []
+    for label, lhs, rhs in (("status", golden.status, actual.status),
+                            ("tiling_key", golden.tiling_key, actual.tiling_key),
+                            ("block_dim", golden.block_dim, actual.block_dim)):
+        if lhs != rhs:
+            diffs.append(f"{label}: {lhs} -> {rhs}")
+    for i in range(max(len(golden.workspaces), len(actual.workspaces))):
+        lhs = golden.workspaces[i] if i < len(golden.workspaces) else "<none>"
+        rhs = actual.workspaces[i] if i < len(actual.workspaces) else "<none>"
+        if lhs != rhs:
+            diffs.append(f"workspace[{i}]: {lhs} -> {rhs}")
+    if len(golden.data) != len(actual.data):
+        diffs.append(f"data_size: {len(golden.data)} -> {len(actual.data)}")
+    if golden.data == actual.data:
+        return diffs
+    covered = 0
+    fields = list(layout)
+    for f in layout:
+        covered = max(covered, f.offset + f.size)
+    end = max(len(golden.data), len(actual.data))
+    fields.extend(TilingField(f"data+0x{off:x}", off, min(4, end - off), "u") for off in range(covered, end, 4))
+    for f in fields:
+        lhs = golden.data[f.offset: f.offset + f.size]
+        rhs = actual.data[f.offset: f.offset + f.size]
+        if lhs != rhs and f.size in (1, 2, 4, 8):
+            diffs.append(f"{f.name}: {_field_value(golden.data, f.offset, f.size, f.kind)} -> "
+                         f"{_field_value(actual.data, f.offset, f.size, f.kind)}")
+        elif lhs != rhs:
+            diffs.append(f"{f.name}: {lhs.hex()} -> {rhs.hex()}")
+    return diffs
+
+
+def diff_snapshots(old_path: Path, new_path: Path, layout: List[TilingField]) -> int:
+    golden = read_snapshot(old_path)
+    actual = read_snapshot(new_path)
+    mismatched = 0
+    for name in sorted(set(golden) | set(actual)):
+        if name not in actual:
+            print(f"- {name}: 仅存在于 {old_path.name}")
+            continue
+        if name not in golden:
+            print(f"+ {name}: 仅存在于 {new_path.name}")
+            continue
+        diffs = diff_entries(golden[name], actual[name], layout)
+        if diffs:
+            mismatched += 1
+            print(f"~ {name}")
+            for d in diffs[:MAX_DIFFS_PER_CASE]:
+                print(f"    {d}")
+    print(f"共 {len(golden)} / {len(actual)} 条，{mismatched} 条不一致")
+    return 1 if mismatched else 0
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description="TilingData 黄金快照离线查看与比较")
+    sub = parser.add_subparsers(dest="cmd", required=True)
+    p_diff = sub.add_parser("diff", help="比较两份快照")
+    p_diff.add_argument("old")
+    p_diff.add_argument("new")
+    p_diff.add_argument("--op", default=None, help="算子名，用于加载模板的 TILING_DATA_FIELDS")
+    p_dump = sub.add_parser("dump", help="列出快照中的用例")
+    p_dump.add_argument("path")
+    args = parser.parse_args()
+
+    if args.cmd == "dump":
+        for name, e in sorted(read_snapshot(Path(args.path)).items()):
+            print(f"{name}: status={e.status} tiling_key={e.tiling_key} block_dim={e.block_dim} "
+                  f"data={len(e.data)}B workspaces={e.workspaces}")
+        return 0
+
+    layout: List[TilingField] = []
+    if args.op:
+        from convert_ut_from_xlsx import load_case_template_module
+        module = load_case_template_module(args.op)
+        layout = build_tiling_layout(getattr(module, "TILING_DATA_FIELDS", None))
+    return diff_snapshots(Path(args.old), Path(args.new), layout)
+
+
+if __name__ == "__main__":
+    raise SystemExit(main())
@@ -0,0 +1,409 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+异步大模型客户端（OpenAI 兼容接口）：
+- AsyncModelCaller 基于 AsyncOpenAI 流式收集结果，asyncio.Semaphore 限制单个调用器的并发请求数
+- RateLimiter 为进程内同一 (base_url, model, 配额) 共享的双令牌桶：每分钟请求数（LLM_RPM）与每分钟 token 数（LLM_TPM），
+  请求前按 prompt 估算预扣 token，完成后按生成长度补扣；桶允许透支，透支期间后续请求排队
+- 429 时优先按 Retry-After / retry-after-ms 暂停整个限流器（所有并发请求一起让路），否则按带抖动的指数退避重试；
+  连接错误、超时与 5xx 同样退避重试，400/401/403/404 不重试
+- 流式请求带 stream_options.include_usage，每次调用把服务端报告的 prompt/缓存命中 token 数与首 token 时延
+  交给 llm_metrics.record（服务端不支持该参数时自动去掉）
+- call(sink=...) 把每个增量文本块实时交给 sink.feed（重试前先 sink.reset()），stage 1 流水线据此边生成边解析
+  （见 stream_pipeline.py）
+- utils.ModelCaller 的同步接口（call / call_many / stream）通过 run_sync 驱动本模块：默认每次 asyncio.run；
+  常驻进程（utgen_daemon.py）调用 start_persistent_loop() 后改为在后台常驻事件循环上执行，
+  AsyncOpenAI 客户端按 (api_key, base_url) 复用，HTTP 连接池在多次生成之间保持
+
+环境变量（0 表示不限制）：LLM_RPM（默认 60）、LLM_TPM（默认 0）、LLM_CONCURRENCY（默认 4）
+
+本地联调可使用 mock_openai_server.py 提供的 OpenAI 兼容替身服务。
+"""
+
+from __future__ import annotations
+
+import asyncio
+import email.utils
+import logging
+import os
+import random
+import threading
+import time
+from typing import Any, Awaitable, Dict, List, Optional, Protocol, Sequence, Tuple
+
+from openai import (
+    APIStatusError,
+    AsyncOpenAI,
+    AuthenticationError,
+    BadRequestError,
+    NotFoundError,
+    PermissionDeniedError,
+    RateLimitError,
+)
+
+import llm_metrics
+
+logger = logging.getLogger("utils")
+
+DEFAULT_RPM = 60
+DEFAULT_TPM = 0
+DEFAULT_CONCURRENCY = 4
+
+BACKOFF_BASE = 2.0     # 首次退避上限（秒）
+BACKOFF_CAP = 120.0    # 退避上限（秒）
+REQUEST_TIMEOUT = 6000
+
+NON_RETRYABLE = (BadRequestError, AuthenticationError, PermissionDeniedError, NotFoundError)
+
+
+def env_int(name: str, default: int) -> int:
+    value = os.environ.get(name, "").strip()
+    if not value:
+        return default
+    try:
+        return max(0, int(value))
+    except ValueError:
+        logger.warning(f"环境变量 {name}={value} 不是整数，使用默认值 {default}")
+        return default
+
+
+def estimate_tokens(text: str) -> int:
+    """粗略估计 token 数：CJK 字符按 1 个 token，其余按 4 字符 1 个 token。"""
+    cjk = sum(1 for ch in text if ord(ch) >= 0x2E80)
+    return cjk + (len(text) - cjk + 3) // 4
+
+
+def parse_retry_after(error: APIStatusError) -> Optional[float]:
+    """从 429 响应头中解析建议等待秒数（retry-after-ms / retry-after 秒数或 HTTP 日期）。"""
+    headers = getattr(getattr(error, "response", None), "headers", None)
+    if not headers:
+        return None
+    value = headers.get("retry-after-ms")
+    if value:
+        try:
+            return max(0.0, float(value) / 1000.0)
+        except ValueError:
+            pass
+    value = headers.get("retry-after")
+    if not value:
+        return None
+    try:
+        return max(0.0, float(value))
+    except ValueError:
+        pass
+    try:
+        when = email.utils.parsedate_to_datetime(value)
+        return max(0.0, when.timestamp() - time.time())
+    except (TypeError, ValueError):
+        return None
+
+
+def backoff_delay(attempt: int) -> float:
+    """带抖动的指数退避（full jitter）。"""
+    return random.uniform(0.0, min(BACKOFF_CAP, BACKOFF_BASE * (2 ** (attempt - 1))))
+
+
+# =============================================================================
+# 限流
+# =============================================================================
+
+class TokenBucket:
+    """每分钟补满 per_minute 的令牌桶；per_minute 为 0 时不限制。调用方负责加锁。"""
+
+    def __init__(self, per_minute: int):
+        self.capacity = float(per_minute)
+        self.rate = per_minute / 60.0
+        self.level = self.capacity
+        self.updated = time.monotonic()
+
+    def _refill(self, now: float):
+        self.level = min(self.capacity, self.level + (now - self.updated) * self.rate)
+        self.updated = now
+
+    def wait_time(self, amount: float, now: float) -> float:
+        if self.capacity <= 0:
+            return 0.0
+        self._refill(now)
+        # 超过桶容量的单次请求只要求桶满，避免永远等不到
+        need = min(amount, self.capacity)
+        return 0.0 if self.level >= need else (need - self.level) / self.rate
+
+    def take(self, amount: float):
+        if self.capacity > 0:
+            self.level -= amount
+
+
+class RateLimiter:
+    """请求数 + token 数双令牌桶，线程安全，可在多个事件循环之间共享。"""
+
+    def __init__(self, rpm: int, tpm: int):
+        self.rpm = rpm
+        self.tpm = tpm
+        self._requests = TokenBucket(rpm)
+        self._tokens = TokenBucket(tpm)
+        self._paused_until = 0.0
+        self._lock = threading.Lock()
+        self.waited_seconds = 0.0
+
+    async def acquire(self, tokens: int):
+        start = time.monotonic()
+        while True:
+            with self._lock:
+                now = time.monotonic()
+                wait = max(self._paused_until - now,
+                           self._requests.wait_time(1, now),
+                           self._tokens.wait_time(tokens, now))
+                if wait <= 0:
+                    self._requests.take(1)
+                    self._tokens.take(tokens)
+                    self.waited_seconds += now - start
+                    return
+            await asyncio.sleep(wait)
+
+    def charge(self, tokens: int):
+        """请求完成后补扣生成部分的 token。"""
+        with self._lock:
+            self._tokens.take(tokens)
+
+    def pause(self, seconds: float):
+        """服务端限流时暂停所有共享此限流器的请求。"""
+        with self._lock:
+            self._paused_until = max(self._paused_until, time.monotonic() + seconds)
+
+
+_limiters: Dict[Tuple[str, str, int, int], RateLimiter] = {}
+_limiters_lock = threading.Lock()
+
+
+def shared_limiter(base_url: str, model_name: str,
+                   rpm: Optional[int] = None, tpm: Optional[int] = None) -> RateLimiter:
+    """
+    按 (base_url, model, rpm, tpm) 获取进程内共享的限流器；配额在每次调用时按当前环境变量解析，
+    常驻服务中以不同 LLM_RPM/LLM_TPM 发起的请求不会沿用第一次请求的配额。
+    """
+    rpm = env_int("LLM_RPM", DEFAULT_RPM) if rpm is None else rpm
+    tpm = env_int("LLM_TPM", DEFAULT_TPM) if tpm is None else tpm
+    key = (base_url, model_name, rpm, tpm)
+    with _limiters_lock:
+        limiter = _limiters.get(key)
+        if limiter is None:
+            limiter = _limiters[key] = RateLimiter(rpm, tpm)
+        return limiter
+
+
+# =============================================================================
+# 常驻事件循环
+# =============================================================================
+
+class PersistentLoop:
+    """后台线程中的常驻事件循环，缓存其上创建的 AsyncOpenAI 客户端。"""
+
+    def __init__(self):
+        self.loop = asyncio.new_event_loop()
+        self._thread = threading.Thread(target=self.loop.run_forever, name="llm-loop", daemon=True)
+        self._thread.start()
+        self._clients: Dict[Tuple[str, str], AsyncOpenAI] = {}
+
+    def client(self, api_key: str, base_url: str) -> AsyncOpenAI:
+        """仅在常驻循环内调用。"""
+        key = (api_key, base_url)
+        client = self._clients.get(key)
+        if client is None:
+            client = self._clients[key] = AsyncOpenAI(api_key=api_key, base_url=base_url, max_retries=0)
+        return client
+
+    def run(self, coro: Awaitable[Any]) -> Any:
+        return asyncio.run_coroutine_threadsafe(coro, self.loop).result()
+
+    def close(self):
+        async def close_clients():
+            for client in self._clients.values():
+                await client.close()
+            self._clients.clear()
+
+        self.run(close_clients())
+        self.loop.call_soon_threadsafe(self.loop.stop)
+        self._thread.join(timeout=5)
+
+
+_persistent: Optional[PersistentLoop] = None
+
+
+def start_persistent_loop() -> PersistentLoop:
+    global _persistent
+    if _persistent is None:
+        _persistent = PersistentLoop()
+    return _persistent
+
+
+def stop_persistent_loop():
+    global _persistent
+    if _persistent is not None:
+        _persistent.close()
+        _persistent = None
+
+
+def run_sync(coro: Awaitable[Any]) -> Any:
+    """在常驻循环（已启动时）或新建的事件循环中执行协程并等待结果。"""
+    if _persistent is not None:
+        return _persistent.run(coro)
+    return asyncio.run(coro)
+
+
+def _pooled_client(api_key: str, base_url: str) -> Optional[AsyncOpenAI]:
+    """当前正运行在常驻循环上时返回复用的客户端，否则返回 None。"""
+    if _persistent is None:
+        return None
+    try:
+        if asyncio.get_running_loop() is not _persistent.loop:
+            return None
+    except RuntimeError:
+        return None
+    return _persistent.client(api_key, base_url)
+
+
+# =============================================================================
+# 异步调用器
+# =============================================================================
+
+class StreamSink(Protocol):
+    """流式结果的接收方；回调在事件循环线程内执行，应快速返回且不抛异常。"""
+
+    def feed(self, text: str) -> None:
+        """收到一段增量文本。"""
+
+    def reset(self) -> None:
+        """上一次尝试作废（将重试），丢弃已收到的内容。"""
+
+
+class AsyncModelCaller:
+    """异步模型调用器；实例绑定创建它的事件循环，用 async with 或 aclose() 释放连接（常驻循环上的共享客户端不关闭）。"""
+
+    def __init__(self, api_key: str, base_url: str, model_name: str,
+                 concurrency: Optional[int] = None, limiter: Optional[RateLimiter] = None,
+                 metrics_context: Optional[Dict[str, Any]] = None):
+        self.model_name = model_name
+        # 随每条调用指标记录的上下文（阶段、算子、prompt 布局、静态前缀哈希）
+        self.metrics_context = dict(metrics_context or {})
+        self._stream_usage = True
+        self.limiter = limiter or shared_limiter(base_url, model_name)
+        self.concurrency = max(1, env_int("LLM_CONCURRENCY", DEFAULT_CONCURRENCY) if concurrency is None else concurrency)
+        self._semaphore = asyncio.Semaphore(self.concurrency)
+        # 重试由本类统一处理（需要与共享限流器协同），关闭 SDK 自带重试
+        pooled = _pooled_client(api_key, base_url)
+        self._owns_client = pooled is None
+        self.client = pooled or AsyncOpenAI(api_key=api_key, base_url=base_url, max_retries=0)
+
+    async def __aenter__(self) -> "AsyncModelCaller":
+        return self
+
+    async def __aexit__(self, *exc_info):
+        await self.aclose()
+
+    async def aclose(self):
+        if self._owns_client:
+            await self.client.close()
+
+    async def _create(self, messages: List[Dict[str, str]], temperature: float, max_tokens: int):
+        kwargs: Dict[str, Any] = {}
+        if self._stream_usage:
+            kwargs["stream_options"] = {"include_usage": True}
+        try:
+            return await self.client.chat.completions.create(
+                model=self.model_name,
+                messages=messages,
+                temperature=temperature,
+                max_tokens=max_tokens,
+                stream=True,
+                timeout=REQUEST_TIMEOUT,
+                **kwargs,
+            )
+        except BadRequestError as e:
+            if not self._stream_usage or "stream_options" not in str(e):
+                raise
+            logger.warning(f"服务端不支持 stream_options，不再统计缓存命中: {self.model_name}")
+            self._stream_usage = False
+            return await self._create(messages, temperature, max_tokens)
+
+    async def _stream(self, messages: List[Dict[str, str]], temperature: float,
+                      max_tokens: int, sink: Optional[StreamSink] = None) -> Tuple[str, Any, Optional[float]]:
+        """返回 (生成内容, 最后一块携带的 usage, 首 token 时延秒数)；sink 非空时逐块转交增量文本。"""
+        start = time.monotonic()
+        response = await self._create(messages, temperature, max_tokens)
+        result = []
+        usage = None
+        ttft = None
+        async for chunk in response:
+            if getattr(chunk, "usage", None):
+                usage = chunk.usage
+            if chunk.choices and chunk.choices[0].delta.content:
+                if ttft is None:
+                    ttft = time.monotonic() - start
+                result.append(chunk.choices[0].delta.content)
+                if sink is not None:
+                    sink.feed(chunk.choices[0].delta.content)
+        return "".join(result).strip(), usage, ttft
+
+    async def call(self, prompt: str, system_message: str, max_retries: int = 5,
+                   temperature: float = 0.7, max_tokens: int = 65536, tag: str = "",
+                   sink: Optional[StreamSink] = None) -> str:
+        """调用模型，失败 max_retries 次后返回空字符串；sink 见 StreamSink。"""
+        messages = [
+            {"role": "system", "content": system_message},
+            {"role": "user", "content": prompt},
+        ]
+        prompt_tokens = estimate_tokens(system_message) + estimate_tokens(prompt)
+        label = f"{self.model_name}{tag}"
+
+        for attempt in range(1, max_retries + 1):
+            await self.limiter.acquire(prompt_tokens)
+            delay = 0.0
+            async with self._semaphore:
+                try:
+                    logger.info(f"调用模型 {label} (尝试 {attempt}/{max_retries})")
+                    if sink is not None and attempt > 1:
+                        sink.reset()
+                    start = time.monotonic()
+                    full_result, usage, ttft = await self._stream(messages, temperature, max_tokens, sink)
+                    elapsed = time.monotonic() - start
+                    self.limiter.charge(estimate_tokens(full_result))
+                    counts = llm_metrics.usage_counts(usage)
+                    llm_metrics.record(dict(self.metrics_context, model=self.model_name, ok=bool(full_result),
+                                            attempt=attempt, ttft=None if ttft is None else round(ttft, 3),
+                                            elapsed=round(elapsed, 3), **counts))
+                    if full_result:
+                        detail = f"首 token {ttft:.1f}s，" if ttft is not None else ""
+                        if counts["prompt_tokens"]:
+                            detail += (f"prompt {counts['prompt_tokens']:,} tokens"
+                                       f"（服务端缓存命中 {counts['cached_tokens']:,}），")
+                        logger.info(f"模型调用成功 {label}，生成 {len(full_result):,} 字符，{detail}耗时 {elapsed:.1f}s")
+                        return full_result
+                    logger.warning(f"模型返回空内容 {label}")
+                    delay = backoff_delay(attempt)
+                except RateLimitError as e:
+                    retry_after = parse_retry_after(e)
+                    delay = retry_after + random.uniform(0.0, 1.0) if retry_after is not None else backoff_delay(attempt)
+                    self.limiter.pause(delay)
+                    logger.warning(f"达到速率限制 {label}: {str(e)}")
+                except NON_RETRYABLE as e:
+                    logger.error(f"模型调用出错（不重试）{label}: {str(e)}")
+                    return ""
+                except Exception as e:  # 连接错误、超时、5xx 等
+                    logger.error(f"模型调用出错 {label}: {str(e)}")
+                    delay = backoff_delay(attempt)
+            if attempt < max_retries:
+                logger.info(f"等待 {delay:.1f} 秒后重试...")
+                await asyncio.sleep(delay)
+
+        logger.error(f"在 {max_retries} 次尝试后模型调用失败 {label}")
+        return ""
+
+    async def call_many(self, requests: Sequence[Tuple[str, str]], max_retries: int = 5,
+                        temperature: float = 0.7, max_tokens: int = 65536) -> List[str]:
+        """并发调用多个 (prompt, system_message)，结果与输入同序。"""
+        tasks = [
+            self.call(prompt, system_message, max_retries, temperature, max_tokens,
+                      tag=f" #{i + 1}/{len(requests)}" if len(requests) > 1 else "")
+            for i, (prompt, system_message) in enumerate(requests)
+        ]
+        return list(await asyncio.gather(*tasks))
@@ -0,0 +1,185 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+大模型调用指标：每次实际发出的调用（响应缓存命中的不算）记录一行 JSON，用于衡量服务端前缀缓存节省的时延。
+
+- 字段：时间、阶段/算子/prompt 布局等上下文、prompt/生成 token 数、服务端报告的缓存命中 token 数、
+  首 token 时延（TTFT）、总耗时、静态前缀哈希（相同哈希的调用可共享服务端 KV 前缀缓存）
+- 缓存命中数兼容 OpenAI/vLLM 的 usage.prompt_tokens_details.cached_tokens 与 DeepSeek 的 prompt_cache_hit_tokens
+- 默认写入 <UTGEN_CACHE_DIR 或 .cache>/llm_calls.jsonl，LLM_METRICS_FILE 指定其它文件（batch_runner 每批一个），
+  LLM_METRICS=0 关闭
+- 汇总：命中率、命中/未命中调用的平均 TTFT，以及按未命中调用的每 token 预填充耗时估算的节省时间
+
+用法：
+    python3 llm_metrics.py summary [--file llm_calls.jsonl] [--since 3600]
+    python3 llm_metrics.py clear
+"""
+
+from __future__ import annotations
+
+import argparse
+import json
+import os
+import sys
+import threading
+import time
+from collections import defaultdict
+from pathlib import Path
+from typing import Any, Dict, Iterable, List, Optional
+
+_lock = threading.Lock()
+
+
+def enabled() -> bool:
+    return os.environ.get("LLM_METRICS", "1") not in ("0", "", "false", "off")
+
+
+def metrics_path() -> Path:
+    explicit = os.environ.get("LLM_METRICS_FILE")
+    if explicit:
+        return Path(explicit)
+    return Path(os.environ.get("UTGEN_CACHE_DIR") or ".cache") / "llm_calls.jsonl"
+
+
+def _field(obj: Any, name: str) -> Any:
+    if obj is None:
+        return None
+    if isinstance(obj, dict):
+        return obj.get(name)
+    value = getattr(obj, name, None)
+    if value is None:
+        extra = getattr(obj, "model_extra", None) or {}
+        value = extra.get(name)
+    return value
+
+
+def usage_counts(usage: Any) -> Dict[str, int]:
+    """从 usage（SDK 对象或 dict）中取 prompt/生成/缓存命中 token 数；缺失的记为 0。"""
+    cached = _field(_field(usage, "prompt_tokens_details"), "cached_tokens")
+    if cached is None:
+        cached = _field(usage, "prompt_cache_hit_tokens")
+    if cached is None:
+        cached = _field(usage, "cached_tokens")
+    return {
+        "prompt_tokens": int(_field(usage, "prompt_tokens") or 0),
+        "completion_tokens": int(_field(usage, "completion_tokens") or 0),
+        "cached_tokens": int(cached or 0),
+    }
+
+
+def record(entry: Dict[str, Any]):
+    """追加一条调用记录；写入失败只影响统计，不影响生成。"""
+    if not enabled():
+        return
+    path = metrics_path()
+    line = json.dumps(dict(entry, ts=round(time.time(), 3)), ensure_ascii=False)
+    try:
+        path.parent.mkdir(parents=True, exist_ok=True)
+        with _lock, open(path, "a", encoding="utf-8") as f:
+            f.write(line + "\n")
+    except OSError:
+        pass
+
+
+def load(path: Optional[Path] = None, since: Optional[float] = None) -> List[Dict[str, Any]]:
+    path = path or metrics_path()
+    records = []
+    try:
+        with open(path, "r", encoding="utf-8") as f:
+            for line in f:
+                try:
+                    item = json.loads(line)
+                except ValueError:
+                    continue
+                if since is None or item.get("ts", 0) >= since:
+                    records.append(item)
+    except OSError:
+        pass
+    return records
+
+
+def _mean(values: List[float]) -> Optional[float]:
+    return sum(values) / len(values) if values else None
+
+
+def summarize(records: Iterable[Dict[str, Any]]) -> Dict[str, Any]:
+    records = list(records)
+    calls = [r for r in records if r.get("ok")]
+    hits = [r for r in calls if r.get("cached_tokens", 0) > 0]
+    misses = [r for r in calls if r.get("cached_tokens", 0) == 0]
+    prompt_tokens = sum(r.get("prompt_tokens", 0) for r in calls)
+    cached_tokens = sum(r.get("cached_tokens", 0) for r in calls)
+
+    # 未命中调用的 TTFT 近似为纯预填充耗时，按其每 token 耗时估算命中部分省下的时间
+    miss_tokens = sum(r.get("prompt_tokens", 0) for r in misses if r.get("ttft") is not None)
+    miss_ttft = sum(r["ttft"] for r in misses if r.get("ttft") is not None)
+    per_token = miss_ttft / miss_tokens if miss_tokens else None
+    saved = cached_tokens * per_token if per_token is not None else None
+
+    prefixes: Dict[str, int] = defaultdict(int)
+    for r in calls:
+        if r.get("prefix_hash"):
+            prefixes[r["prefix_hash"]] += 1
+    return {
+        "calls": len(calls),
+        "failed": len(records) - len(calls),
+        "prompt_tokens": prompt_tokens,
+        "cached_tokens": cached_tokens,
+        "cache_hit_ratio": round(cached_tokens / prompt_tokens, 4) if prompt_tokens else 0.0,
+        "calls_with_cache_hit": len(hits),
+        "ttft_mean": _mean([r["ttft"] for r in calls if r.get("ttft") is not None]),
+        "ttft_mean_hit": _mean([r["ttft"] for r in hits if r.get("ttft") is not None]),
+        "ttft_mean_miss": _mean([r["ttft"] for r in misses if r.get("ttft") is not None]),
+        "estimated_seconds_saved": saved,
+        "shared_prefixes": {h: n for h, n in prefixes.items() if n > 1},
+    }
+
+
+def format_summary(summary: Dict[str, Any]) -> List[str]:
+    def sec(value: Optional[float]) -> str:
+        return "-" if value is None else f"{value:.2f}s"
+
+    if not summary["calls"]:
+        return ["模型调用: 无（全部命中响应缓存或未调用）"]
+    lines = [
+        f"模型调用 {summary['calls']} 次，prompt {summary['prompt_tokens']:,} tokens，"
+        f"服务端前缀缓存命中 {summary['cached_tokens']:,}（{summary['cache_hit_ratio']:.1%}，"
+        f"{summary['calls_with_cache_hit']} 次调用有命中）",
+        f"首 token 时延: 平均 {sec(summary['ttft_mean'])}，有命中 {sec(summary['ttft_mean_hit'])}，"
+        f"无命中 {sec(summary['ttft_mean_miss'])}",
+    ]
+    if summary["estimated_seconds_saved"] is not None and summary["cached_tokens"]:
+        lines.append(f"按无命中调用的预填充速度估算，前缀缓存节省约 {summary['estimated_seconds_saved']:.1f}s")
+    if summary["shared_prefixes"]:
+        shared = sum(summary["shared_prefixes"].values())
+        lines.append(f"{len(summary['shared_prefixes'])} 个静态前缀被 {shared} 次调用共享")
+    return lines
+
+
+def main(argv: Optional[List[str]] = None) -> int:
+    parser = argparse.ArgumentParser(description="大模型调用指标（前缀缓存命中与首 token 时延）")
+    sub = parser.add_subparsers(dest="command", required=True)
+    summary_parser = sub.add_parser("summary", help="汇总调用记录")
+    summary_parser.add_argument("--file", default=None, help="记录文件（默认 LLM_METRICS_FILE 或 .cache/llm_calls.jsonl）")
+    summary_parser.add_argument("--since", type=float, default=None, help="只统计最近 N 秒内的调用")
+    summary_parser.add_argument("--json", action="store_true", help="以 JSON 输出")
+    clear_parser = sub.add_parser("clear", help="删除记录文件")
+    clear_parser.add_argument("--file", default=None)
+    args = parser.parse_args(argv)
+
+    path = Path(args.file) if args.file else metrics_path()
+    if args.command == "clear":
+        path.unlink(missing_ok=True)
+        print(f"✅ 已删除 {path}")
+        return 0
+    since = time.time() - args.since if args.since else None
+    summary = summarize(load(path, since))
+    if args.json:
+        print(json.dumps(summary, ensure_ascii=False, indent=2))
+    else:
+        print("\n".join(format_summary(summary)))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,221 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+本地 OpenAI 兼容替身服务，用于在不消耗真实配额的情况下联调 llm_client / ModelCaller：
+- POST /v1/chat/completions：支持 stream=true（SSE 分块）与非流式两种返回
+- --rpm：服务端按滑动窗口限流，超限返回 429 并带 Retry-After（秒）
+- --latency / --chunk-delay：模拟首包与逐块延迟；--error-rate：按比例返回 500
+- --reply-file：固定返回的文本（默认回显 prompt 长度）
+- 模拟服务端 KV 前缀缓存：按 --prefix-block 字符分块记录见过的 prompt 前缀，usage.prompt_tokens_details.cached_tokens
+  报告命中的 token 数；--prefill-ms 为每 1k 未命中 token 增加的首包延迟（stream_options.include_usage 时流式末块带 usage）
+- GET /stats：请求数、429/500 次数、最大并发与 prompt/缓存命中 token 总数，便于检查客户端是否用满配额又不过载
+
+用法：
+    python3 mock_openai_server.py --port 8800 --rpm 30 --latency 2
+    BASE_URL=http://127.0.0.1:8800/v1/ API_KEY=mock LLM_RPM=30 python3 stage_1.py ...
+"""
+
+from __future__ import annotations
+
+import argparse
+import collections
+import hashlib
+import json
+import random
+import threading
+import time
+import uuid
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+from typing import Deque, Dict, List, Tuple
+
+PREFIX_CACHE_ENTRIES = 200000
+
+
+def estimate_tokens(text: str) -> int:
+    cjk = sum(1 for ch in text if ord(ch) >= 0x2E80)
+    return cjk + (len(text) - cjk + 3) // 4
+
+
+class MockState:
+    def __init__(self, args: argparse.Namespace):
+        self.args = args
+        self.reply = ""
+        if args.reply_file:
+            with open(args.reply_file, "r", encoding="utf-8") as f:
+                self.reply = f.read()
+        self.lock = threading.Lock()
+        self.window: Deque[float] = collections.deque()
+        self.stats: Dict[str, int] = {"requests": 0, "rate_limited": 0, "errors": 0, "completed": 0,
+                                      "in_flight": 0, "max_in_flight": 0, "prompt_tokens": 0, "cached_tokens": 0}
+        self.prefixes: "collections.OrderedDict[str, None]" = collections.OrderedDict()
+
+    def prefix_lookup(self, prompt: str) -> Tuple[int, int]:
+        """返回 (prompt token 数, 命中前缀缓存的 token 数)，并记录本次 prompt 的各块前缀。"""
+        block = max(1, self.args.prefix_block)
+        digest = hashlib.sha256()
+        hashes: List[str] = []
+        for end in range(block, len(prompt) + 1, block):
+            digest.update(prompt[end - block:end].encode("utf-8"))
+            hashes.append(digest.copy().hexdigest())
+        with self.lock:
+            hit_blocks = 0
+            for h in hashes:
+                if h not in self.prefixes:
+                    break
+                hit_blocks += 1
+            for h in hashes:
+                self.prefixes[h] = None
+                self.prefixes.move_to_end(h)
+            while len(self.prefixes) > PREFIX_CACHE_ENTRIES:
+                self.prefixes.popitem(last=False)
+            total = estimate_tokens(prompt)
+            cached = estimate_tokens(prompt[:hit_blocks * block])
+            self.stats["prompt_tokens"] += total
+            self.stats["cached_tokens"] += cached
+        return total, cached
+
+    def admit(self) -> float:
+        """返回 0 表示放行，否则为建议的 Retry-After 秒数。"""
+        with self.lock:
+            self.stats["requests"] += 1
+            now = time.monotonic()
+            while self.window and now - self.window[0] >= 60.0:
+                self.window.popleft()
+            if self.args.rpm > 0 and len(self.window) >= self.args.rpm:
+                self.stats["rate_limited"] += 1
+                return max(1.0, 60.0 - (now - self.window[0]))
+            self.window.append(now)
+            self.stats["in_flight"] += 1
+            self.stats["max_in_flight"] = max(self.stats["max_in_flight"], self.stats["in_flight"])
+            return 0.0
+
+    def release(self, ok: bool):
+        with self.lock:
+            self.stats["in_flight"] -= 1
+            self.stats["completed" if ok else "errors"] += 1
+
+
+def make_handler(state: MockState):
+    class Handler(BaseHTTPRequestHandler):
+        protocol_version = "HTTP/1.1"
+
+        def log_message(self, fmt, *args):
+            if state.args.verbose:
+                super().log_message(fmt, *args)
+
+        def _json(self, code: int, body: dict, headers: Dict[str, str] = None):
+            data = json.dumps(body, ensure_ascii=False).encode("utf-8")
+            self.send_response(code)
+            self.send_header("Content-Type", "application/json")
+            self.send_header("Content-Length", str(len(data)))
+            for key, value in (headers or {}).items():
+                self.send_header(key, value)
+            self.end_headers()
+            self.wfile.write(data)
+
+        def do_GET(self):
+            if self.path.rstrip("/") == "/stats":
+                with state.lock:
+                    self._json(200, dict(state.stats))
+            else:
+                self._json(404, {"error": {"message": "not found"}})
+
+        def do_POST(self):
+            length = int(self.headers.get("Content-Length", "0"))
+            request = json.loads(self.rfile.read(length) or b"{}")
+            if not self.path.rstrip("/").endswith("/chat/completions"):
+                self._json(404, {"error": {"message": "not found"}})
+                return
+
+            retry_after = state.admit()
+            if retry_after > 0:
+                self._json(429, {"error": {"message": "rate limit exceeded", "type": "rate_limit"}},
+                           {"Retry-After": f"{retry_after:.0f}"})
+                return
+
+            ok = False
+            try:
+                prompt = "".join(f"<|{m.get('role', '')}|>{m.get('content', '')}" for m in request.get("messages", []))
+                prompt_tokens, cached_tokens = state.prefix_lookup(prompt)
+                time.sleep(state.args.latency + state.args.prefill_ms / 1000.0 * (prompt_tokens - cached_tokens) / 1000.0)
+                if random.random() < state.args.error_rate:
+                    self._json(500, {"error": {"message": "injected server error"}})
+                    return
+                text = state.reply or f"mock reply to {len(prompt)} chars"
+                usage = {"prompt_tokens": prompt_tokens, "completion_tokens": estimate_tokens(text),
+                         "total_tokens": prompt_tokens + estimate_tokens(text),
+                         "prompt_tokens_details": {"cached_tokens": cached_tokens}}
+                if request.get("stream"):
+                    include_usage = bool((request.get("stream_options") or {}).get("include_usage"))
+                    self._stream(request.get("model", "mock"), text, usage if include_usage else None)
+                else:
+                    self._json(200, {
+                        "id": f"chatcmpl-{uuid.uuid4().hex}", "object": "chat.completion",
+                        "created": int(time.time()), "model": request.get("model", "mock"),
+                        "choices": [{"index": 0, "message": {"role": "assistant", "content": text},
+                                     "finish_reason": "stop"}],
+                        "usage": usage,
+                    })
+                ok = True
+            finally:
+                state.release(ok)
+
+        def _stream(self, model: str, text: str, usage: Dict = None):
+            self.send_response(200)
+            self.send_header("Content-Type", "text/event-stream")
+            self.send_header("Cache-Control", "no-cache")
+            self.send_header("Connection", "close")
+            self.end_headers()
+            completion_id = f"chatcmpl-{uuid.uuid4().hex}"
+            size = max(1, state.args.chunk_size)
+            pieces = [text[i:i + size] for i in range(0, len(text), size)] or [""]
+            for n, piece in enumerate(pieces):
+                chunk = {
+                    "id": completion_id, "object": "chat.completion.chunk", "created": int(time.time()),
+                    "model": model,
+                    "choices": [{"index": 0, "delta": {"content": piece} if n else {"role": "assistant", "content": piece},
+                                 "finish_reason": None}],
+                }
+                self.wfile.write(f"data: {json.dumps(chunk, ensure_ascii=False)}\n\n".encode("utf-8"))
+                self.wfile.flush()
+                time.sleep(state.args.chunk_delay)
+            done = {"id": completion_id, "object": "chat.completion.chunk", "created": int(time.time()),
+                    "model": model, "choices": [{"index": 0, "delta": {}, "finish_reason": "stop"}]}
+            self.wfile.write(f"data: {json.dumps(done)}\n\n".encode("utf-8"))
+            if usage is not None:
+                tail = {"id": completion_id, "object": "chat.completion.chunk", "created": int(time.time()),
+                        "model": model, "choices": [], "usage": usage}
+                self.wfile.write(f"data: {json.dumps(tail)}\n\n".encode("utf-8"))
+            self.wfile.write(b"data: [DONE]\n\n")
+            self.wfile.flush()
+            self.close_connection = True
+
+    return Handler
+
+
+def main():
+    parser = argparse.ArgumentParser(description="本地 OpenAI 兼容替身服务")
+    parser.add_argument("--host", default="127.0.0.1")
+    parser.add_argument("--port", type=int, default=8800)
+    parser.add_argument("--rpm", type=int, default=0, help="每分钟请求上限，0 为不限（默认 0）")
+    parser.add_argument("--latency", type=float, default=0.5, help="首包延迟秒数（默认 0.5）")
+    parser.add_argument("--chunk-size", type=int, default=64, help="流式返回每块字符数（默认 64）")
+    parser.add_argument("--chunk-delay", type=float, default=0.0, help="流式返回块间延迟秒数（默认 0）")
+    parser.add_argument("--error-rate", type=float, default=0.0, help="返回 500 的比例（默认 0）")
+    parser.add_argument("--reply-file", default="", help="固定返回的文本文件")
+    parser.add_argument("--prefill-ms", type=float, default=0.0,
+                        help="每 1k 个未命中前缀缓存的 prompt token 增加的首包延迟毫秒数（默认 0）")
+    parser.add_argument("--prefix-block", type=int, default=256, help="前缀缓存分块字符数（默认 256）")
+    parser.add_argument("-v", "--verbose", action="store_true", help="打印访问日志")
+    args = parser.parse_args()
+
+    server = ThreadingHTTPServer((args.host, args.port), make_handler(MockState(args)))
+    print(f"🧪 mock OpenAI 服务: http://{args.host}:{args.port}/v1/  (rpm={args.rpm or '不限'})", flush=True)
+    try:
+        server.serve_forever()
+    except KeyboardInterrupt:
+        pass
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,1006 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+参数化（TEST_P）单测渲染：
+- 模板通过 PARAM_SUITE 描述算子的参数字段、输入输出形状、属性与数据类型槽位
+- 模板通过 param_values(op_name, spec, idx, helpers) 给出每行 xlsx 对应的字段取值
+- 本模块据此生成一份 TilingParams / Harness / TEST_P 代码，外加紧凑的 test_params[] 数据表，
+  用例再多也只编译一个函数体
+- compile_info/平台信息来自公共前缀中的 TilingPlatformCache（见 platform_cache.py）
+
+PARAM_SUITE 结构（dict）：
+  compile_info:     CompileInfo 结构体名，可选，默认 <Op>CompileInfo
+  kernel_io:        KernelRunContextFaker 的 (输入数, 输出数)
+  fields:           [(字段名, C++类型, 默认值), ...]
+                    C++类型支持 int64_t / bool / float / std::string / ge::DataType / std::vector<int64_t>
+  inputs:           [(形状名, [维度表达式, ...], 可选的 bool 字段名) 或 None, ...]
+                    维度表达式可直接引用 int64_t 字段，如 "A * 128"；bool 字段为 false 时传 nullptr
+  outputs:          同 inputs
+  attrs:            [(属性名, C++类型, 字段名), ...]
+  dtypes:           输入+输出的数据类型槽位，元素为 ge::DataType 字段名、固定值（如 "DT_INT32"）或 None（不设置）
+  groups:           [(通信域字段名, rank_size 字段名), ...]，可选
+  soc_version:      SoC 版本字段名（std::string，非空时注入 "version" 平台资源），可选
+  topo_comm_sets:   是否设置 topo_level_descs[0].comm_sets，可选，默认 False
+  set_op_type:      是否调用 SetOpType，可选，默认 True
+  tiling_data_cap:  TilingData/Workspace 容量，可选，默认 4096
+"""
+
+from __future__ import annotations
+
+import math
+import re
+from dataclasses import dataclass, field
+from typing import Any, Callable, Dict, List, Optional, Tuple
+
+
+SUPPORTED_CTYPES = {
+    "int64_t",
+    "bool",
+    "float",
+    "std::string",
+    "ge::DataType",
+    "std::vector<int64_t>",
+}
+
+IDENT_PATTERN = re.compile(r"[A-Za-z_][A-Za-z0-9_]*")
+
+# ge::DataType 的全部枚举名（graph/types.h）；不在其中的取值在生成期报错，而不是静默变成 DT_UNDEFINED。
+# 运行时加载用例时无法预知 dtype 取值，ParseDataType 覆盖全部枚举，cases 模式写出的取值因此都能被运行时识别
+KNOWN_DTYPES = frozenset([
+    "DT_FLOAT", "DT_FLOAT16", "DT_INT8", "DT_INT32", "DT_UINT8", "DT_INT16", "DT_UINT16", "DT_UINT32",
+    "DT_INT64", "DT_UINT64", "DT_DOUBLE", "DT_BOOL", "DT_STRING", "DT_DUAL_SUB_INT8", "DT_DUAL_SUB_UINT8",
+    "DT_COMPLEX64", "DT_COMPLEX128", "DT_QINT8", "DT_QINT16", "DT_QINT32", "DT_QUINT8", "DT_QUINT16",
+    "DT_RESOURCE", "DT_STRING_REF", "DT_DUAL", "DT_VARIANT", "DT_BF16", "DT_UNDEFINED", "DT_INT4",
+    "DT_UINT1", "DT_INT2", "DT_UINT2", "DT_COMPLEX32", "DT_HIFLOAT8", "DT_FLOAT8_E5M2", "DT_FLOAT8_E4M3FN",
+    "DT_FLOAT8_E8M0", "DT_FLOAT6_E3M2", "DT_FLOAT6_E2M3", "DT_FLOAT4_E2M1", "DT_FLOAT4_E1M2",
+])
+
+
+class UnknownDataTypeError(ValueError):
+    """dtype 取值无法识别为 ge::DataType 枚举。"""
+
+    def __init__(self, field_name: str, value: Any):
+        self.field_name = field_name
+        self.value = value
+        super().__init__(f"字段 {field_name} 的数据类型无法识别: {value!r}")
+
+
+@dataclass
+class ParamField:
+    name: str
+    ctype: str
+    default: Any
+
+
+@dataclass
+class ShapeSlot:
+    name: str
+    dims: List[str]
+    # bool 字段名：为 false 时该槽位传 nullptr
+    present: Optional[str] = None
+
+
+@dataclass
+class ParamSuite:
+    op_name: str
+    compile_info: str
+    kernel_io: Tuple[int, int]
+    fields: List[ParamField]
+    inputs: List[Optional[ShapeSlot]]
+    outputs: List[Optional[ShapeSlot]]
+    attrs: List[Tuple[str, str, str]]
+    dtypes: List[Optional[str]]
+    groups: List[Tuple[str, str]] = field(default_factory=list)
+    soc_version: Optional[str] = None
+    topo_comm_sets: bool = False
+    set_op_type: bool = True
+    tiling_data_cap: int = 4096
+
+    @property
+    def harness(self) -> str:
+        return f"{self.op_name}TilingHarness"
+
+    @property
+    def fixture(self) -> str:
+        return f"{self.op_name}TilingParamTest"
+
+    @property
+    def namespace(self) -> str:
+        return f"{snake_from_camel(self.op_name)}_param_ut"
+
+    def field_map(self) -> Dict[str, ParamField]:
+        return {f.name: f for f in self.fields}
+
+
+@dataclass
+class TestParamRow:
+    """对应 C++ 侧 TestParam 的一行。"""
+    test_name: str
+    params: List[Tuple[str, str]]
+    status: str = "ge::GRAPH_SUCCESS"
+    tiling_key: Optional[str] = None
+
+
+def snake_from_camel(name: str) -> str:
+    s1 = re.sub(r"([a-z0-9])([A-Z])", r"\1_\2", name)
+    s2 = re.sub(r"([A-Z]+)([A-Z][a-z])", r"\1_\2", s1)
+    return s2.lower()
+
+
+def cpp_string_literal(value: str) -> str:
+    escaped = str(value).replace("\\", "\\\\").replace("\"", "\\\"").replace("\n", "\\n")
+    return f"\"{escaped}\""
+
+
+def normalize_dtype(value: Any) -> str:
+    """将 "bf16"/"ge::DT_BF16"/"DT_BF16" 等写法统一为 DT_XXX。"""
+    s = str(value).strip()
+    if s.startswith("ge::"):
+        s = s[len("ge::"):]
+    s = s.upper()
+    aliases = {
+        "BF16": "DT_BF16",
+        "BFLOAT16": "DT_BF16",
+        "FP16": "DT_FLOAT16",
+        "FLOAT16": "DT_FLOAT16",
+        "FP32": "DT_FLOAT",
+        "FLOAT32": "DT_FLOAT",
+        "FLOAT": "DT_FLOAT",
+    }
+    if s in aliases:
+        return aliases[s]
+    if not s.startswith("DT_"):
+        s = "DT_" + s
+    return s
+
+
+def checked_dtype(field_name: str, value: Any) -> str:
+    """normalize_dtype 之后必须是已知的 ge::DataType 枚举名，否则抛 UnknownDataTypeError。"""
+    dtype = normalize_dtype(value)
+    if dtype not in KNOWN_DTYPES:
+        raise UnknownDataTypeError(field_name, value)
+    return dtype
+
+
+def _is_missing(value: Any) -> bool:
+    if value is None:
+        return True
+    if isinstance(value, float) and math.isnan(value):
+        return True
+    return isinstance(value, str) and value.strip().lower() in {"", "nan", "none", "null"}
+
+
+def format_field_value(pf: ParamField, value: Any) -> Optional[str]:
+    """将 Python 值格式化为 tiling_params_str_handlers 可解析的字符串；缺省值返回 None。"""
+    if _is_missing(value):
+        return None
+    if pf.ctype == "int64_t":
+        return str(int(float(value)))
+    if pf.ctype == "bool":
+        if isinstance(value, str):
+            return "true" if value.strip().lower() in {"1", "true", "t", "yes", "y"} else "false"
+        return "true" if bool(value) else "false"
+    if pf.ctype == "float":
+        return repr(float(value))
+    if pf.ctype == "ge::DataType":
+        return checked_dtype(pf.name, value)
+    if pf.ctype == "std::vector<int64_t>":
+        if isinstance(value, str):
+            items = [x for x in re.split(r"[\s,\[\]()]+", value) if x]
+        else:
+            items = list(value)
+        return ",".join(str(int(float(x))) for x in items)
+    return str(value)
+
+
+def cpp_default_literal(pf: ParamField) -> str:
+    value = pf.default
+    if pf.ctype == "int64_t":
+        return str(int(value))
+    if pf.ctype == "bool":
+        return "true" if value else "false"
+    if pf.ctype == "float":
+        return f"{float(value)!r}f"
+    if pf.ctype == "std::string":
+        return cpp_string_literal(value if value is not None else "")
+    if pf.ctype == "ge::DataType":
+        return f"ge::{normalize_dtype(value)}"
+    if pf.ctype == "std::vector<int64_t>":
+        return ", ".join(str(int(x)) for x in (value or []))
+    raise ValueError(f"不支持的字段类型: {pf.ctype}")
+
+
+def build_param_suite(op_name: str, raw: Dict[str, Any]) -> ParamSuite:
+    """将模板导出的 PARAM_SUITE 字典规整为 ParamSuite，并做引用一致性检查。"""
+    fields = [ParamField(str(n), str(t), d) for (n, t, d) in raw.get("fields", [])]
+    names = {f.name for f in fields}
+    for f in fields:
+        if f.ctype not in SUPPORTED_CTYPES:
+            raise ValueError(f"字段 {f.name} 的类型不受支持: {f.ctype}")
+        if f.ctype == "ge::DataType":
+            checked_dtype(f.name, f.default)
+
+    def _slots(items: List[Any]) -> List[Optional[ShapeSlot]]:
+        slots: List[Optional[ShapeSlot]] = []
+        for item in items:
+            if item is None:
+                slots.append(None)
+                continue
+            name, dims = item[0], [str(d) for d in item[1]]
+            present = item[2] if len(item) > 2 else None
+            if present is not None and present not in names:
+                raise ValueError(f"形状 {name} 引用了未声明的字段: {present}")
+            for d in dims:
+                for ident in IDENT_PATTERN.findall(d):
+                    if ident not in names:
+                        raise ValueError(f"形状 {name} 的维度表达式引用了未声明的字段: {ident}")
+            slots.append(ShapeSlot(str(name), dims, present))
+        return slots
+
+    inputs = _slots(raw.get("inputs", []))
+    outputs = _slots(raw.get("outputs", []))
+
+    attrs = [(str(a), str(t), str(f)) for (a, t, f) in raw.get("attrs", [])]
+    for attr_name, _ctype, field_name in attrs:
+        if field_name not in names:
+            raise ValueError(f"属性 {attr_name} 引用了未声明的字段: {field_name}")
+
+    dtypes: List[Optional[str]] = list(raw.get("dtypes", []))
+    if len(dtypes) != len(inputs) + len(outputs):
+        raise ValueError(f"dtypes 槽位数({len(dtypes)})与输入输出数({len(inputs) + len(outputs)})不一致")
+    for i, slot in enumerate(dtypes):
+        if slot is not None and slot not in names:
+            checked_dtype(f"dtypes[{i}]", slot)
+
+    groups = [(str(g), str(r)) for (g, r) in raw.get("groups", [])]
+    for g, r in groups:
+        if g not in names or r not in names:
+            raise ValueError(f"通信域 ({g}, {r}) 引用了未声明的字段")
+
+    soc_version = raw.get("soc_version")
+    if soc_version is not None and soc_version not in names:
+        raise ValueError(f"soc_version 引用了未声明的字段: {soc_version}")
+
+    return ParamSuite(
+        op_name=op_name,
+        compile_info=raw.get("compile_info") or f"{op_name}CompileInfo",
+        kernel_io=tuple(raw.get("kernel_io", (len(inputs), len(outputs)))),
+        fields=fields,
+        inputs=inputs,
+        outputs=outputs,
+        attrs=attrs,
+        dtypes=dtypes,
+        groups=groups,
+        soc_version=soc_version,
+        topo_comm_sets=bool(raw.get("topo_comm_sets", False)),
+        set_op_type=bool(raw.get("set_op_type", True)),
+        tiling_data_cap=int(raw.get("tiling_data_cap", 4096)),
+    )
+
+
+def _expected_status(spec: Any) -> str:
+    expected_ret = getattr(spec, "expected_ret", None)
+    if expected_ret is not None:
+        return str(expected_ret)
+    expect_success = getattr(spec, "expect_success", True)
+    return "ge::GRAPH_SUCCESS" if expect_success else "ge::GRAPH_FAILED"
+
+
+def _expected_tiling_key(spec: Any) -> Optional[str]:
+    key_str = getattr(spec, "expected_tiling_key_str", None)
+    if key_str is not None:
+        return str(key_str)
+    key_val = getattr(spec, "expected_tiling_key", None)
+    if key_val is None:
+        return None
+    return f"{int(key_val)}ULL"
+
+
+def build_test_param(suite: ParamSuite, spec: Any, values: Dict[str, Any]) -> TestParamRow:
+    """根据模板给出的字段取值生成一行 TestParam；与默认值相同的字段不写入数据表。"""
+    fmap = suite.field_map()
+    params: List[Tuple[str, str]] = []
+    for name, value in values.items():
+        pf = fmap.get(name)
+        if pf is None:
+            raise ValueError(f"param_values 返回了未声明的字段: {name}")
+        formatted = format_field_value(pf, value)
+        if formatted is None:
+            continue
+        if formatted == format_field_value(pf, pf.default):
+            continue
+        params.append((name, formatted))
+    return TestParamRow(
+        test_name=str(spec.name),
+        params=params,
+        status=_expected_status(spec),
+        tiling_key=_expected_tiling_key(spec),
+    )
+
+
+def unique_test_names(rows: List[TestParamRow]) -> None:
+    """INSTANTIATE_TEST_SUITE_P 要求用例名为合法标识符且不重复。"""
+    seen: Dict[str, int] = {}
+    for row in rows:
+        name = re.sub(r"[^A-Za-z0-9_]", "_", row.test_name).strip("_") or "case"
+        if name[0].isdigit():
+            name = "case_" + name
+        if name in seen:
+            seen[name] += 1
+            name = f"{name}_{seen[name]}"
+        else:
+            seen[name] = 0
+        row.test_name = name
+
+
+# =============================================================================
+# C++ 代码生成
+# =============================================================================
+
+def _dtype_literals(suite: ParamSuite, rows: List[TestParamRow]) -> List[str]:
+    """收集 ParseDataType 需要识别的 dtype，仅生成实际用到的枚举值。"""
+    used = set()
+    fmap = suite.field_map()
+    for pf in suite.fields:
+        if pf.ctype == "ge::DataType":
+            used.add(normalize_dtype(pf.default))
+    for slot in suite.dtypes:
+        if slot is not None and slot not in fmap:
+            used.add(normalize_dtype(slot))
+    for row in rows:
+        for name, value in row.params:
+            if fmap[name].ctype == "ge::DataType":
+                used.add(value)
+    return sorted(used)
+
+
+def _handler_body(pf: ParamField) -> str:
+    target = f"tiling_params.{pf.name}"
+    if pf.ctype == "int64_t":
+        return f"{target} = std::stoll(value_str);"
+    if pf.ctype == "bool":
+        return f"{target} = (value_str == \"true\" || value_str == \"1\");"
+    if pf.ctype == "float":
+        return f"{target} = std::stof(value_str);"
+    if pf.ctype == "ge::DataType":
+        return f"{target} = ParseDataType(value_str);"
+    if pf.ctype == "std::vector<int64_t>":
+        return f"{target} = ParseInt64List(value_str);"
+    return f"{target} = value_str;"
+
+
+def _shape_ref(slot: Optional[ShapeSlot]) -> str:
+    if slot is None:
+        return "nullptr"
+    ref = f"&tiling_shapes.{slot.name}"
+    if slot.present:
+        return f"(tiling_params.{slot.present} ? {ref} : nullptr)"
+    return ref
+
+
+def _dtype_ref(slot: Optional[str], fmap: Dict[str, ParamField]) -> str:
+    if slot in fmap:
+        return f"tiling_params.{slot}"
+    return f"ge::{normalize_dtype(slot)}"
+
+
+def render_harness(suite: ParamSuite, rows: List[TestParamRow], all_dtypes: bool = False) -> str:
+    """生成 TestParam/TilingParams/TilingShapes 与算子专属 Harness 类。
+
+    all_dtypes 为 True 时 ParseDataType 覆盖 KNOWN_DTYPES（用例表在运行时加载）。
+    """
+    fmap = suite.field_map()
+    H = suite.harness
+    in_num, out_num = len(suite.inputs), len(suite.outputs)
+    slots = [s for s in suite.inputs + suite.outputs if s is not None]
+    dims_idents = set()
+    for s in slots:
+        for d in s.dims:
+            dims_idents.update(IDENT_PATTERN.findall(d))
+    has_vector = any(f.ctype == "std::vector<int64_t>" for f in suite.fields)
+    has_dtype_field = any(f.ctype == "ge::DataType" for f in suite.fields)
+
+    out: List[str] = []
+    out.append("#include <cstdint>")
+    out.append("#include <cstdlib>")
+    out.append("#include <fstream>")
+    out.append("#include <functional>")
+    out.append("#include <iostream>")
+    out.append("#include <map>")
+    out.append("#include <ostream>")
+    out.append("#include <stdexcept>")
+    out.append("#include <string>")
+    out.append("#include <unordered_map>")
+    out.append("#include <utility>")
+    out.append("#include <vector>")
+    out.append("")
+    out.append(f"namespace {suite.namespace}")
+    out.append("{")
+    out.append("struct TestParam {")
+    out.append("    std::string test_name{};")
+    out.append("    std::vector<std::pair<std::string, std::string>> tiling_params_str_pair{};")
+    out.append("    ge::graphStatus status;")
+    out.append("    bool check_tiling_key{false};")
+    out.append("    uint64_t tiling_key{0};")
+    out.append("};")
+    out.append("")
+    out.append("// 失败信息中按用例名打印参数，否则 gtest 会逐字节转储整个结构体")
+    out.append("inline void PrintTo(const TestParam& param, std::ostream* os)")
+    out.append("{")
+    out.append("    *os << param.test_name;")
+    out.append("}")
+    out.append("")
+    out.append("struct TilingParams {")
+    for pf in suite.fields:
+        out.append(f"    {pf.ctype} {pf.name}{{{cpp_default_literal(pf)}}};")
+    out.append("};")
+    out.append("")
+    out.append("struct TilingShapes {")
+    for s in slots:
+        out.append(f"    gert::StorageShape {s.name};")
+    out.append("};")
+    out.append("")
+    if has_dtype_field:
+        out.append("inline ge::DataType ParseDataType(const std::string& value_str)")
+        out.append("{")
+        out.append("    static const std::unordered_map<std::string, ge::DataType> dtypes = {")
+        literals = sorted(KNOWN_DTYPES) if all_dtypes else _dtype_literals(suite, rows)
+        for dt in literals:
+            out.append(f"        {{\"{dt}\", ge::{dt}}},")
+        out.append("    };")
+        out.append("    auto it = dtypes.find(value_str);")
+        out.append("    if (it == dtypes.end()) {")
+        out.append("        throw std::invalid_argument(\"unknown dtype: \" + value_str);")
+        out.append("    }")
+        out.append("    return it->second;")
+        out.append("}")
+        out.append("")
+    if has_vector:
+        out.append("inline std::vector<int64_t> ParseInt64List(const std::string& value_str)")
+        out.append("{")
+        out.append("    std::vector<int64_t> values;")
+        out.append("    size_t pos = 0;")
+        out.append("    while (pos < value_str.size()) {")
+        out.append("        size_t next = value_str.find(',', pos);")
+        out.append("        if (next == std::string::npos) {")
+        out.append("            next = value_str.size();")
+        out.append("        }")
+        out.append("        if (next > pos) {")
+        out.append("            values.push_back(std::stoll(value_str.substr(pos, next - pos)));")
+        out.append("        }")
+        out.append("        pos = next + 1;")
+        out.append("    }")
+        out.append("    return values;")
+        out.append("}")
+        out.append("")
+    out.append(f"class {H}")
+    out.append("{")
+    out.append("public:")
+    out.append("    void InitTilingParams(const std::vector<std::pair<std::string, std::string>>& tiling_params_pair)")
+    out.append("    {")
+    out.append("        this->tiling_params = TilingParams{};")
+    out.append("        auto& tiling_params = this->tiling_params;")
+    out.append(f"        auto& tiling_params_str_handlers = {H}::tiling_params_str_handlers;")
+    out.append("        for (auto& kv : tiling_params_pair) {")
+    out.append("            if (tiling_params_str_handlers.count(kv.first) != 0) {")
+    out.append("                tiling_params_str_handlers[kv.first](tiling_params, kv.second);")
+    out.append("            }")
+    out.append("        }")
+    out.append("        if (derive_params) {")
+    out.append("            derive_params(tiling_params);")
+    out.append("        }")
+    if suite.groups:
+        out.append("        if (!group_suffix.empty()) {")
+        for g, _r in suite.groups:
+            out.append(f"            tiling_params.{g} += group_suffix;")
+        out.append("        }")
+    out.append("    }")
+    out.append("")
+    out.append("    void InitTilingShape()")
+    out.append("    {")
+    out.append("        auto const& tiling_params = this->tiling_params;")
+    for pf in suite.fields:
+        if pf.name in dims_idents:
+            out.append(f"        auto {pf.name} = tiling_params.{pf.name};")
+    out.append("")
+    out.append("        auto& tiling_shapes = this->tiling_shapes;")
+    for s in slots:
+        dims = ", ".join(s.dims)
+        out.append(f"        tiling_shapes.{s.name} = {{{{{dims}}}, {{{dims}}}}};")
+    out.append("    }")
+    out.append("")
+    out.append("    void InitHolder(void* tilingData, gert::ContinuousVector* workspace,")
+    out.append("                    const std::vector<std::pair<std::string, std::string>>& tiling_params_pair)")
+    out.append("    {")
+    out.append("        auto& compile_info_string = TilingPlatformCache::Get().compile_info_string;")
+    out.append("        auto& platform_info = this->platform_info;")
+    out.append("        auto& compile_info = this->compile_info;")
+    out.append("        platform_info.Init();")
+    out.append("")
+    out.append("        this->kernel_faker =")
+    out.append("            gert::KernelRunContextFaker()")
+    out.append(f"                .KernelIONum({suite.kernel_io[0]}, {suite.kernel_io[1]})")
+    out.append("                .Inputs({const_cast<char*>(compile_info_string.c_str()), reinterpret_cast<void*>(&platform_info)})")
+    out.append("                .Outputs({&compile_info});")
+    out.append("        this->kernel_holder = this->kernel_faker.Build();")
+    out.append("")
+    out.append("        this->InitTilingParams(tiling_params_pair);")
+    out.append("        auto const& tiling_params = this->tiling_params;")
+    out.append("")
+    out.append("        this->InitTilingShape();")
+    out.append("        auto& tiling_shapes = this->tiling_shapes;")
+    out.append("")
+    dtype_refs = ", ".join(
+        "ge::DT_UNDEFINED" if d is None else _dtype_ref(d, fmap) for d in suite.dtypes
+    )
+    out.append(f"        std::vector<ge::DataType> dtypes{{{dtype_refs}}};")
+    out.append(f"        std::string op_type(\"{suite.op_name}\");")
+    out.append("")
+    out.append("        this->tiling_faker =")
+    out.append("            gert::TilingContextFaker()")
+    out.append(f"                .NodeIoNum({in_num}, {out_num})")
+    out.append(f"                .IrInstanceNum({{{', '.join(['1'] * in_num)}}})")
+    out.append(f"                .InputShapes({{{', '.join(_shape_ref(s) for s in suite.inputs)}}})")
+    out.append(f"                .OutputShapes({{{', '.join(_shape_ref(s) for s in suite.outputs)}}})")
+    attr_lines = [
+        f"{{\"{a}\", ge::AnyValue::CreateFrom<{t}>(tiling_params.{f})}}" for (a, t, f) in suite.attrs
+    ]
+    if attr_lines:
+        out.append("                .NodeAttrs({" + (",\n" + " " * 28).join(attr_lines) + "})")
+    out.append("                .CompileInfo(&compile_info)")
+    out.append("                .PlatformInfo(reinterpret_cast<char*>(&platform_info))")
+    out.append("                .TilingData(tilingData)")
+    if suite.set_op_type:
+        out.append("                .Workspace(workspace)")
+        out.append("                .SetOpType(op_type);")
+    else:
+        out.append("                .Workspace(workspace);")
+    out.append("")
+    out.append(f"        for (int64_t i = 0; i < {in_num}; ++i) {{")
+    out.append("            if (dtypes[i] != ge::DT_UNDEFINED) {")
+    out.append("                this->tiling_faker.NodeInputTd(i, dtypes[i], ge::FORMAT_ND, ge::FORMAT_ND);")
+    out.append("            }")
+    out.append("        }")
+    out.append(f"        for (int64_t i = 0; i < {out_num}; ++i) {{")
+    out.append(f"            if (dtypes[{in_num} + i] != ge::DT_UNDEFINED) {{")
+    out.append(f"                this->tiling_faker.NodeOutputTd(i, dtypes[{in_num} + i], ge::FORMAT_ND, ge::FORMAT_ND);")
+    out.append("            }")
+    out.append("        }")
+    out.append("        this->tiling_holder = this->tiling_faker.Build();")
+    out.append("    }")
+    out.append("")
+    out.append("    gert::TilingContext* GetTilingContext()")
+    out.append("    {")
+    out.append("        return this->tiling_holder.GetContext<gert::TilingContext>();")
+    out.append("    }")
+    out.append("")
+    out.append("    void SetPlatformRes(const TilingPlatformCache& platform_cache)")
+    out.append("    {")
+    out.append("        auto* platform = this->GetTilingContext()->GetPlatformInfo();")
+    out.append("        platform_cache.Apply(*platform);")
+    if suite.soc_version:
+        out.append(f"        if (!this->tiling_params.{suite.soc_version}.empty()) {{")
+        out.append(f"            std::map<std::string, std::string> version = {{{{\"Short_SoC_version\", this->tiling_params.{suite.soc_version}}}}};")
+        out.append("            platform->SetPlatformRes(\"version\", version);")
+        out.append("        }")
+    out.append("    }")
+    out.append("")
+    out.append("    void SetTopoInfo()")
+    out.append("    {")
+    for g, r in suite.groups:
+        out.append("        {")
+        out.append("            ge::HcomTopoInfo::TopoInfo topoInfo;")
+        out.append(f"            topoInfo.rank_size = this->tiling_params.{r};")
+        if suite.topo_comm_sets:
+            out.append("            topoInfo.topo_level_descs[0].comm_sets = 0b1U;")
+        out.append(f"            ge::HcomTopoInfo::Instance().SetGroupTopoInfo(this->tiling_params.{g}.c_str(), topoInfo);")
+        out.append("        }")
+    out.append("    }")
+    out.append("")
+    out.append("    void UnsetTopoInfo()")
+    out.append("    {")
+    for g, _r in suite.groups:
+        out.append(f"        ge::HcomTopoInfo::Instance().UnsetGroupTopoInfo(this->tiling_params.{g}.c_str());")
+    out.append("    }")
+    out.append("")
+    out.append("public:")
+    out.append("    TilingParams tiling_params;")
+    out.append("    TilingShapes tiling_shapes;")
+    out.append(f"    struct {suite.compile_info} {{")
+    out.append("    } compile_info;")
+    out.append("    fe::PlatFormInfos platform_info;")
+    out.append("    gert::KernelRunContextFaker kernel_faker{};")
+    out.append("    gert::KernelRunContextHolder kernel_holder{};")
+    out.append("    gert::TilingContextFaker tiling_faker{};")
+    out.append("    gert::KernelRunContextHolder tiling_holder{};")
+    out.append("    // 可选：参数解析后按其它字段推导（扫参时用于保持形状间的约束）")
+    out.append("    std::function<void(TilingParams& tiling_params)> derive_params{};")
+    out.append("    // 可选：追加到所有通信域字段（HcomTopoInfo 为进程级单例，并发执行时各线程注册不同的 group）")
+    out.append("    std::string group_suffix{};")
+    out.append("    static std::unordered_map<std::string, std::function<void(TilingParams& tiling_params, const std::string& value_str)>>")
+    out.append("        tiling_params_str_handlers;")
+    out.append("};")
+    out.append("")
+    out.append("std::unordered_map<std::string, std::function<void(TilingParams& tiling_params, const std::string& value_str)>>")
+    out.append(f"    {H}::tiling_params_str_handlers = {{")
+    handler_lines = [
+        f"        {{\"{pf.name}\", [](TilingParams& tiling_params, const std::string& value_str) {{ {_handler_body(pf)} }}}}"
+        for pf in suite.fields
+    ]
+    out.append(",\n".join(handler_lines) + "};")
+    out.append("")
+    out.append("// SetTopoInfo 的 RAII 封装：析构时 UnsetTopoInfo，tiling_func 抛异常时也不会在 HcomTopoInfo 中残留 group")
+    out.append("class TopoInfoGuard")
+    out.append("{")
+    out.append("public:")
+    out.append(f"    explicit TopoInfoGuard({H}& harness) : harness(harness)")
+    out.append("    {")
+    out.append("        harness.SetTopoInfo();")
+    out.append("    }")
+    out.append("")
+    out.append("    ~TopoInfoGuard()")
+    out.append("    {")
+    out.append("        harness.UnsetTopoInfo();")
+    out.append("    }")
+    out.append("")
+    out.append("    TopoInfoGuard(const TopoInfoGuard&) = delete;")
+    out.append("    TopoInfoGuard& operator=(const TopoInfoGuard&) = delete;")
+    out.append("")
+    out.append("private:")
+    out.append(f"    {H}& harness;")
+    out.append("};")
+    return "\n".join(out) + "\n"
+
+
+def render_param_row(row: TestParamRow) -> str:
+    params = ", ".join(f"{{\"{k}\", {cpp_string_literal(v)}}}" for k, v in row.params)
+    if row.tiling_key is not None:
+        key = f"true, {row.tiling_key}"
+    else:
+        key = "false, 0"
+    return f"    {{\"{row.test_name}\", {{{params}}}, {row.status}, {key}}}"
+
+
+def render_case_runner(suite: ParamSuite) -> str:
+    """生成单条用例的执行函数，TEST_P 与运行时加载的用例共用。"""
+    H = suite.harness
+    cap = suite.tiling_data_cap
+    out: List[str] = []
+    out.append(f"inline void RunTilingCase({H}& harness, const TestParam& test_param)")
+    out.append("{")
+    out.append(f"    std::string op_type(\"{suite.op_name}\");")
+    out.append("    ASSERT_NE(gert::OpImplRegistry::GetInstance().GetOpImpl(op_type.c_str()), nullptr);")
+    out.append("    auto tiling_func = gert::OpImplRegistry::GetInstance().GetOpImpl(op_type.c_str())->tiling;")
+    out.append("")
+    out.append("    const auto& platform_cache = TilingPlatformCache::Get();")
+    out.append("")
+    out.append(f"    auto tilingData = gert::TilingData::CreateCap({cap});")
+    out.append("    ASSERT_NE(tilingData, nullptr);")
+    out.append(f"    auto workspace_holer = gert::ContinuousVector::Create<size_t>({cap});")
+    out.append("    auto workspace = reinterpret_cast<gert::ContinuousVector*>(workspace_holer.get());")
+    out.append("")
+    out.append("    harness.InitHolder(tilingData.get(), workspace, test_param.tiling_params_str_pair);")
+    out.append("    gert::TilingContext* tiling_context = harness.GetTilingContext();")
+    out.append("    ASSERT_NE(tiling_context->GetPlatformInfo(), nullptr);")
+    out.append("    harness.SetPlatformRes(platform_cache);")
+    out.append("")
+    out.append("    {")
+    out.append("        TopoInfoGuard topo_guard(harness);")
+    out.append("        EXPECT_EQ(tiling_func(tiling_context), test_param.status);")
+    out.append("    }")
+    out.append("    if (test_param.check_tiling_key) {")
+    out.append("        EXPECT_EQ(tiling_context->GetTilingKey(), test_param.tiling_key);")
+    out.append("    }")
+    out.append("}")
+    return "\n".join(out) + "\n"
+
+
+def render_param_tests(suite: ParamSuite, rows: List[TestParamRow], row_texts: Optional[List[str]] = None) -> str:
+    """生成 fixture、唯一的 TEST_P 函数体、test_params[] 数据表与 INSTANTIATE_TEST_SUITE_P。
+
+    row_texts 非空时直接作为 test_params[] 的初始化项（已逐行检查过的渲染结果）。
+    """
+    F, H = suite.fixture, suite.harness
+    out: List[str] = []
+    out.append(f"class {F} : public testing::TestWithParam<TestParam>")
+    out.append("{")
+    out.append("protected:")
+    out.append("    static void SetUpTestCase()")
+    out.append("    {")
+    out.append(f"        std::cout << \"{F} SetUp\" << std::endl;")
+    out.append("    }")
+    out.append("")
+    out.append("    static void TearDownTestCase()")
+    out.append("    {")
+    out.append(f"        std::cout << \"{F} TearDown\" << std::endl;")
+    out.append("    }")
+    out.append("")
+    out.append(f"    {H} harness;")
+    out.append("};")
+    out.append("")
+    out.append(f"TEST_P({F}, common_test)")
+    out.append("{")
+    out.append("    RunTilingCase(harness, GetParam());")
+    out.append("}")
+    out.append("")
+    out.append("static TestParam test_params[] = {")
+    out.append(",\n".join(row_texts if row_texts is not None else (render_param_row(r) for r in rows)))
+    out.append("};")
+    out.append("")
+    out.append(f"INSTANTIATE_TEST_SUITE_P({suite.op_name}TilingParam, {F},")
+    out.append("                         testing::ValuesIn(test_params),")
+    out.append(f"                         [](const testing::TestParamInfo<{F}::ParamType>& info) {{")
+    out.append("                             return info.param.test_name;")
+    out.append("                         });")
+    out.append(f"}} // namespace {suite.namespace}")
+    return "\n".join(out) + "\n"
+
+
+def render_param_file(common_prefix: str, suite: ParamSuite, rows: List[TestParamRow],
+                      check_row: Optional[Callable[[int, TestParamRow, str], Optional[str]]] = None) -> Optional[str]:
+    """check_row 非空时逐行检查 test_params[] 的初始化项：返回要写入的文本，返回 None 则丢弃该行；全部丢弃时返回 None。"""
+    unique_test_names(rows)
+    row_texts = None
+    if check_row is not None:
+        checked = (check_row(idx, row, render_param_row(row)) for idx, row in enumerate(rows, start=1))
+        row_texts = [text for text in checked if text is not None]
+        if not row_texts:
+            return None
+    return (
+        common_prefix
+        + "\n\n"
+        + render_harness(suite, rows)
+        + "\n"
+        + render_case_runner(suite)
+        + "\n"
+        + render_param_tests(suite, rows, row_texts)
+    )
+
+
+# =============================================================================
+# 运行时用例加载（驱动只编译一次，用例表在启动时读取）
+# =============================================================================
+
+CASE_TABLE_FIXED_COLUMNS = ["test_name", "status", "tiling_key"]
+
+
+def _plain_tiling_key(tiling_key: Optional[str]) -> str:
+    """"100ULL" -> "100"；无法解析为整数的表达式返回空串（运行时不校验）。"""
+    if tiling_key is None:
+        return ""
+    s = re.sub(r"[uUlL]+$", "", str(tiling_key).strip())
+    try:
+        return str(int(s, 0))
+    except ValueError:
+        return ""
+
+
+def render_case_table(suite: ParamSuite, rows: List[TestParamRow]) -> str:
+    """生成运行时驱动读取的用例表（CSV），列为 test_name,status,tiling_key,<字段...>；空单元格表示默认值。"""
+    import csv
+    import io
+
+    unique_test_names(rows)
+    columns = CASE_TABLE_FIXED_COLUMNS + [f.name for f in suite.fields]
+    buf = io.StringIO()
+    writer = csv.writer(buf, lineterminator="\n")
+    writer.writerow(columns)
+    for row in rows:
+        values = dict(row.params)
+        writer.writerow(
+            [row.test_name, row.status, _plain_tiling_key(row.tiling_key)]
+            + [values.get(f.name, "") for f in suite.fields]
+        )
+    return buf.getvalue()
+
+
+def render_runtime_registrar(suite: ParamSuite, default_case_file: str) -> str:
+    """生成用例表解析与 gtest RegisterTest 动态注册代码。"""
+    H = suite.harness
+    F = f"{suite.op_name}TilingRuntimeTest"
+    out: List[str] = []
+    out.append("inline std::vector<std::string> SplitCsvLine(const std::string& line)")
+    out.append("{")
+    out.append("    std::vector<std::string> cells;")
+    out.append("    std::string cell;")
+    out.append("    bool quoted = false;")
+    out.append("    for (size_t i = 0; i < line.size(); ++i) {")
+    out.append("        char c = line[i];")
+    out.append("        if (quoted) {")
+    out.append("            if (c == '\"' && i + 1 < line.size() && line[i + 1] == '\"') {")
+    out.append("                cell.push_back('\"');")
+    out.append("                ++i;")
+    out.append("            } else if (c == '\"') {")
+    out.append("                quoted = false;")
+    out.append("            } else {")
+    out.append("                cell.push_back(c);")
+    out.append("            }")
+    out.append("        } else if (c == '\"') {")
+    out.append("            quoted = true;")
+    out.append("        } else if (c == ',') {")
+    out.append("            cells.push_back(cell);")
+    out.append("            cell.clear();")
+    out.append("        } else if (c != '\\r') {")
+    out.append("            cell.push_back(c);")
+    out.append("        }")
+    out.append("    }")
+    out.append("    cells.push_back(cell);")
+    out.append("    return cells;")
+    out.append("}")
+    out.append("")
+    out.append("inline ge::graphStatus ParseStatus(const std::string& value_str)")
+    out.append("{")
+    out.append("    if (value_str.empty() || value_str.find(\"SUCCESS\") != std::string::npos) {")
+    out.append("        return ge::GRAPH_SUCCESS;")
+    out.append("    }")
+    out.append("    if (value_str.find(\"FAILED\") != std::string::npos) {")
+    out.append("        return ge::GRAPH_FAILED;")
+    out.append("    }")
+    out.append("    return static_cast<ge::graphStatus>(std::stoul(value_str, nullptr, 0));")
+    out.append("}")
+    out.append("")
+    out.append("// 表头固定为 test_name,status,tiling_key，其余列为 TilingParams 字段名；空单元格沿用默认值")
+    out.append("inline bool LoadCaseTable(const std::string& path, std::vector<TestParam>& cases, std::string& error)")
+    out.append("{")
+    out.append("    std::ifstream in(path);")
+    out.append("    if (!in.is_open()) {")
+    out.append("        error = \"cannot open case table: \" + path;")
+    out.append("        return false;")
+    out.append("    }")
+    out.append("    std::string line;")
+    out.append("    if (!std::getline(in, line)) {")
+    out.append("        error = \"empty case table: \" + path;")
+    out.append("        return false;")
+    out.append("    }")
+    out.append("    auto header = SplitCsvLine(line);")
+    out.append("    size_t line_no = 1;")
+    out.append("    while (std::getline(in, line)) {")
+    out.append("        ++line_no;")
+    out.append("        if (line.empty() || line == \"\\r\") {")
+    out.append("            continue;")
+    out.append("        }")
+    out.append("        auto cells = SplitCsvLine(line);")
+    out.append("        TestParam test_param{};")
+    out.append("        test_param.status = ge::GRAPH_SUCCESS;")
+    out.append("        try {")
+    out.append("            for (size_t i = 0; i < header.size() && i < cells.size(); ++i) {")
+    out.append("                const auto& key = header[i];")
+    out.append("                const auto& value = cells[i];")
+    out.append("                if (key == \"test_name\") {")
+    out.append("                    test_param.test_name = value;")
+    out.append("                } else if (key == \"status\") {")
+    out.append("                    test_param.status = ParseStatus(value);")
+    out.append("                } else if (key == \"tiling_key\") {")
+    out.append("                    if (!value.empty()) {")
+    out.append("                        test_param.check_tiling_key = true;")
+    out.append("                        test_param.tiling_key = std::stoull(value, nullptr, 0);")
+    out.append("                    }")
+    out.append(f"                }} else if (!value.empty() && {H}::tiling_params_str_handlers.count(key) != 0) {{")
+    out.append("                    test_param.tiling_params_str_pair.emplace_back(key, value);")
+    out.append("                }")
+    out.append("            }")
+    out.append("        } catch (const std::exception& e) {")
+    out.append("            error = path + \":\" + std::to_string(line_no) + \": \" + e.what();")
+    out.append("            return false;")
+    out.append("        }")
+    out.append("        if (test_param.test_name.empty()) {")
+    out.append("            test_param.test_name = \"case_\" + std::to_string(line_no - 1);")
+    out.append("        }")
+    out.append("        cases.push_back(test_param);")
+    out.append("    }")
+    out.append("    return true;")
+    out.append("}")
+    out.append("")
+    out.append(f"class {F} : public testing::Test")
+    out.append("{")
+    out.append("public:")
+    out.append(f"    explicit {F}(TestParam test_param) : test_param(std::move(test_param))")
+    out.append("    {")
+    out.append("    }")
+    out.append("")
+    out.append("    void TestBody() override")
+    out.append("    {")
+    out.append("        RunTilingCase(harness, test_param);")
+    out.append("    }")
+    out.append("")
+    out.append("private:")
+    out.append("    TestParam test_param;")
+    out.append(f"    {H} harness;")
+    out.append("};")
+    out.append("")
+    out.append("// 用例表路径：环境变量 UTGEN_CASE_FILE 优先，其次编译期宏 UTGEN_CASE_FILE_DEFAULT（生成时的绝对路径）；")
+    out.append("// 该路径不存在时（生成目录被整体拷走），依次在源文件、可执行文件、运行目录下查找同名用例表")
+    out.append("#ifndef UTGEN_CASE_FILE_DEFAULT")
+    out.append(f"#define UTGEN_CASE_FILE_DEFAULT {cpp_string_literal(default_case_file)}")
+    out.append("#endif")
+    out.append("")
+    out.append("inline std::vector<std::string> CaseFileCandidates()")
+    out.append("{")
+    out.append("    auto dir_of = [](const std::string& path) {")
+    out.append("        size_t pos = path.find_last_of('/');")
+    out.append("        return pos == std::string::npos ? std::string(\".\") : path.substr(0, pos);")
+    out.append("    };")
+    out.append("    std::string path = UTGEN_CASE_FILE_DEFAULT;")
+    out.append("    size_t slash = path.find_last_of('/');")
+    out.append("    std::string name = slash == std::string::npos ? path : path.substr(slash + 1);")
+    out.append("    std::vector<std::string> candidates{path, dir_of(__FILE__) + \"/\" + name};")
+    out.append("    char exe[4096];")
+    out.append("    ssize_t len = readlink(\"/proc/self/exe\", exe, sizeof(exe) - 1);")
+    out.append("    if (len > 0) {")
+    out.append("        exe[len] = '\\0';")
+    out.append("        candidates.push_back(dir_of(exe) + \"/\" + name);")
+    out.append("    }")
+    out.append("    candidates.push_back(name);")
+    out.append("    return candidates;")
+    out.append("}")
+    out.append("")
+    out.append("// gtest 要求在 RUN_ALL_TESTS 之前完成注册，SetUpTestSuite 时已来不及，因此在静态初始化阶段加载用例表")
+    out.append("struct CaseRegistrar {")
+    out.append("    CaseRegistrar()")
+    out.append("    {")
+    out.append("        const char* env_path = std::getenv(\"UTGEN_CASE_FILE\");")
+    out.append("        std::string path;")
+    out.append("        std::string tried;")
+    out.append("        if (env_path != nullptr && env_path[0] != '\\0') {")
+    out.append("            path = env_path;")
+    out.append("        } else {")
+    out.append("            for (const auto& candidate : CaseFileCandidates()) {")
+    out.append("                tried += (tried.empty() ? \"\" : \", \") + candidate;")
+    out.append("                if (std::ifstream(candidate).good()) {")
+    out.append("                    path = candidate;")
+    out.append("                    break;")
+    out.append("                }")
+    out.append("            }")
+    out.append("        }")
+    out.append("        std::vector<TestParam> cases;")
+    out.append("        std::string error;")
+    out.append("        if (path.empty()) {")
+    out.append("            error = \"case table not found (set UTGEN_CASE_FILE), tried: \" + tried;")
+    out.append("        } else if (LoadCaseTable(path, cases, error) && cases.empty()) {")
+    out.append("            error = \"case table has no cases: \" + path;")
+    out.append("        }")
+    out.append("        if (!error.empty()) {")
+    out.append(f"            testing::RegisterTest(\"{suite.op_name}TilingRuntime\", \"load_case_table\", nullptr, nullptr, __FILE__, __LINE__,")
+    out.append("                                  [error]() -> testing::Test* { return new CaseTableErrorTest(error); });")
+    out.append("            return;")
+    out.append("        }")
+    out.append("        std::cout << \"loaded \" << cases.size() << \" cases from \" << path << std::endl;")
+    out.append("        for (const auto& test_param : cases) {")
+    out.append(f"            testing::RegisterTest(\"{suite.op_name}TilingRuntime\", test_param.test_name.c_str(), nullptr, nullptr, __FILE__, __LINE__,")
+    out.append(f"                                  [test_param]() -> {F}* {{ return new {F}(test_param); }});")
+    out.append("        }")
+    out.append("    }")
+    out.append("")
+    out.append("    class CaseTableErrorTest : public testing::Test")
+    out.append("    {")
+    out.append("    public:")
+    out.append("        explicit CaseTableErrorTest(std::string error) : error(std::move(error))")
+    out.append("        {")
+    out.append("        }")
+    out.append("")
+    out.append("        void TestBody() override")
+    out.append("        {")
+    out.append("            FAIL() << error;")
+    out.append("        }")
+    out.append("")
+    out.append("    private:")
+    out.append("        std::string error;")
+    out.append("    };")
+    out.append("};")
+    out.append("")
+    out.append("static CaseRegistrar case_registrar;")
+    out.append(f"}} // namespace {suite.namespace}")
+    return "\n".join(out) + "\n"
+
+
+def render_runtime_file(common_prefix: str, suite: ParamSuite, default_case_file: str) -> str:
+    """生成运行时驱动：与 --mode param 共享 Harness/RunTilingCase，用例改为启动时从用例表注册。"""
+    return (
+        common_prefix
+        + "\n\n#include <unistd.h>\n"
+        + render_harness(suite, [], all_dtypes=True)
+        + "\n"
+        + render_case_runner(suite)
+        + "\n"
+        + render_runtime_registrar(suite, default_case_file)
+    )
@@ -0,0 +1,271 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+Stage 2 参数表流式读取：按行惰性产出 {列名: 单元格值}，不再整体载入 DataFrame 再 iterrows。
+
+- .xlsx/.xlsm：openpyxl read_only 模式逐行读取第一个工作表（iter_rows(values_only=True)），内存与行数无关
+- .csv：csv 模块逐行读取，数值文本转换为 int/float
+- .parquet / .arrow / .feather：pyarrow 按批读取（可选依赖，未安装时报错提示）
+- 空单元格、空字符串与 NaN 统一为 None；整数值的浮点数（如 1024.0）转为 int；日期单元格为 datetime
+- 按列转换：每 BATCH_ROWS 行为一批，对 converters 中的列逐列转换，同一列的相同取值只解析一次
+  （扫参表里形状/dtype 列高度重复）；解析成功的值写回行内，失败时保留原值，由 row_to_case 按原逻辑处理
+- RowBuilder 按同样的规则逐行构造行 dict，供 stage 1 → stage 2 流水线在参数行生成时直接渲染
+- ParamTable 可重复迭代（每次重新打开文件），同一次生成中 testf/bench/stress 多次遍历时内存不随行数增长
+
+用法：
+  python param_reader.py count params.xlsx     # 输出数据行数（workflow.sh 用）
+"""
+
+from __future__ import annotations
+
+import csv
+import math
+import re
+import sys
+from pathlib import Path
+from typing import Any, Callable, Dict, Iterator, List, Optional
+
+BATCH_ROWS = 4096
+# 每列记忆的不同取值上限，超过后清空重新累计
+MEMO_LIMIT = 1 << 16
+
+XLSX_SUFFIXES = {".xlsx", ".xlsm"}
+CSV_SUFFIXES = {".csv"}
+ARROW_SUFFIXES = {".parquet", ".arrow", ".feather"}
+
+_NUMBER_RE = re.compile(r"[+-]?(?:\d+\.?\d*|\.\d+)(?:[eE][+-]?\d+)?")
+
+Converter = Callable[[Any], Any]
+
+
+def to_number(text: str) -> Any:
+    """数值文本转为 int/float；整数值的浮点数转 int，非数值原样返回。"""
+    if not _NUMBER_RE.fullmatch(text):
+        return text
+    try:
+        return int(text)
+    except ValueError:
+        pass
+    value = float(text)
+    if math.isnan(value):
+        return None
+    return int(value) if value.is_integer() else value
+
+
+def normalize_cell(value: Any) -> Any:
+    if value is None:
+        return None
+    if isinstance(value, float):
+        if math.isnan(value):
+            return None
+        return int(value) if value.is_integer() else value
+    if isinstance(value, str) and not value.strip():
+        return None
+    return value
+
+
+def header_names(cells: List[Any]) -> List[str]:
+    """与 pandas 一致的列名：空列名为 "Unnamed: i"，重名依次追加 .1/.2。"""
+    names: List[str] = []
+    seen: Dict[str, int] = {}
+    for i, cell in enumerate(cells):
+        name = f"Unnamed: {i}" if normalize_cell(cell) is None else str(normalize_cell(cell))
+        if name in seen:
+            seen[name] += 1
+            name = f"{name}.{seen[name]}"
+        else:
+            seen[name] = 0
+        names.append(name)
+    return names
+
+
+# ---------------------------------------------------------------------------
+# xlsx
+# ---------------------------------------------------------------------------
+
+def iter_xlsx(path: Path) -> Iterator[List[Any]]:
+    import openpyxl
+    from openpyxl.utils.exceptions import InvalidFileException
+    from zipfile import BadZipFile
+
+    try:
+        wb = openpyxl.load_workbook(path, read_only=True, data_only=True)
+    except (BadZipFile, InvalidFileException) as e:
+        raise ValueError(f"不是有效的 xlsx 文件: {path}") from e
+    try:
+        for values in wb.worksheets[0].iter_rows(values_only=True):
+            yield list(values)
+    finally:
+        wb.close()
+
+
+# ---------------------------------------------------------------------------
+# csv / arrow
+# ---------------------------------------------------------------------------
+
+def iter_csv(path: Path) -> Iterator[List[Any]]:
+    with open(path, "r", encoding="utf-8-sig", newline="") as f:
+        reader = csv.reader(f)
+        header = next(reader, None)
+        if header is None:
+            return
+        yield header
+        for record in reader:
+            yield [to_number(cell) if cell else None for cell in record]
+
+
+def iter_arrow(path: Path, batch_rows: int = BATCH_ROWS) -> Iterator[List[Any]]:
+    try:
+        import pyarrow.ipc as ipc
+        import pyarrow.parquet as pq
+    except ImportError as e:
+        raise RuntimeError(f"读取 {path.suffix} 需要安装 pyarrow（pip install pyarrow）") from e
+
+    if path.suffix.lower() == ".parquet":
+        source = pq.ParquetFile(path)
+        names = source.schema_arrow.names
+        batches = source.iter_batches(batch_size=batch_rows)
+    else:
+        source = ipc.open_file(path)
+        names = source.schema.names
+        batches = (source.get_batch(i) for i in range(source.num_record_batches))
+    yield list(names)
+    for batch in batches:
+        columns = [column.to_pylist() for column in batch.columns]
+        for values in zip(*columns):
+            yield list(values)
+
+
+def iter_cells(path: Path) -> Iterator[List[Any]]:
+    """按行产出单元格列表，第一行为表头。"""
+    suffix = path.suffix.lower()
+    if suffix in XLSX_SUFFIXES:
+        return iter_xlsx(path)
+    if suffix in CSV_SUFFIXES:
+        return iter_csv(path)
+    if suffix in ARROW_SUFFIXES:
+        return iter_arrow(path)
+    raise ValueError(f"不支持的参数表格式: {path.suffix}（支持 xlsx/xlsm/csv/parquet/arrow/feather）")
+
+
+# ---------------------------------------------------------------------------
+# 行表
+# ---------------------------------------------------------------------------
+
+def make_row(columns: List[str], values: List[Any]) -> Optional[Dict[str, Any]]:
+    """单元格列表转为 {列名: 值}；多余的列丢弃、缺少的补 None，全空行返回 None。"""
+    width = len(columns)
+    values = [normalize_cell(v) for v in values[:width]]
+    if not any(v is not None for v in values):
+        return None
+    if len(values) < width:
+        values.extend([None] * (width - len(values)))
+    return dict(zip(columns, values))
+
+
+def _convert_value(fn: Converter, memo: Dict[Any, Any], value: Any) -> Any:
+    try:
+        return memo[value]
+    except KeyError:
+        parsed = memo[value] = fn(value)
+        return parsed
+    except TypeError:  # 不可哈希（如 Arrow 的 list 列）
+        return fn(value)
+
+
+class ParamTable:
+    """参数表的惰性行视图；迭代产出 dict，按列转换 converters 中的列。"""
+
+    def __init__(self, path: Path, converters: Optional[Dict[str, Converter]] = None,
+                 batch_rows: int = BATCH_ROWS):
+        self.path = Path(path)
+        self.converters = dict(converters or {})
+        self.batch_rows = batch_rows
+        self.columns: Optional[List[str]] = None
+        self._memo: Dict[str, Dict[Any, Any]] = {name: {} for name in self.converters}
+
+    def _rows(self) -> Iterator[Dict[str, Any]]:
+        cells = iter_cells(self.path)
+        header = next(cells, None)
+        if header is None:
+            return
+        self.columns = header_names(header)
+        for values in cells:
+            row = make_row(self.columns, values)
+            if row is not None:
+                yield row
+
+    def _convert(self, batch: List[Dict[str, Any]]) -> List[Dict[str, Any]]:
+        for column in self.columns or ():
+            fn = self.converters.get(column)
+            if fn is None:
+                continue
+            memo = self._memo[column]
+            if len(memo) > MEMO_LIMIT:
+                memo.clear()
+            for row in batch:
+                value = row[column]
+                if value is None:
+                    continue
+                parsed = _convert_value(fn, memo, value)
+                if parsed is not None and parsed != []:
+                    row[column] = parsed
+        return batch
+
+    def __iter__(self) -> Iterator[Dict[str, Any]]:
+        batch: List[Dict[str, Any]] = []
+        for row in self._rows():
+            batch.append(row)
+            if len(batch) >= self.batch_rows:
+                yield from self._convert(batch)
+                batch = []
+        if batch:
+            yield from self._convert(batch)
+
+    def is_empty(self) -> bool:
+        return next(self._rows(), None) is None
+
+    def count(self) -> int:
+        return sum(1 for _ in self._rows())
+
+
+class RowBuilder:
+    """逐行构造与 ParamTable 迭代结果一致的行（流水线模式下参数行逐条到达，见 stream_pipeline.py）。"""
+
+    def __init__(self, header: List[Any], converters: Optional[Dict[str, Converter]] = None):
+        self.columns = header_names(header)
+        self.converters = {name: fn for name, fn in (converters or {}).items() if name in self.columns}
+        self._memo: Dict[str, Dict[Any, Any]] = {name: {} for name in self.converters}
+
+    def build(self, values: List[Any]) -> Optional[Dict[str, Any]]:
+        """全空行返回 None（ParamTable 同样跳过）。"""
+        row = make_row(self.columns, values)
+        if row is None:
+            return None
+        for column, fn in self.converters.items():
+            value = row[column]
+            if value is None:
+                continue
+            memo = self._memo[column]
+            if len(memo) > MEMO_LIMIT:
+                memo.clear()
+            parsed = _convert_value(fn, memo, value)
+            if parsed is not None and parsed != []:
+                row[column] = parsed
+        return row
+
+
+def main(argv: List[str]) -> int:
+    if len(argv) != 3 or argv[1] != "count":
+        print("用法: python param_reader.py count <params.xlsx|csv|parquet>")
+        return 2
+    try:
+        print(ParamTable(Path(argv[2])).count())
+    except Exception as e:
+        print(f"❌ 读取参数表失败: {e}", file=sys.stderr)
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    raise SystemExit(main(sys.argv))
@@ -0,0 +1,131 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+套件级平台信息缓存：
+- compile_info_string 的 JSON、GetPlatFormInfos 解析结果（soc_infos/aicore_spec/intrinsics）
+  在整个测试文件内只构造一次，放在公共前缀的匿名命名空间中（每个翻译单元各一份，互不冲突）
+- 夹具的 SetUpTestCase 中预热缓存；每个用例只需各自的 fe::PlatFormInfos，
+  并通过 platform_cache.Apply(...) 把缓存内容写入自己的 TilingContext
+
+模板可导出 HARDWARE_INFO（dict）覆盖默认硬件参数，例如 {"CORE_NUM": 32, "UB_SIZE": 262144}。
+"""
+
+from __future__ import annotations
+
+import json
+import re
+from typing import Any, Dict, List, Optional
+
+
+DEFAULT_HARDWARE_INFO: Dict[str, Any] = {
+    "BT_SIZE": 1024,
+    "load3d_constraints": "0",
+    "Intrinsic_fix_pipe_l0c2out": True,
+    "Intrinsic_data_move_l12ub": False,
+    "Intrinsic_data_move_l0c2ub": False,
+    "Intrinsic_data_move_out2l1_nd2nz": True,
+    "UB_SIZE": 196608,
+    "L2_SIZE": 33554432,
+    "L1_SIZE": 524288,
+    "L0A_SIZE": 65536,
+    "L0B_SIZE": 65536,
+    "L0C_SIZE": 131072,
+    "CORE_NUM": 20,
+}
+
+CACHE_MARKER = "class TilingPlatformCache"
+
+FIXTURE_SETUP_PATTERN = re.compile(
+    r"(class\s+\w+\s*:\s*public\s+testing::Test\s*\{.*?static\s+void\s+SetUpTestCase\s*\(\s*\)\s*\{)",
+    re.DOTALL,
+)
+FIXTURE_CLASS_PATTERN = re.compile(r"^\s*class\s+\w+\s*:\s*public\s+testing::Test", re.MULTILINE)
+
+
+def hardware_info(overrides: Optional[Dict[str, Any]] = None) -> Dict[str, Any]:
+    info = dict(DEFAULT_HARDWARE_INFO)
+    if overrides:
+        info.update(overrides)
+    return info
+
+
+def render_compile_info_json(overrides: Optional[Dict[str, Any]] = None) -> str:
+    body = json.dumps({"hardware_info": hardware_info(overrides)}, indent=4)
+    return "\n".join("    " + ln if i else ln for i, ln in enumerate(body.splitlines()))
+
+
+def render_platform_cache(overrides: Optional[Dict[str, Any]] = None) -> str:
+    """生成 TilingPlatformCache 定义（匿名命名空间，函数内静态对象延迟构造）。"""
+    out: List[str] = []
+    out.append("#include <map>")
+    out.append("#include <string>")
+    out.append("")
+    out.append("namespace {")
+    out.append("// 套件级平台信息缓存：compile_info 只解析一次，用例各自 Apply 到自己的 TilingContext")
+    out.append("class TilingPlatformCache {")
+    out.append("public:")
+    out.append("    static const TilingPlatformCache& Get()")
+    out.append("    {")
+    out.append("        static const TilingPlatformCache instance;")
+    out.append("        return instance;")
+    out.append("    }")
+    out.append("")
+    out.append("    void Apply(fe::PlatFormInfos& platform) const")
+    out.append("    {")
+    out.append("        // SetPlatformRes 接收非 const 引用，拷贝一份以保持缓存不可变")
+    out.append("        auto soc_infos_copy = soc_infos;")
+    out.append("        auto aicore_spec_copy = aicore_spec;")
+    out.append("        auto intrinsics_copy = intrinsics;")
+    out.append("        platform.SetPlatformRes(\"SoCInfo\", soc_infos_copy);")
+    out.append("        platform.SetPlatformRes(\"AICoreSpec\", aicore_spec_copy);")
+    out.append("        platform.SetCoreNumByCoreType(\"AICore\");")
+    out.append("        platform.SetPlatformRes(\"AICoreintrinsicDtypeMap\", intrinsics_copy);")
+    out.append("    }")
+    out.append("")
+    out.append("    const std::string compile_info_string = R\"(" + render_compile_info_json(overrides) + ")\";")
+    out.append("    std::map<std::string, std::string> soc_infos;")
+    out.append("    std::map<std::string, std::string> aicore_spec;")
+    out.append("    std::map<std::string, std::string> intrinsics;")
+    out.append("")
+    out.append("private:")
+    out.append("    TilingPlatformCache()")
+    out.append("    {")
+    out.append("        GetPlatFormInfos(compile_info_string.c_str(), soc_infos, aicore_spec, intrinsics);")
+    out.append("    }")
+    out.append("};")
+    out.append("} // namespace")
+    return "\n".join(out) + "\n"
+
+
+def inject_platform_cache(common_prefix: str, overrides: Optional[Dict[str, Any]] = None) -> str:
+    """把缓存定义插入到公共前缀的测试夹具之前，并在夹具 SetUpTestCase 中预热。"""
+    if CACHE_MARKER in common_prefix:
+        return common_prefix
+    cache = render_platform_cache(overrides)
+    m = FIXTURE_CLASS_PATTERN.search(common_prefix)
+    if m is None:
+        return common_prefix.rstrip() + "\n\n" + cache
+    prefix = common_prefix[: m.start()].rstrip() + "\n\n" + cache + "\n" + common_prefix[m.start():].lstrip("\n")
+    return FIXTURE_SETUP_PATTERN.sub(
+        lambda mm: mm.group(1) + "\n        TilingPlatformCache::Get();",
+        prefix,
+        count=1,
+    )
+
+
+def platform_setup_lines() -> List[str]:
+    """模板中替代 compile_info_string/GetPlatFormInfos 的行（<LB>/<RB> 占位）。"""
+    return [
+        "    // 2. Setup compile info and platform info (parsed once per suite)",
+        "    const auto& platform_cache = TilingPlatformCache::Get();",
+        "    const std::string& compile_info_string = platform_cache.compile_info_string;",
+        "    fe::PlatFormInfos platform_info;",
+        "    platform_info.Init();",
+    ]
+
+
+def platform_apply_lines(context_expr: str = "tiling_context") -> List[str]:
+    """模板中替代 SetPlatformRes/SetCoreNumByCoreType 的行。"""
+    return [
+        f"    platform_cache.Apply(*{context_expr}->GetPlatformInfo());",
+    ]
@@ -0,0 +1,151 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+Stage 2 行级渲染缓存：xlsx 某一行的内容及其渲染环境都未变化时，直接复用上次该行的渲染结果。
+
+- 环境哈希 = 算子名 + 输出形式 + 模板文件内容 + 公共前缀哈希 + 生成器代码（本目录下 Stage 2 相关 .py）
+- 行键 = 环境哈希前缀 + sha256(行内容的规范化 JSON + 用例名)，不含行号：插入、删除或调换行不影响其它行命中；
+  未填名称的行用默认名 case_<行号>，该名字会写进用例，因此参与哈希
+- testf 模式缓存每行的 TEST_F 文本；param/runtime/bench/stress 缓存每行的 TestParamRow（JSON）
+- 存储复用 response_cache（命名空间 render，默认永不过期，可用 UTGEN_CACHE_TTL_RENDER 调整），按 LRU 与其它缓存共享字节上限；
+  构造时按环境哈希前缀一条 SELECT 读入全部条目，flush 时在一个事务内写入本次新渲染的行（不压缩）
+"""
+
+from __future__ import annotations
+
+import hashlib
+import json
+import math
+import os
+from dataclasses import fields
+from pathlib import Path
+from typing import Any, Dict, Iterable, Optional
+
+from param_harness import TestParamRow
+from utils import get_cache_manager, logger
+
+NAMESPACE = "render"
+SCRIPT_DIR = Path(__file__).resolve().parent
+# 键中环境哈希前缀的长度；同一环境的条目在主键上连续，可按前缀范围一次读出
+ENV_PREFIX_LEN = 16
+
+# 影响单行渲染结果的生成器代码
+GENERATOR_FILES = (
+    "convert_ut_from_xlsx.py",
+    "param_harness.py",
+    "param_reader.py",
+    "platform_cache.py",
+    "tiling_layouts.py",
+    "render_cache.py",
+)
+
+
+def _sha256(*parts: bytes) -> str:
+    digest = hashlib.sha256()
+    for part in parts:
+        digest.update(len(part).to_bytes(8, "little"))
+        digest.update(part)
+    return digest.hexdigest()
+
+
+def _file_bytes(path: Optional[Path]) -> bytes:
+    if path is None:
+        return b""
+    try:
+        return path.read_bytes()
+    except OSError:
+        return b""
+
+
+def generator_hash(files: Iterable[str] = GENERATOR_FILES) -> str:
+    return _sha256(*(_file_bytes(SCRIPT_DIR / name) for name in files))
+
+
+def _json_default(value: Any) -> Any:
+    # pandas/numpy 标量与时间等按字符串参与哈希
+    item = getattr(value, "item", None)
+    if callable(item):
+        try:
+            return item()
+        except (TypeError, ValueError):
+            pass
+    return str(value)
+
+
+def canonical_row(row: Dict[str, Any]) -> str:
+    """行内容的规范化表示：列名排序，NaN 统一为 null。"""
+    normalized = {}
+    for key, value in row.items():
+        if isinstance(value, float) and math.isnan(value):
+            value = None
+        normalized[str(key)] = value
+    return json.dumps(normalized, sort_keys=True, ensure_ascii=False, default=_json_default)
+
+
+class RenderCache:
+    def __init__(self, op_name: str, mode: str, template_path: Optional[Path], common_prefix: str,
+                 enabled: bool = True):
+        self.enabled = enabled
+        self.env_hash = _sha256(op_name.encode("utf-8"), mode.encode("utf-8"), _file_bytes(template_path),
+                                _sha256(common_prefix.encode("utf-8")).encode("ascii"),
+                                generator_hash().encode("ascii"))
+        self.prefix = self.env_hash[:ENV_PREFIX_LEN] + ":"
+        self.hits = 0
+        self.misses = 0
+        self._pending: Dict[str, str] = {}
+        self._store = None
+        self._entries: Dict[str, str] = {}
+        if enabled:
+            self._store = get_cache_manager().store
+            # render 命名空间默认永不过期（键已包含全部输入）
+            if "UTGEN_CACHE_TTL_" + NAMESPACE.upper() not in os.environ:
+                self._store.ttls.setdefault(NAMESPACE, 0)
+            self._entries = self._store.load_prefix(NAMESPACE, self.prefix)
+
+    def key(self, row: Dict[str, Any], name: str) -> str:
+        """name 为该行最终的用例名（row_to_case 的取值）。"""
+        if self._store is None:
+            return ""
+        return self.prefix + _sha256(canonical_row(row).encode("utf-8"), name.encode("utf-8"))
+
+    def get_text(self, key: str) -> Optional[str]:
+        if self._store is None:
+            return None
+        value = self._entries.get(key)
+        if value is None:
+            self.misses += 1
+        else:
+            self.hits += 1
+        return value
+
+    def set_text(self, key: str, value: str):
+        if self._store is not None:
+            self._entries[key] = value
+            self._pending[key] = value
+
+    def get_param_row(self, key: str) -> Optional[TestParamRow]:
+        text = self.get_text(key)
+        if text is None:
+            return None
+        data = json.loads(text)
+        data["params"] = [tuple(p) for p in data["params"]]
+        return TestParamRow(**data)
+
+    def set_param_row(self, key: str, row: TestParamRow):
+        if self._store is None:
+            return
+        # 浅层取字段即可（params 为元组列表，JSON 中记为数组），asdict 的逐层深拷贝在大表上很慢
+        data = {f.name: getattr(row, f.name) for f in fields(row)}
+        self.set_text(key, json.dumps(data, ensure_ascii=False))
+
+    def flush(self):
+        """把本次新渲染的行写入存储（一个事务）。"""
+        if self._store is not None and self._pending:
+            # 每行只有几 KB，解压的开销与重新渲染相当，因此不压缩
+            self._store.set_many(NAMESPACE, self._pending, compress=False)
+            self._pending = {}
+
+    def report(self, label: str):
+        self.flush()
+        if self.enabled and (self.hits or self.misses):
+            logger.info(f"{label} 行级渲染缓存: 命中 {self.hits}，重新渲染 {self.misses}")
@@ -0,0 +1,402 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+持久化响应缓存（单文件 SQLite，替代每个键一个 JSON 文件的旧缓存）：
+- 表 entries 以 (namespace, key) 为主键（WITHOUT ROWID 聚簇存储），查找为一次主键 B 树定位，与条目数基本无关
+- 值使用 zstd 压缩（未安装 zstandard 时退回 zlib），codec 列记录压缩方式，两种格式可混存
+- 按命名空间配置 TTL（秒，0 为永不过期）：读取时按写入时间判断，调整 TTL 对已有条目立即生效
+- 总字节数（压缩后）超过上限时按最近访问时间淘汰（LRU），淘汰到上限的 90%；总量记在 meta 表中，
+  与写入在同一事务内更新，多个进程（如 batch_runner 并行的 stage-1）共享同一文件时也保持一致
+- 进程内统计命中/未命中/过期/写入次数与读写耗时，退出时写入日志；CLI 可查看各命名空间的条目数与体积
+
+环境变量：
+    UTGEN_CACHE_DIR           缓存目录（默认 .cache）
+    UTGEN_CACHE_MAX_MB        字节上限（默认 512）
+    UTGEN_CACHE_TTL           默认 TTL 秒数（默认 86400）
+    UTGEN_CACHE_TTL_<NS>      命名空间 <NS>（大写，非字母数字替换为 _）的 TTL，如 UTGEN_CACHE_TTL_STAGE1=0
+
+用法：
+    python3 response_cache.py stats
+    python3 response_cache.py purge            # 删除过期条目
+    python3 response_cache.py clear [--ns stage1]
+"""
+
+from __future__ import annotations
+
+import argparse
+import atexit
+import logging
+import os
+import re
+import sqlite3
+import threading
+import time
+import zlib
+from pathlib import Path
+from typing import Dict, Optional
+
+try:
+    import zstandard
+except ImportError:  # pragma: no cover - 依赖缺失时退回 zlib
+    zstandard = None
+
+logger = logging.getLogger("utils")
+
+CODEC_RAW = 0
+CODEC_ZLIB = 1
+CODEC_ZSTD = 2
+
+DEFAULT_MAX_MB = 512
+DEFAULT_TTL = 86400
+EVICT_TARGET = 0.9
+# load_prefix 刷新访问时间的粒度（秒）：更新会重写整行，批量读取时只刷新超过该时长未访问的条目
+TOUCH_RESOLUTION = 3600
+SCHEMA_VERSION = 1
+
+SCHEMA = """
+CREATE TABLE IF NOT EXISTS entries (
+    namespace TEXT NOT NULL,
+    key       TEXT NOT NULL,
+    codec     INTEGER NOT NULL,
+    value     BLOB NOT NULL,
+    size      INTEGER NOT NULL,
+    raw_size  INTEGER NOT NULL,
+    created   REAL NOT NULL,
+    accessed  REAL NOT NULL,
+    PRIMARY KEY (namespace, key)
+) WITHOUT ROWID;
+CREATE INDEX IF NOT EXISTS entries_accessed ON entries (accessed);
+CREATE TABLE IF NOT EXISTS meta (
+    name  TEXT PRIMARY KEY,
+    value INTEGER NOT NULL
+);
+"""
+
+
+def _env_number(name: str, default: float) -> float:
+    value = os.environ.get(name, "").strip()
+    if not value:
+        return default
+    try:
+        return max(0.0, float(value))
+    except ValueError:
+        logger.warning(f"环境变量 {name}={value} 不是数字，使用默认值 {default}")
+        return default
+
+
+def namespace_ttl(namespace: str) -> float:
+    """命名空间的 TTL（秒），0 表示永不过期。"""
+    env_name = "UTGEN_CACHE_TTL_" + re.sub(r"[^0-9A-Za-z]", "_", namespace).upper()
+    return _env_number(env_name, _env_number("UTGEN_CACHE_TTL", DEFAULT_TTL))
+
+
+class CacheStats:
+    def __init__(self):
+        self.hits = 0
+        self.misses = 0
+        self.expired = 0
+        self.writes = 0
+        self.evicted = 0
+        self.read_seconds = 0.0
+        self.write_seconds = 0.0
+
+    def summary(self) -> str:
+        reads = self.hits + self.misses
+        hit_rate = self.hits / reads * 100 if reads else 0.0
+        read_ms = self.read_seconds / reads * 1000 if reads else 0.0
+        write_ms = self.write_seconds / self.writes * 1000 if self.writes else 0.0
+        return (f"命中 {self.hits}/{reads}（{hit_rate:.0f}%，其中过期 {self.expired}），写入 {self.writes}，"
+                f"淘汰 {self.evicted}，平均读 {read_ms:.2f}ms / 写 {write_ms:.2f}ms")
+
+
+class ResponseCache:
+    """SQLite 单文件缓存；线程安全，首次使用时才打开数据库。"""
+
+    def __init__(self, cache_dir: Optional[str] = None, max_bytes: Optional[int] = None,
+                 ttls: Optional[Dict[str, float]] = None):
+        self.cache_dir = Path(cache_dir or os.environ.get("UTGEN_CACHE_DIR") or ".cache")
+        self.path = self.cache_dir / "responses.sqlite3"
+        self.max_bytes = int(max_bytes if max_bytes is not None
+                             else _env_number("UTGEN_CACHE_MAX_MB", DEFAULT_MAX_MB) * 1024 * 1024)
+        self.ttls = dict(ttls or {})
+        self.stats = CacheStats()
+        self._lock = threading.Lock()
+        self._conn: Optional[sqlite3.Connection] = None
+        self._compressor = zstandard.ZstdCompressor(level=3) if zstandard else None
+        self._decompressor = zstandard.ZstdDecompressor() if zstandard else None
+
+    # ------------------------------------------------------------------
+    # 连接与编码
+    # ------------------------------------------------------------------
+
+    def _connect(self) -> sqlite3.Connection:
+        if self._conn is None:
+            self.cache_dir.mkdir(parents=True, exist_ok=True)
+            conn = sqlite3.connect(str(self.path), timeout=30, check_same_thread=False, isolation_level=None)
+            conn.execute("PRAGMA journal_mode=WAL")
+            conn.execute("PRAGMA synchronous=NORMAL")
+            conn.executescript(SCHEMA)
+            conn.execute("INSERT OR IGNORE INTO meta (name, value) VALUES ('schema_version', ?)", (SCHEMA_VERSION,))
+            conn.execute("INSERT OR IGNORE INTO meta (name, value) VALUES ('total_bytes', 0)")
+            self._conn = conn
+            atexit.register(self.close)
+        return self._conn
+
+    def close(self):
+        with self._lock:
+            if self._conn is not None:
+                if self.stats.hits or self.stats.misses or self.stats.writes:
+                    logger.info(f"响应缓存: {self.stats.summary()}")
+                self._conn.close()
+                self._conn = None
+
+    def _encode(self, text: str, compress: bool = True):
+        raw = text.encode("utf-8")
+        if not compress:
+            return CODEC_RAW, raw, len(raw)
+        if self._compressor is not None:
+            return CODEC_ZSTD, self._compressor.compress(raw), len(raw)
+        return CODEC_ZLIB, zlib.compress(raw, 6), len(raw)
+
+    def _decode(self, codec: int, value: bytes) -> str:
+        if codec == CODEC_ZSTD:
+            if self._decompressor is None:
+                raise RuntimeError("缓存条目为 zstd 压缩，但未安装 zstandard")
+            return self._decompressor.decompress(value).decode("utf-8")
+        if codec == CODEC_ZLIB:
+            return zlib.decompress(value).decode("utf-8")
+        return bytes(value).decode("utf-8")
+
+    def ttl(self, namespace: str) -> float:
+        return self.ttls[namespace] if namespace in self.ttls else namespace_ttl(namespace)
+
+    # ------------------------------------------------------------------
+    # 读写
+    # ------------------------------------------------------------------
+
+    def get(self, namespace: str, key: str) -> Optional[str]:
+        start = time.perf_counter()
+        with self._lock:
+            try:
+                conn = self._connect()
+                row = conn.execute("SELECT codec, value, created FROM entries WHERE namespace = ? AND key = ?",
+                                   (namespace, key)).fetchone()
+                result = None
+                if row is not None:
+                    ttl = self.ttl(namespace)
+                    now = time.time()
+                    if ttl > 0 and now - row[2] >= ttl:
+                        self.stats.expired += 1
+                        self._delete(conn, namespace, key)
+                    else:
+                        result = self._decode(row[0], row[1])
+                        conn.execute("UPDATE entries SET accessed = ? WHERE namespace = ? AND key = ?",
+                                     (now, namespace, key))
+            except (sqlite3.Error, zlib.error, RuntimeError, UnicodeDecodeError) as e:
+                logger.warning(f"读取缓存失败: {str(e)}")
+                result = None
+            if result is None:
+                self.stats.misses += 1
+            else:
+                self.stats.hits += 1
+            self.stats.read_seconds += time.perf_counter() - start
+        return result
+
+    def set(self, namespace: str, key: str, content: str):
+        start = time.perf_counter()
+        codec, value, raw_size = self._encode(content)
+        if self.max_bytes > 0 and len(value) > self.max_bytes * EVICT_TARGET:
+            # 单条超过上限时不缓存，否则会把其它条目全部淘汰
+            logger.warning(f"缓存条目过大（{len(value)} 字节），跳过")
+            return
+        with self._lock:
+            try:
+                conn = self._connect()
+                now = time.time()
+                conn.execute("BEGIN IMMEDIATE")
+                try:
+                    old = conn.execute("SELECT size FROM entries WHERE namespace = ? AND key = ?",
+                                       (namespace, key)).fetchone()
+                    conn.execute(
+                        "INSERT OR REPLACE INTO entries (namespace, key, codec, value, size, raw_size, created, accessed) "
+                        "VALUES (?, ?, ?, ?, ?, ?, ?, ?)",
+                        (namespace, key, codec, value, len(value), raw_size, now, now))
+                    delta = len(value) - (old[0] if old else 0)
+                    conn.execute("UPDATE meta SET value = value + ? WHERE name = 'total_bytes'", (delta,))
+                    self._evict(conn)
+                    conn.execute("COMMIT")
+                except BaseException:
+                    conn.execute("ROLLBACK")
+                    raise
+                self.stats.writes += 1
+            except sqlite3.Error as e:
+                logger.warning(f"写入缓存失败: {str(e)}")
+            self.stats.write_seconds += time.perf_counter() - start
+
+    def load_prefix(self, namespace: str, prefix: str) -> Dict[str, str]:
+        """
+        一条 SELECT 读出命名空间内以 prefix 开头的全部未过期条目（主键范围扫描），并一次性刷新其访问时间
+        （TOUCH_RESOLUTION 内访问过的不再刷新）。
+        用于按批读取的调用方（如 render_cache）；不计入逐键的命中统计。
+        """
+        start = time.perf_counter()
+        upper = prefix[:-1] + chr(ord(prefix[-1]) + 1) if prefix else None
+        result: Dict[str, str] = {}
+        with self._lock:
+            try:
+                conn = self._connect()
+                now = time.time()
+                ttl = self.ttl(namespace)
+                where = "namespace = ? AND key >= ?" + (" AND key < ?" if upper else "")
+                args = (namespace, prefix) + ((upper,) if upper else ())
+                if ttl > 0:
+                    where += " AND created > ?"
+                    args += (now - ttl,)
+                for key, codec, value in conn.execute(f"SELECT key, codec, value FROM entries WHERE {where}", args):
+                    try:
+                        result[key] = self._decode(codec, value)
+                    except (zlib.error, RuntimeError, UnicodeDecodeError):
+                        continue
+                if result:
+                    conn.execute(f"UPDATE entries SET accessed = ? WHERE {where} AND accessed < ?",
+                                 (now,) + args + (now - TOUCH_RESOLUTION,))
+            except sqlite3.Error as e:
+                logger.warning(f"读取缓存失败: {str(e)}")
+            self.stats.read_seconds += time.perf_counter() - start
+        return result
+
+    def set_many(self, namespace: str, items: Dict[str, str], compress: bool = True):
+        """在一个事务内写入多条（批量调用方的 set）；compress=False 时不压缩，换取读取时免解压。"""
+        if not items:
+            return
+        start = time.perf_counter()
+        encoded = []
+        for key, content in items.items():
+            codec, value, raw_size = self._encode(content, compress)
+            if self.max_bytes > 0 and len(value) > self.max_bytes * EVICT_TARGET:
+                continue
+            encoded.append((key, codec, value, raw_size))
+        with self._lock:
+            try:
+                conn = self._connect()
+                now = time.time()
+                conn.execute("BEGIN IMMEDIATE")
+                try:
+                    delta = 0
+                    for key, codec, value, raw_size in encoded:
+                        old = conn.execute("SELECT size FROM entries WHERE namespace = ? AND key = ?",
+                                           (namespace, key)).fetchone()
+                        conn.execute(
+                            "INSERT OR REPLACE INTO entries (namespace, key, codec, value, size, raw_size, created, accessed) "
+                            "VALUES (?, ?, ?, ?, ?, ?, ?, ?)",
+                            (namespace, key, codec, value, len(value), raw_size, now, now))
+                        delta += len(value) - (old[0] if old else 0)
+                    conn.execute("UPDATE meta SET value = value + ? WHERE name = 'total_bytes'", (delta,))
+                    self._evict(conn)
+                    conn.execute("COMMIT")
+                except BaseException:
+                    conn.execute("ROLLBACK")
+                    raise
+                self.stats.writes += len(encoded)
+            except sqlite3.Error as e:
+                logger.warning(f"写入缓存失败: {str(e)}")
+            self.stats.write_seconds += time.perf_counter() - start
+
+    def _delete(self, conn: sqlite3.Connection, namespace: str, key: str):
+        conn.execute("BEGIN IMMEDIATE")
+        row = conn.execute("SELECT size FROM entries WHERE namespace = ? AND key = ?", (namespace, key)).fetchone()
+        if row:
+            conn.execute("DELETE FROM entries WHERE namespace = ? AND key = ?", (namespace, key))
+            conn.execute("UPDATE meta SET value = value - ? WHERE name = 'total_bytes'", (row[0],))
+        conn.execute("COMMIT")
+
+    def _evict(self, conn: sqlite3.Connection):
+        """在当前事务内按 LRU 淘汰到上限的 EVICT_TARGET。"""
+        total = conn.execute("SELECT value FROM meta WHERE name = 'total_bytes'").fetchone()[0]
+        if self.max_bytes <= 0 or total <= self.max_bytes:
+            return
+        target = int(self.max_bytes * EVICT_TARGET)
+        while total > target:
+            rows = conn.execute("SELECT namespace, key, size FROM entries ORDER BY accessed LIMIT 64").fetchall()
+            if not rows:
+                break
+            for namespace, key, size in rows:
+                conn.execute("DELETE FROM entries WHERE namespace = ? AND key = ?", (namespace, key))
+                total -= size
+                self.stats.evicted += 1
+                if total <= target:
+                    break
+        conn.execute("UPDATE meta SET value = ? WHERE name = 'total_bytes'", (max(0, total),))
+
+    # ------------------------------------------------------------------
+    # 维护
+    # ------------------------------------------------------------------
+
+    def purge_expired(self) -> int:
+        """删除所有已过期条目，返回删除数量。"""
+        removed = 0
+        with self._lock:
+            conn = self._connect()
+            now = time.time()
+            conn.execute("BEGIN IMMEDIATE")
+            for (namespace,) in conn.execute("SELECT DISTINCT namespace FROM entries").fetchall():
+                ttl = self.ttl(namespace)
+                if ttl <= 0:
+                    continue
+                row = conn.execute("SELECT COUNT(*), COALESCE(SUM(size), 0) FROM entries WHERE namespace = ? AND created <= ?",
+                                   (namespace, now - ttl)).fetchone()
+                conn.execute("DELETE FROM entries WHERE namespace = ? AND created <= ?", (namespace, now - ttl))
+                conn.execute("UPDATE meta SET value = value - ? WHERE name = 'total_bytes'", (row[1],))
+                removed += row[0]
+            conn.execute("COMMIT")
+        return removed
+
+    def clear(self, namespace: Optional[str] = None) -> int:
+        with self._lock:
+            conn = self._connect()
+            conn.execute("BEGIN IMMEDIATE")
+            if namespace is None:
+                removed = conn.execute("DELETE FROM entries").rowcount
+            else:
+                removed = conn.execute("DELETE FROM entries WHERE namespace = ?", (namespace,)).rowcount
+            total = conn.execute("SELECT COALESCE(SUM(size), 0) FROM entries").fetchone()[0]
+            conn.execute("UPDATE meta SET value = ? WHERE name = 'total_bytes'", (total,))
+            conn.execute("COMMIT")
+        return removed
+
+    def namespace_stats(self) -> Dict[str, Dict[str, float]]:
+        with self._lock:
+            conn = self._connect()
+            rows = conn.execute(
+                "SELECT namespace, COUNT(*), SUM(size), SUM(raw_size), MIN(created) FROM entries GROUP BY namespace"
+            ).fetchall()
+        return {ns: {"entries": n, "bytes": size, "raw_bytes": raw, "oldest": oldest}
+                for ns, n, size, raw, oldest in rows}
+
+
+def main():
+    parser = argparse.ArgumentParser(description="响应缓存维护")
+    parser.add_argument("command", choices=["stats", "purge", "clear"])
+    parser.add_argument("--ns", default=None, help="clear 时只清空该命名空间")
+    parser.add_argument("--dir", default=None, help="缓存目录（默认 UTGEN_CACHE_DIR 或 .cache）")
+    args = parser.parse_args()
+
+    cache = ResponseCache(args.dir)
+    if args.command == "stats":
+        stats = cache.namespace_stats()
+        total = sum(s["bytes"] for s in stats.values())
+        print(f"📦 {cache.path}  {total / 1024 / 1024:.1f}MB / {cache.max_bytes / 1024 / 1024:.0f}MB")
+        for ns, s in sorted(stats.items()):
+            ratio = s["raw_bytes"] / s["bytes"] if s["bytes"] else 0.0
+            ttl = cache.ttl(ns)
+            age = (time.time() - s["oldest"]) / 3600
+            print(f"  {ns}: {s['entries']} 条，{s['bytes'] / 1024:.0f}KB（压缩比 {ratio:.1f}x），"
+                  f"TTL {'永久' if ttl <= 0 else f'{ttl:.0f}s'}，最旧 {age:.1f}h")
+    elif args.command == "purge":
+        print(f"🧹 删除过期条目 {cache.purge_expired()} 条")
+    else:
+        print(f"🧹 删除 {cache.clear(args.ns)} 条")
+
+
+if __name__ == "__main__":
+    main()
@@ -8,7 +8,10 @@
 import sys
 import os
 import importlib
+import shutil
+import struct
 import subprocess
+import tempfile
 from pathlib import Path
 
 # 测试结果统计
@@ -183,6 +186,57 @@ def test_utils_functions():
     except Exception as e:
         test_failed(f"工具函数测试失败: {str(e)}")
 
+def test_tiling_decode():
+    """测试 TilingData 解码（--score/--check-buffers 共用的 utgen_perf::Decode）"""
+    print_test_header("TilingData 解码测试")
+
+    compiler = shutil.which("g++")
+    if compiler is None:
+        print("⚠️  未找到 g++，跳过")
+        return
+    try:
+        from convert_ut_from_xlsx import load_case_template_module
+        from tiling_score import load_score_spec, perf_model_includes, render_perf_model
+
+        spec = load_score_spec(load_case_template_module("AllGatherMatmul"))
+        # 各角色写入互不相同的已知值，按布局中的偏移与宽度打包成 TilingData
+        expected = {role: 3 + 7 * i for i, role in enumerate(sorted(spec.roles))}
+        blob = bytearray(max(f.offset + f.size for f in spec.roles.values()))
+        for role, f in spec.roles.items():
+            struct.pack_into("<" + {1: "B", 2: "H", 4: "I", 8: "Q"}[f.size], blob, f.offset, expected[role])
+
+        prints = "\n".join(f'    std::cout << "{role}=" << d.{role} << "\\n";' for role in sorted(spec.roles))
+        program = "\n".join(perf_model_includes() + ['#include <iostream>', '#include "graph/types.h"', ""]) + (
+            render_perf_model(spec)
+            + "struct Desc { ge::DataType GetDataType() const { return ge::DT_FLOAT; } };\n"
+            + "struct Context { const Desc* GetInputDesc(size_t) const { static Desc desc; return &desc; } };\n"
+            + f"static const uint8_t kBlob[] = {{{', '.join(str(b) for b in blob)}}};\n"
+            + "int main()\n{\n"
+            + "    Context context;\n"
+            + "    auto d = utgen_perf::Decode(kBlob, sizeof(kBlob), utgen_perf::DtypeBytes(&context));\n"
+            + '    std::cout << "valid=" << d.valid << "\\n" << "dtype_bytes=" << d.dtype_bytes << "\\n";\n'
+            + prints + "\n    return 0;\n}\n"
+        )
+        with tempfile.TemporaryDirectory() as work_dir:
+            source = Path(work_dir) / "decode.cpp"
+            binary = Path(work_dir) / "decode"
+            source.write_text(program, encoding="utf-8")
+            build = subprocess.run([compiler, "-std=c++17", "-I", "stub-sdk/include", "-o", str(binary), str(source)],
+                                   capture_output=True, text=True)
+            if build.returncode != 0:
+                test_failed(f"解码程序编译失败: {build.stderr[-500:]}")
+                return
+            run = subprocess.run([str(binary)], capture_output=True, text=True)
+        decoded = dict(line.split("=", 1) for line in run.stdout.split())
+        want = {"valid": "1", "dtype_bytes": "4", **{role: str(v) for role, v in expected.items()}}
+        wrong = {k: (decoded.get(k), v) for k, v in want.items() if decoded.get(k) != v}
+        if wrong:
+            test_failed(f"解码结果不符（实际, 期望）: {wrong}")
+        else:
+            test_passed(f"{len(spec.roles)} 个角色字段与 dtype 字节数解码正确")
+    except Exception as e:
+        test_failed(f"TilingData 解码测试失败: {str(e)}")
+
 def run_all_tests():
     """运行所有测试"""
     print("=" * 60)
@@ -196,6 +250,7 @@ def run_all_tests():
     test_directory_structure()
     test_config_files()
     test_utils_functions()
+    test_tiling_decode()
     test_api_connectivity()
     
     # 打印测试结果
@@ -0,0 +1,211 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+Stage 2 分片输出（--shard N，testf 模式）：一个 test_<op>_tiling.cpp 拆成公共头 + 若干分片源文件，
+改动一行参数只重编一个分片，并行构建可分摊到多个核上。
+
+- <stem>_common.h：extract_common_prefix 得到的公共部分（头文件、夹具类、平台信息缓存），加 include guard；
+  命名空间作用域的非 inline 函数定义补 inline、非 const 全局变量补 static，避免多个翻译单元重复定义
+- <stem>_shard_NNN.cpp：分片数为 ceil(用例数 / N)，每片至多 N 个 TEST_F；每个用例按 TEST_F 名的哈希
+  （jump consistent hash）分到固定的分片，该分片已满时顺延到下一个未满的分片，片内保持原用例顺序。
+  中间插入、删除或改动一行通常只影响该用例所在的分片（发生顺延时另牵动少数溢出用例）；
+  分片数加一时每个旧分片约有 1/分片数 的用例移入新分片，其余用例不动。未变化的分片不重写（write_output 保留时间戳），增量构建只重编变化的分片
+- <stem>_shards.cmake：列出分片的 CMake 片段，include() 后得到 <stem>_SHARDS，并把 <stem> 追加到 UTGEN_SHARDED_UTS
+  （stub-sdk/CMakeLists.txt 的 UT_SHARD_LISTS 据此为每个单测建一个可执行文件）
+- 用例数减少时，多余的旧分片文件会被删除
+
+夹具类必须在所有分片中是同一个类型（gtest 按类型校验同一套件的夹具），因此公共部分不放进匿名命名空间。
+"""
+
+from __future__ import annotations
+
+import hashlib
+import re
+from dataclasses import dataclass, field
+from pathlib import Path
+from typing import Dict, List, Tuple
+
+from case_lint import mask_literals
+
+DEFAULT_SHARD_SIZE = 50
+
+_TEST_F_NAME_RE = re.compile(r"^\s*TEST_F\s*\(\s*(\w+)\s*,\s*(\w+)", re.M)
+_PREPROCESSOR_RE = re.compile(r"^[ \t]*#(?:[^\n]*\\\n)*[^\n]*", re.M)
+_NAMED_NAMESPACE_RE = re.compile(r"^(?:inline\s+)?namespace\s+[\w:]+\s*$")
+_ANON_NAMESPACE_RE = re.compile(r"^(?:inline\s+)?namespace\s*$")
+_FUNCTION_HEAD_RE = re.compile(r"\)\s*(?:const\s*|noexcept\s*|override\s*|final\s*|->\s*[\w:<>,\s\*&]+)*$")
+_VARIABLE_HEAD_RE = re.compile(r"^[\w:<>,\s\*&]+?[\s\*&]\w+(?:\s*\[[^\]]*\])*$")
+# 以这些关键字开头的语句不是需要补 inline/static 的定义
+_SKIP_KEYWORDS = (
+    "class", "struct", "union", "enum", "template", "typedef", "using", "namespace", "extern",
+    "static", "inline", "constexpr", "const", "friend", "thread_local",
+)
+
+
+def shard_header_name(stem: str) -> str:
+    return f"{stem}_common.h"
+
+
+def shard_file_name(stem: str, index: int) -> str:
+    return f"{stem}_shard_{index:03d}.cpp"
+
+
+def shard_cmake_name(stem: str) -> str:
+    return f"{stem}_shards.cmake"
+
+
+def _statement_head(masked: str, start: int, end: int) -> Tuple[int, str]:
+    """masked[start:end] 去掉首尾空白后的起点与文本。"""
+    text = masked[start:end]
+    stripped = text.lstrip()
+    return start + len(text) - len(stripped), stripped.rstrip()
+
+
+def _skip_statement(first: str, head: str) -> bool:
+    # const T* p 的指针本身不是 const，仍有外部链接
+    if first == "const" and "*" in head.split("=", 1)[0] and not re.search(r"\*\s*const\b", head):
+        return False
+    return first in _SKIP_KEYWORDS
+
+
+def _is_variable(head: str) -> bool:
+    """变量定义：T name = ...、T name{...}、T name（括号初始化与函数声明无法区分，不处理）。"""
+    if "=" in head:
+        return bool(_VARIABLE_HEAD_RE.match(head.split("=", 1)[0].rstrip()))
+    return "(" not in head and bool(_VARIABLE_HEAD_RE.match(head))
+
+
+def make_header_safe(prefix: str) -> Tuple[str, int]:
+    """
+    公共部分改为可被多个翻译单元 include：命名空间作用域（含具名命名空间内）的函数定义补 inline，
+    非 const 变量定义补 static。类体、匿名命名空间、模板内的内容不变。返回 (新文本, 修改处数)。
+    """
+    masked = _PREPROCESSOR_RE.sub(lambda m: re.sub(r"[^\n]", " ", m.group(0)), mask_literals(prefix))
+    inserts: List[Tuple[int, str]] = []
+    scopes: List[str] = []  # "ns" 具名命名空间；"other" 其它（类体、函数体、匿名命名空间等）
+    stmt_start = 0
+    for i, ch in enumerate(masked):
+        at_namespace_scope = all(scope == "ns" for scope in scopes)
+        if ch == "{":
+            if at_namespace_scope:
+                pos, head = _statement_head(masked, stmt_start, i)
+                first = re.match(r"\w*", head).group(0)
+                if _NAMED_NAMESPACE_RE.match(head):
+                    scopes.append("ns")
+                    stmt_start = i + 1
+                    continue
+                if _ANON_NAMESPACE_RE.match(head) or _skip_statement(first, head):
+                    pass
+                elif _is_variable(head):
+                    inserts.append((pos, "static "))
+                elif "(" in head and "=" not in head and _FUNCTION_HEAD_RE.search(head):
+                    inserts.append((pos, "inline "))
+            scopes.append("other")
+        elif ch == "}":
+            if scopes:
+                scopes.pop()
+            if all(scope == "ns" for scope in scopes):
+                stmt_start = i + 1
+        elif ch == ";" and at_namespace_scope:
+            pos, head = _statement_head(masked, stmt_start, i)
+            first = re.match(r"\w*", head).group(0)
+            if head and not _skip_statement(first, head) and _is_variable(head):
+                inserts.append((pos, "static "))
+            stmt_start = i + 1
+    text = prefix
+    for pos, keyword in reversed(inserts):
+        text = text[:pos] + keyword + text[pos:]
+    return text, len(inserts)
+
+
+def _case_key(case: str) -> int:
+    """用例的稳定分片键：Suite.name 的哈希（没有 TEST_F 头时取整个用例文本）。"""
+    m = _TEST_F_NAME_RE.search(case)
+    key = f"{m.group(1)}.{m.group(2)}" if m else case
+    return int.from_bytes(hashlib.sha256(key.encode("utf-8")).digest()[:8], "little")
+
+
+def jump_hash(key: int, buckets: int) -> int:
+    """Lamping & Veach 的 jump consistent hash：桶数从 n 变为 n+1 时只有约 1/(n+1) 的键换桶。"""
+    b, j = -1, 0
+    while j < buckets:
+        b = j
+        key = (key * 2862933555777941757 + 1) & 0xFFFFFFFFFFFFFFFF
+        j = int((b + 1) * ((1 << 31) / ((key >> 33) + 1)))
+    return b
+
+
+def assign_shards(cases: List[str], shard_size: int) -> List[List[str]]:
+    """
+    按 TEST_F 名的哈希把用例分到 ceil(用例数 / shard_size) 个分片，每片至多 shard_size 个，片内保持原顺序。
+    哈希选中的分片已满时顺延到下一个未满的分片；总容量不小于用例数，因此总能放下，且不会出现空分片。
+    """
+    shards: List[List[str]] = [[] for _ in range(-(-len(cases) // shard_size))]
+    for case in cases:
+        index = jump_hash(_case_key(case), len(shards))
+        while len(shards[index]) >= shard_size:
+            index = (index + 1) % len(shards)
+        shards[index].append(case)
+    return shards
+
+
+@dataclass
+class ShardLayout:
+    files: Dict[Path, str] = field(default_factory=dict)  # 路径 -> 内容：公共头、各分片、CMake 片段
+    shard_count: int = 0
+    linkage_fixes: int = 0  # 公共部分补 inline/static 的处数
+
+
+def render_shard_layout(common_prefix: str, cases: List[str], out_path: Path,
+                        shard_size: int = DEFAULT_SHARD_SIZE) -> ShardLayout:
+    """
+    生成分片布局。
+
+    Args:
+        common_prefix: 公共部分（build_common_prefix 的结果）
+        cases: 渲染好的 TEST_F 文本
+        out_path: 单文件输出路径，分片文件以其 stem 命名、写在同一目录
+        shard_size: 每个分片最多的 TEST_F 数（决定分片数；各用例所在分片由 TEST_F 名的哈希决定，满则顺延）
+    """
+    if shard_size <= 0:
+        raise ValueError(f"分片大小必须为正整数: {shard_size}")
+    stem = out_path.stem
+    directory = out_path.parent
+    header = shard_header_name(stem)
+    guard = "UTGEN_" + re.sub(r"\W", "_", header).upper() + "_"
+    safe_prefix, changed = make_header_safe(common_prefix)
+
+    files: Dict[Path, str] = {}
+    files[directory / header] = (
+        f"// utgen: {stem} 的公共部分，由各分片 include\n"
+        f"#ifndef {guard}\n#define {guard}\n\n"
+        f"{safe_prefix.rstrip()}\n\n#endif  // {guard}\n"
+    )
+    shard_names = []
+    for index, shard_cases in enumerate(assign_shards(cases, shard_size)):
+        name = shard_file_name(stem, index)
+        shard_names.append(name)
+        files[directory / name] = (
+            f"// utgen: {stem} 分片 {index:03d}，公共部分见 {header}\n"
+            f"#include \"{header}\"\n\n" + "\n\n".join(shard_cases) + "\n"
+        )
+    listing = "\n".join(f'  "${{CMAKE_CURRENT_LIST_DIR}}/{name}"' for name in shard_names)
+    files[directory / shard_cmake_name(stem)] = (
+        f"# utgen: {stem} 的分片源文件（每片至多 {shard_size} 个 TEST_F，按 TEST_F 名哈希分配）\n"
+        f"#   include({shard_cmake_name(stem)})\n"
+        f"#   add_executable({stem} ${{{stem}_SHARDS}})\n"
+        f"set({stem}_SHARDS\n{listing}\n)\n"
+        f"list(APPEND UTGEN_SHARDED_UTS {stem})\n"
+    )
+    return ShardLayout(files, len(shard_names), changed)
+
+
+def stale_shards(out_path: Path, shard_count: int) -> List[Path]:
+    """上次生成、本次已不存在的分片文件。"""
+    pattern = re.compile(re.escape(out_path.stem) + r"_shard_(\d+)\.cpp$")
+    stale = []
+    for path in sorted(out_path.parent.glob(f"{out_path.stem}_shard_*.cpp")):
+        m = pattern.match(path.name)
+        if m and int(m.group(1)) >= shard_count:
+            stale.append(path)
+    return stale
@@ -0,0 +1,722 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+Stage 1 源码切片：从算子的 tiling 入口出发，只把可达的函数、常量与 tiling key 计算放进 prompt。
+
+- 词法层面解析 C++：去掉注释、#include/#if 等预处理行与日志语句（OP_LOGD、OPS_LOG_I 等），
+  按顶层声明切成单元（函数、类/结构体、枚举、常量、宏、BEGIN_*/END_* 宏块），类的内联成员函数单独成单元
+- 入口：IMPL_OP_OPTILING(...).Tiling(F) / REGISTER_OP_TILING_*(Op, F) 注册的函数、STAGE1_SLICE_ENTRY 指定的函数；
+  没有注册时取名字同时含算子名与 Tiling 的函数，再退到 TilingFunc。已命中文件中名字含 tiling key 的定义一并作为入口
+- 按标识符引用从入口广度优先遍历，不可达的代码丢弃；找不到任何入口时保留全部单元（仍去注释与日志）
+- 按离入口的距离由近到远装入 token 预算（STAGE1_TOKEN_BUDGET，默认 32000，0 为不限；约 3 字符/token 估算），
+  装不下的单元丢弃，输出时恢复源码顺序
+- STAGE1_SLICE=0 关闭切片，恢复为拼接全部源码
+
+命令行预览切片结果：python3 source_slicer.py <算子名> <源码路径...> [--budget N] [--entry 函数名]
+"""
+
+from __future__ import annotations
+
+import argparse
+import os
+import re
+import sys
+from collections import deque
+from dataclasses import dataclass, field
+from pathlib import Path
+from typing import Dict, List, Optional, Sequence, Set, Tuple
+
+from utils import get_cpp_files, logger, read_file_content
+
+# 切片规则变化时递增，使 Stage 1 增量清单失效
+SLICER_VERSION = 1
+DEFAULT_TOKEN_BUDGET = 32000
+CHARS_PER_TOKEN = 3
+
+_LITERAL_RE = re.compile(
+    r'//[^\n]*'
+    r'|/\*.*?\*/'
+    r'|R"([^(\s"\\]{0,16})\(.*?\)\1"'
+    r'|"(?:\\.|[^"\\\n])*"'
+    r"|(?<![\w'])'(?:\\.|[^'\\\n])+'",
+    re.S,
+)
+_IDENT_RE = re.compile(r'[A-Za-z_]\w*')
+_QUALIFIED_RE = re.compile(r'(?:[A-Za-z_]\w*\s*::\s*)*~?[A-Za-z_]\w*')
+_LABEL_RE = re.compile(r'(?:public|private|protected)\s*:(?!:)')
+_MACRO_STMT_RE = re.compile(r'[A-Z_][A-Z0-9_]*\s*\(')
+_BLOCK_BEGIN_RE = re.compile(r'BEGIN_(\w+)\s*\(\s*(\w+)')
+_CONTAINER_RE = re.compile(r'(?:inline\s+)?namespace\b[\w:\s]*$|extern\s+"[^"]*"\s*$')
+_RECORD_RE = re.compile(r'(?:typedef\s+)?(class|struct|union|enum)\b')
+_TEMPLATE_RE = re.compile(r'template\s*<')
+
+# 纯日志语句：前面是语句边界、后面紧跟分号时整句删除（作为 OP_TILING_CHECK 等参数的日志保留）
+_LOG_CALL_RE = re.compile(
+    r'\b(?:OP_LOG[A-Z_]*|OPS_LOG_[A-Z_]+|OPS_ERR_[A-Z_]+|GELOG[A-Z_]*|D?LOG(?:D|I|W|E|_[A-Z]+)'
+    r'|OP_EVENT|(?:std::)?f?printf)\s*\('
+)
+_STREAM_LOG_RE = re.compile(r'\bstd::(?:cout|cerr|clog)\b')
+
+_REGISTER_RES = (
+    re.compile(r'\bIMPL_OP(?:_OPTILING)?\s*\(\s*\w+\s*\)'),
+    re.compile(r'\bREGISTER_OP_TILING\w*\s*\(\s*\w+\s*,\s*([\w:]+)'),
+)
+_REGISTERED_FUNC_RE = re.compile(r'\.\s*Tiling(?:Parse)?\s*(?:<[^>]*>)?\s*\(\s*([\w:]+)')
+_TILING_KEY_RE = re.compile(r'tiling_?key', re.I)
+
+_KEYWORDS = frozenset("""
+alignas alignof and asm auto bool break case catch char char16_t char32_t class const constexpr const_cast
+continue decltype default delete do double dynamic_cast else enum explicit export extern false final float for
+friend goto if inline int int8_t int16_t int32_t int64_t long mutable namespace new noexcept not nullptr operator
+or override private protected public register reinterpret_cast return short signed size_t sizeof static
+static_assert static_cast struct switch template this throw true try typedef typeid typename uint8_t uint16_t
+uint32_t uint64_t union unsigned using virtual void volatile wchar_t while std
+""".split())
+
+
+def estimate_tokens(text: str) -> int:
+    """按约 3 字符/token 粗估（C++ 源码的 BPE 切分普遍比自然语言碎）。"""
+    return (len(text) + CHARS_PER_TOKEN - 1) // CHARS_PER_TOKEN
+
+
+def slice_enabled() -> bool:
+    return os.environ.get("STAGE1_SLICE", "1") not in ("0", "", "false", "off")
+
+
+def token_budget() -> int:
+    try:
+        return max(0, int(os.environ.get("STAGE1_TOKEN_BUDGET", DEFAULT_TOKEN_BUDGET)))
+    except ValueError:
+        logger.warning(f"STAGE1_TOKEN_BUDGET 无效，使用默认值 {DEFAULT_TOKEN_BUDGET}")
+        return DEFAULT_TOKEN_BUDGET
+
+
+def configured_entries() -> List[str]:
+    raw = os.environ.get("STAGE1_SLICE_ENTRY", "")
+    return [name.strip() for name in re.split(r"[,\s]+", raw) if name.strip()]
+
+
+def slice_settings() -> str:
+    """影响切片结果的设置，写入 Stage 1 增量清单。"""
+    if not slice_enabled():
+        return "off"
+    return f"v{SLICER_VERSION};budget={token_budget()};entry={','.join(configured_entries())}"
+
+
+# ---------------------------------------------------------------------------
+# 词法处理
+# ---------------------------------------------------------------------------
+
+def strip_comments(text: str) -> Tuple[str, str]:
+    """返回 (去注释文本, 同长度的分析文本)；分析文本中字符串与字符字面量的内容被替换为空格。"""
+    clean: List[str] = []
+    masked: List[str] = []
+    last = 0
+    for match in _LITERAL_RE.finditer(text):
+        clean.append(text[last:match.start()])
+        masked.append(text[last:match.start()])
+        token = match.group(0)
+        if token.startswith("//") or token.startswith("/*"):
+            filler = "\n" * token.count("\n") or " "
+            clean.append(filler)
+            masked.append(filler)
+        else:
+            quote = token.index(token[-1])
+            clean.append(token)
+            masked.append(token[:quote + 1] + re.sub(r"[^\n]", " ", token[quote + 1:-1]) + token[-1])
+        last = match.end()
+    clean.append(text[last:])
+    masked.append(text[last:])
+    return "".join(clean), "".join(masked)
+
+
+def _remove_spans(clean: str, masked: str, spans: List[Tuple[int, int]]) -> Tuple[str, str]:
+    """把 spans 替换为空白（保留换行与长度），各单元的偏移在两份文本中保持一致。"""
+    if not spans:
+        return clean, masked
+    out_clean: List[str] = []
+    out_masked: List[str] = []
+    last = 0
+    for start, end in sorted(spans):
+        if start < last:
+            continue
+        filler = re.sub(r"[^\n]", " ", clean[start:end])
+        out_clean.append(clean[last:start] + filler)
+        out_masked.append(masked[last:start] + filler)
+        last = end
+    out_clean.append(clean[last:])
+    out_masked.append(masked[last:])
+    return "".join(out_clean), "".join(out_masked)
+
+
+def _extract_directives(clean: str, masked: str) -> Tuple[str, str, List[Tuple[int, int, str]]]:
+    """去掉预处理行；#define 单独取出为 (位置, 长度, 文本)。"""
+    spans: List[Tuple[int, int]] = []
+    defines: List[Tuple[int, int, str]] = []
+    pos = 0
+    length = len(masked)
+    while pos < length:
+        line_end = masked.find("\n", pos)
+        line_end = length if line_end < 0 else line_end
+        stripped = masked[pos:line_end].lstrip()
+        if stripped.startswith("#"):
+            end = line_end
+            while masked[pos:end].rstrip().endswith("\\") and end < length:
+                next_end = masked.find("\n", end + 1)
+                end = length if next_end < 0 else next_end
+            if re.match(r"#\s*define\b", stripped):
+                defines.append((pos, end - pos, clean[pos:end].strip()))
+            spans.append((pos, end))
+            pos = end + 1
+        else:
+            pos = line_end + 1
+    clean, masked = _remove_spans(clean, masked, spans)
+    return clean, masked, defines
+
+
+def _matching(masked: str, pos: int, open_ch: str, close_ch: str) -> int:
+    """masked[pos] 为 open_ch，返回匹配的 close_ch 下标；不匹配时返回文本末尾。"""
+    depth = 0
+    for i in range(pos, len(masked)):
+        ch = masked[i]
+        if ch == open_ch:
+            depth += 1
+        elif ch == close_ch:
+            depth -= 1
+            if depth == 0:
+                return i
+    return len(masked) - 1
+
+
+def _log_spans(masked: str) -> List[Tuple[int, int]]:
+    spans: List[Tuple[int, int]] = []
+    candidates = [(m.start(), m.end() - 1) for m in _LOG_CALL_RE.finditer(masked)]
+    candidates += [(m.start(), -1) for m in _STREAM_LOG_RE.finditer(masked)]
+    for start, paren in candidates:
+        j = start - 1
+        while j >= 0 and masked[j] in " \t\r\n":
+            j -= 1
+        if j >= 0 and (masked[j] not in ";{}:" or masked[j - 1:j + 1] == "::"):
+            continue
+        if paren >= 0:
+            end = _matching(masked, paren, "(", ")") + 1
+        else:
+            end = masked.find(";", start)
+            if end < 0:
+                continue
+        after = end
+        while after < len(masked) and masked[after] in " \t\r\n":
+            after += 1
+        if after < len(masked) and masked[after] == ";":
+            spans.append((start, after + 1))
+    return spans
+
+
+def _skip_template(header: str) -> str:
+    header = header.lstrip()
+    while _TEMPLATE_RE.match(header):
+        close = _matching(header, header.index("<"), "<", ">")
+        header = header[close + 1:].lstrip()
+    return header
+
+
+def _flatten(text: str) -> str:
+    """只保留最外层：()、[]、{} 中的内容替换为空格。"""
+    out = list(text)
+    depth = 0
+    for i, ch in enumerate(text):
+        if ch in "([{":
+            depth += 1
+            if depth > 1:
+                out[i] = " "
+        elif ch in ")]}":
+            if depth > 1:
+                out[i] = " "
+            depth -= 1
+        elif depth > 0 and ch != "\n":
+            out[i] = " "
+    return "".join(out)
+
+
+# ---------------------------------------------------------------------------
+# 切分单元
+# ---------------------------------------------------------------------------
+
+@dataclass
+class Unit:
+    file_index: int
+    start: int
+    end: int
+    kind: str  # func / record / enum / decl / macro / block
+    text: str = ""
+    names: Set[str] = field(default_factory=set)
+    refs: Set[str] = field(default_factory=set)
+    parent: Optional[int] = None
+    members: List[int] = field(default_factory=list)
+    # record 单元：类体内需要整体保留的部分（成员函数之外）
+    shell: str = ""
+
+
+def _split(masked: str, start: int, end: int) -> List[Tuple[int, int, str, Optional[Tuple[int, int]]]]:
+    """切分 [start, end) 内的声明，返回 (起, 止, 类型, 类体范围)；namespace/extern "C" 展开为其内容。"""
+    pieces: List[Tuple[int, int, str, Optional[Tuple[int, int]]]] = []
+    pos = start
+    while pos < end:
+        while pos < end and masked[pos] in " \t\r\n;":
+            pos += 1
+        if pos >= end:
+            break
+        label = _LABEL_RE.match(masked, pos)
+        if label:
+            pos = label.end()
+            continue
+        unit_start = pos
+        paren = 0
+        body: Optional[Tuple[int, int]] = None
+        kind = ""
+        i = pos
+        while i < end:
+            ch = masked[i]
+            if ch in "([":
+                paren += 1
+            elif ch in ")]":
+                paren -= 1
+                if paren == 0 and not kind and _MACRO_STMT_RE.fullmatch(masked[unit_start:i].split("(")[0] + "("):
+                    # 不带分号的顶层宏调用（BEGIN_TILING_DATA_DEF(X)、REGISTER_TILING_DATA_CLASS(...)）
+                    nxt = i + 1
+                    while nxt < end and masked[nxt] in " \t\r\n":
+                        nxt += 1
+                    if (nxt >= end or masked[nxt] not in ";{.:(-=,<") and not masked.startswith("const", nxt) \
+                            and not masked.startswith("noexcept", nxt) and not masked.startswith("override", nxt):
+                        if masked[unit_start:i].count("(") == 1:
+                            pieces.append((unit_start, i + 1, "macro_stmt", None))
+                            pos = i + 1
+                            break
+            elif paren == 0 and ch == ";":
+                pieces.append((unit_start, i + 1, kind or "decl", body))
+                pos = i + 1
+                break
+            elif paren == 0 and ch == "{":
+                header = masked[unit_start:i]
+                close = min(_matching(masked, i, "{", "}"), end - 1)
+                if _CONTAINER_RE.match(header.strip()):
+                    pieces.extend(_split(masked, i + 1, close))
+                    pos = close + 1
+                    break
+                if kind:
+                    i = close + 1
+                    continue
+                bare = _skip_template(_flatten(header))
+                record = _RECORD_RE.match(bare)
+                if record:
+                    kind = "enum" if record.group(1) == "enum" else "record"
+                    body = (i + 1, close)
+                    i = close + 1
+                    continue
+                if "=" in _flatten(header).replace("==", "") or "(" not in header:
+                    kind = "decl"
+                    i = close + 1
+                    continue
+                nxt = close + 1
+                while nxt < end and masked[nxt] in " \t\r\n":
+                    nxt += 1
+                if nxt < end and masked[nxt] in ",{":
+                    # 构造函数初始化列表中的花括号初始化
+                    i = close + 1
+                    continue
+                pieces.append((unit_start, close + 1, "func", None))
+                pos = close + 1
+                break
+            i += 1
+        else:
+            pieces.append((unit_start, end, kind or "decl", body))
+            pos = end
+    return pieces
+
+
+def _merge_blocks(pieces, masked: str):
+    """BEGIN_X(...) ... END_X 宏块合并为一个单元。"""
+    merged = []
+    i = 0
+    while i < len(pieces):
+        start, end, kind, body = pieces[i]
+        begin = _BLOCK_BEGIN_RE.match(masked, start) if kind == "macro_stmt" else None
+        if begin:
+            tag = "END_" + begin.group(1)
+            j = i
+            while j + 1 < len(pieces) and not masked.startswith(tag, pieces[j][0]):
+                j += 1
+            if masked.startswith(tag, pieces[j][0]):
+                merged.append((start, pieces[j][1], "block", None))
+                i = j + 1
+                continue
+        merged.append((start, end, kind, body))
+        i += 1
+    return merged
+
+
+def _idents(text: str) -> Set[str]:
+    return {word for word in _IDENT_RE.findall(text) if word not in _KEYWORDS}
+
+
+def _func_names(header: str) -> Set[str]:
+    flat = _flatten(header)
+    paren = flat.find("(")
+    if paren < 0:
+        return set()
+    head = flat[:paren].rstrip()
+    match = None
+    for match in _QUALIFIED_RE.finditer(head):
+        pass
+    if not match or match.end() != len(head):
+        return set()
+    qualified = re.sub(r"\s+", "", match.group(0))
+    parts = qualified.split("::")
+    names = {parts[-1].lstrip("~")}
+    if len(parts) > 1:
+        names.add("::".join(parts[-2:]))
+    return names - _KEYWORDS
+
+
+def _decl_names(text: str) -> Set[str]:
+    flat = _flatten(_skip_template(text))
+    names: Set[str] = set()
+    using = re.match(r"\s*using\s+(\w+)\s*=", flat)
+    if using:
+        return {using.group(1)}
+    record = re.match(r"\s*(?:typedef\s+)?(?:class|struct|union)\s+(?:\w+\s+)*?(\w+)\s*(?:final\s*)?(?:[:{]|$)", flat)
+    if record and not flat.lstrip().startswith("typedef"):
+        names.add(record.group(1))
+    names.update(re.findall(r"([A-Za-z_]\w*)\s*(?:\[\s*\]\s*)*=(?!=)", flat))
+    names.update(re.findall(r"([A-Za-z_]\w*)\s*\{\s*\}\s*[,;]", flat))
+    tail = re.search(r"([A-Za-z_]\w*)\s*(?:\[\s*\]\s*)*;\s*$", flat)
+    if tail and not names:
+        names.add(tail.group(1))
+    if not names:
+        names |= _func_names(flat)
+    return names - _KEYWORDS
+
+
+def _enum_names(text: str, masked_body: str) -> Set[str]:
+    names = set()
+    head = re.match(r"\s*(?:typedef\s+)?enum\s+(?:class\s+|struct\s+)?(\w+)", text)
+    if head:
+        names.add(head.group(1))
+    for item in _flatten("(" + masked_body + ")")[1:-1].split(","):
+        ident = re.match(r"\s*([A-Za-z_]\w*)", item)
+        if ident:
+            names.add(ident.group(1))
+    tail = re.search(r"\}\s*(\w+)\s*;\s*$", text)
+    if tail:
+        names.add(tail.group(1))
+    return names - _KEYWORDS
+
+
+def _record_name(header: str) -> Set[str]:
+    bare = _skip_template(_flatten(header))
+    match = re.match(r"(?:typedef\s+)?(?:class|struct|union)\s+((?:\w+\s+)*?)(\w+)\s*(?:final\b)?\s*(?::(?!:)[^{]*)?$",
+                     bare.strip())
+    return {match.group(2)} if match else set()
+
+
+def _registered_entries(masked: str) -> Set[str]:
+    entries: Set[str] = set()
+    for match in _REGISTER_RES[0].finditer(masked):
+        stmt_end = masked.find(";", match.end())
+        stmt = masked[match.end(): stmt_end if stmt_end >= 0 else len(masked)]
+        entries.update(name.split("::")[-1] for name in _REGISTERED_FUNC_RE.findall(stmt))
+    for match in _REGISTER_RES[1].finditer(masked):
+        entries.add(match.group(1).split("::")[-1])
+    return entries
+
+
+class SourceSlicer:
+    """一次切片：解析全部文件，从入口遍历引用图并按预算取舍。"""
+
+    def __init__(self, operator_name: str, budget: int = DEFAULT_TOKEN_BUDGET,
+                 entries: Sequence[str] = ()):
+        self.operator_name = operator_name
+        self.budget = budget
+        self.extra_entries = list(entries)
+        self.units: List[Unit] = []
+        self.files: List[Path] = []
+        self.texts: List[str] = []
+        self.registered: Set[str] = set()
+        self.registrations: List[int] = []
+        self.raw_tokens = 0
+        self.fallback = False
+
+    # -- 解析 ------------------------------------------------------------
+    def add_file(self, path: Path, content: str):
+        index = len(self.files)
+        self.files.append(path)
+        self.raw_tokens += estimate_tokens(content)
+        clean, masked = strip_comments(content)
+        clean, masked = _remove_spans(clean, masked, _log_spans(masked))
+        clean, masked, defines = _extract_directives(clean, masked)
+        self.texts.append(clean)
+        self.registered |= _registered_entries(masked)
+
+        pieces = []
+        for pos, length, text in defines:
+            pieces.append((pos, pos + length, "macro", None))
+        pieces += _merge_blocks(_split(masked, 0, len(masked)), masked)
+        define_texts = {pos: text for pos, _, text in defines}
+        for start, end, kind, body in sorted(pieces, key=lambda p: p[0]):
+            if kind == "macro":
+                self._add_macro(index, start, end, define_texts[start])
+            else:
+                self._add_unit(index, clean, masked, start, end, kind, body)
+
+    def _add_macro(self, index: int, start: int, end: int, text: str):
+        match = re.match(r"#\s*define\s+(\w+)", text)
+        if not match:
+            return
+        body = text[match.end():]
+        unit = Unit(index, start, end, "macro", text=text, names={match.group(1)})
+        unit.refs = _idents(body) - unit.names
+        self.units.append(unit)
+
+    def _add_unit(self, index: int, clean: str, masked: str, start: int, end: int, kind: str,
+                  body: Optional[Tuple[int, int]], parent: Optional[int] = None):
+        text = clean[start:end]
+        mtext = masked[start:end]
+        unit = Unit(index, start, end, kind, text=text, parent=parent)
+        if kind == "func":
+            unit.names = _func_names(mtext[:mtext.find("{")])
+        elif kind == "enum":
+            unit.names = _enum_names(mtext, masked[body[0]:body[1]] if body else "")
+        elif kind == "block":
+            begin = _BLOCK_BEGIN_RE.match(mtext)
+            unit.names = {begin.group(2)} if begin else set()
+        elif kind == "macro_stmt":
+            # REGISTER_TILING_DATA_CLASS(Op, Data) 等：随其参数中的任一名字一起保留
+            unit.names = _idents(mtext[mtext.find("("):])
+        elif kind == "record" and body:
+            unit.names = _record_name(mtext[:body[0] - start - 1]) or _decl_names(mtext)
+        else:
+            unit.names = _decl_names(mtext)
+        unit.refs = _idents(mtext) - unit.names
+        if _REGISTER_RES[0].search(mtext) or _REGISTER_RES[1].search(mtext):
+            self.registrations.append(len(self.units))
+        unit_index = len(self.units)
+        self.units.append(unit)
+        if kind != "record" or not body:
+            return
+
+        # 类体：成员函数单独成单元，其余部分（字段、声明、嵌套枚举/常量）留在类壳中
+        shell_mask = masked[start:end]
+        shell_clean = text
+        cut: List[Tuple[int, int]] = []
+        for m_start, m_end, m_kind, m_body in _merge_blocks(_split(masked, body[0], body[1]), masked):
+            if m_kind == "func":
+                member = len(self.units)
+                self._add_unit(index, clean, masked, m_start, m_end, m_kind, m_body, parent=unit_index)
+                self.units[member].refs |= unit.names
+                unit.members.append(member)
+                cut.append((m_start - start, m_end - start))
+            elif m_kind == "enum":
+                unit.names |= _enum_names(masked[m_start:m_end], masked[m_body[0]:m_body[1]] if m_body else "")
+            elif m_kind == "decl":
+                unit.names |= {name for name in _decl_names(masked[m_start:m_end])
+                               if "=" in masked[m_start:m_end] or "{" in masked[m_start:m_end]}
+        shell_clean, shell_mask = _remove_spans(shell_clean, shell_mask, cut)
+        unit.shell = shell_clean
+        unit.refs = _idents(shell_mask) - unit.names
+
+    # -- 遍历 ------------------------------------------------------------
+    def _definitions(self) -> Dict[str, List[int]]:
+        defs: Dict[str, List[int]] = {}
+        for i, unit in enumerate(self.units):
+            for name in unit.names:
+                defs.setdefault(name, []).append(i)
+        # 有定义的函数不再拉入其前置声明
+        for name, indices in defs.items():
+            bodies = [i for i in indices if self.units[i].kind != "decl" or "(" not in self.units[i].text]
+            if bodies and len(bodies) < len(indices):
+                defs[name] = bodies
+        return defs
+
+    def entry_names(self) -> List[str]:
+        if self.extra_entries:
+            return list(self.extra_entries)
+        if self.registered:
+            return sorted(self.registered)
+        op = self.operator_name.replace("_", "").lower()
+        names = sorted({name for unit in self.units if unit.kind == "func" for name in unit.names
+                        if "::" not in name and "tiling" in name.lower() and op in name.replace("_", "").lower()})
+        if names:
+            return names
+        return sorted({name for unit in self.units if unit.kind == "func" for name in unit.names
+                       if name.endswith("TilingFunc")})
+
+    def distances(self) -> Dict[int, int]:
+        defs = self._definitions()
+        roots = [i for name in self.entry_names() for i in defs.get(name, [])]
+        self.fallback = not roots
+        if not roots:
+            return {i: 0 for i in range(len(self.units))}
+        roots += self.registrations
+        dist = self._walk(defs, roots, {})
+        # 已命中文件中的 tiling key 相关定义（常量、宏、计算函数）
+        hit_files = {self.units[i].file_index for i in dist}
+        key_roots = [i for i, unit in enumerate(self.units)
+                     if i not in dist and unit.file_index in hit_files
+                     and any(_TILING_KEY_RE.search(name) for name in unit.names)]
+        return self._walk(defs, key_roots, dist)
+
+    def _walk(self, defs: Dict[str, List[int]], roots: List[int], dist: Dict[int, int]) -> Dict[int, int]:
+        queue = deque()
+        for root in roots:
+            if root not in dist:
+                dist[root] = 0
+                queue.append(root)
+        while queue:
+            current = queue.popleft()
+            unit = self.units[current]
+            targets = [i for ref in unit.refs for i in defs.get(ref, [])]
+            if unit.parent is not None:
+                targets.append(unit.parent)
+            for target in targets:
+                if target not in dist:
+                    dist[target] = dist[current] + 1
+                    queue.append(target)
+        return dist
+
+    # -- 输出 ------------------------------------------------------------
+    def render(self) -> Tuple[str, "SliceReport"]:
+        dist = self.distances()
+        costs = {i: estimate_tokens(_tidy(self.units[i].shell or self.units[i].text)) for i in dist}
+        kept: Set[int] = set()
+        used = 0
+        dropped = 0
+        for i in sorted(dist, key=lambda i: (dist[i], self.units[i].file_index, self.units[i].start)):
+            cost = costs[i]
+            if self.budget and used + cost > self.budget and kept:
+                dropped += 1
+                continue
+            kept.add(i)
+            used += cost
+
+        sections: List[str] = []
+        files_kept = 0
+        for file_index, path in enumerate(self.files):
+            blocks = []
+            for i, unit in enumerate(self.units):
+                if unit.file_index != file_index or i not in kept:
+                    continue
+                if unit.parent is not None and unit.parent in kept:
+                    continue
+                blocks.append(self._unit_text(i, kept))
+            blocks = [b for b in blocks if b]
+            if not blocks:
+                continue
+            files_kept += 1
+            sections.extend([f"#### 源码文件 {files_kept}: {path.name}", "```cpp", _join_blocks(blocks), "```", ""])
+
+        report = SliceReport(
+            entries=[] if self.fallback else self.entry_names(),
+            files_total=len(self.files), files_kept=files_kept,
+            units_total=len(self.units), units_reachable=len(dist), units_kept=len(kept),
+            units_over_budget=dropped, tokens_before=self.raw_tokens,
+            tokens_after=estimate_tokens("\n".join(sections)), budget=self.budget,
+        )
+        return "\n".join(sections), report
+
+    def _unit_text(self, index: int, kept: Set[int]) -> str:
+        unit = self.units[index]
+        if not unit.members:
+            return _tidy(unit.text)
+        # 类壳：保留可达的内联成员函数，删除其余成员函数
+        text = self.texts[unit.file_index]
+        cut = [(self.units[m].start, self.units[m].end) for m in unit.members if m not in kept]
+        parts = []
+        last = unit.start
+        for start, end in sorted(cut):
+            parts.append(text[last:start])
+            last = end
+        parts.append(text[last:unit.end])
+        return _tidy("".join(parts))
+
+
+def _join_blocks(blocks: List[str]) -> str:
+    """相邻的单行单元（宏、常量）紧挨着输出，多行单元之间空一行。"""
+    out = blocks[0]
+    for prev, block in zip(blocks, blocks[1:]):
+        out += ("\n" if "\n" not in prev and "\n" not in block else "\n\n") + block
+    return out
+
+
+def _tidy(text: str) -> str:
+    # 删除日志等留下的空白：空行去掉，行内连续空白压缩
+    lines = [re.sub(r"(?<=\S)[ \t]{4,}", " ", line.rstrip()) for line in text.strip("\n").splitlines()]
+    lines = [line for line in lines if line.strip()]
+    if not lines:
+        return ""
+    indent = min(len(line) - len(line.lstrip()) for line in lines)
+    first = lines[0].lstrip()
+    return "\n".join([first] + [line[indent:] for line in lines[1:]])
+
+
+@dataclass
+class SliceReport:
+    entries: List[str]
+    files_total: int
+    files_kept: int
+    units_total: int
+    units_reachable: int
+    units_kept: int
+    units_over_budget: int
+    tokens_before: int
+    tokens_after: int
+    budget: int
+
+    @property
+    def reduction(self) -> float:
+        if not self.tokens_before:
+            return 0.0
+        return 1.0 - self.tokens_after / self.tokens_before
+
+    def log(self):
+        if self.entries:
+            logger.info(f"✂️ 源码切片入口: {', '.join(self.entries[:8])}"
+                        + (f" 等 {len(self.entries)} 个" if len(self.entries) > 8 else ""))
+        else:
+            logger.warning("⚠️ 未找到 tiling 入口（可用 STAGE1_SLICE_ENTRY 指定），保留全部声明，仅去除注释与日志")
+        logger.info(f"✂️ 源码切片: 单元 {self.units_total} → 可达 {self.units_reachable} → 保留 {self.units_kept}，"
+                    f"文件 {self.files_total} → {self.files_kept}，"
+                    f"约 {self.tokens_before:,} → {self.tokens_after:,} tokens（减少 {self.reduction:.1%}）")
+        if self.units_over_budget:
+            logger.warning(f"⚠️ 超出 token 预算 {self.budget:,}，丢弃 {self.units_over_budget} 个离入口较远的单元")
+
+
+def slice_sources(operator_name: str, cpp_files: Sequence[Path], budget: Optional[int] = None,
+                  entries: Optional[Sequence[str]] = None) -> Tuple[str, SliceReport]:
+    """切片 cpp_files，返回 prompt 源码部分与统计；budget/entries 为空时读取环境变量。"""
+    slicer = SourceSlicer(operator_name,
+                          budget=token_budget() if budget is None else budget,
+                          entries=configured_entries() if entries is None else entries)
+    for path in cpp_files:
+        content = read_file_content(path)
+        if content.strip():
+            slicer.add_file(Path(path), content)
+    return slicer.render()
+
+
+def main(argv: Optional[List[str]] = None) -> int:
+    parser = argparse.ArgumentParser(description="预览 Stage 1 源码切片结果")
+    parser.add_argument("operator_name")
+    parser.add_argument("source_paths", nargs="+")
+    parser.add_argument("--budget", type=int, default=None, help="token 预算（默认 STAGE1_TOKEN_BUDGET 或 32000，0 为不限）")
+    parser.add_argument("--entry", action="append", default=None, help="入口函数名，可重复")
+    args = parser.parse_args(argv)
+
+    section, report = slice_sources(args.operator_name, get_cpp_files(args.source_paths),
+                                    budget=args.budget, entries=args.entry)
+    print(section)
+    report.log()
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
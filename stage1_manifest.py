@@ -0,0 +1,158 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+Stage 1 增量判定：记录每个算子上次成功生成时的输入内容哈希，输入未变化时直接复用上次的 test_params_*.xlsx。
+
+- 输入：get_cpp_files 收集到的源码文件、few-shot 文件、特殊要求文件（均按内容 sha256），以及影响结果的设置
+  （模型名、采样次数、prompt 模板与系统消息的哈希）
+- 清单保存在 <UTGEN_CACHE_DIR 或 .cache>/stage1/<算子名小写>.json，同时记录输出 xlsx/prompt 的路径与哈希
+- 文件的 size + mtime_ns 与上次一致时沿用记录的哈希，不重新读取内容（夜间批量时大部分算子只做 stat）
+- 有变化时给出原因（新增/删除/修改的文件、变化的设置），写入 stage-1 日志
+- STAGE1_FORCE=1 时忽略清单强制重新生成
+"""
+
+from __future__ import annotations
+
+import hashlib
+import json
+import os
+import shutil
+from pathlib import Path
+from typing import Any, Dict, List, Optional, Tuple
+
+from utils import logger
+
+MANIFEST_VERSION = 1
+
+
+def manifest_path(operator_name: str) -> Path:
+    cache_dir = Path(os.environ.get("UTGEN_CACHE_DIR") or ".cache")
+    return cache_dir / "stage1" / f"{operator_name.lower()}.json"
+
+
+def text_hash(text: str) -> str:
+    return hashlib.sha256(text.encode("utf-8")).hexdigest()
+
+
+def file_hash(path: Path) -> str:
+    digest = hashlib.sha256()
+    with open(path, "rb") as f:
+        for block in iter(lambda: f.read(1 << 20), b""):
+            digest.update(block)
+    return digest.hexdigest()
+
+
+def describe_file(path: Path, previous: Optional[Dict[str, Any]] = None) -> Dict[str, Any]:
+    """文件的哈希记录；size 与 mtime_ns 未变时沿用上次的哈希。"""
+    stat = path.stat()
+    if previous and previous.get("size") == stat.st_size and previous.get("mtime_ns") == stat.st_mtime_ns:
+        return dict(previous)
+    return {"sha256": file_hash(path), "size": stat.st_size, "mtime_ns": stat.st_mtime_ns}
+
+
+def load_manifest(operator_name: str) -> Optional[Dict[str, Any]]:
+    path = manifest_path(operator_name)
+    if not path.exists():
+        return None
+    try:
+        with open(path, "r", encoding="utf-8") as f:
+            data = json.load(f)
+        return data if data.get("version") == MANIFEST_VERSION else None
+    except (OSError, ValueError) as e:
+        logger.warning(f"读取 Stage 1 清单失败 {path}: {e}")
+        return None
+
+
+def build_inputs(files: Dict[str, List[Path]], settings: Dict[str, Any],
+                 previous: Optional[Dict[str, Any]] = None) -> Dict[str, Any]:
+    """
+    计算本次输入的清单
+
+    Args:
+        files: 分组 -> 文件列表（sources / fewshot / special_reqs）
+        settings: 影响生成结果的设置
+        previous: 上次的清单（用于复用未变化文件的哈希）
+    """
+    old_files = (previous or {}).get("inputs", {}).get("files", {})
+    groups: Dict[str, Dict[str, Any]] = {}
+    for group, paths in files.items():
+        old_group = old_files.get(group, {})
+        entries = {}
+        for path in paths:
+            key = str(Path(path).resolve())
+            entries[key] = describe_file(Path(key), old_group.get(key))
+        groups[group] = entries
+    return {"files": groups, "settings": dict(settings)}
+
+
+def diff_inputs(old: Optional[Dict[str, Any]], new: Dict[str, Any]) -> List[str]:
+    """返回需要重新生成的原因；为空表示输入未变化。"""
+    if old is None:
+        return ["没有上次成功生成的记录"]
+    reasons: List[str] = []
+    old_inputs = old.get("inputs", {})
+    for name, value in new["settings"].items():
+        if old_inputs.get("settings", {}).get(name) != value:
+            reasons.append(f"设置 {name} 变化: {old_inputs.get('settings', {}).get(name)} -> {value}")
+    for group, entries in new["files"].items():
+        old_entries = old_inputs.get("files", {}).get(group, {})
+        for path in sorted(set(entries) - set(old_entries)):
+            reasons.append(f"[{group}] 新增 {path}")
+        for path in sorted(set(old_entries) - set(entries)):
+            reasons.append(f"[{group}] 删除 {path}")
+        for path in sorted(set(entries) & set(old_entries)):
+            if entries[path]["sha256"] != old_entries[path]["sha256"]:
+                reasons.append(f"[{group}] 修改 {path}")
+    return reasons
+
+
+def _output_record(path: str) -> Optional[Dict[str, str]]:
+    p = Path(path)
+    if not p.exists():
+        return None
+    return {"path": str(p.resolve()), "sha256": file_hash(p)}
+
+
+def save_manifest(operator_name: str, inputs: Dict[str, Any], output_file: str, prompt_file: str):
+    record = {
+        "version": MANIFEST_VERSION,
+        "operator": operator_name,
+        "inputs": inputs,
+        "output": _output_record(output_file),
+        "prompt": _output_record(prompt_file),
+    }
+    path = manifest_path(operator_name)
+    path.parent.mkdir(parents=True, exist_ok=True)
+    tmp = path.with_suffix(".json.tmp")
+    with open(tmp, "w", encoding="utf-8") as f:
+        json.dump(record, f, ensure_ascii=False, indent=2)
+    os.replace(tmp, path)
+
+
+def reusable_output(manifest: Dict[str, Any]) -> Tuple[Optional[Path], str]:
+    """上次的输出是否仍可复用：文件存在且内容与记录一致。返回 (路径, 不可复用的原因)。"""
+    output = manifest.get("output")
+    if not output:
+        return None, "上次没有记录输出文件"
+    path = Path(output["path"])
+    if not path.exists():
+        return None, f"上次的输出文件已不存在: {path}"
+    if file_hash(path) != output["sha256"]:
+        return None, f"上次的输出文件已被修改: {path}"
+    return path, ""
+
+
+def reuse_previous(manifest: Dict[str, Any], output_file: str, prompt_file: str) -> bool:
+    """把上次的 xlsx（及 prompt）复制到本次输出路径；不可复用时返回 False。"""
+    previous_output, reason = reusable_output(manifest)
+    if previous_output is None:
+        logger.info(f"🔁 需要重新生成: {reason}")
+        return False
+    if previous_output.resolve() != Path(output_file).resolve():
+        Path(output_file).parent.mkdir(parents=True, exist_ok=True)
+        shutil.copy2(previous_output, output_file)
+    prompt = manifest.get("prompt")
+    if prompt and Path(prompt["path"]).exists() and Path(prompt["path"]).resolve() != Path(prompt_file).resolve():
+        shutil.copy2(prompt["path"], prompt_file)
+    logger.info(f"♻️  输入未变化，复用上次的测试参数: {previous_output}")
+    return True
@@ -11,12 +11,35 @@ import json
 import csv
 import io
 from pathlib import Path
-from typing import List, Dict, Any, Optional
+from typing import Callable, List, Dict, Any, Optional
 from utils import (
     get_cpp_files, read_file_content,
     ModelCaller, save_xlsx_content, save_file_content,
     logger, validate_path
 )
+from stage1_manifest import (
+    build_inputs, diff_inputs, load_manifest, reuse_previous, save_manifest, text_hash
+)
+from source_slicer import slice_enabled, slice_settings, slice_sources
+from llm_client import estimate_tokens
+
+STAGE1_SYSTEM_MESSAGE = """你是一个专业的C++测试工程师，专门为算子设计测试参数。
+请根据提供的算子代码和示例，生成全面的测试参数集。
+直接输出CSV格式的数据，确保参数覆盖各种测试场景。
+第一行必须是列名，后续行是具体的测试数据。"""
+
+# prompt 布局：prefix 把系统消息、few-shot 与生成要求等不随算子变化的内容放在最前，
+# 算子名、源码与特殊要求放在最后，不同算子的调用共享同一前缀，可命中服务端 KV 前缀缓存；legacy 为原布局
+PROMPT_LAYOUTS = ("prefix", "legacy")
+
+
+def prompt_layout() -> str:
+    layout = (os.environ.get('STAGE1_PROMPT_LAYOUT') or "prefix").strip().lower()
+    if layout not in PROMPT_LAYOUTS:
+        logger.warning(f"未知的 STAGE1_PROMPT_LAYOUT={layout}，使用 prefix")
+        return "prefix"
+    return layout
+
 
 def load_fewshot_examples(fewshot_file: str) -> str:
     """
@@ -46,9 +69,14 @@ def load_fewshot_examples(fewshot_file: str) -> str:
 
 class TestcasePromptGenerator:
     """测试用例提示词生成器"""
+
+    # prefix 布局中算子相关部分的起点，之前的内容与算子无关
+    OPERATOR_MARKER = "## 目标算子："
     
-    def __init__(self, model_caller: ModelCaller, special_reqs_dir: Optional[str] = None):
-        self.template = self._load_template()
+    def __init__(self, model_caller: ModelCaller, special_reqs_dir: Optional[str] = None,
+                 layout: Optional[str] = None):
+        self.layout = layout or prompt_layout()
+        self.template = self._load_prefix_template() if self.layout == "prefix" else self._load_template()
         self.model_caller = model_caller
         self.special_reqs_dir = Path(special_reqs_dir) if special_reqs_dir else None
     
@@ -99,9 +127,65 @@ boundary_min,1,1,1,...
 
 请直接输出CSV内容，至少生成8-10个测试用例：
 """
+
+    def _load_prefix_template(self) -> str:
+        """加载前缀缓存友好的提示词模板：OPERATOR_MARKER 之前只有 {examples_section} 一个占位符"""
+        return """# 算子测试用例参数生成
+
+## 任务目标
+根据目标算子的源码和以下示例，生成一套完整的测试参数。
+输出格式为CSV，包含测试用例名称和各种参数组合。
+
+## 参考示例
+{examples_section}
+
+## 生成要求
+
+### 1. 参数设计原则
+- **覆盖性**: 确保测试用例覆盖算子的所有关键功能路径
+- **边界测试**: 包含最小值、最大值、边界条件
+- **性能测试**: 包含不同规模的数据测试
+- **异常处理**: 包含可能触发异常的参数组合
+
+### 2. 测试用例类型
+请生成以下类型的测试用例：
+- 请尝试理解源码和示例中的 tiling key，这是生成优质测试用例的关键
+- 请参考示例中的输出形式，并生成类似的测试用例
+
+### 3. 参数命名规范
+- 使用清晰的参数名称，与源码中的变量名保持一致
+- 测试用例名称应描述测试目的，请参考示例中的命名方式
+- 数值参数使用合理的范围和步长
+
+### 4. 输出格式
+CSV格式，第一行为列名，格式示例：
+```csv
+test_name,param1,param2,param3,...
+basic_small,64,128,256,...
+boundary_min,1,1,1,...
+```
+
+## 目标算子：{operator_name}
+
+### 算子源码
+{source_code_section}
+
+### 特殊要求
+{special_requirements_section}
+
+请为{operator_name}算子直接输出CSV内容，至少生成8-10个测试用例：
+"""
+
+    def static_prefix(self, fewshot_content: str) -> str:
+        """prefix 布局下与算子无关的 prompt 前缀（legacy 布局为空）"""
+        if self.layout != "prefix":
+            return ""
+        head = self.template[:self.template.index(self.OPERATOR_MARKER)]
+        return head.format(examples_section=self._generate_examples_section(fewshot_content))
     
     def generate(self, operator_name: str, source_paths: List[str], 
-                fewshot_content: str, operator_info: Optional[Dict] = None) -> str:
+                fewshot_content: str, operator_info: Optional[Dict] = None,
+                cpp_files: Optional[List[Path]] = None) -> str:
         """
         生成测试用例提示词
         
@@ -110,13 +194,14 @@ boundary_min,1,1,1,...
             source_paths: 源码路径列表
             fewshot_content: few-shot示例内容
             operator_info: 算子额外信息
+            cpp_files: 已收集的源码文件（为空时按 source_paths 重新收集）
         
         Returns:
             str: 生成的提示词
         """
         
         # 生成源码部分
-        source_code_section = self._generate_source_section(source_paths)
+        source_code_section = self._generate_source_section(source_paths, cpp_files, operator_name)
        
         # 消融模型的“分析算子特征”调用
         # 生成示例部分
@@ -134,12 +219,42 @@ boundary_min,1,1,1,...
         )
         return prompt
     
-    def _generate_special_requirements(self, operator_name: str) -> str:
-        """按算子名从目录读取“特殊要求”文本。
+    def find_special_requirements_file(self, operator_name: str) -> Optional[Path]:
+        """按算子名查找“特殊要求”文件。
 
         优先匹配同名文件（不区分大小写），支持 .md/.txt；
-        若找不到，查找 DEFAULT.md/DEFAULT.txt；若仍未找到，给出提示占位。
+        若找不到，查找 DEFAULT.md/DEFAULT.txt；均不存在时返回 None。
         """
+        if not self.special_reqs_dir or not self.special_reqs_dir.exists():
+            return None
+
+        # 生成候选名（大小写不敏感）
+        op_lower = operator_name.lower()
+
+        candidates = []
+        for path in sorted(self.special_reqs_dir.iterdir()):
+            if not path.is_file():
+                continue
+            stem_lower = path.stem.lower()
+            suffix_lower = path.suffix.lower()
+            if suffix_lower not in {'.md', '.txt'}:
+                continue
+            if stem_lower == op_lower:
+                candidates.append(path)
+
+        # 精确匹配优先
+        if candidates:
+            return candidates[0]
+
+        # 回退到 DEFAULT
+        for default_name in ('DEFAULT.md', 'default.md', 'DEFAULT.txt', 'default.txt'):
+            p = self.special_reqs_dir / default_name
+            if p.exists() and p.is_file():
+                return p
+        return None
+
+    def _generate_special_requirements(self, operator_name: str) -> str:
+        """按算子名从目录读取“特殊要求”文本；未找到时给出提示占位。"""
         if not self.special_reqs_dir:
             return "未提供特殊要求"
 
@@ -147,31 +262,7 @@ boundary_min,1,1,1,...
             if not self.special_reqs_dir.exists():
                 return f"未找到特殊要求目录: {self.special_reqs_dir}"
 
-            # 生成候选名（大小写不敏感）
-            op_lower = operator_name.lower()
-
-            candidates = []
-            for path in self.special_reqs_dir.iterdir():
-                if not path.is_file():
-                    continue
-                stem_lower = path.stem.lower()
-                suffix_lower = path.suffix.lower()
-                if suffix_lower not in {'.md', '.txt'}:
-                    continue
-                if stem_lower == op_lower:
-                    candidates.append(path)
-
-            # 精确匹配优先
-            target_file = candidates[0] if candidates else None
-
-            # 回退到 DEFAULT
-            if target_file is None:
-                for default_name in ('DEFAULT.md', 'default.md', 'DEFAULT.txt', 'default.txt'):
-                    p = self.special_reqs_dir / default_name
-                    if p.exists() and p.is_file():
-                        target_file = p
-                        break
-
+            target_file = self.find_special_requirements_file(operator_name)
             if target_file is None:
                 return "未找到与该算子匹配的特殊要求"
 
@@ -182,12 +273,23 @@ boundary_min,1,1,1,...
             logger.warning(f"读取特殊要求失败: {exc}")
             return "未能读取特殊要求"
 
-    def _generate_source_section(self, source_paths: List[str]) -> str:
-        """生成源码部分"""
+    def _generate_source_section(self, source_paths: List[str],
+                                 cpp_files: Optional[List[Path]] = None,
+                                 operator_name: str = "") -> str:
+        """生成源码部分；默认按 tiling 入口切片（source_slicer.py），STAGE1_SLICE=0 时拼接全部源码"""
         lines = []
-        cpp_files = get_cpp_files(source_paths)
+        if cpp_files is None:
+            cpp_files = get_cpp_files(source_paths)
         
-        if cpp_files:
+        if cpp_files and slice_enabled():
+            logger.info(f"收集到 {len(cpp_files)} 个源码文件，按 tiling 入口切片")
+            section, report = slice_sources(operator_name, cpp_files)
+            report.log()
+            if section.strip():
+                return ("以下源码已从 tiling 入口切片：仅保留可达的函数、常量与 tiling key 计算，"
+                        "已去除注释、日志与无关代码。\n\n" + section)
+            lines.append("未找到目标算子源码文件")
+        elif cpp_files:
             logger.info(f"收集到 {len(cpp_files)} 个源码文件")
             
             for i, file_path in enumerate(cpp_files, 1):
@@ -291,6 +393,76 @@ def is_likely_csv_line(line: str) -> bool:
         return False
 
 
+def _merge_bracket_groups(tokens: List[str]) -> List[str]:
+    """合并未加引号的括号/中括号/花括号中的逗号，避免被误拆分为多列"""
+    merged: List[str] = []
+    buf: List[str] = []
+    open_ch = ''
+    close_ch = ''
+    balance = 0
+    def counts(s: str, ch_open: str, ch_close: str) -> int:
+        return s.count(ch_open) - s.count(ch_close)
+    for t in tokens:
+        st = t.strip()
+        if balance == 0 and st and st[0] in '[{(': 
+            open_ch = st[0]
+            close_ch = { '[': ']', '{': '}', '(': ')' }[open_ch]
+            balance = counts(st, open_ch, close_ch)
+            buf = [t]
+            if balance <= 0:
+                merged.append("".join(buf).strip())
+                buf = []
+                open_ch = close_ch = ''
+                balance = 0
+            continue
+        if balance > 0:
+            buf.append(t)
+            balance += counts(st, open_ch, close_ch)
+            if balance <= 0:
+                merged.append(",".join(buf).strip())
+                buf = []
+                open_ch = close_ch = ''
+                balance = 0
+            continue
+        merged.append(t)
+    if buf:
+        merged.append(",".join(buf).strip())
+    return merged
+
+
+def validate_csv_line(line: str, i: int, first_row_fields: List[str]) -> Optional[str]:
+    """
+    按表头校验第 i 行（从 0 起，第 0 行为表头），返回修正后的行；解析失败返回 None
+    """
+    expected_columns = len(first_row_fields)
+    try:
+        reader = csv.reader(io.StringIO(line))
+        fields = next(reader)
+        # 若表头包含 op_type 且当前行第二列像形状（以括号/中括号/花括号开头），则在索引1插入空占位，纠正列左移
+        try:
+            if i > 0 and len(first_row_fields) >= 2 and first_row_fields[1].strip().lower() == 'op_type':
+                if len(fields) >= 2 and fields[1].strip().startswith(('[', '{', '(')):
+                    fields.insert(1, '')
+        except Exception:
+            pass
+        fields = _merge_bracket_groups(fields)
+        
+        # 列数自适应：多的裁剪，少的补空
+        if len(fields) != expected_columns:
+            logger.warning(f"第{i+1}行列数不匹配: 期望{expected_columns}列，实际{len(fields)}列")
+            if len(fields) > expected_columns:
+                fields = fields[:expected_columns]
+            else:
+                fields = fields + [""] * (expected_columns - len(fields))
+            # 重构该行
+            line = ",".join(fields)
+        return line
+            
+    except Exception as e:
+        logger.warning(f"第{i+1}行解析失败: {e}")
+        return None
+
+
 def validate_csv_format(lines: List[str]) -> List[str]:
     """
     验证并返回有效的CSV行
@@ -311,66 +483,9 @@ def validate_csv_format(lines: List[str]) -> List[str]:
         # 验证所有行
         valid_lines = []
         for i, line in enumerate(lines):
-            try:
-                reader = csv.reader(io.StringIO(line))
-                fields = next(reader)
-                # 若表头包含 op_type 且当前行第二列像形状（以括号/中括号/花括号开头），则在索引1插入空占位，纠正列左移
-                try:
-                    if i > 0 and len(first_row_fields) >= 2 and first_row_fields[1].strip().lower() == 'op_type':
-                        if len(fields) >= 2 and fields[1].strip().startswith(('[', '{', '(')):
-                            fields.insert(1, '')
-                except Exception:
-                    pass
-                # 合并未加引号的括号/中括号/花括号中的逗号，避免被误拆分为多列
-                def _merge_bracket_groups(tokens: List[str]) -> List[str]:
-                    merged: List[str] = []
-                    buf: List[str] = []
-                    open_ch = ''
-                    close_ch = ''
-                    balance = 0
-                    def counts(s: str, ch_open: str, ch_close: str) -> int:
-                        return s.count(ch_open) - s.count(ch_close)
-                    for t in tokens:
-                        st = t.strip()
-                        if balance == 0 and st and st[0] in '[{(': 
-                            open_ch = st[0]
-                            close_ch = { '[': ']', '{': '}', '(': ')' }[open_ch]
-                            balance = counts(st, open_ch, close_ch)
-                            buf = [t]
-                            if balance <= 0:
-                                merged.append("".join(buf).strip())
-                                buf = []
-                                open_ch = close_ch = ''
-                                balance = 0
-                            continue
-                        if balance > 0:
-                            buf.append(t)
-                            balance += counts(st, open_ch, close_ch)
-                            if balance <= 0:
-                                merged.append(",".join(buf).strip())
-                                buf = []
-                                open_ch = close_ch = ''
-                                balance = 0
-                            continue
-                        merged.append(t)
-                    if buf:
-                        merged.append(",".join(buf).strip())
-                    return merged
-                fields = _merge_bracket_groups(fields)
-                
-                # 列数自适应：多的裁剪，少的补空
-                if len(fields) != expected_columns:
-                    logger.warning(f"第{i+1}行列数不匹配: 期望{expected_columns}列，实际{len(fields)}列")
-                    if len(fields) > expected_columns:
-                        fields = fields[:expected_columns]
-                    else:
-                        fields = fields + [""] * (expected_columns - len(fields))
-                    # 重构该行
-                    line = ",".join(fields)
+            line = validate_csv_line(line, i, first_row_fields)
+            if line is not None:
                 valid_lines.append(line)
-                    
-            except Exception as e:
-                logger.warning(f"第{i+1}行解析失败: {e}")
                 
         return valid_lines
         
@@ -379,10 +494,106 @@ def validate_csv_format(lines: List[str]) -> List[str]:
         return lines
 
 
+class StreamingCsvParser:
+    """
+    增量CSV解析：流式响应逐块 feed，每凑齐一行即按 parse_csv_response 的规则筛选、
+    按 validate_csv_line 校验，有效行（第一行为表头）立即交给 on_line
+    
+    正常响应下 lines 与 parse_csv_response(完整响应) 的结果一致；stream_pipeline.py 结束时仍会比对
+    """
+    
+    def __init__(self, on_line: Callable[[str], None], on_reset: Optional[Callable[[], None]] = None):
+        self.on_line = on_line
+        self.on_reset = on_reset
+        self.reset(notify=False)
+    
+    def reset(self, notify: bool = True):
+        """丢弃已解析的内容（模型调用重试时由 llm_client 调用）"""
+        self._pending = ""
+        self._in_csv_block = False
+        self._header: Optional[List[str]] = None
+        self._count = 0
+        self.lines: List[str] = []
+        if notify and self.on_reset:
+            self.on_reset()
+    
+    def feed(self, text: str):
+        self._pending += text
+        if '\n' not in text:
+            return
+        *complete, self._pending = self._pending.split('\n')
+        for line in complete:
+            self._consume(line)
+    
+    def close(self) -> List[str]:
+        """处理最后一行（响应末尾可能没有换行），返回全部有效行"""
+        if self._pending.strip():
+            self._consume(self._pending)
+        self._pending = ""
+        return self.lines
+    
+    def _consume(self, line: str):
+        stripped = line.strip()
+        # 检测CSV代码块
+        if stripped.startswith('```csv'):
+            self._in_csv_block = True
+            return
+        if stripped.startswith('```'):
+            self._in_csv_block = False
+            return
+        if not stripped or (not self._in_csv_block and not is_likely_csv_line(line)):
+            return
+        
+        if self._header is None:
+            try:
+                self._header = next(csv.reader(io.StringIO(line)))
+            except Exception as e:
+                logger.error(f"CSV格式验证失败: {e}")
+                return
+            if not any(char.isdigit() for char in line):
+                logger.info(f"检测到CSV表头，共{len(self._header)}列")
+        validated = validate_csv_line(line, self._count, self._header)
+        self._count += 1
+        if validated is not None:
+            self.lines.append(validated)
+            self.on_line(validated)
+
+
+def merge_csv_samples(samples: List[List[str]]) -> List[str]:
+    """
+    合并多次采样得到的CSV行：以第一份有效结果的表头为准，去重保留其余表头一致的样本中的数据行
+    
+    Args:
+        samples: 每次采样解析得到的CSV行（第一行为表头）
+    
+    Returns:
+        List[str]: 合并后的CSV行
+    """
+    samples = [lines for lines in samples if lines]
+    if not samples:
+        return []
+    
+    header = samples[0][0]
+    merged = [header]
+    seen = set()
+    for i, lines in enumerate(samples):
+        if lines[0].replace(' ', '') != header.replace(' ', ''):
+            logger.warning(f"第 {i + 1} 份采样的表头与第 1 份不一致，已忽略")
+            continue
+        for line in lines[1:]:
+            key = line.replace(' ', '')
+            if key not in seen:
+                seen.add(key)
+                merged.append(line)
+    if len(samples) > 1:
+        logger.info(f"合并 {len(samples)} 份采样，共 {len(merged) - 1} 行测试参数")
+    return merged
+
+
 def generate_testcase_params(operator_name: str, source_paths: List[str], 
                             output_file: str, prompt_file: str,
                             fewshot_file: str, api_key: str, 
-                            base_url: str, model_name: str) -> bool:
+                            base_url: str, model_name: str, row_sink: Any = None) -> bool:
     """
     生成测试用例参数的主函数
     
@@ -395,6 +606,8 @@ def generate_testcase_params(operator_name: str, source_paths: List[str],
         api_key: API密钥
         base_url: API基础URL
         model_name: 模型名称
+        row_sink: 流水线接收方（见 stream_pipeline.py）：生成过程中每解析出一行有效CSV即调用 line(行)，
+                  模型调用重试时调用 reset()，保存参数文件后调用 complete(全部CSV行)；复用上次结果时不调用
     
     Returns:
         bool: 是否成功
@@ -403,21 +616,58 @@ def generate_testcase_params(operator_name: str, source_paths: List[str],
     logger.info("=" * 50)
     
     # 初始化模型调用器
-    model_caller = ModelCaller(api_key, base_url, model_name, use_cache=True)
+    # STAGE1_FORCE=1 时既不复用上次的参数文件，也不读取响应缓存
+    force = os.environ.get('STAGE1_FORCE', '') not in ('', '0')
+    model_caller = ModelCaller(api_key, base_url, model_name, use_cache=not force, cache_namespace="stage1")
 
+    # 初始化提示词生成器（支持从环境变量读取特殊要求目录）
+    special_reqs_dir = os.environ.get('SPECIAL_REQS_DIR')
+    prompt_generator = TestcasePromptGenerator(model_caller, special_reqs_dir=special_reqs_dir)
+    num_samples = max(1, int(os.environ.get('STAGE1_SAMPLES', '1') or 1))
+    
+    # 增量判定：源码、few-shot、特殊要求与生成设置均未变化时复用上次的参数文件
+    cpp_files = get_cpp_files(source_paths)
+    special_file = prompt_generator.find_special_requirements_file(operator_name)
+    input_files = {
+        "sources": cpp_files,
+        "fewshot": [Path(fewshot_file)] if Path(fewshot_file).is_file() else [],
+        "special_reqs": [special_file] if special_file else [],
+    }
+    settings = {
+        "model": model_name,
+        "samples": num_samples,
+        "prompt_template": text_hash(prompt_generator.template + STAGE1_SYSTEM_MESSAGE),
+        "source_slice": slice_settings(),
+    }
+    previous = load_manifest(operator_name)
+    inputs = build_inputs(input_files, settings, previous)
+    if not force:
+        reasons = diff_inputs(previous, inputs)
+        if not reasons and reuse_previous(previous, output_file, prompt_file):
+            return True
+        for reason in reasons[:20]:
+            logger.info(f"🔁 需要重新生成: {reason}")
+        if len(reasons) > 20:
+            logger.info(f"🔁 ... 另有 {len(reasons) - 20} 处变化")
+    else:
+        logger.info("🔁 STAGE1_FORCE 已设置，强制重新生成")
+    
     # 加载few-shot示例
     logger.info("📚 加载few-shot示例...")
     fewshot_content = load_fewshot_examples(fewshot_file)
     if not fewshot_content:
         logger.warning("未能加载few-shot示例，将仅基于源码生成")
     
-    # 初始化提示词生成器（支持从环境变量读取特殊要求目录）
-    special_reqs_dir = os.environ.get('SPECIAL_REQS_DIR')
-    prompt_generator = TestcasePromptGenerator(model_caller, special_reqs_dir=special_reqs_dir)
-    
     # 生成prompt
     logger.info("📝 生成测试参数生成prompt...")
-    prompt = prompt_generator.generate(operator_name, source_paths, fewshot_content)
+    prompt = prompt_generator.generate(operator_name, source_paths, fewshot_content, cpp_files=cpp_files)
+    static_prefix = prompt_generator.static_prefix(fewshot_content)
+    model_caller.metrics_context.update(operator=operator_name, layout=prompt_generator.layout,
+                                        prefix_hash=text_hash(STAGE1_SYSTEM_MESSAGE + static_prefix)[:16]
+                                        if static_prefix else "")
+    if static_prefix:
+        logger.info(f"📝 prompt 布局 prefix：与算子无关的前缀约 {estimate_tokens(static_prefix):,} tokens，"
+                    f"算子相关部分约 {estimate_tokens(prompt) - estimate_tokens(static_prefix):,} tokens")
     
     # 保存prompt到文件
     logger.info("💾 保存prompt到文件...")
@@ -426,30 +676,38 @@ def generate_testcase_params(operator_name: str, source_paths: List[str],
     
     logger.info("🤖 调用模型生成测试参数...")
     
-    system_message = """你是一个专业的C++测试工程师，专门为算子设计测试参数。
-请根据提供的算子代码和示例，生成全面的测试参数集。
-直接输出CSV格式的数据，确保参数覆盖各种测试场景。
-第一行必须是列名，后续行是具体的测试数据。"""
-    
-    response = model_caller.call(prompt, system_message, temperature=0.7)
-    
-    if not response:
+    if row_sink is not None and num_samples == 1:
+        # 流水线：边生成边解析，每行校验通过后立即交给 stage 2 渲染
+        parser = StreamingCsvParser(row_sink.line, row_sink.reset)
+        responses = [model_caller.stream(prompt, parser, STAGE1_SYSTEM_MESSAGE, temperature=0.7)]
+        parser.close()
+    else:
+        if row_sink is not None:
+            logger.info("STAGE1_SAMPLES > 1 需要合并各次采样，生成结束后再逐行渲染")
+        # 多次采样（STAGE1_SAMPLES > 1）时并发请求，合并各次结果中表头一致的行
+        responses = model_caller.sample(prompt, STAGE1_SYSTEM_MESSAGE, num_samples, temperature=0.7)
+    responses = [r for r in responses if r]
+    
+    if not responses:
         logger.error("模型调用失败")
         return False
     
     # 解析CSV响应
     logger.info("📊 解析生成的测试参数...")
-    csv_lines = parse_csv_response(response)
+    csv_lines = merge_csv_samples([parse_csv_response(r) for r in responses])
     
     if not csv_lines:
         logger.error("未能从响应中提取有效的CSV内容")
-        logger.debug(f"原始响应前500字符: {response[:500]}")
+        logger.debug(f"原始响应前500字符: {responses[0][:500]}")
         return False
     
     # 保存为Excel文件（XLSX格式）
     success = save_xlsx_content(csv_lines, output_file)
     
     if success:
+        save_manifest(operator_name, inputs, output_file, prompt_file)
+        if row_sink is not None:
+            row_sink.complete(csv_lines)
         logger.info("✅ 测试参数生成完成!")
         logger.info(f"📄 输出文件: {output_file}")
         logger.info(f"📝 Prompt文件: {prompt_file}")
@@ -465,9 +723,10 @@ def generate_testcase_params(operator_name: str, source_paths: List[str],
     return success
 
 
-def main():
-    """主函数"""
-    if len(sys.argv) < 9:
+def main(argv: Optional[List[str]] = None, row_sink: Any = None):
+    """主函数；argv 为空时读取命令行参数（常驻进程 utgen_daemon.py 直接传入），row_sink 见 generate_testcase_params"""
+    argv = sys.argv[1:] if argv is None else list(argv)
+    if len(argv) < 8:
         print("用法: python stage_1.py <算子名称> <输出Excel文件> <Prompt文件> <Few-shot文件> <API_KEY> <BASE_URL> <MODEL_NAME> <源码路径1> [源码路径2] ...")
         print()
         print("示例:")
@@ -477,14 +736,14 @@ def main():
         print("    ../cann-ops-adv/src/mc2/all_gather_matmul")
         return
     
-    operator_name = sys.argv[1]
-    output_file = sys.argv[2]
-    prompt_file = sys.argv[3]
-    fewshot_file = sys.argv[4]
-    api_key = sys.argv[5]
-    base_url = sys.argv[6]
-    model_name = sys.argv[7]
-    source_paths = sys.argv[8:]
+    operator_name = argv[0]
+    output_file = argv[1]
+    prompt_file = argv[2]
+    fewshot_file = argv[3]
+    api_key = argv[4]
+    base_url = argv[5]
+    model_name = argv[6]
+    source_paths = argv[7:]
 
     # 验证few-shot文件路径
     if not Path(fewshot_file).exists():
@@ -511,7 +770,7 @@ def main():
     # 生成测试参数
     success = generate_testcase_params(
         operator_name, valid_paths, output_file, prompt_file,
-        fewshot_file, api_key, base_url, model_name
+        fewshot_file, api_key, base_url, model_name, row_sink
     )
     
     if not success:
@@ -0,0 +1,174 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+Stage 1 → Stage 2 流水线（testf 模式）：模型流式生成参数的同时增量解析 CSV，每校验通过一行就渲染出对应的 TEST_F，
+端到端耗时约等于模型生成时间，而不是“生成 + 保存 xlsx + 读取 + 转换”。
+
+- stage_1.StreamingCsvParser 按 parse_csv_response/validate_csv_format 的规则逐行筛选、校验
+- 每行按 save_xlsx_content 写入单元格的取值规则（utils.csv_cell_value）与 param_reader.RowBuilder 构造行，
+  与读回 xlsx 得到的行一致，输出与先后执行两阶段逐字节相同，行级渲染缓存照常命中
+- 渲染出的用例实时追加到 <out>.partial（可 tail -f 查看），不在内存中累积；结束后把它原子替换为 <out>
+- 参数表照常保存（workflow 的 stage_2 仍可单独重跑）；模型调用重试时丢弃已渲染的用例重新开始
+- --shard N 时结束后按 convert_ut_from_xlsx.py --shard 写出公共头 + 分片 + CMake 片段（见 shard_layout.py）
+- 结束时比对流式解析的行与最终写入 xlsx 的行，不一致（或 STAGE1_SAMPLES > 1 需要合并采样）时按最终参数重新渲染；
+  stage 1 复用上次参数文件时直接按参数表渲染
+
+用法：
+  python3 stream_pipeline.py --ref test_all_gather_matmul.cpp --out test_allgathermatmul_tiling.cpp -- \
+    <stage_1.py 的全部参数：算子名称 输出Excel Prompt文件 Few-shot文件 API_KEY BASE_URL MODEL_NAME 源码路径...>
+"""
+
+from __future__ import annotations
+
+import argparse
+import csv
+import io
+import sys
+import time
+from pathlib import Path
+from typing import Any, Dict, Iterable, List, Optional
+
+import stage_1
+from case_lint import DEFAULT_LINT_MODE, LINT_MODES, CaseLinter
+from convert_ut_from_xlsx import (
+    COLUMN_CONVERTERS,
+    TestfStream,
+    build_case_linter,
+    build_common_prefix,
+    load_params,
+    read_text,
+    write_shard_output,
+)
+from param_reader import RowBuilder
+from utils import csv_cell_value, logger
+
+
+def csv_line_cells(line: str) -> List[Any]:
+    """CSV 行 -> 单元格取值（与 save_xlsx_content 写入的一致）。"""
+    try:
+        fields = next(csv.reader(io.StringIO(line)))
+    except Exception:
+        return [cell.strip() for cell in line.split(',')]
+    return [csv_cell_value(value) for value in fields]
+
+
+class PipelineSink:
+    """stage_1 的 row_sink：表头行建立 RowBuilder，其后每行立即渲染为 TEST_F。"""
+
+    def __init__(self, op_name: str, common_prefix: str, out_path: Path, use_cache: bool = True,
+                 linter: Optional[CaseLinter] = None):
+        self.stream = TestfStream(op_name, common_prefix, use_cache,
+                                  spool_path=out_path.with_name(out_path.name + ".partial"), linter=linter)
+        self.builder: Optional[RowBuilder] = None
+        self.lines: List[str] = []
+        self.final_lines: Optional[List[str]] = None
+        self.start = time.monotonic()
+
+    def line(self, line: str):
+        self.lines.append(line)
+        cells = csv_line_cells(line)
+        if self.builder is None:
+            self.builder = RowBuilder(cells, COLUMN_CONVERTERS)
+            return
+        row = self.builder.build(cells)
+        if row is not None and self.stream.add(row):
+            logger.info(f"📝 第{self.stream.rows}行参数已渲染为 TEST_F（+{time.monotonic() - self.start:.1f}s）")
+
+    def reset(self):
+        logger.info("🔁 模型调用重试，丢弃已渲染的用例")
+        self.lines = []
+        self.builder = None
+        self.stream.reset()
+
+    def complete(self, csv_lines: List[str]):
+        self.final_lines = list(csv_lines)
+
+    def rerender(self, rows: Iterable[Dict[str, Any]]):
+        self.stream.reset()
+        for row in rows:
+            self.stream.add(row)
+
+
+def main(argv: Optional[List[str]] = None) -> int:
+    argv = sys.argv[1:] if argv is None else list(argv)
+    if "--" in argv:
+        split = argv.index("--")
+        own_argv, stage1_argv = argv[:split], argv[split + 1:]
+    else:
+        own_argv, stage1_argv = argv, []
+    parser = argparse.ArgumentParser(description="Stage 1 → Stage 2 流水线：边生成参数边渲染 TEST_F",
+                                     usage="%(prog)s --ref REF --out OUT [--no-render-cache] [--lint MODE] [--shard N] "
+                                           "-- <stage_1.py 参数...>")
+    parser.add_argument("--ref", required=True, help="参考UT cpp文件路径")
+    parser.add_argument("--out", required=True, help="输出单测文件路径")
+    parser.add_argument("--no-render-cache", action="store_true", help="不使用行级渲染缓存")
+    parser.add_argument("--lint", choices=LINT_MODES, default=DEFAULT_LINT_MODE,
+                        help="用例静态检查模式（同 convert_ut_from_xlsx.py --lint）")
+    parser.add_argument("--shard", type=int, default=0, metavar="N",
+                        help="每片至多 N 个 TEST_F 分片输出（同 convert_ut_from_xlsx.py --shard）")
+    args = parser.parse_args(own_argv)
+    if args.shard < 0:
+        parser.error(f"--shard 必须为正整数: {args.shard}")
+    if len(stage1_argv) < 8:
+        parser.error("-- 之后需要 stage_1.py 的全部参数（算子名称 输出Excel Prompt文件 Few-shot文件 API_KEY BASE_URL MODEL_NAME 源码路径...）")
+
+    ref_path = Path(args.ref).resolve()
+    if not ref_path.exists():
+        print(f"❌ 参考UT不存在: {ref_path}")
+        return 1
+    op_name = stage1_argv[0]
+    xlsx_path = Path(stage1_argv[1]).resolve()
+    out_path = Path(args.out).resolve()
+    ref_content = read_text(ref_path)
+    try:
+        linter = build_case_linter(op_name, ref_content, args.lint)
+    except ValueError as e:
+        print(f"❌ 模板 ATTR_SCHEMA 无效: {e}")
+        return 1
+    sink = PipelineSink(op_name, build_common_prefix(ref_content, op_name), out_path,
+                        not args.no_render_cache, linter)
+
+    try:
+        stage_1.main(stage1_argv, row_sink=sink)
+    except SystemExit as e:
+        if e.code:
+            sink.stream.discard()
+            print("❌ 测试参数生成失败，未生成单测")
+            return int(e.code) if isinstance(e.code, int) else 1
+    generated = time.monotonic()
+
+    if sink.final_lines is None:
+        logger.info(f"参数文件未重新生成，按参数表渲染: {xlsx_path}")
+        try:
+            sink.rerender(load_params(xlsx_path))
+        except Exception as e:
+            sink.stream.discard()
+            print(f"❌ 读取xlsx失败: {e}")
+            return 1
+    elif sink.final_lines != sink.lines:
+        if sink.lines:
+            logger.warning("⚠️ 流式解析结果与最终参数不一致，按最终参数重新渲染")
+        builder = RowBuilder(csv_line_cells(sink.final_lines[0]), COLUMN_CONVERTERS)
+        sink.rerender(row for row in (builder.build(csv_line_cells(line)) for line in sink.final_lines[1:])
+                      if row is not None)
+
+    stream = sink.stream
+    if not stream.finish():
+        return 1
+    if args.shard:
+        ok = write_shard_output(stream.common_prefix, stream.cases(), out_path, args.shard)
+        stream.discard()
+        if not ok:
+            return 1
+        print(f"✅ 单测分片生成完成: {out_path.parent}/{out_path.stem}_shard_*.cpp（{stream.case_count} 个用例，"
+              f"参数生成结束后 {time.monotonic() - generated:.2f}s 写出）")
+        return 0
+    if not stream.commit(out_path):
+        return 1
+    print(f"✅ 单测生成完成: {out_path}（{stream.case_count} 个用例，参数生成结束后 "
+          f"{time.monotonic() - generated:.2f}s 写出）")
+    return 0
+
+
+if __name__ == "__main__":
+    raise SystemExit(main())
@@ -0,0 +1,185 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+tiling_func 并发压力测试渲染：
+- 复用 param_harness 的 Harness 与 test_params[] 数据表，与单测共享同一份 xlsx 行
+- 先单线程逐条执行得到基线（返回状态 + tiling key），再由 N 个线程交错重复执行全部用例，
+  每次结果都与基线比对，不一致即判定为数据竞争或全局状态污染
+- HcomTopoInfo 为进程级单例，各线程通过 Harness::group_suffix 给通信域字段追加 "_t<线程号>" 后缀，
+  保证并发注册/注销互不覆盖（与 sweep_harness 相同）；TopoInfoGuard 保证异常时也会注销
+- 线程数与轮数由环境变量 UTGEN_STRESS_THREADS / UTGEN_STRESS_ITERS 控制，可配合 -fsanitize=thread 使用
+"""
+
+from __future__ import annotations
+
+from typing import List
+
+from param_harness import (
+    ParamSuite,
+    TestParamRow,
+    render_harness,
+    render_param_row,
+    snake_from_camel,
+    unique_test_names,
+)
+
+
+def stress_file_stem(op_name: str) -> str:
+    return f"stress_{snake_from_camel(op_name)}_tiling"
+
+
+def render_stress_body(suite: ParamSuite, rows: List[TestParamRow]) -> str:
+    H = suite.harness
+    cap = suite.tiling_data_cap
+    out: List[str] = []
+    out.append("static TestParam test_params[] = {")
+    out.append(",\n".join(render_param_row(r) for r in rows))
+    out.append("};")
+    out.append("")
+    out.append("struct CaseOutcome {")
+    out.append("    int64_t status{-1};")
+    out.append("    uint64_t tiling_key{0};")
+    out.append("    std::string error;")
+    out.append("};")
+    out.append("")
+    out.append("inline size_t EnvOrDefault(const char* name, size_t fallback)")
+    out.append("{")
+    out.append("    const char* value = std::getenv(name);")
+    out.append("    if (value == nullptr || *value == '\\0') {")
+    out.append("        return fallback;")
+    out.append("    }")
+    out.append("    return std::max<size_t>(1, std::stoul(value));")
+    out.append("}")
+    out.append("")
+    out.append("// group_suffix 非空时追加到所有通信域字段，使各线程在 HcomTopoInfo 中注册不同的 group")
+    out.append("CaseOutcome ExecuteCase(const TestParam& test_param, const std::string& group_suffix)")
+    out.append("{")
+    out.append("    CaseOutcome outcome;")
+    out.append(f"    std::string op_type(\"{suite.op_name}\");")
+    out.append("    auto tiling_func = gert::OpImplRegistry::GetInstance().GetOpImpl(op_type.c_str())->tiling;")
+    out.append("    const auto& platform_cache = TilingPlatformCache::Get();")
+    out.append(f"    auto tilingData = gert::TilingData::CreateCap({cap});")
+    out.append(f"    auto workspace_holer = gert::ContinuousVector::Create<size_t>({cap});")
+    out.append("    auto workspace = reinterpret_cast<gert::ContinuousVector*>(workspace_holer.get());")
+    out.append(f"    {H} harness;")
+    out.append("    harness.group_suffix = group_suffix;")
+    out.append("    try {")
+    out.append("        harness.InitHolder(tilingData.get(), workspace, test_param.tiling_params_str_pair);")
+    out.append("        gert::TilingContext* tiling_context = harness.GetTilingContext();")
+    out.append("        harness.SetPlatformRes(platform_cache);")
+    out.append("        TopoInfoGuard topo_guard(harness);")
+    out.append("        outcome.status = static_cast<int64_t>(tiling_func(tiling_context));")
+    out.append("        outcome.tiling_key = tiling_context->GetTilingKey();")
+    out.append("    } catch (const std::exception& e) {")
+    out.append("        outcome.error = e.what();")
+    out.append("    }")
+    out.append("    return outcome;")
+    out.append("}")
+    out.append("")
+    out.append("inline bool SameOutcome(const CaseOutcome& a, const CaseOutcome& b)")
+    out.append("{")
+    out.append("    return a.status == b.status && a.tiling_key == b.tiling_key && a.error == b.error;")
+    out.append("}")
+    out.append("")
+    out.append("inline std::string DescribeOutcome(const CaseOutcome& outcome)")
+    out.append("{")
+    out.append("    if (!outcome.error.empty()) {")
+    out.append("        return \"exception: \" + outcome.error;")
+    out.append("    }")
+    out.append("    return \"status=\" + std::to_string(outcome.status) + \" tiling_key=\" + std::to_string(outcome.tiling_key);")
+    out.append("}")
+    out.append("")
+    out.append("struct StressMismatch {")
+    out.append("    size_t thread_id;")
+    out.append("    size_t iteration;")
+    out.append("    size_t case_index;")
+    out.append("    CaseOutcome outcome;")
+    out.append("};")
+    out.append("")
+    out.append(f"TEST({suite.op_name}TilingStress, concurrent_matches_baseline)")
+    out.append("{")
+    out.append(f"    ASSERT_NE(gert::OpImplRegistry::GetInstance().GetOpImpl(\"{suite.op_name}\"), nullptr);")
+    out.append("    const size_t case_num = sizeof(test_params) / sizeof(test_params[0]);")
+    out.append("    const size_t thread_num = EnvOrDefault(\"UTGEN_STRESS_THREADS\", std::max(2u, std::thread::hardware_concurrency()));")
+    out.append("    const size_t iterations = EnvOrDefault(\"UTGEN_STRESS_ITERS\", 20);")
+    out.append("    TilingPlatformCache::Get();")
+    out.append("")
+    out.append("    // 1. 单线程基线：使用原始通信域名")
+    out.append("    std::vector<CaseOutcome> baseline(case_num);")
+    out.append("    auto baseline_start = std::chrono::steady_clock::now();")
+    out.append("    for (size_t i = 0; i < case_num; ++i) {")
+    out.append("        baseline[i] = ExecuteCase(test_params[i], \"\");")
+    out.append("    }")
+    out.append("    double baseline_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - baseline_start).count();")
+    out.append("")
+    out.append("    // 2. 并发执行：各线程起始用例错开，所有线程就绪后同时开始，尽量制造交错")
+    out.append("    std::vector<std::vector<StressMismatch>> mismatches(thread_num);")
+    out.append("    std::atomic<size_t> ready{0};")
+    out.append("    std::atomic<bool> go{false};")
+    out.append("    std::vector<std::thread> workers;")
+    out.append("    for (size_t t = 0; t < thread_num; ++t) {")
+    out.append("        workers.emplace_back([&, t]() {")
+    out.append("            const std::string suffix = \"_t\" + std::to_string(t);")
+    out.append("            ready.fetch_add(1);")
+    out.append("            while (!go.load()) {")
+    out.append("                std::this_thread::yield();")
+    out.append("            }")
+    out.append("            for (size_t iter = 0; iter < iterations; ++iter) {")
+    out.append("                for (size_t n = 0; n < case_num; ++n) {")
+    out.append("                    size_t i = (n + t + iter) % case_num;")
+    out.append("                    CaseOutcome outcome = ExecuteCase(test_params[i], suffix);")
+    out.append("                    if (!SameOutcome(outcome, baseline[i])) {")
+    out.append("                        mismatches[t].push_back({t, iter, i, outcome});")
+    out.append("                    }")
+    out.append("                }")
+    out.append("            }")
+    out.append("        });")
+    out.append("    }")
+    out.append("    while (ready.load() < thread_num) {")
+    out.append("        std::this_thread::yield();")
+    out.append("    }")
+    out.append("    auto stress_start = std::chrono::steady_clock::now();")
+    out.append("    go.store(true);")
+    out.append("    for (auto& worker : workers) {")
+    out.append("        worker.join();")
+    out.append("    }")
+    out.append("    double stress_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - stress_start).count();")
+    out.append("")
+    out.append("    // 3. 汇总：吞吐对比与不一致明细（每个用例最多打印一次）")
+    out.append("    size_t total_calls = thread_num * iterations * case_num;")
+    out.append("    double baseline_rate = baseline_s > 0 ? case_num / baseline_s : 0.0;")
+    out.append("    double stress_rate = stress_s > 0 ? total_calls / stress_s : 0.0;")
+    out.append("    std::cout << \"[stress] \" << case_num << \" cases x \" << iterations << \" iters x \" << thread_num << \" threads, \"")
+    out.append("              << \"single-thread \" << baseline_rate << \" calls/s, concurrent \" << stress_rate << \" calls/s (x\"")
+    out.append("              << (baseline_rate > 0 ? stress_rate / baseline_rate : 0.0) << \")\" << std::endl;")
+    out.append("    size_t mismatch_num = 0;")
+    out.append("    std::vector<bool> reported(case_num, false);")
+    out.append("    for (const auto& per_thread : mismatches) {")
+    out.append("        mismatch_num += per_thread.size();")
+    out.append("        for (const auto& m : per_thread) {")
+    out.append("            if (reported[m.case_index]) {")
+    out.append("                continue;")
+    out.append("            }")
+    out.append("            reported[m.case_index] = true;")
+    out.append("            ADD_FAILURE() << test_params[m.case_index].test_name << \": thread \" << m.thread_id << \" iter \" << m.iteration")
+    out.append("                          << \" got \" << DescribeOutcome(m.outcome) << \", baseline \"")
+    out.append("                          << DescribeOutcome(baseline[m.case_index]);")
+    out.append("        }")
+    out.append("    }")
+    out.append("    EXPECT_EQ(mismatch_num, 0U) << \"concurrent tiling results differ from single-thread baseline\";")
+    out.append("}")
+    out.append(f"}} // namespace {suite.namespace}")
+    return "\n".join(out) + "\n"
+
+
+def render_stress_file(common_prefix: str, suite: ParamSuite, rows: List[TestParamRow]) -> str:
+    """生成并发压力 gtest 文件（链接 gtest_main 与 pthread）。"""
+    unique_test_names(rows)
+    return (
+        common_prefix
+        + "\n\n"
+        + "#include <algorithm>\n#include <atomic>\n#include <chrono>\n#include <thread>\n\n"
+        + render_harness(suite, rows)
+        + "\n"
+        + render_stress_body(suite, rows)
+    )
@@ -0,0 +1,11 @@
+// utgen 桩 SDK：ut_op_util.h，汇总单测常用的图类型与属性值
+#ifndef UTGEN_STUB_COMMON_UTILS_UT_OP_UTIL_H_
+#define UTGEN_STUB_COMMON_UTILS_UT_OP_UTIL_H_
+
+#include "graph/any_value.h"
+#include "graph/types.h"
+
+// 工程内单测直接使用 DT_FLOAT16 等未加限定的枚举
+using namespace ge;
+
+#endif  // UTGEN_STUB_COMMON_UTILS_UT_OP_UTIL_H_
@@ -0,0 +1,8 @@
+// utgen 桩 SDK：common_unittest.h，汇总 Faker 与平台信息
+#ifndef UTGEN_STUB_COMMON_UNITTEST_H_
+#define UTGEN_STUB_COMMON_UNITTEST_H_
+
+#include "kernel_run_context_facker.h"
+#include "platform/platform_infos_def.h"
+
+#endif  // UTGEN_STUB_COMMON_UNITTEST_H_
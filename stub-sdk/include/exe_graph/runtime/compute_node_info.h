@@ -0,0 +1,34 @@
+// utgen 桩 SDK：gert::CompileTimeTensorDesc（NodeInputTd/NodeOutputTd 设置的数据类型与格式）
+#ifndef UTGEN_STUB_EXE_GRAPH_RUNTIME_COMPUTE_NODE_INFO_H_
+#define UTGEN_STUB_EXE_GRAPH_RUNTIME_COMPUTE_NODE_INFO_H_
+
+#include "exe_graph/runtime/storage_format.h"
+#include "graph/types.h"
+
+namespace gert {
+class CompileTimeTensorDesc {
+ public:
+  CompileTimeTensorDesc() = default;
+  CompileTimeTensorDesc(ge::DataType data_type, ge::Format origin_format, ge::Format storage_format)
+      : data_type_(data_type), format_(origin_format, storage_format) {}
+
+  ge::DataType GetDataType() const {
+    return data_type_;
+  }
+  const StorageFormat &GetFormat() const {
+    return format_;
+  }
+  ge::Format GetOriginFormat() const {
+    return format_.GetOriginFormat();
+  }
+  ge::Format GetStorageFormat() const {
+    return format_.GetStorageFormat();
+  }
+
+ private:
+  ge::DataType data_type_ = ge::DT_UNDEFINED;
+  StorageFormat format_;
+};
+}  // namespace gert
+
+#endif  // UTGEN_STUB_EXE_GRAPH_RUNTIME_COMPUTE_NODE_INFO_H_
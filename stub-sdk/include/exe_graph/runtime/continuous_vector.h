@@ -0,0 +1,52 @@
+// utgen 桩 SDK：gert::ContinuousVector，头部之后紧跟 capacity 个元素（workspace 大小列表使用）
+#ifndef UTGEN_STUB_EXE_GRAPH_RUNTIME_CONTINUOUS_VECTOR_H_
+#define UTGEN_STUB_EXE_GRAPH_RUNTIME_CONTINUOUS_VECTOR_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+
+#include "graph/types.h"
+
+namespace gert {
+class ContinuousVector {
+ public:
+  template <typename T>
+  static std::unique_ptr<uint8_t[]> Create(size_t capacity) {
+    std::unique_ptr<uint8_t[]> holder(new (std::nothrow) uint8_t[sizeof(ContinuousVector) + sizeof(T) * capacity]);
+    if (holder != nullptr) {
+      new (holder.get()) ContinuousVector(capacity);
+    }
+    return holder;
+  }
+
+  size_t GetSize() const {
+    return size_;
+  }
+  ge::graphStatus SetSize(size_t size) {
+    if (size > capacity_) {
+      return ge::GRAPH_FAILED;
+    }
+    size_ = size;
+    return ge::GRAPH_SUCCESS;
+  }
+  size_t GetCapacity() const {
+    return capacity_;
+  }
+  const void *GetData() const {
+    return reinterpret_cast<const uint8_t *>(this) + sizeof(ContinuousVector);
+  }
+  void *MutableData() {
+    return reinterpret_cast<uint8_t *>(this) + sizeof(ContinuousVector);
+  }
+
+ private:
+  explicit ContinuousVector(size_t capacity) : capacity_(capacity), size_(0) {}
+
+  size_t capacity_;
+  size_t size_;
+};
+}  // namespace gert
+
+#endif  // UTGEN_STUB_EXE_GRAPH_RUNTIME_CONTINUOUS_VECTOR_H_
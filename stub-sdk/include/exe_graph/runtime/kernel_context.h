@@ -0,0 +1,75 @@
+// utgen 桩 SDK：gert::KernelContext。桩实现中所有上下文（Tiling/TilingParse）共用同一份数据，
+// 由 kernel_run_context_facker.h 的 Faker 填充，子类只增加访问接口
+#ifndef UTGEN_STUB_EXE_GRAPH_RUNTIME_KERNEL_CONTEXT_H_
+#define UTGEN_STUB_EXE_GRAPH_RUNTIME_KERNEL_CONTEXT_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "exe_graph/runtime/compute_node_info.h"
+#include "exe_graph/runtime/continuous_vector.h"
+#include "exe_graph/runtime/runtime_attrs.h"
+#include "exe_graph/runtime/storage_shape.h"
+#include "exe_graph/runtime/tiling_data.h"
+
+namespace gert {
+class KernelContext {
+ public:
+  size_t GetInputNum() const {
+    return inputs_.size();
+  }
+  size_t GetOutputNum() const {
+    return outputs_.size();
+  }
+  template <typename T>
+  const T *GetInputPointer(size_t index) const {
+    return index < inputs_.size() ? static_cast<const T *>(inputs_[index]) : nullptr;
+  }
+  template <typename T>
+  T *GetOutputPointer(size_t index) {
+    return index < outputs_.size() ? static_cast<T *>(outputs_[index]) : nullptr;
+  }
+  const char *GetNodeType() const {
+    return node_type_.c_str();
+  }
+  const char *GetNodeName() const {
+    return node_name_.c_str();
+  }
+
+ protected:
+  friend class KernelRunContextHolder;
+  friend class KernelRunContextFaker;
+  friend class TilingContextFaker;
+
+  // KernelRunContextFaker：Inputs/Outputs
+  std::vector<void *> inputs_;
+  std::vector<void *> outputs_;
+  // 节点信息：NodeIoNum/IrInstanceNum/NodeInputTd/NodeOutputTd/NodeAttrs/SetOpType
+  std::string node_type_;
+  std::string node_name_;
+  size_t node_input_num_ = 0;
+  size_t node_output_num_ = 0;
+  std::vector<uint32_t> ir_instance_num_;
+  std::vector<CompileTimeTensorDesc> input_desc_;
+  std::vector<CompileTimeTensorDesc> output_desc_;
+  RuntimeAttrs attrs_;
+  // TilingContextFaker：形状、编译信息、平台信息、TilingData、workspace
+  std::vector<StorageShape *> input_shapes_;
+  std::vector<StorageShape *> output_shapes_;
+  const void *compile_info_ = nullptr;
+  void *platform_info_ = nullptr;
+  TilingData *tiling_data_ = nullptr;
+  ContinuousVector *workspace_ = nullptr;
+  int32_t deterministic_ = 0;
+  // tiling 函数的输出
+  uint64_t tiling_key_ = 0;
+  uint32_t block_dim_ = 0;
+  bool need_atomic_ = false;
+  uint32_t schedule_mode_ = 0;
+  int32_t tiling_cond_ = 0;
+};
+}  // namespace gert
+
+#endif  // UTGEN_STUB_EXE_GRAPH_RUNTIME_KERNEL_CONTEXT_H_
@@ -0,0 +1,50 @@
+// utgen 桩 SDK：gert::RuntimeAttrs，按 NodeAttrs 的顺序取属性
+#ifndef UTGEN_STUB_EXE_GRAPH_RUNTIME_RUNTIME_ATTRS_H_
+#define UTGEN_STUB_EXE_GRAPH_RUNTIME_RUNTIME_ATTRS_H_
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "graph/any_value.h"
+
+namespace gert {
+class RuntimeAttrs {
+ public:
+  RuntimeAttrs() = default;
+  explicit RuntimeAttrs(std::vector<std::pair<std::string, ge::AnyValue>> attrs) : attrs_(std::move(attrs)) {}
+
+  size_t GetAttrNum() const {
+    return attrs_.size();
+  }
+  // 序号越界或类型与 CreateFrom<T> 不一致时返回 nullptr
+  template <typename T>
+  const T *GetAttrPointer(size_t index) const {
+    return index < attrs_.size() ? attrs_[index].second.Get<T>() : nullptr;
+  }
+  const int64_t *GetInt(size_t index) const {
+    return GetAttrPointer<int64_t>(index);
+  }
+  const bool *GetBool(size_t index) const {
+    return GetAttrPointer<bool>(index);
+  }
+  const float *GetFloat(size_t index) const {
+    return GetAttrPointer<float>(index);
+  }
+  const char *GetStr(size_t index) const {
+    const std::string *value = GetAttrPointer<std::string>(index);
+    return value == nullptr ? nullptr : value->c_str();
+  }
+  const std::vector<int64_t> *GetListInt(size_t index) const {
+    return GetAttrPointer<std::vector<int64_t>>(index);
+  }
+  const char *GetAttrName(size_t index) const {
+    return index < attrs_.size() ? attrs_[index].first.c_str() : nullptr;
+  }
+
+ private:
+  std::vector<std::pair<std::string, ge::AnyValue>> attrs_;
+};
+}  // namespace gert
+
+#endif  // UTGEN_STUB_EXE_GRAPH_RUNTIME_RUNTIME_ATTRS_H_
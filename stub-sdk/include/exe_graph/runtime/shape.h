@@ -0,0 +1,73 @@
+// utgen 桩 SDK：gert::Shape，最多 8 维（与 CANN 的 kMaxDimNum 一致）
+#ifndef UTGEN_STUB_EXE_GRAPH_RUNTIME_SHAPE_H_
+#define UTGEN_STUB_EXE_GRAPH_RUNTIME_SHAPE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+
+namespace gert {
+class Shape {
+ public:
+  static constexpr size_t kMaxDimNum = 8;
+
+  Shape() = default;
+  Shape(std::initializer_list<int64_t> dims) {
+    for (int64_t dim : dims) {
+      AppendDim(dim);
+    }
+  }
+
+  size_t GetDimNum() const {
+    return dim_num_;
+  }
+  void SetDimNum(size_t dim_num) {
+    dim_num_ = dim_num > kMaxDimNum ? kMaxDimNum : dim_num;
+  }
+  int64_t GetDim(size_t idx) const {
+    return idx < dim_num_ ? dims_[idx] : 0;
+  }
+  void SetDim(size_t idx, int64_t dim) {
+    if (idx < kMaxDimNum) {
+      dims_[idx] = dim;
+    }
+  }
+  // 超过 kMaxDimNum 的维度被丢弃（CANN 中为越界写）
+  Shape &AppendDim(int64_t dim) {
+    if (dim_num_ < kMaxDimNum) {
+      dims_[dim_num_++] = dim;
+    }
+    return *this;
+  }
+  bool IsScalar() const {
+    return dim_num_ == 0;
+  }
+  int64_t GetShapeSize() const {
+    int64_t size = 1;
+    for (size_t i = 0; i < dim_num_; ++i) {
+      size *= dims_[i];
+    }
+    return size;
+  }
+  bool operator==(const Shape &other) const {
+    if (dim_num_ != other.dim_num_) {
+      return false;
+    }
+    for (size_t i = 0; i < dim_num_; ++i) {
+      if (dims_[i] != other.dims_[i]) {
+        return false;
+      }
+    }
+    return true;
+  }
+  bool operator!=(const Shape &other) const {
+    return !(*this == other);
+  }
+
+ private:
+  size_t dim_num_ = 0;
+  int64_t dims_[kMaxDimNum] = {};
+};
+}  // namespace gert
+
+#endif  // UTGEN_STUB_EXE_GRAPH_RUNTIME_SHAPE_H_
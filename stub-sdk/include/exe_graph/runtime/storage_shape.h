@@ -0,0 +1,33 @@
+// utgen 桩 SDK：gert::StorageShape（原始形状 + 存储形状）
+#ifndef UTGEN_STUB_EXE_GRAPH_RUNTIME_STORAGE_SHAPE_H_
+#define UTGEN_STUB_EXE_GRAPH_RUNTIME_STORAGE_SHAPE_H_
+
+#include "exe_graph/runtime/shape.h"
+
+namespace gert {
+class StorageShape {
+ public:
+  StorageShape() = default;
+  StorageShape(std::initializer_list<int64_t> origin_shape, std::initializer_list<int64_t> storage_shape)
+      : origin_shape_(origin_shape), storage_shape_(storage_shape) {}
+
+  const Shape &GetOriginShape() const {
+    return origin_shape_;
+  }
+  const Shape &GetStorageShape() const {
+    return storage_shape_;
+  }
+  Shape &MutableOriginShape() {
+    return origin_shape_;
+  }
+  Shape &MutableStorageShape() {
+    return storage_shape_;
+  }
+
+ private:
+  Shape origin_shape_;
+  Shape storage_shape_;
+};
+}  // namespace gert
+
+#endif  // UTGEN_STUB_EXE_GRAPH_RUNTIME_STORAGE_SHAPE_H_
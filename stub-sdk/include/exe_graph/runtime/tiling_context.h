@@ -0,0 +1,143 @@
+// utgen 桩 SDK：gert::TilingContext，tiling 函数读取输入、写出 tiling key/block dim/TilingData/workspace
+#ifndef UTGEN_STUB_EXE_GRAPH_RUNTIME_TILING_CONTEXT_H_
+#define UTGEN_STUB_EXE_GRAPH_RUNTIME_TILING_CONTEXT_H_
+
+#include "exe_graph/runtime/kernel_context.h"
+#include "platform/platform_infos_def.h"
+
+namespace gert {
+class TilingContext : public KernelContext {
+ public:
+  size_t GetComputeNodeInputNum() const {
+    return node_input_num_;
+  }
+  size_t GetComputeNodeOutputNum() const {
+    return node_output_num_;
+  }
+
+  // 按实例序号取形状，未提供（nullptr）或越界时返回 nullptr
+  const StorageShape *GetInputShape(size_t index) const {
+    return index < input_shapes_.size() ? input_shapes_[index] : nullptr;
+  }
+  const StorageShape *GetOutputShape(size_t index) const {
+    return index < output_shapes_.size() ? output_shapes_[index] : nullptr;
+  }
+  // 按 IR 序号取可选输入：实例数为 0 时返回 nullptr
+  const StorageShape *GetOptionalInputShape(size_t ir_index) const {
+    size_t start = 0;
+    if (!InstanceStart(ir_index, start)) {
+      return nullptr;
+    }
+    return GetInputShape(start);
+  }
+  const StorageShape *GetDynamicInputShape(size_t ir_index, size_t relative_index) const {
+    size_t start = 0;
+    if (!InstanceStart(ir_index, start) ||
+        (!ir_instance_num_.empty() && relative_index >= ir_instance_num_[ir_index])) {
+      return nullptr;
+    }
+    return GetInputShape(start + relative_index);
+  }
+  const CompileTimeTensorDesc *GetInputDesc(size_t index) const {
+    return index < input_desc_.size() ? &input_desc_[index] : nullptr;
+  }
+  const CompileTimeTensorDesc *GetOptionalInputDesc(size_t ir_index) const {
+    size_t start = 0;
+    if (!InstanceStart(ir_index, start)) {
+      return nullptr;
+    }
+    return GetInputDesc(start);
+  }
+  const CompileTimeTensorDesc *GetOutputDesc(size_t index) const {
+    return index < output_desc_.size() ? &output_desc_[index] : nullptr;
+  }
+  const RuntimeAttrs *GetAttrs() const {
+    return &attrs_;
+  }
+
+  const void *GetCompileInfo() const {
+    return compile_info_;
+  }
+  template <typename T>
+  const T *GetCompileInfo() const {
+    return static_cast<const T *>(compile_info_);
+  }
+  fe::PlatFormInfos *GetPlatformInfo() const {
+    return static_cast<fe::PlatFormInfos *>(platform_info_);
+  }
+  int32_t GetDeterministic() const {
+    return deterministic_;
+  }
+
+  TilingData *GetRawTilingData() {
+    return tiling_data_;
+  }
+  template <typename T>
+  T *GetTilingData() {
+    return tiling_data_ == nullptr ? nullptr : static_cast<T *>(tiling_data_->GetData());
+  }
+  ge::graphStatus SetTilingKey(uint64_t tiling_key) {
+    tiling_key_ = tiling_key;
+    return ge::GRAPH_SUCCESS;
+  }
+  uint64_t GetTilingKey() const {
+    return tiling_key_;
+  }
+  ge::graphStatus SetBlockDim(uint32_t block_dim) {
+    block_dim_ = block_dim;
+    return ge::GRAPH_SUCCESS;
+  }
+  uint32_t GetBlockDim() const {
+    return block_dim_;
+  }
+  ge::graphStatus SetNeedAtomic(bool need_atomic) {
+    need_atomic_ = need_atomic;
+    return ge::GRAPH_SUCCESS;
+  }
+  bool NeedAtomic() const {
+    return need_atomic_;
+  }
+  ge::graphStatus SetScheduleMode(uint32_t schedule_mode) {
+    schedule_mode_ = schedule_mode;
+    return ge::GRAPH_SUCCESS;
+  }
+  uint32_t GetScheduleMode() const {
+    return schedule_mode_;
+  }
+  ge::graphStatus SetTilingCond(int32_t tiling_cond) {
+    tiling_cond_ = tiling_cond;
+    return ge::GRAPH_SUCCESS;
+  }
+  int32_t GetTilingCond() const {
+    return tiling_cond_;
+  }
+  // 申请 num 个 workspace，超过容量时返回 nullptr
+  size_t *GetWorkspaceSizes(size_t num) {
+    if (workspace_ == nullptr || workspace_->SetSize(num) != ge::GRAPH_SUCCESS) {
+      return nullptr;
+    }
+    return static_cast<size_t *>(workspace_->MutableData());
+  }
+  size_t GetWorkspaceNum() const {
+    return workspace_ == nullptr ? 0 : workspace_->GetSize();
+  }
+
+ private:
+  bool InstanceStart(size_t ir_index, size_t &start) const {
+    if (ir_instance_num_.empty()) {
+      start = ir_index;
+      return true;
+    }
+    if (ir_index >= ir_instance_num_.size() || ir_instance_num_[ir_index] == 0) {
+      return false;
+    }
+    start = 0;
+    for (size_t i = 0; i < ir_index; ++i) {
+      start += ir_instance_num_[i];
+    }
+    return true;
+  }
+};
+}  // namespace gert
+
+#endif  // UTGEN_STUB_EXE_GRAPH_RUNTIME_TILING_CONTEXT_H_
@@ -0,0 +1,64 @@
+// utgen 桩 SDK：gert::TilingData，头部之后紧跟 cap_size 字节的数据区（与 CANN 的 CreateCap 布局一致）
+#ifndef UTGEN_STUB_EXE_GRAPH_RUNTIME_TILING_DATA_H_
+#define UTGEN_STUB_EXE_GRAPH_RUNTIME_TILING_DATA_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+
+#include "graph/types.h"
+
+namespace gert {
+class TilingData {
+ public:
+  static std::unique_ptr<uint8_t[]> CreateCap(size_t cap_size) {
+    std::unique_ptr<uint8_t[]> holder(new (std::nothrow) uint8_t[sizeof(TilingData) + cap_size]);
+    if (holder != nullptr) {
+      new (holder.get()) TilingData(cap_size, holder.get() + sizeof(TilingData));
+    }
+    return holder;
+  }
+
+  size_t GetCapacity() const {
+    return capacity_;
+  }
+  size_t GetDataSize() const {
+    return data_size_;
+  }
+  void SetDataSize(size_t size) {
+    data_size_ = size;
+  }
+  void *GetData() {
+    return data_;
+  }
+  const void *GetData() const {
+    return data_;
+  }
+
+  template <typename T>
+  ge::graphStatus Append(const T &data) {
+    return Append(&data, 1);
+  }
+  template <typename T>
+  ge::graphStatus Append(const T *data, size_t num) {
+    size_t bytes = sizeof(T) * num;
+    if (data_size_ + bytes > capacity_) {
+      return ge::GRAPH_FAILED;
+    }
+    std::memcpy(static_cast<uint8_t *>(data_) + data_size_, data, bytes);
+    data_size_ += bytes;
+    return ge::GRAPH_SUCCESS;
+  }
+
+ private:
+  TilingData(size_t capacity, void *data) : capacity_(capacity), data_size_(0), data_(data) {}
+
+  size_t capacity_;
+  size_t data_size_;
+  void *data_;
+};
+}  // namespace gert
+
+#endif  // UTGEN_STUB_EXE_GRAPH_RUNTIME_TILING_DATA_H_
@@ -0,0 +1,25 @@
+// utgen 桩 SDK：gert::TilingParseContext。KernelRunContextFaker 的输入依次为 compile json 与平台信息，
+// 输出为 compile info
+#ifndef UTGEN_STUB_EXE_GRAPH_RUNTIME_TILING_PARSE_CONTEXT_H_
+#define UTGEN_STUB_EXE_GRAPH_RUNTIME_TILING_PARSE_CONTEXT_H_
+
+#include "exe_graph/runtime/kernel_context.h"
+#include "platform/platform_infos_def.h"
+
+namespace gert {
+class TilingParseContext : public KernelContext {
+ public:
+  const char *GetCompileJson() const {
+    return GetInputPointer<char>(0);
+  }
+  fe::PlatFormInfos *GetPlatformInfo() const {
+    return inputs_.size() > 1 ? static_cast<fe::PlatFormInfos *>(inputs_[1]) : nullptr;
+  }
+  template <typename T>
+  T *GetCompiledInfo() {
+    return GetOutputPointer<T>(0);
+  }
+};
+}  // namespace gert
+
+#endif  // UTGEN_STUB_EXE_GRAPH_RUNTIME_TILING_PARSE_CONTEXT_H_
@@ -0,0 +1,49 @@
+// utgen 桩 SDK：ge::HcomTopoInfo，按通信域名保存拓扑信息（进程内单例，线程安全）
+#ifndef UTGEN_STUB_EXTERNAL_HCOM_HCOM_TOPO_INFO_H_
+#define UTGEN_STUB_EXTERNAL_HCOM_HCOM_TOPO_INFO_H_
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "graph/types.h"
+
+namespace ge {
+static constexpr uint32_t COMM_MESH = 0b1U;
+static constexpr uint32_t COMM_SWITCH = 0b10U;
+static constexpr uint32_t COMM_RING = 0b100U;
+static constexpr uint32_t COMM_PAIRWISE = 0b1000U;
+
+class HcomTopoInfo {
+ public:
+  enum class TopoLevel { L0 = 0, L1, MAX };
+  struct TopoLevelDesc {
+    uint32_t comm_sets = 0;
+    uint32_t rank_size = 0;
+  };
+  using TopoDescs = TopoLevelDesc[static_cast<int32_t>(TopoLevel::MAX)];
+  struct TopoInfo {
+    int64_t rank_size = 0;
+    void *notify_handle = nullptr;
+    TopoDescs topo_level_descs;
+  };
+
+  static HcomTopoInfo &Instance();
+  bool TopoInfoHasBeenSet(const char *group);
+  bool TryGetGroupTopoInfo(const char *group, TopoInfo &info);
+  Status SetGroupTopoInfo(const char *group, const TopoInfo &info);
+  Status GetGroupRankSize(const char *group, int64_t &rank_size);
+  TopoDescs *GetGroupTopoDesc(const char *group);
+  Status GetGroupNotifyHandle(const char *group, void *&notify_handle);
+  void UnsetGroupTopoInfo(const char *group);
+
+ private:
+  HcomTopoInfo() = default;
+
+  std::unordered_map<std::string, TopoInfo> rank_info_;
+  std::mutex mutex_;
+};
+}  // namespace ge
+
+#endif  // UTGEN_STUB_EXTERNAL_HCOM_HCOM_TOPO_INFO_H_
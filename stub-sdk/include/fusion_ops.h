@@ -0,0 +1,7 @@
+// utgen 桩 SDK：算子原型声明（REG_OP）。tiling 单测不依赖原型，桩实现为空
+#ifndef UTGEN_STUB_FUSION_OPS_H_
+#define UTGEN_STUB_FUSION_OPS_H_
+
+#include "graph/types.h"
+
+#endif  // UTGEN_STUB_FUSION_OPS_H_
@@ -0,0 +1,48 @@
+// utgen 桩 SDK：ge::AnyValue 的最小替代，按类型保存任意属性值（NodeAttrs 使用）
+#ifndef UTGEN_STUB_GRAPH_ANY_VALUE_H_
+#define UTGEN_STUB_GRAPH_ANY_VALUE_H_
+
+#include <memory>
+
+namespace ge {
+class AnyValue {
+ public:
+  AnyValue() = default;
+
+  template <typename T>
+  static AnyValue CreateFrom(const T &value) {
+    AnyValue any;
+    any.value_ = std::make_shared<T>(value);
+    any.type_ = TypeOf<T>();
+    return any;
+  }
+
+  // 类型不一致时返回 nullptr（与 CANN 一致，由调用方判空）
+  template <typename T>
+  const T *Get() const {
+    return type_ == TypeOf<T>() ? static_cast<const T *>(value_.get()) : nullptr;
+  }
+
+  template <typename T>
+  bool SameType() const {
+    return type_ == TypeOf<T>();
+  }
+
+  bool IsEmpty() const {
+    return value_ == nullptr;
+  }
+
+ private:
+  using TypeId = const void *;
+  template <typename T>
+  static TypeId TypeOf() {
+    static const char id = 0;
+    return &id;
+  }
+
+  std::shared_ptr<void> value_;
+  TypeId type_ = nullptr;
+};
+}  // namespace ge
+
+#endif  // UTGEN_STUB_GRAPH_ANY_VALUE_H_
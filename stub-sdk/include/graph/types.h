@@ -0,0 +1,75 @@
+// utgen 桩 SDK：graph/types.h 的最小替代（数据类型、格式与返回码），取值与 CANN 保持一致
+#ifndef UTGEN_STUB_GRAPH_TYPES_H_
+#define UTGEN_STUB_GRAPH_TYPES_H_
+
+#include <cstdint>
+
+namespace ge {
+using graphStatus = uint32_t;
+using Status = uint32_t;
+const graphStatus GRAPH_SUCCESS = 0;
+const graphStatus GRAPH_FAILED = 0xFFFFFFFF;
+const graphStatus GRAPH_PARAM_INVALID = 50331649;
+const Status SUCCESS = 0;
+const Status FAILED = 0xFFFFFFFF;
+
+enum DataType {
+  DT_FLOAT = 0,
+  DT_FLOAT16 = 1,
+  DT_INT8 = 2,
+  DT_INT32 = 3,
+  DT_UINT8 = 4,
+  DT_INT16 = 6,
+  DT_UINT16 = 7,
+  DT_UINT32 = 8,
+  DT_INT64 = 9,
+  DT_UINT64 = 10,
+  DT_DOUBLE = 11,
+  DT_BOOL = 12,
+  DT_STRING = 13,
+  DT_DUAL_SUB_INT8 = 14,
+  DT_DUAL_SUB_UINT8 = 15,
+  DT_COMPLEX64 = 16,
+  DT_COMPLEX128 = 17,
+  DT_QINT8 = 18,
+  DT_QINT16 = 19,
+  DT_QINT32 = 20,
+  DT_QUINT8 = 21,
+  DT_QUINT16 = 22,
+  DT_RESOURCE = 23,
+  DT_STRING_REF = 24,
+  DT_DUAL = 25,
+  DT_VARIANT = 26,
+  DT_BF16 = 27,
+  DT_UNDEFINED = 28,
+  DT_INT4 = 29,
+  DT_UINT1 = 30,
+  DT_INT2 = 31,
+  DT_UINT2 = 32,
+  DT_COMPLEX32 = 33,
+  DT_HIFLOAT8 = 34,
+  DT_FLOAT8_E5M2 = 35,
+  DT_FLOAT8_E4M3FN = 36,
+  DT_FLOAT8_E8M0 = 37,
+  DT_FLOAT6_E3M2 = 38,
+  DT_FLOAT6_E2M3 = 39,
+  DT_FLOAT4_E2M1 = 40,
+  DT_FLOAT4_E1M2 = 41,
+  DT_MAX
+};
+
+enum Format {
+  FORMAT_NCHW = 0,
+  FORMAT_NHWC = 1,
+  FORMAT_ND = 2,
+  FORMAT_NC1HWC0 = 3,
+  FORMAT_FRACTAL_Z = 4,
+  FORMAT_FRACTAL_NZ = 29,
+  FORMAT_NCDHW = 30,
+  FORMAT_NDHWC = 27,
+  FORMAT_RESERVED = 40,
+  FORMAT_MAX = 0xff
+};
+}  // namespace ge
+
+#endif  // UTGEN_STUB_GRAPH_TYPES_H_
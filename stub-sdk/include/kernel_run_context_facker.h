@@ -0,0 +1,85 @@
+// utgen 桩 SDK：KernelRunContextFaker / TilingContextFaker，构造 tiling_parse 与 tiling 的上下文
+#ifndef UTGEN_STUB_KERNEL_RUN_CONTEXT_FACKER_H_
+#define UTGEN_STUB_KERNEL_RUN_CONTEXT_FACKER_H_
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "exe_graph/runtime/continuous_vector.h"
+#include "exe_graph/runtime/storage_format.h"
+#include "exe_graph/runtime/storage_shape.h"
+#include "exe_graph/runtime/tiling_context.h"
+#include "exe_graph/runtime/tiling_data.h"
+#include "exe_graph/runtime/tiling_parse_context.h"
+#include "graph/any_value.h"
+#include "graph/types.h"
+#include "platform/platform_infos_def.h"
+#include "register/op_impl_registry.h"
+
+namespace gert {
+class KernelRunContextHolder {
+ public:
+  KernelRunContextHolder() = default;
+
+  template <typename T>
+  T *GetContext() {
+    return static_cast<T *>(context_.get());
+  }
+  KernelContext *GetKernelContext() {
+    return context_.get();
+  }
+
+ private:
+  friend class KernelRunContextFaker;
+  friend class TilingContextFaker;
+
+  std::shared_ptr<KernelContext> context_;
+};
+
+class KernelRunContextFaker {
+ public:
+  KernelRunContextFaker &KernelIONum(size_t input_num, size_t output_num);
+  KernelRunContextFaker &NodeIoNum(size_t input_num, size_t output_num);
+  KernelRunContextFaker &IrInstanceNum(std::vector<uint32_t> instance_num);
+  KernelRunContextFaker &NodeInputTd(int32_t index, ge::DataType dt, ge::Format origin_format,
+                                     ge::Format storage_format);
+  KernelRunContextFaker &NodeOutputTd(int32_t index, ge::DataType dt, ge::Format origin_format,
+                                      ge::Format storage_format);
+  KernelRunContextFaker &NodeAttrs(std::vector<std::pair<std::string, ge::AnyValue>> attrs);
+  KernelRunContextFaker &Inputs(std::vector<void *> inputs);
+  KernelRunContextFaker &Outputs(std::vector<void *> outputs);
+  KernelRunContextHolder Build() const;
+
+ private:
+  TilingParseContext context_;
+};
+
+class TilingContextFaker {
+ public:
+  TilingContextFaker &NodeIoNum(size_t input_num, size_t output_num);
+  TilingContextFaker &IrInstanceNum(std::vector<uint32_t> instance_num);
+  TilingContextFaker &IrInstanceNum(std::vector<uint32_t> input_instance_num,
+                                    std::vector<uint32_t> output_instance_num);
+  TilingContextFaker &InputShapes(std::vector<StorageShape *> input_shapes);
+  TilingContextFaker &OutputShapes(std::vector<StorageShape *> output_shapes);
+  TilingContextFaker &NodeInputTd(int32_t index, ge::DataType dt, ge::Format origin_format,
+                                  ge::Format storage_format);
+  TilingContextFaker &NodeOutputTd(int32_t index, ge::DataType dt, ge::Format origin_format,
+                                   ge::Format storage_format);
+  TilingContextFaker &NodeAttrs(std::vector<std::pair<std::string, ge::AnyValue>> attrs);
+  TilingContextFaker &CompileInfo(const void *compile_info);
+  TilingContextFaker &PlatformInfo(void *platform_info);
+  TilingContextFaker &TilingData(void *tiling_data);
+  TilingContextFaker &Workspace(ContinuousVector *workspace);
+  TilingContextFaker &DeterministicInfo(int32_t *deterministic);
+  TilingContextFaker &SetOpType(const std::string &op_type);
+  KernelRunContextHolder Build() const;
+
+ private:
+  TilingContext context_;
+};
+}  // namespace gert
+
+#endif  // UTGEN_STUB_KERNEL_RUN_CONTEXT_FACKER_H_
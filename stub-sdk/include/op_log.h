@@ -0,0 +1,36 @@
+// utgen 桩 SDK：op_log.h 的最小替代，日志写到 stderr。
+// 级别沿用 ASCEND_GLOBAL_LOG_LEVEL（0 debug / 1 info / 2 warning / 3 error，默认 3）
+#ifndef UTGEN_STUB_OP_LOG_H_
+#define UTGEN_STUB_OP_LOG_H_
+
+#include <string>
+
+namespace utgen_stub {
+void OpLog(int level, const char *op_name, const char *fmt, ...) __attribute__((format(printf, 3, 4)));
+
+inline const char *OpLogName(const char *op_name) {
+  return op_name == nullptr ? "" : op_name;
+}
+inline const char *OpLogName(const std::string &op_name) {
+  return op_name.c_str();
+}
+// OP_LOGE(context, ...) 形式：取上下文的节点名
+template <typename T>
+inline const char *OpLogName(const T *context) {
+  return context == nullptr ? "" : context->GetNodeName();
+}
+}  // namespace utgen_stub
+
+#define OP_LOGD(op_name, ...) ::utgen_stub::OpLog(0, ::utgen_stub::OpLogName(op_name), __VA_ARGS__)
+#define OP_LOGI(op_name, ...) ::utgen_stub::OpLog(1, ::utgen_stub::OpLogName(op_name), __VA_ARGS__)
+#define OP_LOGW(op_name, ...) ::utgen_stub::OpLog(2, ::utgen_stub::OpLogName(op_name), __VA_ARGS__)
+#define OP_LOGE(op_name, ...) ::utgen_stub::OpLog(3, ::utgen_stub::OpLogName(op_name), __VA_ARGS__)
+#define OP_TILING_CHECK(cond, log_func, expr) \
+  do {                                        \
+    if (cond) {                               \
+      log_func;                               \
+      expr;                                   \
+    }                                         \
+  } while (0)
+
+#endif  // UTGEN_STUB_OP_LOG_H_
@@ -0,0 +1,9 @@
+// utgen 桩 SDK：op_tiling_util.h，汇总 tiling 上下文、注册表与日志
+#ifndef UTGEN_STUB_OP_TILING_OP_TILING_UTIL_H_
+#define UTGEN_STUB_OP_TILING_OP_TILING_UTIL_H_
+
+#include "exe_graph/runtime/tiling_context.h"
+#include "op_log.h"
+#include "register/op_impl_registry.h"
+
+#endif  // UTGEN_STUB_OP_TILING_OP_TILING_UTIL_H_
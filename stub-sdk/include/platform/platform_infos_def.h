@@ -0,0 +1,33 @@
+// utgen 桩 SDK：fe::PlatFormInfos，按 label/key 保存平台资源（SoCInfo、AICoreSpec 等）
+#ifndef UTGEN_STUB_PLATFORM_PLATFORM_INFOS_DEF_H_
+#define UTGEN_STUB_PLATFORM_PLATFORM_INFOS_DEF_H_
+
+#include <cstdint>
+#include <map>
+#include <string>
+
+namespace fe {
+enum class LocalMemType { L0_A = 0, L0_B = 1, L0_C = 2, L1 = 3, L2 = 4, UB = 5, HBM = 6, RESERVED };
+
+class PlatFormInfos {
+ public:
+  bool Init();
+  bool GetPlatformRes(const std::string &label, const std::string &key, std::string &val);
+  bool GetPlatformRes(const std::string &label, std::map<std::string, std::string> &res);
+  bool GetPlatformResWithLock(const std::string &label, const std::string &key, std::string &val);
+  void SetPlatformRes(const std::string &label, std::map<std::string, std::string> &res);
+  void SetPlatformResWithLock(const std::string &label, std::map<std::string, std::string> &res);
+  // AICore 取 SoCInfo.ai_core_cnt，VectorCore 取 SoCInfo.vector_core_cnt
+  void SetCoreNumByCoreType(const std::string &core_type);
+  uint32_t GetCoreNumByType(const std::string &core_type);
+  uint32_t GetCoreNum() const;
+  void SetCoreNum(uint32_t core_num);
+  void GetLocalMemSize(const LocalMemType &mem_type, uint64_t &size);
+
+ private:
+  std::map<std::string, std::map<std::string, std::string>> platform_res_;
+  uint32_t core_num_ = 0;
+};
+}  // namespace fe
+
+#endif  // UTGEN_STUB_PLATFORM_PLATFORM_INFOS_DEF_H_
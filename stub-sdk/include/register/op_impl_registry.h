@@ -0,0 +1,73 @@
+// utgen 桩 SDK：gert::OpImplRegistry。IMPL_OP_OPTILING 注册的算子返回真实 tiling；
+// 未注册的算子默认返回桩 tiling（见 src/op_impl_registry.cpp），UTGEN_STUB_STRICT=1 时返回 nullptr
+#ifndef UTGEN_STUB_REGISTER_OP_IMPL_REGISTRY_H_
+#define UTGEN_STUB_REGISTER_OP_IMPL_REGISTRY_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+
+#include "exe_graph/runtime/kernel_context.h"
+#include "exe_graph/runtime/tiling_context.h"
+#include "exe_graph/runtime/tiling_parse_context.h"
+
+namespace gert {
+using UINT32 = uint32_t;
+using KernelFunc = UINT32 (*)(KernelContext *context);
+using TilingKernelFunc = UINT32 (*)(TilingContext *context);
+using TilingParseFunc = UINT32 (*)(TilingParseContext *context);
+
+struct OpImplFunctions {
+  TilingKernelFunc tiling = nullptr;
+  KernelFunc tiling_parse = nullptr;
+  size_t max_tiling_data_size = 2048;
+  bool is_stub = false;  // 桩 tiling（算子未注册）
+};
+
+class OpImplRegistry {
+ public:
+  static OpImplRegistry &GetInstance();
+  OpImplFunctions &CreateOrGetOpImpl(const char *op_type);
+  const OpImplFunctions *GetOpImpl(const char *op_type) const;
+
+ private:
+  OpImplRegistry() = default;
+
+  std::map<std::string, OpImplFunctions> types_to_impl_;
+};
+
+class OpImplRegisterV2 {
+ public:
+  explicit OpImplRegisterV2(const char *op_type) : functions_(OpImplRegistry::GetInstance().CreateOrGetOpImpl(op_type)) {}
+
+  OpImplRegisterV2 &Tiling(TilingKernelFunc tiling_func, size_t max_tiling_data_size = 2048) {
+    functions_.tiling = tiling_func;
+    functions_.max_tiling_data_size = max_tiling_data_size;
+    return *this;
+  }
+  template <typename T>
+  OpImplRegisterV2 &TilingParse(KernelFunc tiling_parse_func) {
+    functions_.tiling_parse = tiling_parse_func;
+    return *this;
+  }
+  // 桩实现中 TilingParseContext 不含额外数据成员，可按 KernelFunc 调用
+  template <typename T>
+  OpImplRegisterV2 &TilingParse(TilingParseFunc tiling_parse_func) {
+    functions_.tiling_parse = reinterpret_cast<KernelFunc>(tiling_parse_func);
+    return *this;
+  }
+
+ private:
+  OpImplFunctions &functions_;
+};
+}  // namespace gert
+
+#define UTGEN_STUB_CONCAT_(a, b) a##b
+#define UTGEN_STUB_CONCAT(a, b) UTGEN_STUB_CONCAT_(a, b)
+#define IMPL_OP_OPTILING(op_type) \
+  static gert::OpImplRegisterV2 UTGEN_STUB_CONCAT(op_impl_register_optiling_##op_type, __COUNTER__) = \
+      gert::OpImplRegisterV2(#op_type)
+#define IMPL_OP(op_type) IMPL_OP_OPTILING(op_type)
+
+#endif  // UTGEN_STUB_REGISTER_OP_IMPL_REGISTRY_H_
@@ -0,0 +1,17 @@
+// utgen 桩 SDK：test_cube_util.h。GetPlatFormInfos 把 compile_info 中的 hardware_info 拆成
+// SoCInfo / AICoreSpec / AICoreintrinsicDtypeMap 三组平台资源
+#ifndef UTGEN_STUB_TEST_CUBE_UTIL_H_
+#define UTGEN_STUB_TEST_CUBE_UTIL_H_
+
+#include <map>
+#include <string>
+
+#include "platform/platform_infos_def.h"
+
+// 生成的单测直接使用 string/map（与工程内单测的公共头一致）
+using namespace std;
+
+void GetPlatFormInfos(const char *compile_info_str, std::map<std::string, std::string> &soc_infos,
+                      std::map<std::string, std::string> &aicore_spec, std::map<std::string, std::string> &intrinsics);
+
+#endif  // UTGEN_STUB_TEST_CUBE_UTIL_H_
@@ -0,0 +1,70 @@
+// utgen 桩 SDK：ge::HcomTopoInfo
+#include "external/hcom/hcom_topo_info.h"
+
+namespace ge {
+HcomTopoInfo &HcomTopoInfo::Instance() {
+  static HcomTopoInfo instance;
+  return instance;
+}
+
+bool HcomTopoInfo::TopoInfoHasBeenSet(const char *group) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return group != nullptr && rank_info_.count(group) > 0;
+}
+
+bool HcomTopoInfo::TryGetGroupTopoInfo(const char *group, TopoInfo &info) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (group == nullptr) {
+    return false;
+  }
+  auto found = rank_info_.find(group);
+  if (found == rank_info_.end()) {
+    return false;
+  }
+  info = found->second;
+  return true;
+}
+
+Status HcomTopoInfo::SetGroupTopoInfo(const char *group, const TopoInfo &info) {
+  if (group == nullptr) {
+    return FAILED;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  rank_info_[group] = info;
+  return SUCCESS;
+}
+
+Status HcomTopoInfo::GetGroupRankSize(const char *group, int64_t &rank_size) {
+  TopoInfo info;
+  if (!TryGetGroupTopoInfo(group, info)) {
+    return FAILED;
+  }
+  rank_size = info.rank_size;
+  return SUCCESS;
+}
+
+HcomTopoInfo::TopoDescs *HcomTopoInfo::GetGroupTopoDesc(const char *group) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (group == nullptr) {
+    return nullptr;
+  }
+  auto found = rank_info_.find(group);
+  return found == rank_info_.end() ? nullptr : &found->second.topo_level_descs;
+}
+
+Status HcomTopoInfo::GetGroupNotifyHandle(const char *group, void *&notify_handle) {
+  TopoInfo info;
+  if (!TryGetGroupTopoInfo(group, info)) {
+    return FAILED;
+  }
+  notify_handle = info.notify_handle;
+  return SUCCESS;
+}
+
+void HcomTopoInfo::UnsetGroupTopoInfo(const char *group) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (group != nullptr) {
+    rank_info_.erase(group);
+  }
+}
+}  // namespace ge
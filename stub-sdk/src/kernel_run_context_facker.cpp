@@ -0,0 +1,160 @@
+// utgen 桩 SDK：Faker 把链式调用收集到的输入写入上下文，Build 时复制一份交给 holder
+#include "kernel_run_context_facker.h"
+
+namespace gert {
+namespace {
+void SetTd(std::vector<CompileTimeTensorDesc> &descs, int32_t index, ge::DataType dt, ge::Format origin_format,
+           ge::Format storage_format) {
+  if (index < 0) {
+    return;
+  }
+  if (descs.size() <= static_cast<size_t>(index)) {
+    descs.resize(static_cast<size_t>(index) + 1);
+  }
+  descs[static_cast<size_t>(index)] = CompileTimeTensorDesc(dt, origin_format, storage_format);
+}
+}  // namespace
+
+KernelRunContextFaker &KernelRunContextFaker::KernelIONum(size_t input_num, size_t output_num) {
+  context_.inputs_.resize(input_num, nullptr);
+  context_.outputs_.resize(output_num, nullptr);
+  return *this;
+}
+
+KernelRunContextFaker &KernelRunContextFaker::NodeIoNum(size_t input_num, size_t output_num) {
+  context_.node_input_num_ = input_num;
+  context_.node_output_num_ = output_num;
+  return *this;
+}
+
+KernelRunContextFaker &KernelRunContextFaker::IrInstanceNum(std::vector<uint32_t> instance_num) {
+  context_.ir_instance_num_ = std::move(instance_num);
+  return *this;
+}
+
+KernelRunContextFaker &KernelRunContextFaker::NodeInputTd(int32_t index, ge::DataType dt, ge::Format origin_format,
+                                                          ge::Format storage_format) {
+  SetTd(context_.input_desc_, index, dt, origin_format, storage_format);
+  return *this;
+}
+
+KernelRunContextFaker &KernelRunContextFaker::NodeOutputTd(int32_t index, ge::DataType dt, ge::Format origin_format,
+                                                           ge::Format storage_format) {
+  SetTd(context_.output_desc_, index, dt, origin_format, storage_format);
+  return *this;
+}
+
+KernelRunContextFaker &KernelRunContextFaker::NodeAttrs(std::vector<std::pair<std::string, ge::AnyValue>> attrs) {
+  context_.attrs_ = RuntimeAttrs(std::move(attrs));
+  return *this;
+}
+
+// KernelIONum 之后按位置覆盖，多出的部分追加
+KernelRunContextFaker &KernelRunContextFaker::Inputs(std::vector<void *> inputs) {
+  if (context_.inputs_.size() < inputs.size()) {
+    context_.inputs_.resize(inputs.size(), nullptr);
+  }
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    context_.inputs_[i] = inputs[i];
+  }
+  return *this;
+}
+
+KernelRunContextFaker &KernelRunContextFaker::Outputs(std::vector<void *> outputs) {
+  if (context_.outputs_.size() < outputs.size()) {
+    context_.outputs_.resize(outputs.size(), nullptr);
+  }
+  for (size_t i = 0; i < outputs.size(); ++i) {
+    context_.outputs_[i] = outputs[i];
+  }
+  return *this;
+}
+
+KernelRunContextHolder KernelRunContextFaker::Build() const {
+  KernelRunContextHolder holder;
+  holder.context_ = std::make_shared<TilingParseContext>(context_);
+  return holder;
+}
+
+TilingContextFaker &TilingContextFaker::NodeIoNum(size_t input_num, size_t output_num) {
+  context_.node_input_num_ = input_num;
+  context_.node_output_num_ = output_num;
+  return *this;
+}
+
+TilingContextFaker &TilingContextFaker::IrInstanceNum(std::vector<uint32_t> instance_num) {
+  context_.ir_instance_num_ = std::move(instance_num);
+  return *this;
+}
+
+TilingContextFaker &TilingContextFaker::IrInstanceNum(std::vector<uint32_t> input_instance_num,
+                                                      std::vector<uint32_t> output_instance_num) {
+  (void)output_instance_num;
+  context_.ir_instance_num_ = std::move(input_instance_num);
+  return *this;
+}
+
+TilingContextFaker &TilingContextFaker::InputShapes(std::vector<StorageShape *> input_shapes) {
+  context_.input_shapes_ = std::move(input_shapes);
+  return *this;
+}
+
+TilingContextFaker &TilingContextFaker::OutputShapes(std::vector<StorageShape *> output_shapes) {
+  context_.output_shapes_ = std::move(output_shapes);
+  return *this;
+}
+
+TilingContextFaker &TilingContextFaker::NodeInputTd(int32_t index, ge::DataType dt, ge::Format origin_format,
+                                                    ge::Format storage_format) {
+  SetTd(context_.input_desc_, index, dt, origin_format, storage_format);
+  return *this;
+}
+
+TilingContextFaker &TilingContextFaker::NodeOutputTd(int32_t index, ge::DataType dt, ge::Format origin_format,
+                                                     ge::Format storage_format) {
+  SetTd(context_.output_desc_, index, dt, origin_format, storage_format);
+  return *this;
+}
+
+TilingContextFaker &TilingContextFaker::NodeAttrs(std::vector<std::pair<std::string, ge::AnyValue>> attrs) {
+  context_.attrs_ = RuntimeAttrs(std::move(attrs));
+  return *this;
+}
+
+TilingContextFaker &TilingContextFaker::CompileInfo(const void *compile_info) {
+  context_.compile_info_ = compile_info;
+  return *this;
+}
+
+TilingContextFaker &TilingContextFaker::PlatformInfo(void *platform_info) {
+  context_.platform_info_ = platform_info;
+  return *this;
+}
+
+TilingContextFaker &TilingContextFaker::TilingData(void *tiling_data) {
+  context_.tiling_data_ = static_cast<gert::TilingData *>(tiling_data);
+  return *this;
+}
+
+TilingContextFaker &TilingContextFaker::Workspace(ContinuousVector *workspace) {
+  context_.workspace_ = workspace;
+  return *this;
+}
+
+TilingContextFaker &TilingContextFaker::DeterministicInfo(int32_t *deterministic) {
+  context_.deterministic_ = deterministic == nullptr ? 0 : *deterministic;
+  return *this;
+}
+
+TilingContextFaker &TilingContextFaker::SetOpType(const std::string &op_type) {
+  context_.node_type_ = op_type;
+  context_.node_name_ = op_type;
+  return *this;
+}
+
+KernelRunContextHolder TilingContextFaker::Build() const {
+  KernelRunContextHolder holder;
+  holder.context_ = std::make_shared<TilingContext>(context_);
+  return holder;
+}
+}  // namespace gert
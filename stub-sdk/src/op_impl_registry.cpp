@@ -0,0 +1,107 @@
+// utgen 桩 SDK：算子实现注册表与桩 tiling。
+// 桩 tiling 只校验上下文是否完整并写出确定的输出，用于确认生成的单测能编译、链接、跑通；
+// tiling key 取 UTGEN_STUB_TILING_KEY（默认 0），与真实 tiling key 的断言预期会失败
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <set>
+
+#include "op_log.h"
+#include "register/op_impl_registry.h"
+
+namespace gert {
+namespace {
+constexpr size_t kStubWorkspaceSize = 16 * 1024 * 1024;
+
+bool EnvFlag(const char *name) {
+  const char *value = std::getenv(name);
+  return value != nullptr && value[0] != '\0' && value[0] != '0';
+}
+
+UINT32 StubTiling(TilingContext *context) {
+  if (context == nullptr) {
+    return ge::GRAPH_FAILED;
+  }
+  const char *op_type = context->GetNodeType();
+  if (context->GetPlatformInfo() == nullptr) {
+    OP_LOGE(op_type, "[stub] platform info is null");
+    return ge::GRAPH_FAILED;
+  }
+  TilingData *tiling_data = context->GetRawTilingData();
+  if (tiling_data == nullptr || tiling_data->GetCapacity() == 0) {
+    OP_LOGE(op_type, "[stub] tiling data is null");
+    return ge::GRAPH_FAILED;
+  }
+  size_t *workspaces = context->GetWorkspaceSizes(1);
+  if (workspaces == nullptr) {
+    OP_LOGE(op_type, "[stub] workspace is null");
+    return ge::GRAPH_FAILED;
+  }
+  workspaces[0] = kStubWorkspaceSize;
+
+  // TilingData 依次写入各输入的原始形状，使不同用例的输出可区分
+  tiling_data->SetDataSize(0);
+  for (size_t i = 0; i < context->GetComputeNodeInputNum(); ++i) {
+    const StorageShape *shape = context->GetInputShape(i);
+    if (shape == nullptr) {
+      continue;
+    }
+    const Shape &origin = shape->GetOriginShape();
+    for (size_t dim = 0; dim < origin.GetDimNum(); ++dim) {
+      if (tiling_data->Append(static_cast<int64_t>(origin.GetDim(dim))) != ge::GRAPH_SUCCESS) {
+        break;
+      }
+    }
+  }
+  uint32_t core_num = context->GetPlatformInfo()->GetCoreNum();
+  context->SetBlockDim(core_num == 0 ? 1 : core_num);
+  const char *tiling_key = std::getenv("UTGEN_STUB_TILING_KEY");
+  context->SetTilingKey(tiling_key == nullptr ? 0 : std::strtoull(tiling_key, nullptr, 10));
+  return ge::GRAPH_SUCCESS;
+}
+
+UINT32 StubTilingParse(KernelContext *context) {
+  (void)context;
+  return ge::GRAPH_SUCCESS;
+}
+
+OpImplFunctions MakeStubImpl() {
+  OpImplFunctions functions;
+  functions.tiling = StubTiling;
+  functions.tiling_parse = StubTilingParse;
+  functions.is_stub = true;
+  return functions;
+}
+}  // namespace
+
+OpImplRegistry &OpImplRegistry::GetInstance() {
+  static OpImplRegistry instance;
+  return instance;
+}
+
+OpImplFunctions &OpImplRegistry::CreateOrGetOpImpl(const char *op_type) {
+  return types_to_impl_[op_type == nullptr ? "" : op_type];
+}
+
+const OpImplFunctions *OpImplRegistry::GetOpImpl(const char *op_type) const {
+  if (op_type == nullptr) {
+    return nullptr;
+  }
+  auto found = types_to_impl_.find(op_type);
+  if (found != types_to_impl_.end() && found->second.tiling != nullptr) {
+    return &found->second;
+  }
+  if (EnvFlag("UTGEN_STUB_STRICT")) {
+    return nullptr;
+  }
+  static const OpImplFunctions stub_impl = MakeStubImpl();
+  static std::mutex mutex;
+  static std::set<std::string> reported;
+  std::lock_guard<std::mutex> lock(mutex);
+  if (reported.insert(op_type).second) {
+    std::fprintf(stderr, "[utgen-stub] %s 未注册 tiling，使用桩 tiling（tiling key 恒为 %s）\n", op_type,
+                 std::getenv("UTGEN_STUB_TILING_KEY") == nullptr ? "0" : std::getenv("UTGEN_STUB_TILING_KEY"));
+  }
+  return &stub_impl;
+}
+}  // namespace gert
@@ -0,0 +1,31 @@
+// utgen 桩 SDK：OP_LOG* 的输出
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+
+#include "op_log.h"
+
+namespace utgen_stub {
+namespace {
+int LogLevel() {
+  static const int level = [] {
+    const char *value = std::getenv("ASCEND_GLOBAL_LOG_LEVEL");
+    return value == nullptr ? 3 : std::atoi(value);
+  }();
+  return level;
+}
+}  // namespace
+
+void OpLog(int level, const char *op_name, const char *fmt, ...) {
+  if (level < LogLevel()) {
+    return;
+  }
+  static const char kLevels[] = {'D', 'I', 'W', 'E'};
+  std::fprintf(stderr, "[%c] %s ", kLevels[level < 0 ? 0 : (level > 3 ? 3 : level)], op_name);
+  va_list args;
+  va_start(args, fmt);
+  std::vfprintf(stderr, fmt, args);
+  va_end(args);
+  std::fputc('\n', stderr);
+}
+}  // namespace utgen_stub
@@ -0,0 +1,84 @@
+// utgen 桩 SDK：fe::PlatFormInfos
+#include <cstdlib>
+
+#include "platform/platform_infos_def.h"
+
+namespace fe {
+namespace {
+uint32_t ToUint(const std::string &value) {
+  return static_cast<uint32_t>(std::strtoul(value.c_str(), nullptr, 10));
+}
+}  // namespace
+
+bool PlatFormInfos::Init() {
+  platform_res_.clear();
+  core_num_ = 0;
+  return true;
+}
+
+bool PlatFormInfos::GetPlatformRes(const std::string &label, const std::string &key, std::string &val) {
+  auto res = platform_res_.find(label);
+  if (res == platform_res_.end()) {
+    return false;
+  }
+  auto item = res->second.find(key);
+  if (item == res->second.end()) {
+    return false;
+  }
+  val = item->second;
+  return true;
+}
+
+bool PlatFormInfos::GetPlatformRes(const std::string &label, std::map<std::string, std::string> &res) {
+  auto found = platform_res_.find(label);
+  if (found == platform_res_.end()) {
+    return false;
+  }
+  res = found->second;
+  return true;
+}
+
+bool PlatFormInfos::GetPlatformResWithLock(const std::string &label, const std::string &key, std::string &val) {
+  return GetPlatformRes(label, key, val);
+}
+
+void PlatFormInfos::SetPlatformRes(const std::string &label, std::map<std::string, std::string> &res) {
+  platform_res_[label] = res;
+}
+
+void PlatFormInfos::SetPlatformResWithLock(const std::string &label, std::map<std::string, std::string> &res) {
+  SetPlatformRes(label, res);
+}
+
+void PlatFormInfos::SetCoreNumByCoreType(const std::string &core_type) {
+  core_num_ = GetCoreNumByType(core_type);
+}
+
+uint32_t PlatFormInfos::GetCoreNumByType(const std::string &core_type) {
+  std::string value;
+  const char *key = core_type == "VectorCore" ? "vector_core_cnt" : "ai_core_cnt";
+  return GetPlatformRes("SoCInfo", key, value) ? ToUint(value) : 0;
+}
+
+uint32_t PlatFormInfos::GetCoreNum() const {
+  return core_num_;
+}
+
+void PlatFormInfos::SetCoreNum(uint32_t core_num) {
+  core_num_ = core_num;
+}
+
+void PlatFormInfos::GetLocalMemSize(const LocalMemType &mem_type, uint64_t &size) {
+  static const std::map<LocalMemType, std::pair<const char *, const char *>> kKeys = {
+      {LocalMemType::L0_A, {"AICoreSpec", "l0_a_size"}}, {LocalMemType::L0_B, {"AICoreSpec", "l0_b_size"}},
+      {LocalMemType::L0_C, {"AICoreSpec", "l0_c_size"}}, {LocalMemType::L1, {"AICoreSpec", "l1_size"}},
+      {LocalMemType::L2, {"SoCInfo", "l2_size"}},        {LocalMemType::UB, {"AICoreSpec", "ub_size"}},
+  };
+  size = 0;
+  auto key = kKeys.find(mem_type);
+  std::string value;
+  if (key != kKeys.end() && GetPlatformRes(key->second.first, key->second.second, value)) {
+    size = std::strtoull(value.c_str(), nullptr, 10);
+  }
+}
+}  // namespace fe
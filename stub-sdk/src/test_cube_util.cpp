@@ -0,0 +1,107 @@
+// utgen 桩 SDK：GetPlatFormInfos，只解析 hardware_info 一层的 "KEY": 值
+#include <cctype>
+#include <cstring>
+
+#include "test_cube_util.h"
+
+namespace {
+// hardware_info 键 -> (平台资源组, 键)，未列出的键转小写写入 AICoreSpec
+const std::map<std::string, std::pair<int, std::string>> &KnownKeys() {
+  static const std::map<std::string, std::pair<int, std::string>> keys = {
+      {"CORE_NUM", {0, "ai_core_cnt"}},      {"L2_SIZE", {0, "l2_size"}},     {"UB_SIZE", {1, "ub_size"}},
+      {"L1_SIZE", {1, "l1_size"}},           {"L0A_SIZE", {1, "l0_a_size"}},  {"L0B_SIZE", {1, "l0_b_size"}},
+      {"L0C_SIZE", {1, "l0_c_size"}},        {"BT_SIZE", {1, "bt_size"}},     {"soc_version", {0, "SoCVersion"}},
+      {"short_soc_version", {0, "Short_SoC_version"}},
+  };
+  return keys;
+}
+
+void SkipSpaces(const char *&p) {
+  while (*p != '\0' && std::isspace(static_cast<unsigned char>(*p))) {
+    ++p;
+  }
+}
+
+bool ReadString(const char *&p, std::string &out) {
+  if (*p != '"') {
+    return false;
+  }
+  const char *end = std::strchr(p + 1, '"');
+  if (end == nullptr) {
+    return false;
+  }
+  out.assign(p + 1, end);
+  p = end + 1;
+  return true;
+}
+
+// 读取标量值（字符串、数字、true/false），遇到对象或数组返回 false
+bool ReadScalar(const char *&p, std::string &out) {
+  if (*p == '"') {
+    return ReadString(p, out);
+  }
+  const char *start = p;
+  while (*p != '\0' && *p != ',' && *p != '}' && !std::isspace(static_cast<unsigned char>(*p))) {
+    if (*p == '{' || *p == '[') {
+      return false;
+    }
+    ++p;
+  }
+  out.assign(start, p);
+  return !out.empty();
+}
+}  // namespace
+
+void GetPlatFormInfos(const char *compile_info_str, std::map<std::string, std::string> &soc_infos,
+                      std::map<std::string, std::string> &aicore_spec, std::map<std::string, std::string> &intrinsics) {
+  if (compile_info_str == nullptr) {
+    return;
+  }
+  const char *p = std::strstr(compile_info_str, "\"hardware_info\"");
+  if (p == nullptr || (p = std::strchr(p, '{')) == nullptr) {
+    return;
+  }
+  ++p;
+  std::string key;
+  std::string value;
+  while (true) {
+    SkipSpaces(p);
+    if (*p == ',') {
+      ++p;
+      continue;
+    }
+    if (*p != '"' || !ReadString(p, key)) {
+      break;
+    }
+    SkipSpaces(p);
+    if (*p != ':') {
+      break;
+    }
+    ++p;
+    SkipSpaces(p);
+    if (!ReadScalar(p, value)) {
+      break;
+    }
+    if (key.compare(0, 10, "Intrinsic_") == 0) {
+      if (value == "true") {
+        intrinsics[key] = "float16";
+      }
+      continue;
+    }
+    auto known = KnownKeys().find(key);
+    if (known != KnownKeys().end()) {
+      (known->second.first == 0 ? soc_infos : aicore_spec)[known->second.second] = value;
+      if (key == "CORE_NUM") {
+        soc_infos["cube_core_cnt"] = value;
+        soc_infos["vector_core_cnt"] = value;
+      }
+      continue;
+    }
+    std::string lower;
+    for (char c : key) {
+      lower.push_back(static_cast<char>(std::tolower(static_cast<unsigned char>(c))));
+    }
+    aicore_spec[lower] = value;
+  }
+  soc_infos["core_type_list"] = "AICore,VectorCore";
+}
@@ -0,0 +1,501 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+tiling 参数网格扫描（sweep）渲染：
+- 网格描述为 JSON，轴名即 PARAM_SUITE 中的字段名，网格为各轴取值的笛卡尔积
+- 生成的 sweep_<op>_tiling.cpp 在进程内用线程池分片遍历网格，每个点调用 tiling_func
+- 输出 JSON：tiling key 直方图（含每个 key 在各轴取值上的分布）、返回状态分布与失败样本
+- 模板提供 TILING_ROLES 时，每个 tiling key 额外汇总预测耗时与最低效率点（模型见 tiling_score.py）
+
+网格 JSON 结构：
+  {
+    "axes":   {"字段名": [取值, ...], ...},           # 必填，按声明顺序编码
+    "derive": {"字段名": "C++ 表达式", ...}          # 可选，如 "expand_x_out_dim0": "bs * ep_world_size"
+  }
+derive 在网格取值写入之后按声明顺序计算，目标与引用的字段限于 int64_t、bool 与 ge::DataType；
+表达式中可直接写 dtype 枚举名与 true/false，如 "dtype_out": "dtype_in"、"has_scales": "quant_mode != 0"。
+"""
+
+from __future__ import annotations
+
+import json
+from dataclasses import dataclass, field
+from pathlib import Path
+from typing import List, Optional, Tuple
+
+from param_harness import (
+    IDENT_PATTERN,
+    KNOWN_DTYPES,
+    ParamSuite,
+    cpp_string_literal,
+    format_field_value,
+    render_harness,
+    snake_from_camel,
+)
+from tiling_score import ScoreSpec, perf_model_includes, render_perf_model
+
+
+# derive 可写入、可引用的字段类型
+DERIVE_CTYPES = ("int64_t", "bool", "ge::DataType")
+DERIVE_CONSTANTS = frozenset(["true", "false"])
+
+
+@dataclass
+class SweepGrid:
+    axes: List[Tuple[str, List[str]]]
+    derive: List[Tuple[str, str]] = field(default_factory=list)
+
+    @property
+    def total(self) -> int:
+        n = 1
+        for _name, values in self.axes:
+            n *= len(values)
+        return n
+
+
+def sweep_file_stem(op_name: str) -> str:
+    return f"sweep_{snake_from_camel(op_name)}_tiling"
+
+
+def load_sweep_grid(path: Path, suite: ParamSuite) -> SweepGrid:
+    """读取并校验网格 JSON，取值统一格式化为 tiling_params_str_handlers 可解析的字符串。"""
+    raw = json.loads(Path(path).read_text(encoding="utf-8"))
+    fmap = suite.field_map()
+
+    axes: List[Tuple[str, List[str]]] = []
+    for name, values in (raw.get("axes") or {}).items():
+        pf = fmap.get(name)
+        if pf is None:
+            raise ValueError(f"网格轴 {name} 不是 PARAM_SUITE 字段")
+        if not isinstance(values, list) or not values:
+            raise ValueError(f"网格轴 {name} 需要非空取值列表")
+        formatted = []
+        for v in values:
+            s = format_field_value(pf, v)
+            if s is None:
+                raise ValueError(f"网格轴 {name} 含空值")
+            formatted.append(s)
+        axes.append((name, formatted))
+    if not axes:
+        raise ValueError("网格至少需要一个轴")
+
+    derive: List[Tuple[str, str]] = []
+    for name, expr in (raw.get("derive") or {}).items():
+        pf = fmap.get(name)
+        if pf is None or pf.ctype not in DERIVE_CTYPES:
+            raise ValueError(f"derive 目标 {name} 必须是 {'/'.join(DERIVE_CTYPES)} 字段")
+        for ident in IDENT_PATTERN.findall(str(expr)):
+            if ident in KNOWN_DTYPES or ident in DERIVE_CONSTANTS:
+                continue
+            if ident not in fmap or fmap[ident].ctype not in DERIVE_CTYPES:
+                raise ValueError(f"derive 表达式 {expr} 引用了未知或不支持的字段: {ident}")
+        derive.append((name, str(expr)))
+    return SweepGrid(axes=axes, derive=derive)
+
+
+def _cpp_derive_ident(ident: str) -> str:
+    if ident in DERIVE_CONSTANTS:
+        return ident
+    if ident in KNOWN_DTYPES:
+        return f"ge::{ident}"
+    return f"tiling_params.{ident}"
+
+
+def _cpp_derive_expr(expr: str) -> str:
+    return IDENT_PATTERN.sub(lambda m: _cpp_derive_ident(m.group(0)), expr)
+
+
+def render_sweep_body(suite: ParamSuite, grid: SweepGrid, scored: bool = False) -> str:
+    H = suite.harness
+    cap = suite.tiling_data_cap
+    fmap = suite.field_map()
+    out: List[str] = []
+    out.append("struct SweepAxis {")
+    out.append("    const char* name;")
+    out.append("    std::vector<std::string> values;")
+    out.append("};")
+    out.append("")
+    out.append("static const std::vector<SweepAxis> sweep_axes = {")
+    for name, values in grid.axes:
+        vals = ", ".join(cpp_string_literal(v) for v in values)
+        out.append(f"    {{\"{name}\", {{{vals}}}}},")
+    out.append("};")
+    out.append("")
+    out.append("inline void DeriveParams(TilingParams& tiling_params)")
+    out.append("{")
+    if not grid.derive:
+        out.append("    (void)tiling_params;")
+    for name, expr in grid.derive:
+        out.append(f"    tiling_params.{name} = {_cpp_derive_expr(expr)};")
+    out.append("}")
+    out.append("")
+    out.append("// 混合进制解码：第一个轴变化最慢")
+    out.append("inline std::vector<size_t> DecodePoint(size_t index)")
+    out.append("{")
+    out.append("    std::vector<size_t> digits(sweep_axes.size());")
+    out.append("    for (size_t i = sweep_axes.size(); i-- > 0;) {")
+    out.append("        digits[i] = index % sweep_axes[i].values.size();")
+    out.append("        index /= sweep_axes[i].values.size();")
+    out.append("    }")
+    out.append("    return digits;")
+    out.append("}")
+    out.append("")
+    out.append("inline size_t GridSize()")
+    out.append("{")
+    out.append("    size_t total = 1;")
+    out.append("    for (const auto& axis : sweep_axes) {")
+    out.append("        total *= axis.values.size();")
+    out.append("    }")
+    out.append("    return total;")
+    out.append("}")
+    out.append("")
+    out.append("struct SweepFailure {")
+    out.append("    size_t index;")
+    out.append("    int64_t status;")
+    out.append("    std::string message;")
+    out.append("};")
+    out.append("")
+    if scored:
+        out.append("// 同一 tiling key 下的预测耗时汇总，worst_index 为效率最低的网格点")
+        out.append("struct PredictedStats {")
+        out.append("    uint64_t count{0};")
+        out.append("    double sum_us{0.0};")
+        out.append("    double min_us{0.0};")
+        out.append("    double max_us{0.0};")
+        out.append("    double worst_efficiency{0.0};")
+        out.append("    size_t worst_index{0};")
+        out.append("")
+        out.append("    void Add(double predicted_us, double efficiency, size_t index)")
+        out.append("    {")
+        out.append("        if (count == 0 || predicted_us < min_us) {")
+        out.append("            min_us = predicted_us;")
+        out.append("        }")
+        out.append("        if (count == 0 || predicted_us > max_us) {")
+        out.append("            max_us = predicted_us;")
+        out.append("        }")
+        out.append("        if (count == 0 || efficiency < worst_efficiency) {")
+        out.append("            worst_efficiency = efficiency;")
+        out.append("            worst_index = index;")
+        out.append("        }")
+        out.append("        count++;")
+        out.append("        sum_us += predicted_us;")
+        out.append("    }")
+        out.append("")
+        out.append("    void Merge(const PredictedStats& other)")
+        out.append("    {")
+        out.append("        if (other.count == 0) {")
+        out.append("            return;")
+        out.append("        }")
+        out.append("        if (count == 0) {")
+        out.append("            *this = other;")
+        out.append("            return;")
+        out.append("        }")
+        out.append("        min_us = std::min(min_us, other.min_us);")
+        out.append("        max_us = std::max(max_us, other.max_us);")
+        out.append("        if (other.worst_efficiency < worst_efficiency) {")
+        out.append("            worst_efficiency = other.worst_efficiency;")
+        out.append("            worst_index = other.worst_index;")
+        out.append("        }")
+        out.append("        count += other.count;")
+        out.append("        sum_us += other.sum_us;")
+        out.append("    }")
+        out.append("};")
+        out.append("")
+    out.append("struct SweepStats {")
+    out.append("    uint64_t points{0};")
+    out.append("    uint64_t calls{0};")
+    out.append("    std::map<int64_t, uint64_t> status_count;")
+    out.append("    // tiling key -> 各轴各取值上的命中次数")
+    out.append("    std::map<uint64_t, std::vector<std::vector<uint64_t>>> key_axis_count;")
+    out.append("    std::map<uint64_t, uint64_t> key_count;")
+    if scored:
+        out.append("    std::map<uint64_t, PredictedStats> key_predicted;")
+    out.append("    std::vector<SweepFailure> failures;")
+    out.append("    uint64_t failure_count{0};")
+    out.append("")
+    out.append("    void Merge(const SweepStats& other, size_t max_failures)")
+    out.append("    {")
+    out.append("        points += other.points;")
+    out.append("        calls += other.calls;")
+    out.append("        failure_count += other.failure_count;")
+    out.append("        for (const auto& kv : other.status_count) {")
+    out.append("            status_count[kv.first] += kv.second;")
+    out.append("        }")
+    out.append("        for (const auto& kv : other.key_count) {")
+    out.append("            key_count[kv.first] += kv.second;")
+    out.append("            auto& dst = key_axis_count[kv.first];")
+    out.append("            const auto& src = other.key_axis_count.at(kv.first);")
+    out.append("            if (dst.empty()) {")
+    out.append("                dst = src;")
+    out.append("                continue;")
+    out.append("            }")
+    out.append("            for (size_t a = 0; a < src.size(); ++a) {")
+    out.append("                for (size_t v = 0; v < src[a].size(); ++v) {")
+    out.append("                    dst[a][v] += src[a][v];")
+    out.append("                }")
+    out.append("            }")
+    out.append("        }")
+    if scored:
+        out.append("        for (const auto& kv : other.key_predicted) {")
+        out.append("            key_predicted[kv.first].Merge(kv.second);")
+        out.append("        }")
+    out.append("        for (const auto& f : other.failures) {")
+    out.append("            if (failures.size() < max_failures) {")
+    out.append("                failures.push_back(f);")
+    out.append("            }")
+    out.append("        }")
+    out.append("    }")
+    out.append("};")
+    out.append("")
+    out.append("struct SweepOptions {")
+    out.append("    size_t threads{std::max(1u, std::thread::hardware_concurrency())};")
+    out.append("    size_t repeat{1};")
+    out.append("    size_t chunk{64};")
+    out.append("    size_t max_failures{100};")
+    out.append(f"    std::string out_path{{\"{sweep_file_stem(suite.op_name)}.json\"}};")
+    out.append("};")
+    out.append("")
+    out.append("void SweepWorker(size_t thread_id, const SweepOptions& options, std::atomic<size_t>& next, SweepStats& stats)")
+    out.append("{")
+    out.append(f"    std::string op_type(\"{suite.op_name}\");")
+    out.append("    auto tiling_func = gert::OpImplRegistry::GetInstance().GetOpImpl(op_type.c_str())->tiling;")
+    out.append("    const auto& platform_cache = TilingPlatformCache::Get();")
+    out.append(f"    auto tilingData = gert::TilingData::CreateCap({cap});")
+    out.append(f"    auto workspace_holer = gert::ContinuousVector::Create<size_t>({cap});")
+    out.append("    auto workspace = reinterpret_cast<gert::ContinuousVector*>(workspace_holer.get());")
+    out.append(f"    {H} harness;")
+    out.append("    harness.derive_params = DeriveParams;")
+    out.append("    // HcomTopoInfo 为进程级单例，各线程使用独立的通信域名")
+    out.append("    harness.group_suffix = \"_t\" + std::to_string(thread_id);")
+    out.append("")
+    out.append("    const size_t total = GridSize();")
+    out.append("    std::vector<std::pair<std::string, std::string>> pairs;")
+    out.append("    for (size_t begin = next.fetch_add(options.chunk); begin < total; begin = next.fetch_add(options.chunk)) {")
+    out.append("        size_t end = std::min(total, begin + options.chunk);")
+    out.append("        for (size_t index = begin; index < end; ++index) {")
+    out.append("            auto digits = DecodePoint(index);")
+    out.append("            pairs.clear();")
+    out.append("            for (size_t a = 0; a < sweep_axes.size(); ++a) {")
+    out.append("                pairs.emplace_back(sweep_axes[a].name, sweep_axes[a].values[digits[a]]);")
+    out.append("            }")
+    out.append("")
+    out.append("            ge::graphStatus ret = ge::GRAPH_FAILED;")
+    out.append("            std::string message;")
+    out.append("            try {")
+    out.append("                harness.InitHolder(tilingData.get(), workspace, pairs);")
+    out.append("                gert::TilingContext* tiling_context = harness.GetTilingContext();")
+    out.append("                harness.SetPlatformRes(platform_cache);")
+    out.append("                {")
+    out.append("                    TopoInfoGuard topo_guard(harness);")
+    out.append("                    for (size_t r = 0; r < options.repeat; ++r) {")
+    out.append("                        ret = tiling_func(tiling_context);")
+    out.append("                    }")
+    out.append("                }")
+    out.append("                stats.calls += options.repeat;")
+    out.append("                if (ret == ge::GRAPH_SUCCESS) {")
+    out.append("                    uint64_t tiling_key = tiling_context->GetTilingKey();")
+    out.append("                    stats.key_count[tiling_key]++;")
+    out.append("                    auto& per_axis = stats.key_axis_count[tiling_key];")
+    out.append("                    if (per_axis.empty()) {")
+    out.append("                        for (const auto& axis : sweep_axes) {")
+    out.append("                            per_axis.emplace_back(axis.values.size(), 0);")
+    out.append("                        }")
+    out.append("                    }")
+    out.append("                    for (size_t a = 0; a < digits.size(); ++a) {")
+    out.append("                        per_axis[a][digits[a]]++;")
+    out.append("                    }")
+    if scored:
+        out.append("                    auto* raw_tiling_data = tiling_context->GetRawTilingData();")
+        out.append("                    auto decoded = utgen_perf::Decode(static_cast<const uint8_t*>(raw_tiling_data->GetData()),")
+        out.append("                                                      raw_tiling_data->GetDataSize(),")
+        out.append("                                                      utgen_perf::DtypeBytes(tiling_context));")
+        out.append("                    if (decoded.valid) {")
+        out.append("                        auto estimate = utgen_perf::EstimateTime(decoded);")
+        out.append("                        stats.key_predicted[tiling_key].Add(estimate.predicted_us, estimate.Efficiency(), index);")
+        out.append("                    }")
+    out.append("                }")
+    out.append("            } catch (const std::exception& e) {")
+    out.append("                message = e.what();")
+    out.append("            }")
+    out.append("            stats.points++;")
+    out.append("            stats.status_count[static_cast<int64_t>(ret)]++;")
+    out.append("            if (ret != ge::GRAPH_SUCCESS) {")
+    out.append("                stats.failure_count++;")
+    out.append("                if (stats.failures.size() < options.max_failures) {")
+    out.append("                    stats.failures.push_back({index, static_cast<int64_t>(ret), message});")
+    out.append("                }")
+    out.append("            }")
+    out.append("        }")
+    out.append("    }")
+    out.append("}")
+    return "\n".join(out) + "\n"
+
+
+def render_sweep_main(suite: ParamSuite, scored: bool = False) -> str:
+    out: List[str] = []
+    out.append("inline std::string JsonEscape(const std::string& s)")
+    out.append("{")
+    out.append("    std::string r;")
+    out.append("    for (char c : s) {")
+    out.append("        if (c == '\"' || c == '\\\\') {")
+    out.append("            r.push_back('\\\\');")
+    out.append("        }")
+    out.append("        r.push_back(c == '\\n' ? ' ' : c);")
+    out.append("    }")
+    out.append("    return r;")
+    out.append("}")
+    out.append("")
+    out.append("void WriteSweepReport(const SweepOptions& options, const SweepStats& stats, double elapsed_s)")
+    out.append("{")
+    out.append("    std::ofstream os(options.out_path);")
+    out.append("    os << \"{\\n\";")
+    out.append(f"    os << \"  \\\"op\\\": \\\"{suite.op_name}\\\",\\n\";")
+    out.append("    os << \"  \\\"points\\\": \" << stats.points << \",\\n\";")
+    out.append("    os << \"  \\\"calls\\\": \" << stats.calls << \",\\n\";")
+    out.append("    os << \"  \\\"threads\\\": \" << options.threads << \",\\n\";")
+    out.append("    os << \"  \\\"elapsed_s\\\": \" << elapsed_s << \",\\n\";")
+    out.append("    os << \"  \\\"calls_per_s\\\": \" << (elapsed_s > 0 ? stats.calls / elapsed_s : 0.0) << \",\\n\";")
+    out.append("    os << \"  \\\"axes\\\": [\";")
+    out.append("    for (size_t a = 0; a < sweep_axes.size(); ++a) {")
+    out.append("        os << (a ? \", \" : \"\") << \"{\\\"name\\\": \\\"\" << sweep_axes[a].name << \"\\\", \\\"values\\\": [\";")
+    out.append("        for (size_t v = 0; v < sweep_axes[a].values.size(); ++v) {")
+    out.append("            os << (v ? \", \" : \"\") << \"\\\"\" << JsonEscape(sweep_axes[a].values[v]) << \"\\\"\";")
+    out.append("        }")
+    out.append("        os << \"]}\";")
+    out.append("    }")
+    out.append("    os << \"],\\n\";")
+    out.append("    os << \"  \\\"status\\\": {\";")
+    out.append("    bool first = true;")
+    out.append("    for (const auto& kv : stats.status_count) {")
+    out.append("        os << (first ? \"\" : \", \") << \"\\\"\" << kv.first << \"\\\": \" << kv.second;")
+    out.append("        first = false;")
+    out.append("    }")
+    out.append("    os << \"},\\n\";")
+    out.append("    os << \"  \\\"tiling_keys\\\": [\";")
+    out.append("    first = true;")
+    out.append("    for (const auto& kv : stats.key_count) {")
+    out.append("        os << (first ? \"\\n\" : \",\\n\") << \"    {\\\"key\\\": \\\"\" << kv.first << \"\\\", \\\"count\\\": \" << kv.second << \", \\\"axes\\\": {\";")
+    out.append("        first = false;")
+    out.append("        const auto& per_axis = stats.key_axis_count.at(kv.first);")
+    out.append("        for (size_t a = 0; a < per_axis.size(); ++a) {")
+    out.append("            os << (a ? \", \" : \"\") << \"\\\"\" << sweep_axes[a].name << \"\\\": {\";")
+    out.append("            bool first_value = true;")
+    out.append("            for (size_t v = 0; v < per_axis[a].size(); ++v) {")
+    out.append("                if (per_axis[a][v] == 0) {")
+    out.append("                    continue;")
+    out.append("                }")
+    out.append("                os << (first_value ? \"\" : \", \") << \"\\\"\" << JsonEscape(sweep_axes[a].values[v]) << \"\\\": \" << per_axis[a][v];")
+    out.append("                first_value = false;")
+    out.append("            }")
+    out.append("            os << \"}\";")
+    out.append("        }")
+    out.append("        os << \"}\";")
+    if scored:
+        out.append("        auto predicted = stats.key_predicted.find(kv.first);")
+        out.append("        if (predicted != stats.key_predicted.end() && predicted->second.count > 0) {")
+        out.append("            const auto& p = predicted->second;")
+        out.append("            os << \", \\\"predicted_us\\\": {\\\"mean\\\": \" << p.sum_us / p.count << \", \\\"min\\\": \" << p.min_us")
+        out.append("               << \", \\\"max\\\": \" << p.max_us << \"}, \\\"worst_efficiency\\\": \" << p.worst_efficiency")
+        out.append("               << \", \\\"worst_params\\\": {\";")
+        out.append("            auto worst = DecodePoint(p.worst_index);")
+        out.append("            for (size_t a = 0; a < worst.size(); ++a) {")
+        out.append("                os << (a ? \", \" : \"\") << \"\\\"\" << sweep_axes[a].name << \"\\\": \\\"\" << JsonEscape(sweep_axes[a].values[worst[a]]) << \"\\\"\";")
+        out.append("            }")
+        out.append("            os << \"}\";")
+        out.append("        }")
+    out.append("        os << \"}\";")
+    out.append("    }")
+    out.append("    os << \"\\n  ],\\n\";")
+    out.append("    os << \"  \\\"failure_count\\\": \" << stats.failure_count << \",\\n\";")
+    out.append("    os << \"  \\\"failures\\\": [\";")
+    out.append("    for (size_t i = 0; i < stats.failures.size(); ++i) {")
+    out.append("        const auto& f = stats.failures[i];")
+    out.append("        auto digits = DecodePoint(f.index);")
+    out.append("        os << (i ? \",\\n\" : \"\\n\") << \"    {\\\"index\\\": \" << f.index << \", \\\"status\\\": \" << f.status;")
+    out.append("        if (!f.message.empty()) {")
+    out.append("            os << \", \\\"message\\\": \\\"\" << JsonEscape(f.message) << \"\\\"\";")
+    out.append("        }")
+    out.append("        os << \", \\\"params\\\": {\";")
+    out.append("        for (size_t a = 0; a < digits.size(); ++a) {")
+    out.append("            os << (a ? \", \" : \"\") << \"\\\"\" << sweep_axes[a].name << \"\\\": \\\"\" << JsonEscape(sweep_axes[a].values[digits[a]]) << \"\\\"\";")
+    out.append("        }")
+    out.append("        os << \"}}\";")
+    out.append("    }")
+    out.append("    os << \"\\n  ]\\n}\\n\";")
+    out.append("}")
+    out.append(f"}} // namespace {suite.namespace}")
+    out.append("")
+    out.append("int main(int argc, char** argv)")
+    out.append("{")
+    out.append(f"    using namespace {suite.namespace};")
+    out.append("    SweepOptions options;")
+    out.append("    for (int i = 1; i + 1 < argc; i += 2) {")
+    out.append("        std::string key = argv[i];")
+    out.append("        std::string value = argv[i + 1];")
+    out.append("        if (key == \"--threads\") {")
+    out.append("            options.threads = std::max<size_t>(1, std::stoul(value));")
+    out.append("        } else if (key == \"--repeat\") {")
+    out.append("            options.repeat = std::max<size_t>(1, std::stoul(value));")
+    out.append("        } else if (key == \"--chunk\") {")
+    out.append("            options.chunk = std::max<size_t>(1, std::stoul(value));")
+    out.append("        } else if (key == \"--max-failures\") {")
+    out.append("            options.max_failures = std::stoul(value);")
+    out.append("        } else if (key == \"--out\") {")
+    out.append("            options.out_path = value;")
+    out.append("        } else {")
+    out.append("            std::cerr << \"unknown option: \" << key << std::endl;")
+    out.append("            return 2;")
+    out.append("        }")
+    out.append("    }")
+    out.append("")
+    out.append(f"    if (gert::OpImplRegistry::GetInstance().GetOpImpl(\"{suite.op_name}\") == nullptr) {{")
+    out.append(f"        std::cerr << \"tiling func of {suite.op_name} not registered\" << std::endl;")
+    out.append("        return 1;")
+    out.append("    }")
+    out.append("    TilingPlatformCache::Get();")
+    out.append("    std::cout << \"sweeping \" << GridSize() << \" points x \" << options.repeat << \" calls on \" << options.threads")
+    out.append("              << \" threads\" << std::endl;")
+    out.append("")
+    out.append("    std::atomic<size_t> next{0};")
+    out.append("    std::vector<SweepStats> per_thread(options.threads);")
+    out.append("    std::vector<std::thread> workers;")
+    out.append("    auto start = std::chrono::steady_clock::now();")
+    out.append("    for (size_t t = 0; t < options.threads; ++t) {")
+    out.append("        workers.emplace_back(SweepWorker, t, std::cref(options), std::ref(next), std::ref(per_thread[t]));")
+    out.append("    }")
+    out.append("    for (auto& worker : workers) {")
+    out.append("        worker.join();")
+    out.append("    }")
+    out.append("    double elapsed_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();")
+    out.append("")
+    out.append("    SweepStats stats;")
+    out.append("    for (const auto& s : per_thread) {")
+    out.append("        stats.Merge(s, options.max_failures);")
+    out.append("    }")
+    out.append("    WriteSweepReport(options, stats, elapsed_s);")
+    out.append("    std::cout << stats.points << \" points, \" << stats.key_count.size() << \" tiling keys, \" << stats.failure_count")
+    out.append("              << \" failures, \" << elapsed_s << \" s -> \" << options.out_path << std::endl;")
+    out.append("    return 0;")
+    out.append("}")
+    return "\n".join(out) + "\n"
+
+
+def render_sweep_file(common_prefix: str, suite: ParamSuite, grid: SweepGrid,
+                      score: Optional[ScoreSpec] = None) -> str:
+    """生成独立的扫参可执行源文件（需链接算子 tiling 库与 pthread，不需要 gtest_main）。"""
+    includes = ["#include <algorithm>", "#include <atomic>", "#include <chrono>", "#include <thread>"]
+    model = ""
+    if score is not None:
+        includes += [ln for ln in perf_model_includes() if ln not in includes]
+        model = render_perf_model(score) + "\n"
+    return (
+        common_prefix
+        + "\n\n"
+        + "\n".join(includes) + "\n\n"
+        + model
+        + render_harness(suite, [], all_dtypes=True)
+        + "\n"
+        + render_sweep_body(suite, grid, score is not None)
+        + "\n"
+        + render_sweep_main(suite, score is not None)
+    )
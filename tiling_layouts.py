@@ -0,0 +1,195 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+matmul 类通算融合算子（MC2）TilingData 的公共布局与字段角色，供模板导出 TILING_DATA_FIELDS / TILING_ROLES：
+- 布局条目格式同 golden_snapshot.build_tiling_layout：(字段名, C++类型[, 元素个数])，按自然对齐排布
+- 字段顺序与算子 op_host 中 Mc2Msg / RCSTiling / TCubeTiling 的 TILING_DATA_FIELD_DEF 顺序一致，
+  算子侧结构体变化时需同步修改（黄金快照的字段级差异可用来核对）
+- 角色（role）是打分/缓冲区检查使用的语义名，映射到布局中的字段名，见 tiling_score.py
+- inject_probes：--alloc-probe/--golden/--score/--check-buffers 共用的注入入口，一次改写全部
+  tiling_func(tiling_context) 调用并插入各探针的代码块，包裹层次由 PROBE_ORDER 决定，与启用顺序无关
+"""
+
+from __future__ import annotations
+
+import re
+from dataclasses import dataclass, field
+from typing import Any, Callable, Dict, List, Sequence, Tuple
+
+
+LayoutItem = Tuple[Any, ...]
+
+MC2_MSG_FIELDS: List[LayoutItem] = [
+    ("preparePosition", "uint32_t"),
+    ("sendOff", "uint64_t"),
+    ("recvOff", "uint64_t"),
+    ("tailSendOff", "uint64_t"),
+    ("tailRecvOff", "uint64_t"),
+    ("sendCnt", "uint64_t"),
+    ("recvCnt", "uint64_t"),
+    ("tailSendCnt", "uint64_t"),
+    ("tailRecvCnt", "uint64_t"),
+    ("totalCnt", "uint64_t"),
+    ("turnNum", "uint32_t"),
+    ("tailNum", "uint32_t"),
+    ("stride", "uint32_t"),
+    ("workspaceOff", "uint32_t"),
+    ("notifyOff", "uint32_t"),
+    ("notifyBeginCnt", "uint16_t"),
+    ("notifyEndCnt", "uint16_t"),
+    ("useBufferType", "uint8_t"),
+    ("funID", "uint8_t"),
+    ("dataType", "uint8_t"),
+    ("groupNum", "uint8_t"),
+    ("reuseMode", "uint8_t"),
+    ("commType", "uint8_t"),
+    ("reduceOp", "uint8_t"),
+    ("commOrder", "uint8_t"),
+    ("waitPolicy", "uint8_t"),
+    ("rspPolicy", "uint8_t"),
+    ("exitPolicy", "uint8_t"),
+    ("commAlg", "uint8_t"),
+    ("taskType", "uint8_t"),
+    ("debugMode", "uint8_t"),
+    ("stepSize", "uint8_t"),
+    ("sendArgIndex", "uint8_t"),
+    ("recvArgIndex", "uint8_t"),
+    ("commOutArgIndex", "uint8_t"),
+    ("hasCommOut", "uint8_t"),
+    ("reserve", "uint8_t"),
+    ("reserve2", "uint32_t"),
+]
+
+RCS_TILING_FIELDS: List[LayoutItem] = [
+    ("rankDim", "uint32_t"),
+    ("rankID", "uint32_t"),
+    ("commtype", "uint32_t"),
+    ("subtype", "uint32_t"),
+    ("tileCnt", "uint32_t"),
+    ("tailM", "uint32_t"),
+    ("tailCnt", "uint32_t"),
+    ("biasLen", "uint32_t"),
+    ("isAdd", "uint32_t"),
+    ("rankM", "uint32_t"),
+    ("rankN", "uint32_t"),
+    ("rankK", "uint32_t"),
+    ("gatherIndex", "uint32_t"),
+    ("isTransposeA", "uint32_t"),
+    ("isTransposeB", "uint32_t"),
+    ("storageGather", "uint32_t"),
+    ("nd2NzWorkLen", "uint64_t"),
+    ("cToFloatLen", "uint64_t"),
+    ("gatherLen", "uint64_t"),
+    ("workspaceAddr4", "uint32_t"),
+    ("aicCoreNum", "uint32_t"),
+    ("needUbBuffer", "uint32_t"),
+    ("addX3UbCnt", "uint32_t"),
+    ("commWorkSpaceSize", "uint32_t"),
+    ("isInputCommQuantScale", "uint32_t"),
+    ("dataType", "uint32_t"),
+]
+
+TCUBE_TILING_FIELDS: List[LayoutItem] = [
+    (name, "int32_t") for name in (
+        "usedCoreNum", "M", "N", "Ka", "Kb", "singleCoreM", "singleCoreN", "singleCoreK",
+        "baseM", "baseN", "baseK", "depthA1", "depthB1", "stepM", "stepN", "isBias",
+        "transLength", "iterateOrder", "shareMode", "shareL1Size", "shareL0CSize", "shareUbSize",
+        "batchM", "batchN", "singleBatchM", "singleBatchN", "stepKa", "stepKb",
+        "depthAL1CacheUB", "depthBL1CacheUB", "dbL0A", "dbL0B", "dbL0C",
+        "ALayoutInfoB", "ALayoutInfoS", "ALayoutInfoN", "ALayoutInfoG", "ALayoutInfoD",
+        "BLayoutInfoB", "BLayoutInfoS", "BLayoutInfoN", "BLayoutInfoG", "BLayoutInfoD",
+        "CLayoutInfoB", "CLayoutInfoS1", "CLayoutInfoN", "CLayoutInfoG", "CLayoutInfoS2",
+        "BatchNum",
+    )
+]
+
+
+def prefixed(prefix: str, fields: Sequence[LayoutItem]) -> List[LayoutItem]:
+    """给嵌套结构体的字段加上 "<prefix>." 前缀，便于在差异报告与角色映射中区分。"""
+    return [(f"{prefix}.{item[0]}",) + tuple(item[1:]) for item in fields]
+
+
+def mc2_matmul_layout() -> List[LayoutItem]:
+    """Mc2Msg msg + RCSTiling param + TCubeTiling matmulTiling + TCubeTiling tailTiling。"""
+    return (
+        prefixed("msg", MC2_MSG_FIELDS)
+        + prefixed("param", RCS_TILING_FIELDS)
+        + prefixed("matmulTiling", TCUBE_TILING_FIELDS)
+        + prefixed("tailTiling", TCUBE_TILING_FIELDS)
+    )
+
+
+def mc2_matmul_roles() -> Dict[str, str]:
+    """mc2_matmul_layout 对应的角色映射：matmulTiling 描述每轮（长块）矩阵乘，tailTiling 的 M 为尾块行数。"""
+    return {
+        "m": "matmulTiling.M",
+        "n": "matmulTiling.N",
+        "k": "matmulTiling.Ka",
+        "base_m": "matmulTiling.baseM",
+        "base_n": "matmulTiling.baseN",
+        "base_k": "matmulTiling.baseK",
+        "used_core_num": "matmulTiling.usedCoreNum",
+        "rank_dim": "param.rankDim",
+        "tile_cnt": "param.tileCnt",
+        "tail_m": "param.tailM",
+        "tail_cnt": "param.tailCnt",
+        "depth_a1": "matmulTiling.depthA1",
+        "depth_b1": "matmulTiling.depthB1",
+        "db_l0a": "matmulTiling.dbL0A",
+        "db_l0b": "matmulTiling.dbL0B",
+        "db_l0c": "matmulTiling.dbL0C",
+        "is_bias": "matmulTiling.isBias",
+        # transLength 为 UB 中转缓冲长度（字节）
+        "ub_bytes": "matmulTiling.transLength",
+    }
+
+
+# =============================================================================
+# tiling_func 调用的探针注入
+# =============================================================================
+
+# 已被分配探针改写的调用同样视为 tiling_func 调用，之后再启用其它探针时仍能包裹在外层
+TILING_CALL_PATTERN = re.compile(
+    r"\b(?:utgen_alloc::ProbedCall\(tiling_func, tiling_context\)|tiling_func\(tiling_context\))"
+)
+INCLUDE_LINE_PATTERN = re.compile(r"^\s*#include\s*[<\"].*$", re.MULTILINE)
+
+# 由内向外的包裹顺序：分配探针只统计 tiling_func 本身，其余探针在返回后读取 TilingData
+PROBE_ORDER = ("alloc", "golden", "score", "buffer")
+
+
+@dataclass
+class TilingProbe:
+    kind: str                        # PROBE_ORDER 中的名称
+    marker: str                      # 生成文件中已含该标记时视为已注入，不再重复
+    wrap: Callable[[str], str]       # 调用表达式 -> 包裹后的表达式
+    # (去重键, 代码块)：多个探针共用的代码（如 utgen_perf 解码模型）只插入一次
+    blocks: List[Tuple[str, str]] = field(default_factory=list)
+
+
+def inject_probes(content: str, probes: Sequence[TilingProbe]) -> str:
+    """单遍注入：每个 tiling_func 调用按 PROBE_ORDER 由内向外包裹，各代码块按同一顺序插在最后一个 #include 之后。"""
+    pending = sorted((p for p in probes if p.marker not in content), key=lambda p: PROBE_ORDER.index(p.kind))
+    if not pending:
+        return content
+
+    def _wrap(match: "re.Match[str]") -> str:
+        call = match.group(0)
+        for probe in pending:
+            call = probe.wrap(call)
+        return call
+
+    body = TILING_CALL_PATTERN.sub(_wrap, content)
+    seen = set()
+    blocks: List[str] = []
+    for probe in pending:
+        for key, block in probe.blocks:
+            if key not in seen:
+                seen.add(key)
+                blocks.append(block)
+    code = "\n".join(blocks)
+    includes = list(INCLUDE_LINE_PATTERN.finditer(body))
+    if not includes:
+        return code + "\n" + body
+    pos = includes[-1].end()
+    return body[:pos] + "\n\n" + code + body[pos:]
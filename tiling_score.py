@@ -0,0 +1,452 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+matmul 类通算融合算子的 tiling 质量打分（roofline + 通信掩盖模型）：
+- 按模板导出的 TILING_DATA_FIELDS（布局）与 TILING_ROLES（角色 -> 字段名）从 TilingData 中解码
+  矩阵规模、base 块大小、使用核数与通信切分轮数（见 tiling_layouts.py）
+- 单轮矩阵乘耗时取 max(按 base 块向上取整的计算时间, 按块复用次数与 L2_SIZE 估计的 HBM 访存时间)；
+  通信量按算子的集合通信类型与 rank 数估计，按流水轮数与计算互相掩盖：
+      predicted = max(matmul, comm) + min(matmul, comm) / pipeline
+- 硬件参数取自生成文件中的 hardware_info（CORE_NUM、L2_SIZE，模板 HARDWARE_INFO 可覆盖），
+  峰值算力/频率/带宽取 DEFAULT_PERF_MODEL，模板可导出 PERF_MODEL 覆盖
+- --score 把 tiling_func(tiling_context) 包裹为 utgen_perf::Score(...)，逐用例打印预测耗时并写 <stem>_perf.csv；
+  设置 UTGEN_PERF_BASELINE 指向上一次的 CSV 时，预测耗时劣化超过 UTGEN_PERF_TOLERANCE（默认 0.05）的用例判失败
+- 扫参程序（--sweep）在模板提供角色映射时按 tiling key 汇总预测耗时与最低效率点
+
+模板导出：
+  TILING_DATA_FIELDS = [...]                      # 见 golden_snapshot.build_tiling_layout
+  TILING_ROLES = {"m": ..., "n": ..., "k": ..., "base_m": ..., "base_n": ..., "base_k": ...,   # 必填
+                  "used_core_num": ..., "rank_dim": ..., "tile_cnt": ..., "tail_m": ..., "tail_cnt": ...,  # 可选
+                  "depth_a1": ..., "depth_b1": ..., "db_l0a": ..., "db_l0b": ..., "db_l0c": ...,
+                  "is_bias": ..., "ub_bytes": ...}                                                     # 可选，缓冲区检查用
+  TILING_SCORE = {"comm": "all_gather" | "all_reduce" | "reduce_scatter" | "all_to_all" | "none",
+                  "dtype_bytes": 2}                # 用例首个输入的 dtype 无法识别时的回退字节数
+
+元素字节数按用例取 tiling_context->GetInputDesc(0)->GetDataType()（即 xlsx 的 dtype 列），见 DtypeBytes
+"""
+
+from __future__ import annotations
+
+from dataclasses import dataclass, field
+from typing import Any, Dict, List, Optional
+
+from golden_snapshot import TilingField, build_tiling_layout
+from platform_cache import hardware_info
+from tiling_layouts import TilingProbe
+
+
+SCORE_MARKER = "utgen_perf::Score("
+
+REQUIRED_ROLES = ["m", "n", "k", "base_m", "base_n", "base_k"]
+# 可选角色及缺省值（缺省即不参与对应项的估计）
+OPTIONAL_ROLES = {
+    "used_core_num": 0,
+    "rank_dim": 1,
+    "tile_cnt": 1,
+    "tail_m": 0,
+    "tail_cnt": 0,
+    # 片上缓冲区占用（见 buffer_check.py）
+    "depth_a1": 1,
+    "depth_b1": 1,
+    "db_l0a": 1,
+    "db_l0b": 1,
+    "db_l0c": 1,
+    "is_bias": 0,
+    "ub_bytes": 0,
+}
+
+COMM_KINDS = {
+    "none": "NONE",
+    "all_gather": "ALL_GATHER",
+    "all_reduce": "ALL_REDUCE",
+    "reduce_scatter": "REDUCE_SCATTER",
+    "all_to_all": "ALL_TO_ALL",
+}
+
+DEFAULT_PERF_MODEL: Dict[str, float] = {
+    # 单个 AI Core 的 cube 峰值（fp16，16x16x16 MAC/cycle）
+    "CUBE_FLOPS_PER_CYCLE": 8192,
+    "FREQ_GHZ": 1.8,
+    "HBM_GBPS": 1600.0,
+    # 单卡对外的通信带宽与每轮通信的固定开销
+    "LINK_GBPS": 196.0,
+    "COMM_STEP_US": 5.0,
+}
+
+# ge::DataType -> 元素字节数；INT4 按半字节计
+DTYPE_BYTES: Dict[str, float] = {
+    "DT_DOUBLE": 8, "DT_INT64": 8, "DT_UINT64": 8,
+    "DT_FLOAT": 4, "DT_INT32": 4, "DT_UINT32": 4,
+    "DT_FLOAT16": 2, "DT_BF16": 2, "DT_INT16": 2, "DT_UINT16": 2,
+    "DT_INT8": 1, "DT_UINT8": 1, "DT_BOOL": 1,
+    "DT_FLOAT8_E4M3FN": 1, "DT_FLOAT8_E5M2": 1, "DT_FLOAT8_E8M0": 1, "DT_HIFLOAT8": 1,
+    "DT_INT4": 0.5, "DT_FLOAT4_E2M1": 0.5,
+}
+
+
+@dataclass
+class ScoreSpec:
+    roles: Dict[str, TilingField]
+    comm: str
+    dtype_bytes: float               # 回退值，实际按用例的输入 dtype 取
+    hardware: Dict[str, Any]
+    perf: Dict[str, float] = field(default_factory=dict)
+
+
+def load_score_spec(module: Any) -> Optional[ScoreSpec]:
+    """从模板模块读取布局与角色映射；模板未提供 TILING_ROLES 时返回 None，映射不完整时抛 ValueError。"""
+    if module is None:
+        return None
+    raw_roles = getattr(module, "TILING_ROLES", None)
+    if not isinstance(raw_roles, dict):
+        return None
+    layout = {f.name: f for f in build_tiling_layout(getattr(module, "TILING_DATA_FIELDS", None))}
+    roles: Dict[str, TilingField] = {}
+    for role, field_name in raw_roles.items():
+        if role not in REQUIRED_ROLES and role not in OPTIONAL_ROLES:
+            raise ValueError(f"未知角色: {role}")
+        if field_name not in layout:
+            raise ValueError(f"角色 {role} 对应的字段 {field_name} 不在 TILING_DATA_FIELDS 中")
+        roles[role] = layout[field_name]
+    missing = [r for r in REQUIRED_ROLES if r not in roles]
+    if missing:
+        raise ValueError(f"TILING_ROLES 缺少必填角色: {missing}")
+
+    raw_score = getattr(module, "TILING_SCORE", None) or {}
+    comm = str(raw_score.get("comm", "none"))
+    if comm not in COMM_KINDS:
+        raise ValueError(f"TILING_SCORE.comm 不支持: {comm}")
+    perf = dict(DEFAULT_PERF_MODEL)
+    perf.update(getattr(module, "PERF_MODEL", None) or {})
+    return ScoreSpec(
+        roles=roles,
+        comm=comm,
+        dtype_bytes=float(raw_score.get("dtype_bytes", 2)),
+        hardware=hardware_info(getattr(module, "HARDWARE_INFO", None)),
+        perf=perf,
+    )
+
+
+def perf_model_includes() -> List[str]:
+    return ["#include <algorithm>", "#include <cmath>", "#include <cstdint>", "#include <cstring>"]
+
+
+def render_perf_model(spec: ScoreSpec) -> str:
+    """解码与耗时估计（不依赖 gtest，单测与扫参程序共用）。"""
+    hw, perf = spec.hardware, spec.perf
+    out: List[str] = []
+    out.append("namespace utgen_perf {")
+    out.append("struct Hardware {")
+    out.append("    double core_num;")
+    out.append("    double l2_size;")
+    out.append("    double cube_flops_per_cycle;")
+    out.append("    double freq_ghz;")
+    out.append("    double hbm_gbps;")
+    out.append("    double link_gbps;")
+    out.append("    double comm_step_us;")
+    out.append("};")
+    out.append("")
+    out.append(f"static const Hardware kHardware = {{{float(hw['CORE_NUM'])}, {float(hw['L2_SIZE'])}, "
+               f"{float(perf['CUBE_FLOPS_PER_CYCLE'])}, {float(perf['FREQ_GHZ'])}, {float(perf['HBM_GBPS'])}, {float(perf['LINK_GBPS'])}, "
+               f"{float(perf['COMM_STEP_US'])}}};")
+    out.append("")
+    out.append("enum class CommKind { NONE, ALL_GATHER, ALL_REDUCE, REDUCE_SCATTER, ALL_TO_ALL };")
+    out.append(f"static const CommKind kCommKind = CommKind::{COMM_KINDS[spec.comm]};")
+    out.append(f"static const double kDtypeBytes = {float(spec.dtype_bytes)};")
+    out.append("")
+    out.append("")
+    out.append("// 按用例首个输入的 dtype 取元素字节数，无法识别时回退到模板的 TILING_SCORE.dtype_bytes")
+    out.append("template <typename Context>")
+    out.append("double DtypeBytes(const Context* context)")
+    out.append("{")
+    out.append("    const auto* desc = context == nullptr ? nullptr : context->GetInputDesc(0);")
+    out.append("    if (desc == nullptr) {")
+    out.append("        return kDtypeBytes;")
+    out.append("    }")
+    out.append("    switch (desc->GetDataType()) {")
+    by_size: Dict[float, List[str]] = {}
+    for name, size in DTYPE_BYTES.items():
+        by_size.setdefault(size, []).append(name)
+    for size, names in by_size.items():
+        for name in names:
+            out.append(f"        case ge::{name}:")
+        out.append(f"            return {float(size)};")
+    out.append("        default:")
+    out.append("            return kDtypeBytes;")
+    out.append("    }")
+    out.append("}")
+    out.append("")
+    out.append("struct Decoded {")
+    out.append("    bool valid{false};")
+    out.append("    double dtype_bytes{kDtypeBytes};")
+    for role in REQUIRED_ROLES:
+        out.append(f"    uint64_t {role}{{0}};")
+    for role, default in OPTIONAL_ROLES.items():
+        out.append(f"    uint64_t {role}{{{default}}};")
+    out.append("};")
+    out.append("")
+    out.append("inline bool ReadRole(const uint8_t* data, size_t size, uint32_t offset, uint32_t width, uint64_t& value)")
+    out.append("{")
+    out.append("    if (data == nullptr || offset + width > size) {")
+    out.append("        return false;")
+    out.append("    }")
+    out.append("    value = 0;")
+    out.append("    std::memcpy(&value, data + offset, width);")
+    out.append("    return true;")
+    out.append("}")
+    out.append("")
+    out.append("inline Decoded Decode(const uint8_t* data, size_t size, double dtype_bytes)")
+    out.append("{")
+    out.append("    Decoded decoded;")
+    out.append("    decoded.dtype_bytes = dtype_bytes;")
+    out.append("    bool ok = true;")
+    for role in REQUIRED_ROLES:
+        f = spec.roles[role]
+        out.append(f"    ok = ReadRole(data, size, {f.offset}, {f.size}, decoded.{role}) && ok;")
+    for role in OPTIONAL_ROLES:
+        if role in spec.roles:
+            f = spec.roles[role]
+            out.append(f"    ReadRole(data, size, {f.offset}, {f.size}, decoded.{role});")
+    checks = " && ".join(f"decoded.{r} > 0" for r in REQUIRED_ROLES)
+    out.append(f"    decoded.valid = ok && {checks};")
+    out.append("    return decoded;")
+    out.append("}")
+    out.append("")
+    out.append("struct Estimate {")
+    out.append("    uint64_t cores{0};")
+    out.append("    uint64_t pipeline{1};")
+    out.append("    double compute_us{0.0};")
+    out.append("    double memory_us{0.0};")
+    out.append("    double matmul_us{0.0};")
+    out.append("    double comm_us{0.0};")
+    out.append("    double predicted_us{0.0};")
+    out.append("    double ideal_us{0.0};")
+    out.append("")
+    out.append("    double Efficiency() const")
+    out.append("    {")
+    out.append("        return predicted_us > 0.0 ? ideal_us / predicted_us : 0.0;")
+    out.append("    }")
+    out.append("};")
+    out.append("")
+    out.append("inline uint64_t CeilDiv(uint64_t lhs, uint64_t rhs)")
+    out.append("{")
+    out.append("    return rhs == 0 ? 0 : (lhs + rhs - 1) / rhs;")
+    out.append("}")
+    out.append("")
+    out.append("// 单轮矩阵乘：计算量按 base 块向上取整并按核数分波次；")
+    out.append("// 访存时放得进 L2 的操作数只从 HBM 读一次，否则 A 被读 tiles_n 次、B 被读 tiles_m 次")
+    out.append("inline void AddMatmulStep(const Decoded& t, uint64_t rows, Estimate& e)")
+    out.append("{")
+    out.append("    if (rows == 0) {")
+    out.append("        return;")
+    out.append("    }")
+    out.append("    uint64_t tiles_m = CeilDiv(rows, t.base_m);")
+    out.append("    uint64_t tiles_n = CeilDiv(t.n, t.base_n);")
+    out.append("    uint64_t waves = CeilDiv(tiles_m * tiles_n, e.cores);")
+    out.append("    double flops_per_us = kHardware.cube_flops_per_cycle * kHardware.freq_ghz * 1e3;")
+    out.append("    double padded_flops = 2.0 * static_cast<double>(waves) * static_cast<double>(CeilDiv(t.k, t.base_k)) *")
+    out.append("                          static_cast<double>(t.base_m * t.base_n * t.base_k);")
+    out.append("    double compute_us = padded_flops / flops_per_us;")
+    out.append("    double a_bytes = t.dtype_bytes * static_cast<double>(rows * t.k);")
+    out.append("    double b_bytes = t.dtype_bytes * static_cast<double>(t.k * t.n);")
+    out.append("    double a_reads = a_bytes <= kHardware.l2_size ? 1.0 : static_cast<double>(tiles_n);")
+    out.append("    double b_reads = b_bytes <= kHardware.l2_size ? 1.0 : static_cast<double>(tiles_m);")
+    out.append("    double bytes = a_bytes * a_reads + b_bytes * b_reads + t.dtype_bytes * static_cast<double>(rows * t.n);")
+    out.append("    double memory_us = bytes / (kHardware.hbm_gbps * 1e3);")
+    out.append("    e.compute_us += compute_us;")
+    out.append("    e.memory_us += memory_us;")
+    out.append("    e.matmul_us += std::max(compute_us, memory_us);")
+    out.append("    e.ideal_us += 2.0 * static_cast<double>(rows * t.n * t.k) / (flops_per_us * kHardware.core_num);")
+    out.append("}")
+    out.append("")
+    out.append("inline Estimate EstimateTime(const Decoded& t)")
+    out.append("{")
+    out.append("    Estimate e;")
+    out.append("    if (!t.valid) {")
+    out.append("        return e;")
+    out.append("    }")
+    out.append("    uint64_t core_num = static_cast<uint64_t>(kHardware.core_num);")
+    out.append("    e.cores = t.used_core_num > 0 ? std::min(t.used_core_num, core_num) : core_num;")
+    out.append("    uint64_t tile_cnt = std::max<uint64_t>(1, t.tile_cnt);")
+    out.append("    e.pipeline = tile_cnt + t.tail_cnt;")
+    out.append("    for (uint64_t i = 0; i < tile_cnt; ++i) {")
+    out.append("        AddMatmulStep(t, t.m, e);")
+    out.append("    }")
+    out.append("    for (uint64_t i = 0; i < t.tail_cnt; ++i) {")
+    out.append("        AddMatmulStep(t, t.tail_m, e);")
+    out.append("    }")
+    out.append("")
+    out.append("    double rows = static_cast<double>(t.m * tile_cnt + t.tail_m * t.tail_cnt);")
+    out.append("    double ranks = static_cast<double>(std::max<uint64_t>(1, t.rank_dim));")
+    out.append("    double share = (ranks - 1.0) / ranks;")
+    out.append("    double comm_bytes = 0.0;")
+    out.append("    switch (kCommKind) {")
+    out.append("        case CommKind::ALL_GATHER:")
+    out.append("        case CommKind::ALL_TO_ALL:")
+    out.append("            comm_bytes = rows * static_cast<double>(t.k) * t.dtype_bytes * share;")
+    out.append("            break;")
+    out.append("        case CommKind::ALL_REDUCE:")
+    out.append("            comm_bytes = 2.0 * rows * static_cast<double>(t.n) * t.dtype_bytes * share;")
+    out.append("            break;")
+    out.append("        case CommKind::REDUCE_SCATTER:")
+    out.append("            comm_bytes = rows * static_cast<double>(t.n) * t.dtype_bytes * share;")
+    out.append("            break;")
+    out.append("        default:")
+    out.append("            break;")
+    out.append("    }")
+    out.append("    if (comm_bytes > 0.0) {")
+    out.append("        e.comm_us = comm_bytes / (kHardware.link_gbps * 1e3) + static_cast<double>(e.pipeline) * kHardware.comm_step_us;")
+    out.append("    }")
+    out.append("    // 计算与通信按流水轮数互相掩盖，只有一轮时退化为串行")
+    out.append("    e.predicted_us = std::max(e.matmul_us, e.comm_us) +")
+    out.append("                     std::min(e.matmul_us, e.comm_us) / static_cast<double>(std::max<uint64_t>(1, e.pipeline));")
+    out.append("    return e;")
+    out.append("}")
+    out.append("} // namespace utgen_perf")
+    return "\n".join(out) + "\n"
+
+
+def render_perf_report(report_stem: str) -> str:
+    """逐用例记录预测耗时、写 CSV，并与 UTGEN_PERF_BASELINE 比较（依赖 gtest）。"""
+    out: List[str] = []
+    out.append("namespace utgen_perf {")
+    out.append("struct CaseScore {")
+    out.append("    std::string test_name;")
+    out.append("    uint64_t tiling_key;")
+    out.append("    Decoded tiling;")
+    out.append("    Estimate estimate;")
+    out.append("};")
+    out.append("")
+    out.append("class Report {")
+    out.append("public:")
+    out.append("    static Report& Get()")
+    out.append("    {")
+    out.append("        static Report instance;")
+    out.append("        return instance;")
+    out.append("    }")
+    out.append("")
+    out.append("    // 返回基线中的预测耗时，无基线时返回负值")
+    out.append("    double Add(CaseScore score)")
+    out.append("    {")
+    out.append("        std::lock_guard<std::mutex> lock(mutex_);")
+    out.append("        int seq = call_seq_[score.test_name]++;")
+    out.append("        if (seq > 0) {")
+    out.append("            score.test_name += \"#\" + std::to_string(seq);")
+    out.append("        }")
+    out.append("        auto it = baseline_.find(score.test_name);")
+    out.append("        double baseline_us = it == baseline_.end() ? -1.0 : it->second;")
+    out.append("        scores_.push_back(std::move(score));")
+    out.append("        return baseline_us;")
+    out.append("    }")
+    out.append("")
+    out.append("    double tolerance() const")
+    out.append("    {")
+    out.append("        return tolerance_;")
+    out.append("    }")
+    out.append("")
+    out.append("    ~Report()")
+    out.append("    {")
+    out.append("        const char* env_path = std::getenv(\"UTGEN_PERF_REPORT\");")
+    out.append(f"        std::string path = (env_path != nullptr && *env_path != '\\0') ? env_path : \"{report_stem}_perf.csv\";")
+    out.append("        std::ofstream os(path);")
+    out.append("        os << \"test,predicted_us,ideal_us,efficiency,compute_us,memory_us,comm_us,tiling_key,cores,base_m,base_n,base_k,pipeline\\n\";")
+    out.append("        for (const auto& s : scores_) {")
+    out.append("            const auto& e = s.estimate;")
+    out.append("            os << s.test_name << \",\" << e.predicted_us << \",\" << e.ideal_us << \",\" << e.Efficiency() << \",\"")
+    out.append("               << e.compute_us << \",\" << e.memory_us << \",\" << e.comm_us << \",\" << s.tiling_key << \",\" << e.cores << \",\"")
+    out.append("               << s.tiling.base_m << \",\" << s.tiling.base_n << \",\" << s.tiling.base_k << \",\" << e.pipeline << \"\\n\";")
+    out.append("        }")
+    out.append("    }")
+    out.append("")
+    out.append("private:")
+    out.append("    Report()")
+    out.append("    {")
+    out.append("        const char* tolerance = std::getenv(\"UTGEN_PERF_TOLERANCE\");")
+    out.append("        if (tolerance != nullptr && *tolerance != '\\0') {")
+    out.append("            tolerance_ = std::stod(tolerance);")
+    out.append("        }")
+    out.append("        const char* baseline = std::getenv(\"UTGEN_PERF_BASELINE\");")
+    out.append("        if (baseline == nullptr || *baseline == '\\0') {")
+    out.append("            return;")
+    out.append("        }")
+    out.append("        std::ifstream is(baseline);")
+    out.append("        std::string line;")
+    out.append("        std::getline(is, line);")
+    out.append("        while (std::getline(is, line)) {")
+    out.append("            size_t first = line.find(',');")
+    out.append("            size_t second = line.find(',', first == std::string::npos ? first : first + 1);")
+    out.append("            if (first == std::string::npos || second == std::string::npos) {")
+    out.append("                continue;")
+    out.append("            }")
+    out.append("            baseline_[line.substr(0, first)] = std::stod(line.substr(first + 1, second - first - 1));")
+    out.append("        }")
+    out.append("    }")
+    out.append("")
+    out.append("    std::mutex mutex_;")
+    out.append("    double tolerance_{0.05};")
+    out.append("    std::map<std::string, double> baseline_;")
+    out.append("    std::map<std::string, int> call_seq_;")
+    out.append("    std::vector<CaseScore> scores_;")
+    out.append("};")
+    out.append("")
+    out.append("// 在 tiling_func 返回后解码 TilingData 并估计耗时，不改变返回值")
+    out.append("template <typename Ret, typename Context>")
+    out.append("Ret Score(Ret ret, Context* context)")
+    out.append("{")
+    out.append("    CaseScore score;")
+    out.append("    const auto* test_info = testing::UnitTest::GetInstance()->current_test_info();")
+    out.append("    if (test_info != nullptr) {")
+    out.append("        score.test_name = std::string(test_info->test_suite_name()) + \".\" + test_info->name();")
+    out.append("    }")
+    out.append("    auto* raw_tiling_data = context->GetRawTilingData();")
+    out.append("    if (raw_tiling_data == nullptr || raw_tiling_data->GetData() == nullptr) {")
+    out.append("        return ret;")
+    out.append("    }")
+    out.append("    score.tiling = Decode(static_cast<const uint8_t*>(raw_tiling_data->GetData()), raw_tiling_data->GetDataSize(),")
+    out.append("                          DtypeBytes(context));")
+    out.append("    if (!score.tiling.valid) {")
+    out.append("        std::cout << \"[perf] \" << score.test_name << \": tiling data not decodable\" << std::endl;")
+    out.append("        return ret;")
+    out.append("    }")
+    out.append("    score.tiling_key = context->GetTilingKey();")
+    out.append("    score.estimate = EstimateTime(score.tiling);")
+    out.append("    const Estimate e = score.estimate;")
+    out.append("    std::string name = score.test_name;")
+    out.append("    double baseline_us = Report::Get().Add(std::move(score));")
+    out.append("    std::cout << \"[perf] \" << name << \": predicted \" << e.predicted_us << \" us (compute \" << e.compute_us")
+    out.append("              << \", memory \" << e.memory_us << \", comm \" << e.comm_us << \"), efficiency \" << e.Efficiency()")
+    out.append("              << \", cores \" << e.cores << \", pipeline \" << e.pipeline << std::endl;")
+    out.append("    if (baseline_us > 0.0 && e.predicted_us > baseline_us * (1.0 + Report::Get().tolerance())) {")
+    out.append("        ADD_FAILURE() << \"[perf] \" << name << \" predicted time regressed: \" << baseline_us << \" us -> \"")
+    out.append("                      << e.predicted_us << \" us\";")
+    out.append("    }")
+    out.append("    return ret;")
+    out.append("}")
+    out.append("} // namespace utgen_perf")
+    return "\n".join(out) + "\n"
+
+
+def perf_model_block(spec: ScoreSpec) -> str:
+    """解码与耗时模型连同所需头文件；--score 与 --check-buffers 以同一去重键共用一份。"""
+    includes = perf_model_includes() + [
+        "#include <cstdlib>",
+        "#include <fstream>",
+        "#include <iostream>",
+        "#include <map>",
+        "#include <mutex>",
+        "#include <sstream>",
+        "#include <string>",
+        "#include <vector>",
+        "#include <gtest/gtest.h>",
+    ]
+    return "\n".join(includes) + "\n\n" + render_perf_model(spec)
+
+
+def score_probe(spec: ScoreSpec, report_stem: str) -> TilingProbe:
+    """耗时估计：tiling_func 调用包裹为 Score(...)，可与探针/快照/缓冲区检查叠加。"""
+    return TilingProbe(
+        kind="score",
+        marker=SCORE_MARKER,
+        wrap=lambda call: f"{SCORE_MARKER}{call}, tiling_context)",
+        blocks=[("perf_model", perf_model_block(spec)), ("perf_report", render_perf_report(report_stem))],
+    )
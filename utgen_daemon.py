@@ -0,0 +1,580 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+常驻生成服务：在一个长期运行的 Python 进程里执行 Stage 1 / Stage 2 / 验证，省去每次运行的解释器启动、
+pandas/openpyxl/openai 导入与模板模块加载；响应缓存、渲染缓存、已加载的 case-templates 与 HTTP 连接池在多次运行之间保持。
+
+- 协议：按行分隔的 JSON-RPC 2.0。默认监听 Unix socket（$XDG_RUNTIME_DIR 或临时目录下按仓库路径区分的
+  utgen-<uid>-<hash>.sock，权限 0600，UTGEN_DAEMON_SOCKET 可覆盖）；serve --stdio 改为读写标准输入输出
+- 方法：stage1 / stage2 / validate / pipeline，params 为 {argv, cwd, env}，等价于在 cwd 下以该环境运行
+  stage_1.py / convert_ut_from_xlsx.py / test_validator.py / stream_pipeline.py argv，结果 {"exit_code", "elapsed"}；另有 ping / stats / shutdown
+- 执行期间的 stdout/stderr（含日志）以通知 {"method": "log", "params": {"id", "stream", "text"}} 实时推送给调用方
+- 请求串行执行（切换 cwd 与环境变量对整个进程生效），批量并发作业（batch_runner.py）不经过守护进程；
+  跨请求保留的状态按请求的 cwd/环境区分：utils.get_cache_manager 按缓存目录与 UTGEN_CACHE_*，
+  llm_client.shared_limiter 按 LLM_RPM/LLM_TPM
+- 仓库下的 .py 有改动时不再执行请求：返回 STALE 错误后退出，调用方回退为直接运行；case-templates 按修改时间重新加载，
+  改模板无需重启
+- 空闲 UTGEN_DAEMON_IDLE 秒（默认 3600，0 表示不退出）后自动退出；日志写入 .cache/utgen_daemon.log
+
+用法：
+  python3 utgen_daemon.py start | stop | status
+  python3 utgen_daemon.py serve [--stdio]
+  python3 utgen_daemon.py call stage2 -- --ref ref.cpp --xlsx params.xlsx --op AllGatherMatmul --out out.cpp
+  python3 utgen_daemon.py call convert_ut_from_xlsx.py -- ...   # 也可写入口脚本路径
+
+call 在守护进程不可用时以退出码 75 返回（不输出任何内容），workflow.sh 据此回退为直接运行；UTGEN_DAEMON=0 时不使用守护进程。
+本文件顶层只导入标准库，call 客户端本身启动很快。
+"""
+
+from __future__ import annotations
+
+import argparse
+import hashlib
+import importlib
+import io
+import json
+import os
+import signal
+import socket
+import socketserver
+import subprocess
+import sys
+import tempfile
+import threading
+import time
+import traceback
+from pathlib import Path
+from typing import Any, Callable, Dict, List, Optional
+
+SCRIPT_DIR = Path(__file__).resolve().parent
+
+# 方法 -> 入口模块（模块需提供 main(argv)）
+METHODS = {
+    "stage1": "stage_1",
+    "stage2": "convert_ut_from_xlsx",
+    "validate": "test_validator",
+    "pipeline": "stream_pipeline",
+}
+
+EXIT_UNAVAILABLE = 75  # EX_TEMPFAIL：守护进程不可用，调用方应直接运行
+STALE_ERROR = -32001
+DEFAULT_IDLE = 3600
+START_TIMEOUT = 30.0
+
+
+def socket_path() -> str:
+    configured = os.environ.get("UTGEN_DAEMON_SOCKET")
+    if configured:
+        return configured
+    base = os.environ.get("XDG_RUNTIME_DIR") or tempfile.gettempdir()
+    tag = hashlib.sha256(str(SCRIPT_DIR).encode("utf-8")).hexdigest()[:10]
+    return os.path.join(base, f"utgen-{os.getuid()}-{tag}.sock")
+
+
+def log_path() -> Path:
+    return SCRIPT_DIR / ".cache" / "utgen_daemon.log"
+
+
+def source_stamps() -> Dict[str, tuple]:
+    stamps = {}
+    for path in SCRIPT_DIR.glob("*.py"):
+        try:
+            stat = path.stat()
+        except OSError:
+            continue
+        stamps[path.name] = (stat.st_mtime_ns, stat.st_size)
+    return stamps
+
+
+# =============================================================================
+# 输出转发
+# =============================================================================
+
+class _Sink:
+    """把一次请求的输出按行转发给调用方。"""
+
+    def __init__(self, send: Callable[[str, str], None]):
+        self._send = send
+        self._buffers: Dict[str, str] = {}
+        self._lock = threading.Lock()
+
+    def write(self, stream: str, text: str):
+        with self._lock:
+            buf = self._buffers.get(stream, "") + text
+            cut = buf.rfind("\n") + 1
+            self._buffers[stream] = buf[cut:]
+        if cut:
+            self._send(stream, buf[:cut])
+
+    def close(self):
+        with self._lock:
+            pending = [(stream, buf) for stream, buf in self._buffers.items() if buf]
+            self._buffers.clear()
+        for stream, buf in pending:
+            self._send(stream, buf)
+
+
+_current_sink: Optional[_Sink] = None
+
+
+class _Router(io.TextIOBase):
+    """替换 sys.stdout/sys.stderr：请求执行期间（含其它线程）的输出转发给当前调用方，其余写入原始流。"""
+
+    def __init__(self, stream: str, fallback):
+        self.stream = stream
+        self.fallback = fallback
+
+    @property
+    def encoding(self):
+        return "utf-8"
+
+    def writable(self) -> bool:
+        return True
+
+    def isatty(self) -> bool:
+        return False
+
+    def write(self, text: str) -> int:
+        sink = _current_sink
+        if sink is None:
+            self.fallback.write(text)
+        else:
+            sink.write(self.stream, text)
+        return len(text)
+
+    def flush(self):
+        if _current_sink is None:
+            self.fallback.flush()
+
+
+def _exit_code(entry: Callable[[List[str]], Any], argv: List[str]) -> int:
+    try:
+        result = entry(argv)
+    except SystemExit as e:
+        result = e.code
+    except Exception:
+        traceback.print_exc()
+        return 1
+    if result is None:
+        return 0
+    if isinstance(result, int):
+        return result
+    print(result, file=sys.stderr)
+    return 1
+
+
+# =============================================================================
+# 服务端
+# =============================================================================
+
+class StaleSources(Exception):
+    pass
+
+
+class GenerationDaemon:
+    def __init__(self, idle_seconds: int):
+        self.idle_seconds = idle_seconds
+        self.started = time.time()
+        self.last_active = time.monotonic()
+        self.lock = threading.Lock()
+        self.stop_event = threading.Event()
+        self.sources = source_stamps()
+        self.modules: Dict[str, Any] = {}
+        self.stats: Dict[str, Dict[str, float]] = {}
+
+    def warm_up(self):
+        """预先导入入口模块（及其 pandas/openpyxl/openai 依赖），启动常驻事件循环。"""
+        from llm_client import start_persistent_loop
+
+        start = time.monotonic()
+        for name in METHODS.values():
+            self._module(name)
+        start_persistent_loop()
+        print(f"✅ 预热完成，用时 {time.monotonic() - start:.2f}s", file=sys.stderr)
+
+    def close(self):
+        from llm_client import stop_persistent_loop
+
+        stop_persistent_loop()
+
+    def _module(self, name: str) -> Any:
+        module = self.modules.get(name)
+        if module is None:
+            module = self.modules[name] = importlib.import_module(name)
+        return module
+
+    def _stale_files(self) -> List[str]:
+        current = source_stamps()
+        names = set(current) | set(self.sources)
+        return sorted(n for n in names if current.get(n) != self.sources.get(n))
+
+    def _record(self, method: str, elapsed: float, exit_code: int):
+        entry = self.stats.setdefault(method, {"calls": 0, "failures": 0, "total_s": 0.0, "last_s": 0.0})
+        entry["calls"] += 1
+        entry["failures"] += 1 if exit_code else 0
+        entry["total_s"] += elapsed
+        entry["last_s"] = elapsed
+
+    def run_entry(self, method: str, params: Dict[str, Any], send_log: Callable[[str, str], None]) -> Dict[str, Any]:
+        global _current_sink
+        argv = [str(a) for a in params.get("argv") or []]
+        env = params.get("env")
+        with self.lock:
+            stale = self._stale_files()
+            if stale:
+                raise StaleSources(f"仓库代码已更新（{', '.join(stale[:5])}），守护进程退出")
+            entry = self._module(METHODS[method]).main
+            saved_cwd = os.getcwd()
+            saved_env = dict(os.environ)
+            sink = _Sink(send_log)
+            start = time.monotonic()
+            _current_sink = sink
+            code = 1
+            try:
+                if env is not None:
+                    os.environ.clear()
+                    os.environ.update({str(k): str(v) for k, v in env.items()})
+                os.chdir(params.get("cwd") or saved_cwd)
+                code = _exit_code(entry, argv)
+            finally:
+                _current_sink = None
+                sink.close()
+                os.chdir(saved_cwd)
+                os.environ.clear()
+                os.environ.update(saved_env)
+                elapsed = time.monotonic() - start
+                self._record(method, elapsed, code)
+        return {"exit_code": code, "elapsed": round(elapsed, 3)}
+
+    def snapshot(self) -> Dict[str, Any]:
+        return {
+            "pid": os.getpid(),
+            "python": sys.executable,
+            "socket": socket_path(),
+            "uptime_s": round(time.time() - self.started, 1),
+            "busy": self.lock.locked(),
+            "methods": self.stats,
+        }
+
+    def dispatch(self, line: bytes, send: Callable[[Dict[str, Any]], None]):
+        try:
+            request = json.loads(line)
+            req_id = request.get("id")
+            method = request.get("method")
+            params = request.get("params") or {}
+        except (ValueError, AttributeError):
+            send({"jsonrpc": "2.0", "id": None, "error": {"code": -32700, "message": "无法解析的请求"}})
+            return
+        self.last_active = time.monotonic()
+
+        def send_log(stream: str, text: str):
+            send({"jsonrpc": "2.0", "method": "log", "params": {"id": req_id, "stream": stream, "text": text}})
+
+        try:
+            if method == "ping":
+                result = {"pid": os.getpid(), "uptime_s": round(time.time() - self.started, 1)}
+            elif method == "stats":
+                result = self.snapshot()
+            elif method == "shutdown":
+                result = {"ok": True}
+                self.stop_event.set()
+            elif method in METHODS:
+                result = self.run_entry(method, params, send_log)
+            else:
+                send({"jsonrpc": "2.0", "id": req_id, "error": {"code": -32601, "message": f"未知方法: {method}"}})
+                return
+        except StaleSources as e:
+            send({"jsonrpc": "2.0", "id": req_id, "error": {"code": STALE_ERROR, "message": str(e)}})
+            print(f"⚠️ {e}", file=sys.stderr)
+            self.stop_event.set()
+            return
+        except Exception as e:
+            send({"jsonrpc": "2.0", "id": req_id, "error": {"code": -32603, "message": f"{type(e).__name__}: {e}"}})
+            return
+        finally:
+            self.last_active = time.monotonic()
+        if req_id is not None:
+            send({"jsonrpc": "2.0", "id": req_id, "result": result})
+
+    def idle_expired(self) -> bool:
+        if not self.idle_seconds or self.lock.locked():
+            return False
+        return time.monotonic() - self.last_active > self.idle_seconds
+
+
+class _Handler(socketserver.StreamRequestHandler):
+    def handle(self):
+        state: GenerationDaemon = self.server.generation_daemon
+        write_lock = threading.Lock()
+
+        def send(message: Dict[str, Any]):
+            data = (json.dumps(message, ensure_ascii=False) + "\n").encode("utf-8")
+            with write_lock:
+                try:
+                    self.wfile.write(data)
+                    self.wfile.flush()
+                except OSError:
+                    pass  # 调用方已断开，请求照常执行完
+
+        for line in self.rfile:
+            if line.strip():
+                state.dispatch(line, send)
+            if state.stop_event.is_set():
+                break
+
+
+class _Server(socketserver.ThreadingMixIn, socketserver.UnixStreamServer):
+    daemon_threads = True
+
+
+def _install_routers():
+    # 需在导入入口模块之前替换：utils 中 logging.basicConfig 创建的处理器会直接引用此时的 sys.stderr
+    sys.stdout = _Router("stdout", sys.__stdout__)
+    sys.stderr = _Router("stderr", sys.__stderr__)
+
+
+def serve_socket(idle_seconds: int) -> int:
+    path = socket_path()
+    if _ping(path) is not None:
+        print(f"⚠️ 守护进程已在运行: {path}", file=sys.stderr)
+        return 1
+    if os.path.exists(path):
+        os.unlink(path)  # 上次异常退出遗留的 socket
+
+    _install_routers()
+    state = GenerationDaemon(idle_seconds)
+    state.warm_up()
+    old_umask = os.umask(0o177)
+    try:
+        server = _Server(path, _Handler)
+    finally:
+        os.umask(old_umask)
+    server.generation_daemon = state
+    signal.signal(signal.SIGTERM, lambda *_: state.stop_event.set())
+    thread = threading.Thread(target=server.serve_forever, name="utgen-daemon", daemon=True)
+    thread.start()
+    print(f"✅ 守护进程已启动 (pid {os.getpid()}): {path}", file=sys.stderr)
+    try:
+        while not state.stop_event.wait(min(30, idle_seconds or 30)):
+            if state.idle_expired():
+                print(f"空闲超过 {idle_seconds}s，退出", file=sys.stderr)
+                break
+    except KeyboardInterrupt:
+        pass
+    finally:
+        server.shutdown()
+        server.server_close()
+        try:
+            os.unlink(path)
+        except OSError:
+            pass
+        state.close()
+    print("守护进程已退出", file=sys.stderr)
+    return 0
+
+
+def serve_stdio() -> int:
+    out = sys.__stdout__
+    write_lock = threading.Lock()
+
+    def send(message: Dict[str, Any]):
+        with write_lock:
+            out.write(json.dumps(message, ensure_ascii=False) + "\n")
+            out.flush()
+
+    # 标准输出专用于协议，请求之外的输出写到标准错误
+    sys.stdout = _Router("stdout", sys.__stderr__)
+    sys.stderr = _Router("stderr", sys.__stderr__)
+    state = GenerationDaemon(0)
+    state.warm_up()
+    try:
+        for line in sys.stdin.buffer:
+            if line.strip():
+                state.dispatch(line, send)
+            if state.stop_event.is_set():
+                break
+    finally:
+        state.close()
+    return 0
+
+
+# =============================================================================
+# 客户端
+# =============================================================================
+
+def _connect(path: str) -> Optional[socket.socket]:
+    if not os.path.exists(path):
+        return None
+    sock = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+    try:
+        sock.connect(path)
+    except OSError:
+        sock.close()
+        return None
+    return sock
+
+
+def _request(sock: socket.socket, method: str, params: Optional[Dict[str, Any]] = None,
+             on_log: Optional[Callable[[Dict[str, Any]], None]] = None) -> Dict[str, Any]:
+    """发送一个请求并读取到其响应为止；连接中断时抛出 ConnectionError。"""
+    message = {"jsonrpc": "2.0", "id": 1, "method": method, "params": params or {}}
+    sock.sendall((json.dumps(message, ensure_ascii=False) + "\n").encode("utf-8"))
+    with sock.makefile("rb") as reader:
+        for line in reader:
+            reply = json.loads(line)
+            if reply.get("method") == "log":
+                if on_log is not None:
+                    on_log(reply["params"])
+            elif reply.get("id") == 1:
+                return reply
+    raise ConnectionError("守护进程连接中断")
+
+
+def _ping(path: str, timeout: float = 2.0) -> Optional[Dict[str, Any]]:
+    sock = _connect(path)
+    if sock is None:
+        return None
+    try:
+        sock.settimeout(timeout)
+        return _request(sock, "ping").get("result")
+    except (OSError, ValueError, ConnectionError):
+        return None
+    finally:
+        sock.close()
+
+
+def resolve_method(target: str) -> Optional[str]:
+    """方法名或入口脚本路径 -> 方法名；不是本仓库的入口脚本时返回 None。"""
+    if target in METHODS:
+        return target
+    path = Path(target).resolve()
+    if path.parent != SCRIPT_DIR:
+        return None
+    for method, module in METHODS.items():
+        if path.name == f"{module}.py":
+            return method
+    return None
+
+
+def call(target: str, argv: List[str]) -> int:
+    method = resolve_method(target)
+    if method is None or os.environ.get("UTGEN_DAEMON", "1") == "0":
+        return EXIT_UNAVAILABLE
+    sock = _connect(socket_path())
+    if sock is None:
+        return EXIT_UNAVAILABLE
+
+    def on_log(params: Dict[str, Any]):
+        out = sys.stderr if params.get("stream") == "stderr" else sys.stdout
+        out.write(params.get("text", ""))
+        out.flush()
+
+    try:
+        reply = _request(sock, method, {"argv": argv, "cwd": os.getcwd(), "env": dict(os.environ)}, on_log)
+    except ConnectionError as e:
+        print(f"❌ {e}", file=sys.stderr)
+        return 1
+    finally:
+        sock.close()
+    error = reply.get("error")
+    if error:
+        if error.get("code") == STALE_ERROR:
+            print(f"⚠️ {error.get('message')}，改为直接运行", file=sys.stderr)
+            return EXIT_UNAVAILABLE
+        print(f"❌ 守护进程执行失败: {error.get('message')}", file=sys.stderr)
+        return 1
+    return int(reply["result"]["exit_code"])
+
+
+def start() -> int:
+    path = socket_path()
+    info = _ping(path)
+    if info is not None:
+        print(f"✅ 守护进程已在运行 (pid {info['pid']}): {path}")
+        return 0
+    log_file = log_path()
+    log_file.parent.mkdir(parents=True, exist_ok=True)
+    with open(log_file, "ab") as log:
+        proc = subprocess.Popen([sys.executable, str(Path(__file__).resolve()), "serve"],
+                                cwd=str(SCRIPT_DIR), stdin=subprocess.DEVNULL, stdout=log, stderr=log,
+                                start_new_session=True)
+    deadline = time.monotonic() + START_TIMEOUT
+    while time.monotonic() < deadline:
+        if proc.poll() is not None:
+            print(f"❌ 守护进程启动失败，详见 {log_file}")
+            return 1
+        info = _ping(path)
+        if info is not None:
+            print(f"✅ 守护进程已启动 (pid {info['pid']}): {path}")
+            return 0
+        time.sleep(0.1)
+    print(f"❌ 等待守护进程启动超时，详见 {log_file}")
+    return 1
+
+
+def stop() -> int:
+    path = socket_path()
+    sock = _connect(path)
+    if sock is None:
+        print("守护进程未运行")
+        return 0
+    try:
+        _request(sock, "shutdown")
+    except (OSError, ConnectionError):
+        pass
+    finally:
+        sock.close()
+    deadline = time.monotonic() + 10
+    while os.path.exists(path) and time.monotonic() < deadline:
+        time.sleep(0.1)
+    print("✅ 守护进程已停止")
+    return 0
+
+
+def status() -> int:
+    sock = _connect(socket_path())
+    if sock is None:
+        print("守护进程未运行")
+        return 1
+    try:
+        info = _request(sock, "stats").get("result", {})
+    finally:
+        sock.close()
+    print(f"pid {info['pid']}，运行 {info['uptime_s']}s，{'执行中' if info['busy'] else '空闲'}")
+    print(f"python: {info['python']}")
+    print(f"socket: {info['socket']}")
+    for method, entry in sorted(info.get("methods", {}).items()):
+        avg = entry["total_s"] / entry["calls"] if entry["calls"] else 0.0
+        print(f"  {method:<9} 调用 {entry['calls']:>4}（失败 {entry['failures']}），平均 {avg:.2f}s，最近 {entry['last_s']:.2f}s")
+    return 0
+
+
+def main(argv: Optional[List[str]] = None) -> int:
+    parser = argparse.ArgumentParser(description="常驻生成服务（Stage 1 / Stage 2 / 验证）")
+    sub = parser.add_subparsers(dest="command", required=True)
+    sub.add_parser("start", help="后台启动守护进程（已在运行时直接返回）")
+    sub.add_parser("stop", help="停止守护进程")
+    sub.add_parser("status", help="查看守护进程状态与各方法耗时")
+    serve_parser = sub.add_parser("serve", help="前台运行守护进程")
+    serve_parser.add_argument("--stdio", action="store_true", help="通过标准输入输出收发 JSON-RPC，而不是 Unix socket")
+    call_parser = sub.add_parser("call", help="在守护进程中运行入口脚本；不可用时退出码 75")
+    call_parser.add_argument("target", help="stage1 / stage2 / validate，或对应的入口脚本路径")
+    call_parser.add_argument("args", nargs=argparse.REMAINDER, help="传给入口脚本的参数（置于 -- 之后）")
+    args = parser.parse_args(argv)
+
+    if args.command == "call":
+        rest = args.args[1:] if args.args[:1] == ["--"] else args.args
+        return call(args.target, rest)
+    if args.command == "start":
+        return start()
+    if args.command == "stop":
+        return stop()
+    if args.command == "status":
+        return status()
+    if args.stdio:
+        return serve_stdio()
+    return serve_socket(int(os.environ.get("UTGEN_DAEMON_IDLE", DEFAULT_IDLE) or 0))
+
+
+if __name__ == "__main__":
+    raise SystemExit(main())
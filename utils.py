@@ -13,8 +13,8 @@ import csv
 import time
 import json
 import hashlib
+import threading
 from functools import wraps
-from openai import OpenAI, RateLimitError
 import logging
 from datetime import datetime
 
@@ -93,47 +93,47 @@ def validate_path(path: Union[str, Path], must_exist: bool = False) -> Optional[
 # =============================================================================
 
 class CacheManager:
-    """简单的文件缓存管理器"""
+    """响应缓存管理器（存储实现见 response_cache.py），键按命名空间隔离"""
     
-    def __init__(self, cache_dir: str = ".cache"):
-        self.cache_dir = Path(cache_dir)
-        self.cache_dir.mkdir(exist_ok=True)
+    def __init__(self, cache_dir: Optional[str] = None, namespace: str = "llm"):
+        from response_cache import ResponseCache
+        self.store = ResponseCache(cache_dir)
+        self.namespace = namespace
     
     def get_cache_key(self, content: str) -> str:
         """生成缓存键"""
         return hashlib.md5(content.encode()).hexdigest()
     
-    def get(self, key: str) -> Optional[str]:
-        """获取缓存内容"""
-        cache_file = self.cache_dir / f"{key}.json"
-        if cache_file.exists():
-            try:
-                with open(cache_file, 'r', encoding='utf-8') as f:
-                    data = json.load(f)
-                    # 检查缓存是否过期（24小时）
-                    if time.time() - data.get('timestamp', 0) < 86400:
-                        logger.info(f"使用缓存: {key}")
-                        return data.get('content')
-            except Exception as e:
-                logger.warning(f"读取缓存失败: {str(e)}")
-        return None
+    def get(self, key: str, namespace: Optional[str] = None) -> Optional[str]:
+        """获取缓存内容（过期时间按命名空间的 TTL 判断）"""
+        content = self.store.get(namespace or self.namespace, key)
+        if content is not None:
+            logger.info(f"使用缓存: {key}")
+        return content
     
-    def set(self, key: str, content: str):
+    def set(self, key: str, content: str, namespace: Optional[str] = None):
         """设置缓存内容"""
-        cache_file = self.cache_dir / f"{key}.json"
-        try:
-            with open(cache_file, 'w', encoding='utf-8') as f:
-                json.dump({
-                    'content': content,
-                    'timestamp': time.time()
-                }, f, ensure_ascii=False, indent=2)
-            logger.info(f"已缓存: {key}")
-        except Exception as e:
-            logger.warning(f"写入缓存失败: {str(e)}")
+        self.store.set(namespace or self.namespace, key, content)
+        logger.info(f"已缓存: {key}")
 
 
-# 全局缓存实例
-cache_manager = CacheManager()
+_cache_managers: Dict[tuple, CacheManager] = {}
+_cache_managers_lock = threading.Lock()
+
+
+def get_cache_manager() -> CacheManager:
+    """
+    按 (缓存目录绝对路径, UTGEN_CACHE_* 环境变量) 取缓存管理器。
+    目录、容量与 TTL 均在创建时确定，常驻服务（utgen_daemon.py）中不同 cwd/环境的请求因此各用各的实例。
+    """
+    cache_dir = Path(os.environ.get("UTGEN_CACHE_DIR") or ".cache").resolve()
+    env = tuple(sorted((k, v) for k, v in os.environ.items() if k.startswith("UTGEN_CACHE_")))
+    key = (str(cache_dir), env)
+    with _cache_managers_lock:
+        manager = _cache_managers.get(key)
+        if manager is None:
+            manager = _cache_managers[key] = CacheManager(str(cache_dir))
+        return manager
 
 
 # =============================================================================
@@ -441,6 +441,29 @@ def save_csv_content(csv_lines: List[str], output_file: Union[str, Path],
         return False
 
 
+def csv_cell_value(value: str) -> Any:
+    """
+    CSV字段写入Excel时的取值：数值文本转为 int/float，列表/元组/字典格式的字符串保持原样
+    （流水线模式下逐行渲染时按同一规则取值，见 stream_pipeline.py）
+    """
+    # 清理值
+    value = value.strip()
+    
+    # 尝试转换数值类型，但保留列表格式的字符串
+    if value and not (value.startswith('[') or value.startswith('(') or value.startswith('{')):
+        try:
+            # 尝试转换为整数
+            if '.' not in value:
+                return int(value)
+            # 尝试转换为浮点数
+            return float(value)
+        except ValueError:
+            # 保持为字符串
+            return value
+    # 保持列表/元组/字典格式的字符串
+    return value
+
+
 def save_xlsx_content(csv_lines: List[str], output_file: Union[str, Path]) -> bool:
     """
     保存CSV内容到Excel文件（XLSX格式）
@@ -484,26 +507,7 @@ def save_xlsx_content(csv_lines: List[str], output_file: Union[str, Path]) -> bo
                     
                     # 写入Excel
                     for col_idx, value in enumerate(row_data, 1):
-                        # 清理值
-                        value = value.strip()
-                        
-                        # 尝试转换数值类型，但保留列表格式的字符串
-                        if value and not (value.startswith('[') or value.startswith('(') or value.startswith('{')):
-                            try:
-                                # 尝试转换为整数
-                                if '.' not in value:
-                                    cell_value = int(value)
-                                else:
-                                    # 尝试转换为浮点数
-                                    cell_value = float(value)
-                            except ValueError:
-                                # 保持为字符串
-                                cell_value = value
-                        else:
-                            # 保持列表/元组/字典格式的字符串
-                            cell_value = value
-                        
-                        ws.cell(row=row_idx, column=col_idx, value=cell_value)
+                        ws.cell(row=row_idx, column=col_idx, value=csv_cell_value(value))
                         
                 except Exception as e:
                     logger.warning(f"解析第{row_idx}行失败: {e}")
@@ -595,15 +599,27 @@ def read_excel_content(excel_path: Union[str, Path],
 # =============================================================================
 
 class ModelCaller:
-    """增强的模型调用器，支持缓存和更好的错误处理"""
+    """增强的模型调用器，支持缓存、共享限流与并发调用（异步实现见 llm_client.py）"""
+    
+    DEFAULT_SYSTEM_MESSAGE = "你是一个专业的C++程序员和测试工程师。请根据提供的代码为算子类写一个完整的单元测试(UT)。请直接输出UT代码，不需要额外的说明。"
     
     def __init__(self, api_key: str, base_url: str, model_name: str,
-                 use_cache: bool = True):
+                 use_cache: bool = True, concurrency: Optional[int] = None,
+                 cache_namespace: str = "llm", metrics_context: Optional[Dict[str, Any]] = None):
         self.api_key = api_key
         self.base_url = base_url
         self.model_name = model_name
         self.use_cache = use_cache
-        self.client = OpenAI(api_key=api_key, base_url=base_url)
+        self.concurrency = concurrency
+        # 缓存命名空间决定 TTL（UTGEN_CACHE_TTL_<NS>），见 response_cache.py
+        self.cache_namespace = cache_namespace
+        # 调用指标的上下文（见 llm_metrics.py），如阶段、算子、prompt 布局
+        self.metrics_context = dict(metrics_context or {"stage": cache_namespace})
+    
+    def _cache_key(self, prompt: str, system_message: str, sample: int = 0) -> str:
+        # 多次采样时第 2 份起的结果单独缓存，避免全部命中同一条
+        suffix = f":sample={sample}" if sample else ""
+        return get_cache_manager().get_cache_key(f"{self.model_name}:{system_message}:{prompt}{suffix}")
     
     def call(self, prompt: str, system_message: Optional[str] = None,
              max_retries: int = 5, temperature: float = 0.7,
@@ -619,72 +635,94 @@ class ModelCaller:
             max_tokens: 最大token数
         
         Returns:
-            str: 生成的内容
+            str: 生成的内容，失败时为空字符串
         """
-        if system_message is None:
-            system_message = "你是一个专业的C++程序员和测试工程师。请根据提供的代码为算子类写一个完整的单元测试(UT)。请直接输出UT代码，不需要额外的说明。"
+        return self.call_many([prompt], system_message, max_retries, temperature, max_tokens)[0]
+    
+    def sample(self, prompt: str, system_message: Optional[str] = None, num_samples: int = 1,
+               max_retries: int = 5, temperature: float = 0.7,
+               max_tokens: int = 65536) -> List[str]:
+        """对同一 prompt 并发采样 num_samples 次，返回各次结果（失败的为空字符串）。"""
+        return self.call_many([prompt] * num_samples, system_message, max_retries, temperature,
+                              max_tokens, distinct_samples=True)
+    
+    def stream(self, prompt: str, sink: Any, system_message: Optional[str] = None,
+               max_retries: int = 5, temperature: float = 0.7,
+               max_tokens: int = 65536) -> str:
+        """
+        调用模型，生成过程中把增量文本逐块交给 sink（feed/reset，见 llm_client.StreamSink）
+        
+        命中响应缓存时整段结果作为一块交给 sink；返回完整结果，失败时为空字符串
+        """
+        from llm_client import AsyncModelCaller, run_sync
         
-        # 检查缓存
-        if self.use_cache:
-            cache_key = cache_manager.get_cache_key(f"{self.model_name}:{system_message}:{prompt}")
-            cached_result = cache_manager.get(cache_key)
+        if system_message is None:
+            system_message = self.DEFAULT_SYSTEM_MESSAGE
+        key = self._cache_key(prompt, system_message) if self.use_cache else None
+        if key:
+            cached_result = get_cache_manager().get(key, self.cache_namespace)
             if cached_result:
+                sink.feed(cached_result)
                 return cached_result
         
-        wait_time = 10
-        attempt = 0
+        async def run() -> str:
+            async with AsyncModelCaller(self.api_key, self.base_url, self.model_name,
+                                        concurrency=self.concurrency,
+                                        metrics_context=self.metrics_context) as caller:
+                return await caller.call(prompt, system_message, max_retries, temperature, max_tokens, sink=sink)
         
-        while attempt < max_retries:
-            attempt += 1
-            
-            try:
-                logger.info(f"调用模型 {self.model_name} (尝试 {attempt}/{max_retries})")
-                
-                response = self.client.chat.completions.create(
-                    model=self.model_name,
-                    messages=[
-                        {"role": "system", "content": system_message},
-                        {"role": "user", "content": prompt}
-                    ],
-                    temperature=temperature,
-                    max_tokens=max_tokens,
-                    stream=True,
-                    timeout=6000
-                )
-                
-                # 收集流式响应
-                result = []
-                for chunk in response:
-                    if chunk.choices[0].delta.content:
-                        result.append(chunk.choices[0].delta.content)
-                
-                full_result = "".join(result).strip()
-                
-                if full_result:
-                    logger.info(f"模型调用成功，生成 {len(full_result):,} 字符")
-                    
-                    # 缓存结果
-                    if self.use_cache:
-                        cache_manager.set(cache_key, full_result)
-                    
-                    return full_result
-                else:
-                    logger.warning("模型返回空内容")
-                    
-            except RateLimitError as e:
-                wait_time = min(wait_time * 2, 300)  # 最大等待5分钟
-                logger.warning(f"达到速率限制: {str(e)}")
-                logger.info(f"等待 {wait_time} 秒后重试...")
-                time.sleep(wait_time)
-                
-            except Exception as e:
-                logger.error(f"模型调用出错: {str(e)}")
-                if attempt < max_retries:
-                    logger.info(f"等待 10 秒后重试...")
-                    time.sleep(10)
+        result = run_sync(run())
+        if result and key:
+            get_cache_manager().set(key, result, self.cache_namespace)
+        return result
+    
+    def call_many(self, prompts: List[str], system_message: Optional[str] = None,
+                  max_retries: int = 5, temperature: float = 0.7,
+                  max_tokens: int = 65536, distinct_samples: bool = False) -> List[str]:
+        """
+        并发调用多个 prompt，受 LLM_CONCURRENCY 并发数与共享的 LLM_RPM/LLM_TPM 配额约束
         
-        logger.error(f"在 {max_retries} 次尝试后模型调用失败")
-        return ""
+        Args:
+            prompts: 输入提示列表
+            distinct_samples: 为 True 时按序号区分缓存键（同一 prompt 的多次采样）
+        
+        Returns:
+            List[str]: 与 prompts 同序的结果，失败的为空字符串
+        """
+        from llm_client import AsyncModelCaller, run_sync
+        
+        if system_message is None:
+            system_message = self.DEFAULT_SYSTEM_MESSAGE
+        
+        results: List[str] = [""] * len(prompts)
+        keys: List[Optional[str]] = [None] * len(prompts)
+        pending: List[int] = []
+        for i, prompt in enumerate(prompts):
+            # 检查缓存
+            if self.use_cache:
+                keys[i] = self._cache_key(prompt, system_message, i if distinct_samples else 0)
+                cached_result = get_cache_manager().get(keys[i], self.cache_namespace)
+                if cached_result:
+                    results[i] = cached_result
+                    continue
+            pending.append(i)
+        
+        if not pending:
+            return results
+        
+        async def run() -> List[str]:
+            async with AsyncModelCaller(self.api_key, self.base_url, self.model_name,
+                                        concurrency=self.concurrency,
+                                        metrics_context=self.metrics_context) as caller:
+                return await caller.call_many([(prompts[i], system_message) for i in pending],
+                                              max_retries, temperature, max_tokens)
+        
+        for i, result in zip(pending, run_sync(run())):
+            results[i] = result
+            # 缓存结果
+            if result and self.use_cache:
+                get_cache_manager().set(keys[i], result, self.cache_namespace)
+        return results
 
 
 def call_model(prompt: str, api_key: str, base_url: str, model_name: str,
@@ -831,7 +869,7 @@ def get_file_stats(file_path: Union[str, Path]) -> Dict[str, Any]:
 # =============================================================================
 
 def cleanup_old_cache(days: int = 7):
-    """清理旧的缓存文件"""
+    """清理旧版缓存遗留的 JSON 文件（现缓存过期与淘汰由 response_cache 负责）"""
     cache_dir = Path(".cache")
     if not cache_dir.exists():
         return
@@ -847,4 +885,4 @@ def cleanup_old_cache(days: int = 7):
 
 
 # 启动时清理旧缓存
-cleanup_old_cache()
\ No newline at end of file
+cleanup_old_cache()
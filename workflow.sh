@@ -9,6 +9,21 @@ set -e
 SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
 source "$SCRIPT_DIR/config.sh"
 
+# 常驻进程（python3 utgen_daemon.py start）可用时在其中运行 Python 入口，省去解释器启动与依赖导入；
+# 不可用（call 退出码 75）或 UTGEN_DAEMON=0 时直接运行
+run_python() {
+    local script="$1"
+    shift
+    if [ "${UTGEN_DAEMON:-1}" != "0" ]; then
+        local rc=0
+        python3 "$SCRIPT_DIR/utgen_daemon.py" call "$script" -- "$@" || rc=$?
+        if [ "$rc" -ne 75 ]; then
+            return "$rc"
+        fi
+    fi
+    python3 "$script" "$@"
+}
+
 # 在脚本开头添加一个函数来转换小写
 to_lower() {
     echo "$1" | tr '[:upper:]' '[:lower:]'
@@ -38,7 +53,7 @@ show_help() {
 命令:
   gen-ut          生成单元测试代码 (默认命令)
   gen-params      生成测试参数CSV文件
-  gen-all         先生成参数，再生成单测 (完整流程)
+  gen-all         先生成参数，再生成单测 (完整流程，testf 模式下边生成参数边渲染单测)
 
 选项:
   -h, --help      显示帮助信息
@@ -118,21 +133,12 @@ print(datetime.datetime.now().strftime('%Y%m%d_%H%M%S'))
     # 调用测试参数生成器
     echo "🚀 调用测试参数生成器..." | tee -a "$log_file"
     # 传递 SPECIAL_REQS_DIR 环境变量给 stage_1.py
-    if SPECIAL_REQS_DIR="$SPECIAL_REQS_DIR" python3 "$STAGE_1" "$operator_name" "$output_file" "$prompt_file" \
+    if SPECIAL_REQS_DIR="$SPECIAL_REQS_DIR" run_python "$STAGE_1" "$operator_name" "$output_file" "$prompt_file" \
                 "$FEWSHOT_STAGE1_FILE" "$API_KEY" "$BASE_URL" "$MODEL_NAME" "${source_paths[@]}" 2>&1 | tee -a "$log_file"; then
         
         if [ -f "$output_file" ]; then
             echo "✅ 测试参数生成成功: $output_file" | tee -a "$log_file"
-            rows=$(python3 - "$output_file" << 'PY'
-import pandas as pd
-import sys
-try:
-    df = pd.read_excel(sys.argv[1])
-    print(df.shape[0])
-except Exception:
-    print(0)
-PY
-)
+            rows=$(python3 "$SCRIPT_DIR/param_reader.py" count "$output_file" 2>/dev/null || echo 0)
             echo "生成的测试参数行数: ${rows}" | tee -a "$log_file"
             return 0
         else
@@ -171,6 +177,10 @@ print(datetime.datetime.now().strftime('%Y%m%d_%H%M%S'))
     local raw_response_file="$run_dir/raw_response.txt"
     local output_file="$run_dir/test_${operator_lower}_tiling.cpp"
     local log_file="$run_dir/generation.log"
+    # 指定 UT_OUT_DIR 时输出到固定位置（如 UT 工程目录）：内容未变化的文件不重写，增量编译不受影响
+    if [ -n "$UT_OUT_DIR" ]; then
+        output_file="$UT_OUT_DIR/test_${operator_lower}_tiling.cpp"
+    fi
     
     # 记录开始信息
     {
@@ -209,11 +219,17 @@ print(datetime.datetime.now().strftime('%Y%m%d_%H%M%S'))
 
     # 3) 调用转换脚本，输出写入当前 run_dir，保持原有目录结构
     echo "🚚 使用 convert_ut_from_xlsx.py 生成UT..." | tee -a "$log_file"
-    if CASE_TEMPLATE_DIR="$CASE_TEMPLATE_DIR" python3 "$CONVERT_UT_FROM_XLSX" \
+    if CASE_TEMPLATE_DIR="$CASE_TEMPLATE_DIR" run_python "$CONVERT_UT_FROM_XLSX" \
         --ref "$reference_ut" \
         --xlsx "$xlsx_file" \
         --op "$operator_name" \
+        --mode "${UT_MODE:-testf}" \
+        --lint "${UT_LINT:-repair}" \
+        ${UT_BENCH:+--bench} \
+        ${UT_SHARD:+--shard "$UT_SHARD"} \
         --out "$output_file" 2>&1 | tee -a "$log_file"; then
+        # 分片输出时以 CMake 片段代替单文件
+        [ -n "$UT_SHARD" ] && output_file="${output_file%.cpp}_shards.cmake"
         if [ -f "$output_file" ]; then
             echo "✅ 单元测试生成成功: $output_file" | tee -a "$log_file"
             return 0
@@ -227,6 +243,64 @@ print(datetime.datetime.now().strftime('%Y%m%d_%H%M%S'))
     fi
 }
 
+# =============================================================================
+# 流水线：参数逐行生成时立即渲染单测（stream_pipeline.py）
+# =============================================================================
+stage_pipeline() {
+    local operator_name="$1"
+    local reference_ut="$2"
+    shift 2
+    local source_paths=("$@")
+    
+    local timestamp=$(python3 -c "
+import datetime
+print(datetime.datetime.now().strftime('%Y%m%d_%H%M%S'))
+" 2>/dev/null)
+    local operator_lower=$(to_lower "$operator_name")
+    # 参数文件与单测分别写入与 stage_1 / stage_2 相同的目录结构，之后仍可单独重跑 gen-ut
+    local params_dir="runs/${timestamp}_${operator_lower}_stage_1"
+    local run_dir="runs/${timestamp}_${operator_lower}"
+    mkdir -p "$params_dir" "$run_dir"
+    
+    local params_file="$params_dir/test_params_${operator_lower}.xlsx"
+    local prompt_file="$params_dir/prompt_testcase_${operator_lower}.txt"
+    local output_file="$run_dir/test_${operator_lower}_tiling.cpp"
+    local log_file="$run_dir/generation.log"
+    if [ -n "$UT_OUT_DIR" ]; then
+        output_file="$UT_OUT_DIR/test_${operator_lower}_tiling.cpp"
+    fi
+    
+    {
+        echo "开始时间: $(date)"
+        echo "算子名称: $operator_name"
+        echo "源码路径: ${source_paths[*]}"
+        echo "参数文件: $params_file"
+        echo "参考UT: $reference_ut"
+        echo "运行目录: $run_dir"
+        echo "=============================="
+        echo ""
+    } >> "$log_file"
+    
+    echo "🚚 流水线生成参数与单测（用例边生成边写入 ${output_file}.partial）..." | tee -a "$log_file"
+    if SPECIAL_REQS_DIR="$SPECIAL_REQS_DIR" CASE_TEMPLATE_DIR="$CASE_TEMPLATE_DIR" \
+        run_python "$SCRIPT_DIR/stream_pipeline.py" --ref "$reference_ut" --out "$output_file" \
+        --lint "${UT_LINT:-repair}" ${UT_SHARD:+--shard "$UT_SHARD"} -- \
+        "$operator_name" "$params_file" "$prompt_file" \
+        "$FEWSHOT_STAGE1_FILE" "$API_KEY" "$BASE_URL" "$MODEL_NAME" "${source_paths[@]}" 2>&1 | tee -a "$log_file"; then
+        [ -n "$UT_SHARD" ] && output_file="${output_file%.cpp}_shards.cmake"
+        if [ -f "$output_file" ]; then
+            echo "✅ 测试参数: $params_file" | tee -a "$log_file"
+            echo "✅ 单元测试生成成功: $output_file" | tee -a "$log_file"
+            return 0
+        fi
+        echo "❌ 流水线完成但未发现输出文件: $output_file" | tee -a "$log_file"
+        return 1
+    else
+        echo "❌ 流水线执行失败" | tee -a "$log_file"
+        return 1
+    fi
+}
+
 # =============================================================================
 # 完整流程：先生成参数，再生成单测
 # =============================================================================
@@ -238,6 +312,20 @@ stage_all() {
     echo "🚀 执行完整流程: $operator_name"
     echo "==============================="
     
+    # testf 模式默认走流水线（边生成参数边渲染单测），STAGE_PIPELINE=0 时按原流程先后执行
+    if [ "${STAGE_PIPELINE:-1}" != "0" ] && [ "${UT_MODE:-testf}" = "testf" ] && [ -z "$UT_BENCH" ]; then
+        local reference_ut="$REFERENCE_UT_DIR/test_$(to_snake "$operator_name").cpp"
+        if [ -f "$reference_ut" ]; then
+            if stage_pipeline "$operator_name" "$reference_ut" "${source_paths[@]}"; then
+                echo "✅ 完整流程执行成功!"
+                return 0
+            else
+                echo "❌ 完整流程执行失败"
+                return 1
+            fi
+        fi
+    fi
+    
     # 步骤1: 生成测试参数
     echo "第1步: 生成测试参数"
     if stage_1 "$operator_name" "${source_paths[@]}"; then